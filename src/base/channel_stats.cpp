@@ -14,34 +14,335 @@
 
 #include "base/channel_stats.h"
 
+#include <time.h>
+
 #include <common/time.h>
 
+namespace {
+// few msec resolution is enough for last update time, vdso read without hardware clock access
+time_t coarse_current_mstime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+}  // namespace
+
 namespace iptv_cloud {
 
+const uint64_t ChannelStats::invalid_timestamp;
+const uint64_t ChannelStats::buffer_size_first_bound;
+const uint64_t ChannelStats::interval_first_bound;
+
 ChannelStats::ChannelStats() : ChannelStats(0) {}
 
 ChannelStats::ChannelStats(channel_id_t cid)
     : id_(cid),
       last_update_time_(0),
       total_bytes_(0),
+      total_packets_(0),
       prev_total_bytes_(0),
+      dropped_bytes_(0),
+      dropped_packets_(0),
+      prev_dropped_packets_(0),
+      degraded_(false),
+      reconnects_(0),
+      downtime_(0),
+      lost_packets_(0),
+      reordered_packets_(0),
+      duplicate_packets_(0),
+      clients_(0),
+      evicted_clients_(0),
       bytes_per_second_(0),
-      desire_bytes_per_second_() {}
+      desire_bytes_per_second_(),
+      buffer_size_(buffer_size_first_bound),
+      arrival_(interval_first_bound),
+      timestamp_gap_(interval_first_bound),
+      last_arrival_(0),
+      last_timestamp_(invalid_timestamp),
+      window_gap_(0),
+      max_gap_(0),
+      transition_stall_(interval_first_bound),
+      transition_jump_(interval_first_bound) {}
+
+ChannelStats::ChannelStats(const ChannelStats& other)
+    : id_(other.id_),
+      last_update_time_(other.GetLastUpdateTime()),
+      total_bytes_(other.GetTotalBytes()),
+      total_packets_(other.GetTotalPackets()),
+      prev_total_bytes_(other.prev_total_bytes_),
+      dropped_bytes_(other.GetDroppedBytes()),
+      dropped_packets_(other.GetDroppedPackets()),
+      prev_dropped_packets_(other.prev_dropped_packets_),
+      degraded_(other.degraded_),
+      reconnects_(other.reconnects_),
+      downtime_(other.downtime_),
+      lost_packets_(other.GetLostPackets()),
+      reordered_packets_(other.GetReorderedPackets()),
+      duplicate_packets_(other.GetDuplicatePackets()),
+      clients_(other.GetClients()),
+      evicted_clients_(other.GetEvictedClients()),
+      bytes_per_second_(other.bytes_per_second_),
+      desire_bytes_per_second_(other.desire_bytes_per_second_),
+      buffer_size_(other.buffer_size_),
+      arrival_(other.arrival_),
+      timestamp_gap_(other.timestamp_gap_),
+      last_arrival_(other.last_arrival_.load(std::memory_order_relaxed)),
+      last_timestamp_(other.last_timestamp_.load(std::memory_order_relaxed)),
+      window_gap_(other.window_gap_.load(std::memory_order_relaxed)),
+      max_gap_(other.GetMaxGap()),
+      transition_stall_(other.transition_stall_),
+      transition_jump_(other.transition_jump_) {}
+
+ChannelStats& ChannelStats::operator=(const ChannelStats& other) {
+  id_ = other.id_;
+  last_update_time_.store(other.GetLastUpdateTime(), std::memory_order_relaxed);
+  total_bytes_.store(other.GetTotalBytes(), std::memory_order_relaxed);
+  total_packets_.store(other.GetTotalPackets(), std::memory_order_relaxed);
+  prev_total_bytes_ = other.prev_total_bytes_;
+  dropped_bytes_.store(other.GetDroppedBytes(), std::memory_order_relaxed);
+  dropped_packets_.store(other.GetDroppedPackets(), std::memory_order_relaxed);
+  prev_dropped_packets_ = other.prev_dropped_packets_;
+  degraded_ = other.degraded_;
+  reconnects_ = other.reconnects_;
+  downtime_ = other.downtime_;
+  lost_packets_.store(other.GetLostPackets(), std::memory_order_relaxed);
+  reordered_packets_.store(other.GetReorderedPackets(), std::memory_order_relaxed);
+  duplicate_packets_.store(other.GetDuplicatePackets(), std::memory_order_relaxed);
+  clients_.store(other.GetClients(), std::memory_order_relaxed);
+  evicted_clients_.store(other.GetEvictedClients(), std::memory_order_relaxed);
+  bytes_per_second_ = other.bytes_per_second_;
+  desire_bytes_per_second_ = other.desire_bytes_per_second_;
+  buffer_size_ = other.buffer_size_;
+  arrival_ = other.arrival_;
+  timestamp_gap_ = other.timestamp_gap_;
+  last_arrival_.store(other.last_arrival_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  last_timestamp_.store(other.last_timestamp_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  window_gap_.store(other.window_gap_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  max_gap_.store(other.GetMaxGap(), std::memory_order_relaxed);
+  transition_stall_ = other.transition_stall_;
+  transition_jump_ = other.transition_jump_;
+  return *this;
+}
 
 channel_id_t ChannelStats::GetID() const {
   return id_;
 }
 
 time_t ChannelStats::GetLastUpdateTime() const {
-  return last_update_time_;
+  return last_update_time_.load(std::memory_order_relaxed);
 }
 
 void ChannelStats::SetLastUpdateTime(time_t t) {
-  last_update_time_ = t;
+  last_update_time_.store(t, std::memory_order_relaxed);
 }
 
 size_t ChannelStats::GetTotalBytes() const {
-  return total_bytes_;
+  return total_bytes_.load(std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetTotalPackets() const {
+  return total_packets_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetTotalPackets(size_t packets) {
+  total_packets_.store(packets, std::memory_order_relaxed);
+}
+
+void ChannelStats::UpdateData(size_t bytes, size_t packets) {
+  total_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  total_packets_.fetch_add(packets, std::memory_order_relaxed);
+  last_update_time_.store(coarse_current_mstime(), std::memory_order_relaxed);
+}
+
+void ChannelStats::RecordDrop(size_t bytes, size_t packets) {
+  dropped_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  dropped_packets_.fetch_add(packets, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetDroppedBytes() const {
+  return dropped_bytes_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetDroppedBytes(size_t bytes) {
+  dropped_bytes_.store(bytes, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetDroppedPackets() const {
+  return dropped_packets_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetDroppedPackets(size_t packets) {
+  dropped_packets_.store(packets, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetDiffDroppedPackets() const {
+  return GetDroppedPackets() - prev_dropped_packets_;
+}
+
+bool ChannelStats::IsDegraded() const {
+  return degraded_;
+}
+
+void ChannelStats::SetDegraded(bool degraded) {
+  degraded_ = degraded;
+}
+
+void ChannelStats::RecordReconnect(time_t downtime) {
+  reconnects_++;
+  downtime_ += downtime;
+}
+
+size_t ChannelStats::GetReconnects() const {
+  return reconnects_;
+}
+
+void ChannelStats::SetReconnects(size_t reconnects) {
+  reconnects_ = reconnects;
+}
+
+time_t ChannelStats::GetDowntime() const {
+  return downtime_;
+}
+
+void ChannelStats::SetDowntime(time_t downtime) {
+  downtime_ = downtime;
+}
+
+void ChannelStats::RecordRtpCounters(size_t lost, size_t reordered, size_t duplicates) {
+  lost_packets_.fetch_add(lost, std::memory_order_relaxed);
+  reordered_packets_.fetch_add(reordered, std::memory_order_relaxed);
+  duplicate_packets_.fetch_add(duplicates, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetLostPackets() const {
+  return lost_packets_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetLostPackets(size_t packets) {
+  lost_packets_.store(packets, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetReorderedPackets() const {
+  return reordered_packets_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetReorderedPackets(size_t packets) {
+  reordered_packets_.store(packets, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetDuplicatePackets() const {
+  return duplicate_packets_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetDuplicatePackets(size_t packets) {
+  duplicate_packets_.store(packets, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetClients() const {
+  return clients_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetClients(size_t clients) {
+  clients_.store(clients, std::memory_order_relaxed);
+}
+
+size_t ChannelStats::GetEvictedClients() const {
+  return evicted_clients_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetEvictedClients(size_t clients) {
+  evicted_clients_.store(clients, std::memory_order_relaxed);
+}
+
+void ChannelStats::RecordArrival(uint64_t arrival) {
+  const uint64_t prev = last_arrival_.exchange(arrival, std::memory_order_relaxed);
+  if (!prev || arrival < prev) {
+    return;
+  }
+
+  const uint64_t gap = arrival - prev;
+  arrival_.Record(gap);
+  uint64_t window_gap = window_gap_.load(std::memory_order_relaxed);
+  while (gap > window_gap && !window_gap_.compare_exchange_weak(window_gap, gap, std::memory_order_relaxed)) {
+    // window_gap reloaded by failed exchange
+  }
+}
+
+void ChannelStats::RecordBuffer(size_t size, uint64_t timestamp) {
+  buffer_size_.Record(size);
+  if (timestamp == invalid_timestamp) {
+    return;
+  }
+
+  const uint64_t prev = last_timestamp_.exchange(timestamp, std::memory_order_relaxed);
+  if (prev != invalid_timestamp && timestamp >= prev) {  // backward jumps are discontinuities, not gaps
+    timestamp_gap_.Record((timestamp - prev) / 1000);
+  }
+}
+
+void ChannelStats::UpdateGapWindow(uint64_t now) {
+  uint64_t gap = window_gap_.exchange(0, std::memory_order_relaxed);
+  const uint64_t last_arrival = last_arrival_.load(std::memory_order_relaxed);
+  if (last_arrival && now > last_arrival && now - last_arrival > gap) {
+    gap = now - last_arrival;
+  }
+  max_gap_.store(gap, std::memory_order_relaxed);
+}
+
+HistogramSnapshot ChannelStats::GetBufferSizeHistogram() const {
+  return buffer_size_.GetSnapshot();
+}
+
+void ChannelStats::SetBufferSizeHistogram(const HistogramSnapshot& hist) {
+  buffer_size_.SetSnapshot(hist);
+}
+
+HistogramSnapshot ChannelStats::GetArrivalHistogram() const {
+  return arrival_.GetSnapshot();
+}
+
+void ChannelStats::SetArrivalHistogram(const HistogramSnapshot& hist) {
+  arrival_.SetSnapshot(hist);
+}
+
+HistogramSnapshot ChannelStats::GetTimestampGapHistogram() const {
+  return timestamp_gap_.GetSnapshot();
+}
+
+void ChannelStats::SetTimestampGapHistogram(const HistogramSnapshot& hist) {
+  timestamp_gap_.SetSnapshot(hist);
+}
+
+uint64_t ChannelStats::GetMaxGap() const {
+  return max_gap_.load(std::memory_order_relaxed);
+}
+
+void ChannelStats::SetMaxGap(uint64_t gap) {
+  max_gap_.store(gap, std::memory_order_relaxed);
+}
+
+void ChannelStats::RecordTransitionStall(uint64_t stall) {
+  transition_stall_.Record(stall);
+}
+
+void ChannelStats::RecordTransitionJump(uint64_t jump) {
+  transition_jump_.Record(jump);
+}
+
+HistogramSnapshot ChannelStats::GetTransitionStallHistogram() const {
+  return transition_stall_.GetSnapshot();
+}
+
+void ChannelStats::SetTransitionStallHistogram(const HistogramSnapshot& hist) {
+  transition_stall_.SetSnapshot(hist);
+}
+
+HistogramSnapshot ChannelStats::GetTransitionJumpHistogram() const {
+  return transition_jump_.GetSnapshot();
+}
+
+void ChannelStats::SetTransitionJumpHistogram(const HistogramSnapshot& hist) {
+  transition_jump_.SetSnapshot(hist);
 }
 
 size_t ChannelStats::GetPrevTotalBytes() const {
@@ -53,7 +354,7 @@ void ChannelStats::SetPrevTotalBytes(size_t bytes) {
 }
 
 size_t ChannelStats::GetDiffTotalBytes() const {
-  return total_bytes_ - prev_total_bytes_;
+  return GetTotalBytes() - prev_total_bytes_;
 }
 
 void ChannelStats::UpdateBps(size_t sec) {
@@ -73,12 +374,13 @@ void ChannelStats::SetBps(size_t bps) {
 }
 
 void ChannelStats::UpdateCheckPoint() {
-  prev_total_bytes_ = total_bytes_;
+  prev_total_bytes_ = GetTotalBytes();
+  prev_dropped_packets_ = GetDroppedPackets();
 }
 
 void ChannelStats::SetTotalBytes(size_t bytes) {
-  total_bytes_ = bytes;
-  last_update_time_ = common::time::current_mstime();
+  total_bytes_.store(bytes, std::memory_order_relaxed);
+  SetLastUpdateTime(common::time::current_mstime());
 }
 
 void ChannelStats::SetDesireBytesPerSecond(const common::media::DesireBytesPerSec& bps) {
@@ -14,16 +14,29 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <atomic>
+
 #include <common/media/bandwidth_estimation.h>
 
+#include "base/histogram.h"
 #include "base/types.h"
 
 namespace iptv_cloud {
 
-class ChannelStats {  // only compile time size fields
+// only compile time size fields, counters are written by streaming threads and read by main loop,
+// relaxed atomics because nobody orders other memory by them
+class ChannelStats {
  public:
+  static const uint64_t invalid_timestamp = UINT64_MAX;  // same as GST_CLOCK_TIME_NONE
+  static const uint64_t buffer_size_first_bound = 256;     // bytes
+  static const uint64_t interval_first_bound = 250;        // usec, arrival and timestamps gaps
+
   ChannelStats();
   explicit ChannelStats(channel_id_t cid);
+  ChannelStats(const ChannelStats& other);
+  ChannelStats& operator=(const ChannelStats& other);
 
   channel_id_t GetID() const;
 
@@ -33,6 +46,70 @@ class ChannelStats {  // only compile time size fields
   size_t GetTotalBytes() const;
   void SetTotalBytes(size_t bytes);
 
+  size_t GetTotalPackets() const;
+  void SetTotalPackets(size_t packets);
+
+  void UpdateData(size_t bytes, size_t packets);  // per buffer (list) hot path
+
+  // output queues of isolated outputs, buffers dropped instead of blocking other outputs
+  void RecordDrop(size_t bytes, size_t packets);
+  size_t GetDroppedBytes() const;
+  void SetDroppedBytes(size_t bytes);
+  size_t GetDroppedPackets() const;
+  void SetDroppedPackets(size_t packets);
+  size_t GetDiffDroppedPackets() const;  // since checkpoint
+
+  // output lost data or dropped buffers during last check window, stream keeps running
+  bool IsDegraded() const;
+  void SetDegraded(bool degraded);
+
+  // reconnected outputs, downtime in msec from sink error till branch relinked
+  void RecordReconnect(time_t downtime);
+  size_t GetReconnects() const;
+  void SetReconnects(size_t reconnects);
+  time_t GetDowntime() const;
+  void SetDowntime(time_t downtime);
+
+  // rtp input of udp batch ingest, sequence numbers lost, arrived out of order and repeated
+  void RecordRtpCounters(size_t lost, size_t reordered, size_t duplicates);
+  size_t GetLostPackets() const;
+  void SetLostPackets(size_t packets);
+  size_t GetReorderedPackets() const;
+  void SetReorderedPackets(size_t packets);
+  size_t GetDuplicatePackets() const;
+  void SetDuplicatePackets(size_t packets);
+
+  // tcp server output with own clients queues, connected clients and slow ones disconnected
+  size_t GetClients() const;
+  void SetClients(size_t clients);
+  size_t GetEvictedClients() const;
+  void SetEvictedClients(size_t clients);
+
+  // probes side, arrival in monotonic usec once per buffer (list), timestamp dts (pts) nsec of every buffer
+  void RecordArrival(uint64_t arrival);
+  void RecordBuffer(size_t size, uint64_t timestamp);
+  // main loop side, closes window of max gap, silence since last arrival is gap too
+  void UpdateGapWindow(uint64_t now);
+
+  HistogramSnapshot GetBufferSizeHistogram() const;  // bytes
+  void SetBufferSizeHistogram(const HistogramSnapshot& hist);
+  HistogramSnapshot GetArrivalHistogram() const;  // usec between arrivals
+  void SetArrivalHistogram(const HistogramSnapshot& hist);
+  HistogramSnapshot GetTimestampGapHistogram() const;  // usec between timestamps of neighbour buffers
+  void SetTimestampGapHistogram(const HistogramSnapshot& hist);
+
+  uint64_t GetMaxGap() const;  // usec, max arrival gap in last finished window
+  void SetMaxGap(uint64_t gap);
+
+  // playlist input, file transitions
+  void RecordTransitionStall(uint64_t stall);
+  void RecordTransitionJump(uint64_t jump);
+
+  HistogramSnapshot GetTransitionStallHistogram() const;  // usec from end of file till first block of next one
+  void SetTransitionStallHistogram(const HistogramSnapshot& hist);
+  HistogramSnapshot GetTransitionJumpHistogram() const;  // usec of timestamps discontinuity stitched over
+  void SetTransitionJumpHistogram(const HistogramSnapshot& hist);
+
   size_t GetPrevTotalBytes() const;
   void SetPrevTotalBytes(size_t bytes);
 
@@ -50,12 +127,34 @@ class ChannelStats {  // only compile time size fields
  private:
   channel_id_t id_;
 
-  time_t last_update_time_;  // up_time
-  size_t total_bytes_;       // received bytes
-  size_t prev_total_bytes_;  // checkpoint received bytes
+  std::atomic<time_t> last_update_time_;  // up_time
+  std::atomic<size_t> total_bytes_;       // received bytes
+  std::atomic<size_t> total_packets_;     // received buffers
+  size_t prev_total_bytes_;               // checkpoint received bytes
+  std::atomic<size_t> dropped_bytes_;
+  std::atomic<size_t> dropped_packets_;
+  size_t prev_dropped_packets_;  // checkpoint dropped buffers
+  bool degraded_;
+  size_t reconnects_;
+  time_t downtime_;  // msec
+  std::atomic<size_t> lost_packets_;
+  std::atomic<size_t> reordered_packets_;
+  std::atomic<size_t> duplicate_packets_;
+  std::atomic<size_t> clients_;
+  std::atomic<size_t> evicted_clients_;
   size_t bytes_per_second_;  // bps
 
   common::media::DesireBytesPerSec desire_bytes_per_second_;
+
+  Histogram buffer_size_;
+  Histogram arrival_;
+  Histogram timestamp_gap_;
+  std::atomic<uint64_t> last_arrival_;    // usec
+  std::atomic<uint64_t> last_timestamp_;  // nsec
+  std::atomic<uint64_t> window_gap_;      // usec, max gap of current window
+  std::atomic<uint64_t> max_gap_;         // usec
+  Histogram transition_stall_;
+  Histogram transition_jump_;
 };
 
 }  // namespace iptv_cloud
@@ -22,6 +22,20 @@
 
 #define INPUT_FIELD "input"  // required
 #define OUTPUT_FIELD "output"
+#define OUTPUT_ISOLATION_FIELD "output_isolation"
+#define OUTPUT_QUEUE_MAX_TIME_FIELD "output_queue_max_time"
+#define OUTPUT_QUEUE_MAX_BYTES_FIELD "output_queue_max_bytes"
+#define OUTPUT_RECONNECT_FIELD "output_reconnect"
+#define UDP_BATCH_FIELD "udp_batch"
+#define UDP_INPUT_BATCH_FIELD "udp_input_batch"
+#define UDP_INPUT_RCVBUF_FIELD "udp_input_rcvbuf"
+#define UDP_INPUT_LATENCY_FIELD "udp_input_latency"
+#define TCP_CLIENTS_FIELD "tcp_clients"
+#define TCP_CLIENT_QUEUE_BYTES_FIELD "tcp_client_queue_bytes"
+#define TCP_CLIENT_EVICT_TIME_FIELD "tcp_client_evict_time"
+#define SHARED_INGEST_FIELD "shared_ingest"
+#define INGEST_SOCKET_FIELD "ingest_socket"
+#define INGEST_PUBLISH_FIELD "ingest_publish"
 #define HAVE_VIDEO_FIELD "have_video"
 #define HAVE_AUDIO_FIELD "have_audio"
 #define DEINTERLACE_FIELD "deinterlace"
@@ -30,6 +44,7 @@
 #define VOLUME_FIELD "volume"
 #define VIDEO_PARSER_FIELD "video_parser"
 #define AUDIO_PARSER_FIELD "audio_parser"
+#define RELAY_FAST_PATH_FIELD "relay_fast_path"
 #define VIDEO_CODEC_FIELD "video_codec"
 #define AUDIO_CODEC_FIELD "audio_codec"
 #define AUDIO_SELECT_FIELD "audio_select"
@@ -39,6 +54,7 @@
 #define TIMESHIFT_CHUNK_DURATION_FIELD "timeshift_chunk_duration"
 #define LOGO_FIELD "logo"
 #define LOOP_FIELD "loop"
+#define PLAYLIST_BLOCK_SIZE_FIELD "playlist_block_size"
 #define RESTART_ATTEMPTS_FIELD "restart_attempts"
 #define DELAY_TIME_FIELD "delay_time"
 #define SIZE_FIELD "size"
@@ -47,6 +63,9 @@
 #define MAIN_PROFILE_FIELD "mainprofile"
 #define MAIN_PROFILE_EXTERNAL_FIELD "mainprofile_external"
 #define ASPECT_RATIO_FIELD "aspect_ratio"
+#define RENDITIONS_FIELD "renditions"
+#define KEY_FRAME_INTERVAL_FIELD "key_frame_interval"
+#define HLS_MASTER_PLAYLIST_FIELD "hls_master_playlist"
 #define RELAY_AUDIO_FIELD "relay_audio"
 #define RELAY_VIDEO_FIELD "relay_video"
 
@@ -20,4 +20,40 @@
 #define DEFAULT_TIMESHIFT_CHUNK_DURATION 120
 #define DEFAULT_CHUNK_LIFE_TIME 12 * 3600
 
+#define DEFAULT_PLAYLIST_BLOCK_SIZE (1024 * 1024)
+#define MIN_PLAYLIST_BLOCK_SIZE 4096
+#define MAX_PLAYLIST_BLOCK_SIZE (64 * 1024 * 1024)
+
+#define DEFAULT_OUTPUT_QUEUE_MAX_TIME 3000  // msec
+#define MIN_OUTPUT_QUEUE_MAX_TIME 100
+#define MAX_OUTPUT_QUEUE_MAX_TIME 60000
+
+#define DEFAULT_OUTPUT_QUEUE_MAX_BYTES (8 * 1024 * 1024)
+#define MIN_OUTPUT_QUEUE_MAX_BYTES (64 * 1024)
+#define MAX_OUTPUT_QUEUE_MAX_BYTES (256 * 1024 * 1024)
+
+#define DEFAULT_UDP_INPUT_RCVBUF (16 * 1024 * 1024)
+#define MIN_UDP_INPUT_RCVBUF (256 * 1024)
+#define MAX_UDP_INPUT_RCVBUF (512 * 1024 * 1024)
+
+#define DEFAULT_UDP_INPUT_LATENCY 50  // msec
+#define MIN_UDP_INPUT_LATENCY 0
+#define MAX_UDP_INPUT_LATENCY 2000
+
+#define DEFAULT_TCP_CLIENT_QUEUE_BYTES (4 * 1024 * 1024)
+#define MIN_TCP_CLIENT_QUEUE_BYTES (64 * 1024)
+#define MAX_TCP_CLIENT_QUEUE_BYTES (256 * 1024 * 1024)
+
+#define DEFAULT_TCP_CLIENT_EVICT_TIME 5000  // msec
+#define MIN_TCP_CLIENT_EVICT_TIME 0
+#define MAX_TCP_CLIENT_EVICT_TIME 600000
+
+#define DEFAULT_INGEST_SHM_SIZE (32 * 1024 * 1024)  // few seconds of compressed stream for slowest reader
+#define INGEST_QUEUE_MAX_TIME 2000                  // msec, ingest drops oldest data above it while shm is stalled
+#define INGEST_QUEUE_MAX_BYTES (8 * 1024 * 1024)    // same for sources without timestamps
+
+#define DEFAULT_KEY_FRAME_INTERVAL 2000  // msec
+#define MIN_KEY_FRAME_INTERVAL 100
+#define MAX_KEY_FRAME_INTERVAL 60000
+
 #define TEST_URL "test"
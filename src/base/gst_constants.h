@@ -46,6 +46,7 @@
 #define ALSA_SRC "alsasrc"
 #define MULTIFILE_SRC "multifilesrc"
 #define APP_SRC "appsrc"
+#define APP_SINK "appsink"
 #define FILE_SRC "filesrc"
 #define IMAGE_FREEZE "imagefreeze"
 #define CAPS_FILTER "capsfilter"
@@ -72,6 +73,7 @@
 #define NV_H264_ENC "nvh264enc"
 #define NV_H264_ENC_PARAM(x) NV_H264_ENC "." x
 #define NV_H264_ENC_PRESET NV_H264_ENC_PARAM("preset")
+#define NV_H264_ENC_GOP_SIZE NV_H264_ENC_PARAM("gop-size")
 
 #define MSDK_H264_ENC "msdkh264enc"
 
@@ -130,6 +132,7 @@
 #define OPEN_H264_ENC_RATE_CONTROL OPEN_H264_ENC_PARAM("rate-control")
 #define OPEN_H264_ENC_GOP_SIZE OPEN_H264_ENC_PARAM("gop-size")
 #define OPEN_H264_ENC_COMPLEXITY OPEN_H264_ENC_PARAM("complexity")
+#define OPEN_H264_ENC_SCENE_CHANGE_DETECTION OPEN_H264_ENC_PARAM("scene-change-detection")
 
 #define UDP_SRC "udpsrc"
 #define RTMP_SRC "rtmpsrc"
@@ -184,6 +187,9 @@
 #define MFX_H264_GOP_SIZE MFX_H264_ENC_PARAM("gop-size")
 #define MFX_VPP "mfxvpp"
 #define MFX_H264_DEC "mfxh264dec"
+#define SHM_SINK "shmsink"
+#define SHM_SRC "shmsrc"
+#define FLV_DEMUX "flvdemux"
 
 #define SUPPORTED_VIDEO_PARSERS_COUNT 3
 #define SUPPORTED_AUDIO_PARSERS_COUNT 3
@@ -0,0 +1,90 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/histogram.h"
+
+namespace {
+
+size_t BucketIndex(uint64_t value, uint64_t first_bound) {
+  if (value <= first_bound) {
+    return 0;
+  }
+
+  // smallest i with value <= first_bound << i
+  const uint64_t ratio = (value - 1) / first_bound;
+  const size_t index = 64 - __builtin_clzll(ratio);
+  return index < iptv_cloud::Histogram::buckets_count ? index : iptv_cloud::Histogram::buckets_count - 1;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+
+HistogramSnapshot::HistogramSnapshot() : first_bound(1), buckets(), count(0), sum(0) {}
+
+uint64_t HistogramSnapshot::GetUpperBound(size_t bucket) const {
+  if (bucket + 1 >= buckets_count) {
+    return UINT64_MAX;
+  }
+
+  return first_bound << bucket;
+}
+
+Histogram::Histogram(uint64_t first_bound)
+    : first_bound_(first_bound ? first_bound : 1), buckets_(), count_(0), sum_(0) {
+  for (size_t i = 0; i < buckets_count; ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+Histogram::Histogram(const Histogram& other) : Histogram(other.first_bound_) {
+  SetSnapshot(other.GetSnapshot());
+}
+
+Histogram& Histogram::operator=(const Histogram& other) {
+  first_bound_ = other.first_bound_;
+  SetSnapshot(other.GetSnapshot());
+  return *this;
+}
+
+void Histogram::Record(uint64_t value) {
+  buckets_[BucketIndex(value, first_bound_)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+HistogramSnapshot Histogram::GetSnapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.first_bound = first_bound_;
+  for (size_t i = 0; i < buckets_count; ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void Histogram::SetSnapshot(const HistogramSnapshot& snapshot) {
+  for (size_t i = 0; i < buckets_count; ++i) {
+    buckets_[i].store(snapshot.buckets[i], std::memory_order_relaxed);
+  }
+  count_.store(snapshot.count, std::memory_order_relaxed);
+  sum_.store(snapshot.sum, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::GetFirstBound() const {
+  return first_bound_;
+}
+
+}  // namespace iptv_cloud
@@ -0,0 +1,61 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace iptv_cloud {
+
+struct HistogramSnapshot {
+  enum { buckets_count = 16 };
+  HistogramSnapshot();
+
+  uint64_t GetUpperBound(size_t bucket) const;  // UINT64_MAX for last bucket
+
+  uint64_t first_bound;  // upper bound of first bucket, next bucket bound is twice bigger
+  uint64_t buckets[buckets_count];
+  uint64_t count;
+  uint64_t sum;
+};
+
+// Fixed power of two buckets, bucket i counts values <= first_bound << i, last bucket takes the rest.
+// Record is lock free (relaxed atomics) and can be called from streaming threads while others take snapshots,
+// counters are independent, snapshot taken during Record can be off by that one value.
+class Histogram {
+ public:
+  enum { buckets_count = HistogramSnapshot::buckets_count };
+
+  explicit Histogram(uint64_t first_bound);
+  Histogram(const Histogram& other);
+  Histogram& operator=(const Histogram& other);
+
+  void Record(uint64_t value);
+
+  HistogramSnapshot GetSnapshot() const;
+  void SetSnapshot(const HistogramSnapshot& snapshot);  // bound of snapshot should be the same
+
+  uint64_t GetFirstBound() const;
+
+ private:
+  uint64_t first_bound_;
+  std::atomic<uint64_t> buckets_[buckets_count];
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+};
+
+}  // namespace iptv_cloud
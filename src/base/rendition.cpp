@@ -0,0 +1,172 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/rendition.h"
+
+#include <string>
+
+#include <json-c/json_object.h>
+#include <json-c/json_tokener.h>
+
+#include <common/convert2string.h>
+
+#define RENDITION_SIZE_FIELD "size"
+#define RENDITION_VIDEO_BITRATE_FIELD "video_bitrate"
+#define RENDITION_ENCODER_ARGS_FIELD "encoder_args"
+#define RENDITION_OUTPUTS_FIELD "outputs"
+
+namespace iptv_cloud {
+
+Rendition::Rendition() : Rendition(common::draw::Size(), bit_rate_t()) {}
+
+Rendition::Rendition(const common::draw::Size& size, bit_rate_t video_bitrate)
+    : size_(size), video_bitrate_(video_bitrate), encoder_args_(), outputs_() {}
+
+bool Rendition::IsValid() const {
+  return size_.IsValid();
+}
+
+bool Rendition::Equals(const Rendition& rend) const {
+  return size_ == rend.size_ && video_bitrate_ == rend.video_bitrate_ && encoder_args_ == rend.encoder_args_ &&
+         outputs_ == rend.outputs_;
+}
+
+common::draw::Size Rendition::GetSize() const {
+  return size_;
+}
+
+void Rendition::SetSize(const common::draw::Size& size) {
+  size_ = size;
+}
+
+bit_rate_t Rendition::GetVideoBitrate() const {
+  return video_bitrate_;
+}
+
+void Rendition::SetVideoBitrate(bit_rate_t bitrate) {
+  video_bitrate_ = bitrate;
+}
+
+Rendition::encoder_args_t Rendition::GetEncoderArgs() const {
+  return encoder_args_;
+}
+
+void Rendition::SetEncoderArgs(const encoder_args_t& args) {
+  encoder_args_ = args;
+}
+
+Rendition::outputs_t Rendition::GetOutputs() const {
+  return outputs_;
+}
+
+void Rendition::SetOutputs(const outputs_t& outputs) {
+  outputs_ = outputs;
+}
+
+}  // namespace iptv_cloud
+
+namespace common {
+
+std::string ConvertToString(const iptv_cloud::renditions_t& value) {
+  json_object* jrenditions = json_object_new_array();
+  for (const iptv_cloud::Rendition& rend : value) {
+    json_object* jrend = json_object_new_object();
+    const std::string size_str = common::ConvertToString(rend.GetSize());
+    json_object_object_add(jrend, RENDITION_SIZE_FIELD, json_object_new_string(size_str.c_str()));
+    const iptv_cloud::bit_rate_t bitrate = rend.GetVideoBitrate();
+    if (bitrate) {
+      json_object_object_add(jrend, RENDITION_VIDEO_BITRATE_FIELD, json_object_new_int(*bitrate));
+    }
+
+    json_object* jargs = json_object_new_object();
+    for (const auto& arg : rend.GetEncoderArgs()) {
+      json_object_object_add(jargs, arg.first.c_str(), json_object_new_string(arg.second.c_str()));
+    }
+    json_object_object_add(jrend, RENDITION_ENCODER_ARGS_FIELD, jargs);
+
+    json_object* joutputs = json_object_new_array();
+    for (iptv_cloud::channel_id_t oid : rend.GetOutputs()) {
+      json_object_array_add(joutputs, json_object_new_int64(oid));
+    }
+    json_object_object_add(jrend, RENDITION_OUTPUTS_FIELD, joutputs);
+    json_object_array_add(jrenditions, jrend);
+  }
+
+  const std::string res = json_object_get_string(jrenditions);
+  json_object_put(jrenditions);
+  return res;
+}
+
+bool ConvertFromString(const std::string& from, iptv_cloud::renditions_t* out) {
+  if (!out) {
+    return false;
+  }
+
+  json_object* obj = json_tokener_parse(from.c_str());
+  if (!obj) {
+    return false;
+  }
+
+  if (!json_object_is_type(obj, json_type_array)) {
+    json_object_put(obj);
+    return false;
+  }
+
+  iptv_cloud::renditions_t renditions;
+  int len = json_object_array_length(obj);
+  for (int i = 0; i < len; ++i) {
+    json_object* jrend = json_object_array_get_idx(obj, i);
+    json_object* jsize = nullptr;
+    common::draw::Size size;
+    if (!json_object_object_get_ex(jrend, RENDITION_SIZE_FIELD, &jsize) ||
+        !common::ConvertFromString(json_object_get_string(jsize), &size) || !size.IsValid()) {
+      json_object_put(obj);
+      return false;
+    }
+
+    iptv_cloud::Rendition rend(size, iptv_cloud::bit_rate_t());
+    json_object* jbitrate = nullptr;
+    if (json_object_object_get_ex(jrend, RENDITION_VIDEO_BITRATE_FIELD, &jbitrate)) {
+      rend.SetVideoBitrate(json_object_get_int(jbitrate));
+    }
+
+    json_object* jargs = nullptr;
+    if (json_object_object_get_ex(jrend, RENDITION_ENCODER_ARGS_FIELD, &jargs) &&
+        json_object_is_type(jargs, json_type_object)) {
+      iptv_cloud::Rendition::encoder_args_t args;
+      json_object_object_foreach(jargs, key, val) {
+        args.push_back(std::make_pair(key, val ? json_object_get_string(val) : std::string()));
+      }
+      rend.SetEncoderArgs(args);
+    }
+
+    json_object* joutputs = nullptr;
+    if (json_object_object_get_ex(jrend, RENDITION_OUTPUTS_FIELD, &joutputs) &&
+        json_object_is_type(joutputs, json_type_array)) {
+      iptv_cloud::Rendition::outputs_t outputs;
+      int olen = json_object_array_length(joutputs);
+      for (int j = 0; j < olen; ++j) {
+        outputs.push_back(json_object_get_int64(json_object_array_get_idx(joutputs, j)));
+      }
+      rend.SetOutputs(outputs);
+    }
+    renditions.push_back(rend);
+  }
+
+  json_object_put(obj);
+  *out = renditions;
+  return true;
+}
+
+}  // namespace common
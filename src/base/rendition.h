@@ -0,0 +1,74 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <common/draw/types.h>
+
+#include "base/types.h"
+
+namespace iptv_cloud {
+
+// one video quality of abr ladder, all renditions are encoded from the same decoded picture
+class Rendition {
+ public:
+  typedef std::vector<std::pair<std::string, std::string>> encoder_args_t;  // same layout as config args
+  typedef std::vector<channel_id_t> outputs_t;
+
+  Rendition();
+  Rendition(const common::draw::Size& size, bit_rate_t video_bitrate);
+
+  bool IsValid() const;
+
+  bool Equals(const Rendition& rend) const;
+
+  common::draw::Size GetSize() const;
+  void SetSize(const common::draw::Size& size);
+
+  bit_rate_t GetVideoBitrate() const;
+  void SetVideoBitrate(bit_rate_t bitrate);
+
+  encoder_args_t GetEncoderArgs() const;  // override stream encoder args
+  void SetEncoderArgs(const encoder_args_t& args);
+
+  outputs_t GetOutputs() const;  // output ids
+  void SetOutputs(const outputs_t& outputs);
+
+ private:
+  common::draw::Size size_;
+  bit_rate_t video_bitrate_;
+  encoder_args_t encoder_args_;
+  outputs_t outputs_;
+};
+
+inline bool operator==(const Rendition& left, const Rendition& right) {
+  return left.Equals(right);
+}
+
+inline bool operator!=(const Rendition& left, const Rendition& right) {
+  return !operator==(left, right);
+}
+
+typedef std::vector<Rendition> renditions_t;
+
+}  // namespace iptv_cloud
+
+namespace common {
+std::string ConvertToString(const iptv_cloud::renditions_t& value);  // json
+bool ConvertFromString(const std::string& from, iptv_cloud::renditions_t* out);
+}  // namespace common
@@ -0,0 +1,314 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/stream_stats_block.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <common/time.h>
+
+#include "base/channel_stats.h"
+#include "base/stream_struct.h"
+
+namespace {
+
+uint64_t DoubleToBits(double value) {
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits) {
+  double value = 0;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+
+ChannelStatsSnapshot::ChannelStatsSnapshot()
+    : id(0),
+      total_bytes(0),
+      total_packets(0),
+      bps(0),
+      last_update_time(0),
+      buffer_size(),
+      arrival(),
+      timestamp_gap(),
+      max_gap(0),
+      transition_stall(),
+      transition_jump(),
+      dropped_bytes(0),
+      dropped_packets(0),
+      degraded(false),
+      reconnects(0),
+      downtime(0),
+      lost_packets(0),
+      reordered_packets(0),
+      duplicate_packets(0),
+      clients(0),
+      evicted_clients(0) {}
+
+StreamStatsSnapshot::StreamStatsSnapshot()
+    : status(NEW),
+      restarts(0),
+      start_time(0),
+      loop_start_time(0),
+      timestamp(0),
+      init_time(0),
+      first_output(0),
+      cpu_load(0),
+      rss(0),
+      input_count(0),
+      input(),
+      output_count(0),
+      output() {}
+
+StreamStatsBlock::Channel::Channel()
+    : id(0),
+      total_bytes(0),
+      total_packets(0),
+      bps(0),
+      last_update_time(0),
+      buffer_size(ChannelStats::buffer_size_first_bound),
+      arrival(ChannelStats::interval_first_bound),
+      timestamp_gap(ChannelStats::interval_first_bound),
+      max_gap(0),
+      transition_stall(ChannelStats::interval_first_bound),
+      transition_jump(ChannelStats::interval_first_bound),
+      dropped_bytes(0),
+      dropped_packets(0),
+      degraded(false),
+      reconnects(0),
+      downtime(0),
+      lost_packets(0),
+      reordered_packets(0),
+      duplicate_packets(0),
+      clients(0),
+      evicted_clients(0) {}
+
+void StreamStatsBlock::Channel::Store(const ChannelStats* stats) {
+  id.store(stats->GetID(), std::memory_order_relaxed);
+  total_bytes.store(stats->GetTotalBytes(), std::memory_order_relaxed);
+  total_packets.store(stats->GetTotalPackets(), std::memory_order_relaxed);
+  bps.store(stats->GetBps(), std::memory_order_relaxed);
+  last_update_time.store(stats->GetLastUpdateTime(), std::memory_order_relaxed);
+  buffer_size.SetSnapshot(stats->GetBufferSizeHistogram());
+  arrival.SetSnapshot(stats->GetArrivalHistogram());
+  timestamp_gap.SetSnapshot(stats->GetTimestampGapHistogram());
+  max_gap.store(stats->GetMaxGap(), std::memory_order_relaxed);
+  transition_stall.SetSnapshot(stats->GetTransitionStallHistogram());
+  transition_jump.SetSnapshot(stats->GetTransitionJumpHistogram());
+  dropped_bytes.store(stats->GetDroppedBytes(), std::memory_order_relaxed);
+  dropped_packets.store(stats->GetDroppedPackets(), std::memory_order_relaxed);
+  degraded.store(stats->IsDegraded(), std::memory_order_relaxed);
+  reconnects.store(stats->GetReconnects(), std::memory_order_relaxed);
+  downtime.store(stats->GetDowntime(), std::memory_order_relaxed);
+  lost_packets.store(stats->GetLostPackets(), std::memory_order_relaxed);
+  reordered_packets.store(stats->GetReorderedPackets(), std::memory_order_relaxed);
+  duplicate_packets.store(stats->GetDuplicatePackets(), std::memory_order_relaxed);
+  clients.store(stats->GetClients(), std::memory_order_relaxed);
+  evicted_clients.store(stats->GetEvictedClients(), std::memory_order_relaxed);
+}
+
+void StreamStatsBlock::Channel::Load(ChannelStatsSnapshot* snapshot) const {
+  snapshot->id = id.load(std::memory_order_relaxed);
+  snapshot->total_bytes = total_bytes.load(std::memory_order_relaxed);
+  snapshot->total_packets = total_packets.load(std::memory_order_relaxed);
+  snapshot->bps = bps.load(std::memory_order_relaxed);
+  snapshot->last_update_time = last_update_time.load(std::memory_order_relaxed);
+  snapshot->buffer_size = buffer_size.GetSnapshot();
+  snapshot->arrival = arrival.GetSnapshot();
+  snapshot->timestamp_gap = timestamp_gap.GetSnapshot();
+  snapshot->max_gap = max_gap.load(std::memory_order_relaxed);
+  snapshot->transition_stall = transition_stall.GetSnapshot();
+  snapshot->transition_jump = transition_jump.GetSnapshot();
+  snapshot->dropped_bytes = dropped_bytes.load(std::memory_order_relaxed);
+  snapshot->dropped_packets = dropped_packets.load(std::memory_order_relaxed);
+  snapshot->degraded = degraded.load(std::memory_order_relaxed);
+  snapshot->reconnects = reconnects.load(std::memory_order_relaxed);
+  snapshot->downtime = downtime.load(std::memory_order_relaxed);
+  snapshot->lost_packets = lost_packets.load(std::memory_order_relaxed);
+  snapshot->reordered_packets = reordered_packets.load(std::memory_order_relaxed);
+  snapshot->duplicate_packets = duplicate_packets.load(std::memory_order_relaxed);
+  snapshot->clients = clients.load(std::memory_order_relaxed);
+  snapshot->evicted_clients = evicted_clients.load(std::memory_order_relaxed);
+}
+
+StreamStatsBlock::StreamStatsBlock()
+    : sequence_(0),
+      status_(NEW),
+      restarts_(0),
+      start_time_(0),
+      loop_start_time_(0),
+      timestamp_(0),
+      init_time_(0),
+      first_output_(0),
+      cpu_load_(DoubleToBits(0)),
+      rss_(0),
+      input_count_(0),
+      input_(),
+      output_count_(0),
+      output_() {}
+
+void StreamStatsBlock::Publish(const StreamStruct& str) {
+  const size_t input_count = std::min<size_t>(str.input.size(), max_channels);
+  const size_t output_count = std::min<size_t>(str.output.size(), max_channels);
+
+  BeginWrite();
+  status_.store(str.status, std::memory_order_relaxed);
+  restarts_.store(str.restarts, std::memory_order_relaxed);
+  start_time_.store(str.start_time, std::memory_order_relaxed);
+  loop_start_time_.store(str.loop_start_time, std::memory_order_relaxed);
+  timestamp_.store(common::time::current_mstime() / 1000, std::memory_order_relaxed);
+  input_count_.store(input_count, std::memory_order_relaxed);
+  for (size_t i = 0; i < input_count; ++i) {
+    input_[i].Store(str.input[i]);
+  }
+  output_count_.store(output_count, std::memory_order_relaxed);
+  for (size_t i = 0; i < output_count; ++i) {
+    output_[i].Store(str.output[i]);
+  }
+  EndWrite();
+}
+
+void StreamStatsBlock::PublishProcessInfo(double cpu_load, long rss) {
+  BeginWrite();
+  cpu_load_.store(DoubleToBits(cpu_load), std::memory_order_relaxed);
+  rss_.store(rss, std::memory_order_relaxed);
+  EndWrite();
+}
+
+void StreamStatsBlock::PublishInitTime(time_t init_time) {
+  BeginWrite();
+  init_time_.store(init_time, std::memory_order_relaxed);
+  EndWrite();
+}
+
+void StreamStatsBlock::PublishFirstOutput(time_t first_output) {
+  BeginWrite();
+  first_output_.store(first_output, std::memory_order_relaxed);
+  EndWrite();
+}
+
+bool StreamStatsBlock::Read(StreamStatsSnapshot* snapshot) const {
+  if (!snapshot) {
+    return false;
+  }
+
+  for (size_t attempt = 0; attempt < max_read_attempts; ++attempt) {
+    const uint32_t begin = sequence_.load(std::memory_order_acquire);
+    if (begin & 1) {
+      continue;
+    }
+
+    snapshot->status = status_.load(std::memory_order_relaxed);
+    snapshot->restarts = restarts_.load(std::memory_order_relaxed);
+    snapshot->start_time = start_time_.load(std::memory_order_relaxed);
+    snapshot->loop_start_time = loop_start_time_.load(std::memory_order_relaxed);
+    snapshot->timestamp = timestamp_.load(std::memory_order_relaxed);
+    snapshot->init_time = init_time_.load(std::memory_order_relaxed);
+    snapshot->first_output = first_output_.load(std::memory_order_relaxed);
+    snapshot->cpu_load = BitsToDouble(cpu_load_.load(std::memory_order_relaxed));
+    snapshot->rss = rss_.load(std::memory_order_relaxed);
+    snapshot->input_count = std::min<size_t>(input_count_.load(std::memory_order_relaxed), max_channels);
+    for (size_t i = 0; i < snapshot->input_count; ++i) {
+      input_[i].Load(&snapshot->input[i]);
+    }
+    snapshot->output_count = std::min<size_t>(output_count_.load(std::memory_order_relaxed), max_channels);
+    for (size_t i = 0; i < snapshot->output_count; ++i) {
+      output_[i].Load(&snapshot->output[i]);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == begin) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void StreamStatsBlock::BeginWrite() {
+  // stream process can publish from gst loop and from controller thread, so writers are serialized by odd sequence
+  uint32_t seq = sequence_.load(std::memory_order_relaxed);
+  while ((seq & 1) || !sequence_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire)) {
+    seq = sequence_.load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void StreamStatsBlock::EndWrite() {
+  sequence_.fetch_add(1, std::memory_order_release);
+}
+
+common::ErrnoError CreateSharedStatsBlock(int* fd, StreamStatsBlock** block) {
+  if (!fd || !block) {
+    return common::make_errno_error_inval();
+  }
+
+  int lfd = syscall(SYS_memfd_create, "stream_stats", 0);
+  if (lfd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  if (ftruncate(lfd, sizeof(StreamStatsBlock)) == ERROR_RESULT_VALUE) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    ::close(lfd);
+    return err;
+  }
+
+  void* mem = mmap(nullptr, sizeof(StreamStatsBlock), PROT_READ | PROT_WRITE, MAP_SHARED, lfd, 0);
+  if (mem == MAP_FAILED) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    ::close(lfd);
+    return err;
+  }
+
+  *block = new (mem) StreamStatsBlock;
+  *fd = lfd;
+  return common::ErrnoError();
+}
+
+common::ErrnoError AttachSharedStatsBlock(int fd, StreamStatsBlock** block) {
+  if (fd == INVALID_DESCRIPTOR || !block) {
+    return common::make_errno_error_inval();
+  }
+
+  void* mem = mmap(nullptr, sizeof(StreamStatsBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mem == MAP_FAILED) {
+    return common::make_errno_error(errno);
+  }
+
+  *block = static_cast<StreamStatsBlock*>(mem);  // constructed by creator
+  return common::ErrnoError();
+}
+
+void DetachSharedStatsBlock(StreamStatsBlock** block) {
+  if (!block || !*block) {
+    return;
+  }
+
+  munmap(*block, sizeof(StreamStatsBlock));  // atomics are trivially destructible
+  *block = nullptr;
+}
+
+}  // namespace iptv_cloud
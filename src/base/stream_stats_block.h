@@ -0,0 +1,154 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+
+#include <common/error.h>
+
+#include "base/histogram.h"
+#include "base/types.h"
+
+namespace iptv_cloud {
+
+class ChannelStats;
+struct StreamStruct;
+
+struct ChannelStatsSnapshot {
+  ChannelStatsSnapshot();
+
+  channel_id_t id;
+  uint64_t total_bytes;
+  uint64_t total_packets;
+  uint64_t bps;
+  time_t last_update_time;  // msec
+  HistogramSnapshot buffer_size;
+  HistogramSnapshot arrival;
+  HistogramSnapshot timestamp_gap;
+  uint64_t max_gap;  // usec
+  HistogramSnapshot transition_stall;
+  HistogramSnapshot transition_jump;
+  uint64_t dropped_bytes;
+  uint64_t dropped_packets;
+  bool degraded;
+  uint64_t reconnects;
+  time_t downtime;  // msec
+  uint64_t lost_packets;
+  uint64_t reordered_packets;
+  uint64_t duplicate_packets;
+  uint64_t clients;
+  uint64_t evicted_clients;
+};
+
+struct StreamStatsSnapshot {
+  enum { max_channels = 16 };
+  StreamStatsSnapshot();
+
+  int status;  // StreamStatus
+  size_t restarts;
+  time_t start_time;       // sec
+  time_t loop_start_time;  // sec
+  time_t timestamp;        // sec, last publish
+  time_t init_time;        // msec, stream backend initialized in process
+  time_t first_output;     // msec, from pipeline start to first output buffer of last run
+  double cpu_load;
+  long rss;
+
+  size_t input_count;
+  ChannelStatsSnapshot input[max_channels];
+  size_t output_count;
+  ChannelStatsSnapshot output[max_channels];
+};
+
+// Flat statistic of stream placed in shared memory, written by stream process and read by daemon at any rate.
+// Seqlock: writer makes sequence odd while it updates fields, reader retries if sequence was odd or changed.
+// Fields are relaxed atomics, so both sides are free of data races without taking locks.
+class StreamStatsBlock {
+ public:
+  enum { max_channels = StreamStatsSnapshot::max_channels, max_read_attempts = 64 };
+
+  StreamStatsBlock();
+
+  // stream process side, channels over max_channels are not published
+  void Publish(const StreamStruct& str);
+  void PublishProcessInfo(double cpu_load, long rss);
+  void PublishInitTime(time_t init_time);
+  void PublishFirstOutput(time_t first_output);
+
+  // daemon side, false if writer was in progress all attempts (or died in the middle of write)
+  bool Read(StreamStatsSnapshot* snapshot) const WARN_UNUSED_RESULT;
+
+ private:
+  struct Channel {
+    Channel();
+
+    void Store(const ChannelStats* stats);
+    void Load(ChannelStatsSnapshot* snapshot) const;
+
+    std::atomic<uint64_t> id;
+    std::atomic<uint64_t> total_bytes;
+    std::atomic<uint64_t> total_packets;
+    std::atomic<uint64_t> bps;
+    std::atomic<int64_t> last_update_time;
+    Histogram buffer_size;
+    Histogram arrival;
+    Histogram timestamp_gap;
+    std::atomic<uint64_t> max_gap;
+    Histogram transition_stall;
+    Histogram transition_jump;
+    std::atomic<uint64_t> dropped_bytes;
+    std::atomic<uint64_t> dropped_packets;
+    std::atomic<bool> degraded;
+    std::atomic<uint64_t> reconnects;
+    std::atomic<int64_t> downtime;
+    std::atomic<uint64_t> lost_packets;
+    std::atomic<uint64_t> reordered_packets;
+    std::atomic<uint64_t> duplicate_packets;
+    std::atomic<uint64_t> clients;
+    std::atomic<uint64_t> evicted_clients;
+  };
+
+  void BeginWrite();
+  void EndWrite();
+
+  std::atomic<uint32_t> sequence_;
+
+  std::atomic<int> status_;
+  std::atomic<uint64_t> restarts_;
+  std::atomic<int64_t> start_time_;
+  std::atomic<int64_t> loop_start_time_;
+  std::atomic<int64_t> timestamp_;
+  std::atomic<int64_t> init_time_;
+  std::atomic<int64_t> first_output_;
+  std::atomic<uint64_t> cpu_load_;  // bits of double
+  std::atomic<int64_t> rss_;
+
+  std::atomic<uint32_t> input_count_;
+  Channel input_[max_channels];
+  std::atomic<uint32_t> output_count_;
+  Channel output_[max_channels];
+
+  DISALLOW_COPY_AND_ASSIGN(StreamStatsBlock);
+};
+
+// block in anonymous shared memory, fd can be passed to other process and attached there, caller closes fd
+common::ErrnoError CreateSharedStatsBlock(int* fd, StreamStatsBlock** block) WARN_UNUSED_RESULT;
+common::ErrnoError AttachSharedStatsBlock(int fd, StreamStatsBlock** block) WARN_UNUSED_RESULT;
+void DetachSharedStatsBlock(StreamStatsBlock** block);
+
+}  // namespace iptv_cloud
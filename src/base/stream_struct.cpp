@@ -78,7 +78,8 @@ StreamStruct::StreamStruct(stream_id_t sid,
       restarts(rest),
       status(status),
       input(input),
-      output(output) {}
+      output(output),
+      shared_stats(nullptr) {}
 
 bool StreamStruct::IsValid() const {
   return !id.empty();
@@ -112,4 +113,10 @@ void StreamStruct::ResetDataWait() {
   }
 }
 
+void StreamStruct::PublishStats() {
+  if (shared_stats) {
+    shared_stats->Publish(*this);
+  }
+}
+
 }  // namespace iptv_cloud
@@ -19,6 +19,7 @@
 
 #include <common/macros.h>
 
+#include "base/stream_stats_block.h"
 #include "base/types.h"
 
 namespace iptv_cloud {
@@ -67,6 +68,7 @@ struct StreamStruct {
   time_t WithoutRestartTime() const;
 
   void ResetDataWait();
+  void PublishStats();
 
   const stream_id_t id;
   const StreamType type;
@@ -80,6 +82,8 @@ struct StreamStruct {
   const input_channels_info_t input;    // ptrs
   const output_channels_info_t output;  // ptrs
 
+  StreamStatsBlock* shared_stats;  // published copy of fields above in shared memory, can be null
+
  private:
   DISALLOW_COPY_AND_ASSIGN(StreamStruct);
 };
@@ -31,6 +31,7 @@ namespace detail {
 common::ErrnoError WriteRequest(common::libev::IoClient* client, const request_t& request) WARN_UNUSED_RESULT;
 common::ErrnoError WriteResponce(common::libev::IoClient* client, const response_t& responce) WARN_UNUSED_RESULT;
 common::ErrnoError ReadCommand(common::libev::IoClient* client, std::string* out) WARN_UNUSED_RESULT;
+common::ErrnoError WriteMessage(common::libev::IoClient* client, const std::string& message) WARN_UNUSED_RESULT;
 }  // namespace detail
 
 template <typename Client>
@@ -55,6 +56,11 @@ class ProtocolClient : public Client {
 
   common::ErrnoError ReadCommand(std::string* out) WARN_UNUSED_RESULT { return detail::ReadCommand(this, out); }
 
+  // already serialized json-rpc notification, can be shared by many clients
+  common::ErrnoError WriteMessage(const std::string& message) WARN_UNUSED_RESULT {
+    return detail::WriteMessage(this, message);
+  }
+
   bool PopRequestByID(sequance_id_t sid, request_t* req) {
     if (!req || !sid) {
       return false;
@@ -0,0 +1,229 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "protocol/request_parser.h"
+
+#include <string.h>
+
+#include <json-c/json_object.h>
+#include <json-c/json_tokener.h>
+
+#define JSONRPC_METHOD_FIELD "method"
+#define JSONRPC_ID_FIELD "id"
+#define JSONRPC_PARAMS_FIELD "params"
+
+namespace {
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+const char* SkipSpaces(const char* ptr, const char* end) {
+  while (ptr < end && IsSpace(*ptr)) {
+    ptr++;
+  }
+  return ptr;
+}
+
+// ptr points to opening quote, returns position after closing quote
+const char* SkipString(const char* ptr, const char* end) {
+  for (ptr++; ptr < end; ++ptr) {
+    if (*ptr == '\\') {
+      ptr++;
+    } else if (*ptr == '"') {
+      return ptr + 1;
+    }
+  }
+  return nullptr;
+}
+
+const char* SkipValue(const char* ptr, const char* end) {
+  if (ptr >= end) {
+    return nullptr;
+  }
+
+  if (*ptr == '"') {
+    return SkipString(ptr, end);
+  }
+
+  if (*ptr == '{' || *ptr == '[') {
+    size_t depth = 0;
+    while (ptr < end) {
+      if (*ptr == '"') {
+        ptr = SkipString(ptr, end);
+        if (!ptr) {
+          return nullptr;
+        }
+        continue;
+      }
+
+      if (*ptr == '{' || *ptr == '[') {
+        depth++;
+      } else if (*ptr == '}' || *ptr == ']') {
+        if (--depth == 0) {
+          return ptr + 1;
+        }
+      }
+      ptr++;
+    }
+    return nullptr;
+  }
+
+  // number, true, false, null
+  const char* start = ptr;
+  while (ptr < end && !IsSpace(*ptr) && *ptr != ',' && *ptr != '}' && *ptr != ']') {
+    ptr++;
+  }
+  return ptr == start ? nullptr : ptr;
+}
+
+bool KeyEquals(const char* key, size_t key_len, const char* field) {
+  return key_len == strlen(field) && memcmp(key, field, key_len) == 0;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace protocol {
+
+MessageHeader::MessageHeader() : method(), has_id(false), params() {}
+
+bool MessageHeader::IsRequest() const {
+  return !method.empty();
+}
+
+bool MessageHeader::IsNotification() const {
+  return IsRequest() && !has_id;
+}
+
+bool PeekMessageHeader(const std::string& data, MessageHeader* header) {
+  if (!header) {
+    return false;
+  }
+
+  const char* ptr = data.data();
+  const char* end = ptr + data.size();
+  ptr = SkipSpaces(ptr, end);
+  if (ptr == end || *ptr != '{') {
+    return false;
+  }
+
+  MessageHeader lheader;
+  ptr = SkipSpaces(ptr + 1, end);
+  if (ptr < end && *ptr == '}') {
+    *header = lheader;
+    return true;
+  }
+
+  while (ptr < end) {
+    if (*ptr != '"') {
+      return false;
+    }
+
+    const char* key_end = SkipString(ptr, end);
+    if (!key_end) {
+      return false;
+    }
+    const char* key = ptr + 1;
+    const size_t key_len = key_end - key - 1;
+
+    ptr = SkipSpaces(key_end, end);
+    if (ptr == end || *ptr != ':') {
+      return false;
+    }
+
+    const char* value = SkipSpaces(ptr + 1, end);
+    ptr = SkipValue(value, end);
+    if (!ptr) {
+      return false;
+    }
+
+    if (KeyEquals(key, key_len, JSONRPC_METHOD_FIELD)) {
+      if (*value != '"' || memchr(value, '\\', ptr - value)) {  // escaped methods are not used
+        return false;
+      }
+      lheader.method.assign(value + 1, ptr - value - 2);
+    } else if (KeyEquals(key, key_len, JSONRPC_ID_FIELD)) {
+      lheader.has_id = !(ptr - value == 4 && memcmp(value, "null", 4) == 0);
+    } else if (KeyEquals(key, key_len, JSONRPC_PARAMS_FIELD)) {
+      if (!(ptr - value == 4 && memcmp(value, "null", 4) == 0)) {
+        lheader.params.assign(value, ptr - value);
+      }
+    }
+
+    ptr = SkipSpaces(ptr, end);
+    if (ptr == end) {
+      return false;
+    }
+
+    if (*ptr == '}') {
+      *header = lheader;
+      return true;
+    }
+
+    if (*ptr != ',') {
+      return false;
+    }
+    ptr = SkipSpaces(ptr + 1, end);
+  }
+
+  return false;
+}
+
+common::Error ParseRequest(const std::string& data, request_t* req, json_object** params) {
+  if (!req || !params) {
+    return common::make_error_inval();
+  }
+
+  json_object* jrequest = json_tokener_parse(data.c_str());
+  if (!jrequest) {
+    return common::make_error_inval();
+  }
+
+  if (!json_object_is_type(jrequest, json_type_object)) {
+    json_object_put(jrequest);
+    return common::make_error_inval();
+  }
+
+  json_object* jmethod = nullptr;
+  json_bool jmethod_exists = json_object_object_get_ex(jrequest, JSONRPC_METHOD_FIELD, &jmethod);
+  if (!jmethod_exists || !json_object_is_type(jmethod, json_type_string)) {
+    json_object_put(jrequest);
+    return common::make_error_inval();
+  }
+
+  request_t lreq;
+  lreq.method = json_object_get_string(jmethod);
+
+  json_object* jid = nullptr;
+  json_bool jid_exists = json_object_object_get_ex(jrequest, JSONRPC_ID_FIELD, &jid);
+  if (jid_exists && !json_object_is_type(jid, json_type_null)) {
+    lreq.id = std::string(json_object_get_string(jid));
+  }
+
+  json_object* jparams = nullptr;
+  json_bool jparams_exists = json_object_object_get_ex(jrequest, JSONRPC_PARAMS_FIELD, &jparams);
+  if (jparams_exists && !json_object_is_type(jparams, json_type_null)) {
+    *params = json_object_get(jparams);  // survives release of request
+  } else {
+    *params = nullptr;
+  }
+
+  json_object_put(jrequest);
+  *req = lreq;
+  return common::Error();
+}
+
+}  // namespace protocol
+}  // namespace iptv_cloud
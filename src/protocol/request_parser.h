@@ -0,0 +1,46 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "protocol/types.h"
+
+struct json_object;
+
+namespace iptv_cloud {
+namespace protocol {
+
+// top level fields of json-rpc message
+struct MessageHeader {
+  MessageHeader();
+
+  bool IsRequest() const;
+  bool IsNotification() const;
+
+  std::string method;  // empty for responces
+  bool has_id;
+  std::string params;  // raw json text, empty if absent or null
+};
+
+// scans only top level of message, values are skipped without building json tree
+bool PeekMessageHeader(const std::string& data, MessageHeader* header) WARN_UNUSED_RESULT;
+
+// parses json-rpc request once, params are returned as json object (nullptr if absent) instead of string,
+// caller should release them by json_object_put
+common::Error ParseRequest(const std::string& data, request_t* req, json_object** params) WARN_UNUSED_RESULT;
+
+}  // namespace protocol
+}  // namespace iptv_cloud
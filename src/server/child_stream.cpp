@@ -20,8 +20,13 @@
 namespace iptv_cloud {
 namespace server {
 
-ChildStream::ChildStream(common::libev::IoLoop* server, StreamStruct* mem)
-    : base_class(server), mem_(mem), client_(nullptr) {}
+ChildStream::ChildStream(common::libev::IoLoop* server, StreamStruct* mem, time_t spawn_time, bool by_zygote)
+    : base_class(server),
+      mem_(mem),
+      client_(nullptr),
+      spawn_time_(spawn_time),
+      by_zygote_(by_zygote),
+      startup_reported_(false) {}
 
 stream_id_t ChildStream::GetStreamID() const {
   return mem_->id;
@@ -43,6 +48,22 @@ void ChildStream::SetClient(client_t* pipe) {
   client_ = pipe;
 }
 
+time_t ChildStream::GetSpawnTime() const {
+  return spawn_time_;
+}
+
+bool ChildStream::IsSpawnedByZygote() const {
+  return by_zygote_;
+}
+
+bool ChildStream::IsStartupReported() const {
+  return startup_reported_;
+}
+
+void ChildStream::SetStartupReported() {
+  startup_reported_ = true;
+}
+
 common::ErrnoError ChildStream::SendStop(protocol::sequance_id_t id) {
   if (!client_) {
     return common::make_errno_error_inval();
@@ -28,7 +28,7 @@ class ChildStream : public common::libev::IoChild {
  public:
   typedef common::libev::IoChild base_class;
   typedef protocol::protocol_client_t client_t;
-  ChildStream(common::libev::IoLoop* server, StreamStruct* mem);
+  ChildStream(common::libev::IoLoop* server, StreamStruct* mem, time_t spawn_time, bool by_zygote);
 
   common::ErrnoError SendStop(protocol::sequance_id_t id) WARN_UNUSED_RESULT;
   common::ErrnoError SendRestart(protocol::sequance_id_t id) WARN_UNUSED_RESULT;
@@ -42,9 +42,18 @@ class ChildStream : public common::libev::IoChild {
   client_t* GetClient() const;
   void SetClient(client_t* pipe);
 
+  time_t GetSpawnTime() const;  // msec
+  bool IsSpawnedByZygote() const;
+
+  bool IsStartupReported() const;
+  void SetStartupReported();
+
  private:
   StreamStruct* const mem_;
   client_t* client_;
+  const time_t spawn_time_;
+  const bool by_zygote_;
+  bool startup_reported_;
 
   DISALLOW_COPY_AND_ASSIGN(ChildStream);
 };
@@ -0,0 +1,109 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/child_streams_registry.h"
+
+namespace iptv_cloud {
+namespace server {
+
+ChildStreamsRegistry::ChildStreamsRegistry() : streams_(), clients_() {}
+
+bool ChildStreamsRegistry::Add(ChildStream* stream) {
+  if (!stream) {
+    return false;
+  }
+
+  Entry entry = {stream, nullptr};
+  return streams_.insert(std::make_pair(stream->GetStreamID(), entry)).second;
+}
+
+ChildStream* ChildStreamsRegistry::Remove(const stream_id_t& sid) {
+  auto it = streams_.find(sid);
+  if (it == streams_.end()) {
+    return nullptr;
+  }
+
+  ChildStream* stream = it->second.stream;
+  if (it->second.client) {
+    clients_.erase(it->second.client);
+  }
+  streams_.erase(it);
+  return stream;
+}
+
+bool ChildStreamsRegistry::BindClient(client_t* client, ChildStream* stream) {
+  if (!client || !stream) {
+    return false;
+  }
+
+  auto it = streams_.find(stream->GetStreamID());
+  if (it == streams_.end() || it->second.stream != stream) {
+    return false;
+  }
+
+  Entry* entry = &it->second;
+  if (entry->client) {
+    clients_.erase(entry->client);
+  }
+
+  entry->client = client;
+  clients_[client] = entry;
+  return true;
+}
+
+ChildStream* ChildStreamsRegistry::UnBindClient(const common::libev::IoClient* client) {
+  auto it = clients_.find(client);
+  if (it == clients_.end()) {
+    return nullptr;
+  }
+
+  Entry* entry = it->second;
+  entry->client = nullptr;
+  clients_.erase(it);
+  return entry->stream;
+}
+
+ChildStream* ChildStreamsRegistry::FindByID(const stream_id_t& sid) const {
+  auto it = streams_.find(sid);
+  if (it == streams_.end()) {
+    return nullptr;
+  }
+
+  return it->second.stream;
+}
+
+ChildStream* ChildStreamsRegistry::FindByClient(const common::libev::IoClient* client) const {
+  auto it = clients_.find(client);
+  if (it == clients_.end()) {
+    return nullptr;
+  }
+
+  return it->second->stream;
+}
+
+size_t ChildStreamsRegistry::Size() const {
+  return streams_.size();
+}
+
+std::vector<ChildStream*> ChildStreamsRegistry::GetStreams() const {
+  std::vector<ChildStream*> streams;
+  streams.reserve(streams_.size());
+  for (const auto& it : streams_) {
+    streams.push_back(it.second.stream);
+  }
+  return streams;
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,61 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <common/macros.h>
+
+#include "server/child_stream.h"
+
+namespace iptv_cloud {
+namespace server {
+
+// running streams of daemon indexed by stream id and by pipe client, owns nothing, loop thread only
+class ChildStreamsRegistry {
+ public:
+  typedef ChildStream::client_t client_t;
+
+  ChildStreamsRegistry();
+
+  bool Add(ChildStream* stream) WARN_UNUSED_RESULT;  // false if stream id already registered
+  ChildStream* Remove(const stream_id_t& sid);       // drops pipe client binding too
+
+  bool BindClient(client_t* client, ChildStream* stream) WARN_UNUSED_RESULT;  // stream should be added
+  ChildStream* UnBindClient(const common::libev::IoClient* client);
+
+  ChildStream* FindByID(const stream_id_t& sid) const;
+  ChildStream* FindByClient(const common::libev::IoClient* client) const;
+
+  size_t Size() const;
+  std::vector<ChildStream*> GetStreams() const;
+
+ private:
+  struct Entry {
+    ChildStream* stream;
+    const common::libev::IoClient* client;
+  };
+  typedef std::unordered_map<stream_id_t, Entry> streams_t;
+  typedef std::unordered_map<const common::libev::IoClient*, Entry*> clients_t;  // pointers to elements survive rehash
+
+  streams_t streams_;
+  clients_t clients_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChildStreamsRegistry);
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
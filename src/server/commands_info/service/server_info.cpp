@@ -30,6 +30,19 @@
 #define STATISTIC_SERVICE_INFO_BANDWIDTH_IN_FIELD "bandwidth_in"
 #define STATISTIC_SERVICE_INFO_BANDWIDTH_OUT_FIELD "bandwidth_out"
 
+#define STATISTIC_SERVICE_INFO_HTTP_CACHE_HITS_FIELD "http_cache_hits"
+#define STATISTIC_SERVICE_INFO_HTTP_CACHE_MISSES_FIELD "http_cache_misses"
+#define STATISTIC_SERVICE_INFO_HTTP_CACHE_EVICTIONS_FIELD "http_cache_evictions"
+#define STATISTIC_SERVICE_INFO_HTTP_CACHE_INVALIDATIONS_FIELD "http_cache_invalidations"
+#define STATISTIC_SERVICE_INFO_HTTP_CACHE_SIZE_FIELD "http_cache_size"
+#define STATISTIC_SERVICE_INFO_HTTP_CACHE_ENTRIES_FIELD "http_cache_entries"
+
+#define STATISTIC_SERVICE_INFO_HTTP_WORKERS_FIELD "http_workers"
+#define HTTP_WORKER_CONNECTIONS_FIELD "connections"
+#define HTTP_WORKER_ACTIVE_CONNECTIONS_FIELD "active_connections"
+#define HTTP_WORKER_REQUESTS_FIELD "requests"
+#define HTTP_WORKER_BYTES_SENT_FIELD "bytes_sent"
+
 #define FULL_SERVICE_INFO_ID_FIELD "id"
 #define FULL_SERVICE_INFO_HTTP_VERSION_FIELD "version"
 #define FULL_SERVICE_INFO_HTTP_HOST_FIELD "http_host"
@@ -48,7 +61,9 @@ ServerInfo::ServerInfo()
       net_bytes_recv_(),
       net_bytes_send_(),
       current_ts_(),
-      sys_shot_() {}
+      sys_shot_(),
+      http_cache_(),
+      http_workers_() {}
 
 ServerInfo::ServerInfo(int cpu_load,
                        int gpu_load,
@@ -58,7 +73,9 @@ ServerInfo::ServerInfo(int cpu_load,
                        uint64_t net_bytes_recv,
                        uint64_t net_bytes_send,
                        const utils::SysinfoShot& sys,
-                       time_t timestamp)
+                       time_t timestamp,
+                       const HttpCacheStats& http_cache,
+                       const std::vector<HttpWorkerStats>& http_workers)
     : base_class(),
       cpu_load_(cpu_load),
       gpu_load_(gpu_load),
@@ -68,7 +85,9 @@ ServerInfo::ServerInfo(int cpu_load,
       net_bytes_recv_(net_bytes_recv),
       net_bytes_send_(net_bytes_send),
       current_ts_(timestamp),
-      sys_shot_(sys) {}
+      sys_shot_(sys),
+      http_cache_(http_cache),
+      http_workers_(http_workers) {}
 
 common::Error ServerInfo::SerializeFields(json_object* out) const {
   json_object_object_add(out, STATISTIC_SERVICE_INFO_CPU_FIELD, json_object_new_int(cpu_load_));
@@ -84,6 +103,28 @@ common::Error ServerInfo::SerializeFields(json_object* out) const {
   json_object_object_add(out, STATISTIC_SERVICE_INFO_BANDWIDTH_OUT_FIELD, json_object_new_int64(net_bytes_send_));
   json_object_object_add(out, STATISTIC_SERVICE_INFO_UPTIME_FIELD, json_object_new_int64(sys_shot_.uptime));
   json_object_object_add(out, STATISTIC_SERVICE_INFO_TIMESTAMP_FIELD, json_object_new_int64(current_ts_));
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_HTTP_CACHE_HITS_FIELD, json_object_new_int64(http_cache_.hits));
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_HTTP_CACHE_MISSES_FIELD,
+                         json_object_new_int64(http_cache_.misses));
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_HTTP_CACHE_EVICTIONS_FIELD,
+                         json_object_new_int64(http_cache_.evictions));
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_HTTP_CACHE_INVALIDATIONS_FIELD,
+                         json_object_new_int64(http_cache_.invalidations));
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_HTTP_CACHE_SIZE_FIELD, json_object_new_int64(http_cache_.size));
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_HTTP_CACHE_ENTRIES_FIELD,
+                         json_object_new_int64(http_cache_.entries));
+
+  json_object* jworkers = json_object_new_array();
+  for (const HttpWorkerStats& worker : http_workers_) {
+    json_object* jworker = json_object_new_object();
+    json_object_object_add(jworker, HTTP_WORKER_CONNECTIONS_FIELD, json_object_new_int64(worker.connections));
+    json_object_object_add(jworker, HTTP_WORKER_ACTIVE_CONNECTIONS_FIELD,
+                           json_object_new_int64(worker.active_connections));
+    json_object_object_add(jworker, HTTP_WORKER_REQUESTS_FIELD, json_object_new_int64(worker.requests));
+    json_object_object_add(jworker, HTTP_WORKER_BYTES_SENT_FIELD, json_object_new_int64(worker.bytes_sent));
+    json_object_array_add(jworkers, jworker);
+  }
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_HTTP_WORKERS_FIELD, jworkers);
   return common::Error();
 }
 
@@ -168,6 +209,73 @@ common::Error ServerInfo::DoDeSerialize(json_object* serialized) {
     inf.current_ts_ = json_object_get_int64(jcur_ts);
   }
 
+  json_object* jcache_hits = nullptr;
+  json_bool jcache_hits_exists =
+      json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_HTTP_CACHE_HITS_FIELD, &jcache_hits);
+  if (jcache_hits_exists) {
+    inf.http_cache_.hits = json_object_get_int64(jcache_hits);
+  }
+
+  json_object* jcache_misses = nullptr;
+  json_bool jcache_misses_exists =
+      json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_HTTP_CACHE_MISSES_FIELD, &jcache_misses);
+  if (jcache_misses_exists) {
+    inf.http_cache_.misses = json_object_get_int64(jcache_misses);
+  }
+
+  json_object* jcache_evictions = nullptr;
+  json_bool jcache_evictions_exists =
+      json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_HTTP_CACHE_EVICTIONS_FIELD, &jcache_evictions);
+  if (jcache_evictions_exists) {
+    inf.http_cache_.evictions = json_object_get_int64(jcache_evictions);
+  }
+
+  json_object* jcache_invalidations = nullptr;
+  json_bool jcache_invalidations_exists = json_object_object_get_ex(
+      serialized, STATISTIC_SERVICE_INFO_HTTP_CACHE_INVALIDATIONS_FIELD, &jcache_invalidations);
+  if (jcache_invalidations_exists) {
+    inf.http_cache_.invalidations = json_object_get_int64(jcache_invalidations);
+  }
+
+  json_object* jcache_size = nullptr;
+  json_bool jcache_size_exists =
+      json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_HTTP_CACHE_SIZE_FIELD, &jcache_size);
+  if (jcache_size_exists) {
+    inf.http_cache_.size = json_object_get_int64(jcache_size);
+  }
+
+  json_object* jcache_entries = nullptr;
+  json_bool jcache_entries_exists =
+      json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_HTTP_CACHE_ENTRIES_FIELD, &jcache_entries);
+  if (jcache_entries_exists) {
+    inf.http_cache_.entries = json_object_get_int64(jcache_entries);
+  }
+
+  json_object* jworkers = nullptr;
+  json_bool jworkers_exists =
+      json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_HTTP_WORKERS_FIELD, &jworkers);
+  if (jworkers_exists) {
+    int len = json_object_array_length(jworkers);
+    for (int i = 0; i < len; ++i) {
+      json_object* jworker = json_object_array_get_idx(jworkers, i);
+      HttpWorkerStats worker;
+      json_object* jfield = nullptr;
+      if (json_object_object_get_ex(jworker, HTTP_WORKER_CONNECTIONS_FIELD, &jfield)) {
+        worker.connections = json_object_get_int64(jfield);
+      }
+      if (json_object_object_get_ex(jworker, HTTP_WORKER_ACTIVE_CONNECTIONS_FIELD, &jfield)) {
+        worker.active_connections = json_object_get_int64(jfield);
+      }
+      if (json_object_object_get_ex(jworker, HTTP_WORKER_REQUESTS_FIELD, &jfield)) {
+        worker.requests = json_object_get_int64(jfield);
+      }
+      if (json_object_object_get_ex(jworker, HTTP_WORKER_BYTES_SENT_FIELD, &jfield)) {
+        worker.bytes_sent = json_object_get_int64(jfield);
+      }
+      inf.http_workers_.push_back(worker);
+    }
+  }
+
   *this = inf;
   return common::Error();
 }
@@ -204,6 +312,14 @@ time_t ServerInfo::GetTimestamp() const {
   return current_ts_;
 }
 
+HttpCacheStats ServerInfo::GetHttpCacheStats() const {
+  return http_cache_;
+}
+
+std::vector<HttpWorkerStats> ServerInfo::GetHttpWorkersStats() const {
+  return http_workers_;
+}
+
 FullServiceInfo::FullServiceInfo() : base_class(), node_id_(), http_host_(), proj_ver_(PROJECT_VERSION_HUMAN) {}
 
 FullServiceInfo::FullServiceInfo(const std::string& node_id,
@@ -15,10 +15,14 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/net/types.h>
 #include <common/serializer/json_serializer.h>
 
+#include "server/http/http_cache.h"
+#include "server/http/http_handler.h"
+
 #include "utils/utils.h"
 
 namespace iptv_cloud {
@@ -37,7 +41,9 @@ class ServerInfo : public common::serializer::JsonSerializer<ServerInfo> {
                       uint64_t net_bytes_recv,
                       uint64_t net_bytes_send,
                       const utils::SysinfoShot& sys,
-                      time_t timestamp);
+                      time_t timestamp,
+                      const HttpCacheStats& http_cache,
+                      const std::vector<HttpWorkerStats>& http_workers);
 
   int GetCpuLoad() const;
   int GetGpuLoad() const;
@@ -47,6 +53,8 @@ class ServerInfo : public common::serializer::JsonSerializer<ServerInfo> {
   uint64_t GetNetBytesRecv() const;
   uint64_t GetNetBytesSend() const;
   time_t GetTimestamp() const;
+  HttpCacheStats GetHttpCacheStats() const;
+  std::vector<HttpWorkerStats> GetHttpWorkersStats() const;
 
  protected:
   common::Error DoDeSerialize(json_object* serialized) override;
@@ -62,6 +70,8 @@ class ServerInfo : public common::serializer::JsonSerializer<ServerInfo> {
   uint64_t net_bytes_send_;
   time_t current_ts_;
   utils::SysinfoShot sys_shot_;
+  HttpCacheStats http_cache_;
+  std::vector<HttpWorkerStats> http_workers_;
 };
 
 class FullServiceInfo : public ServerInfo {
@@ -0,0 +1,136 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/commands_info/service/subscribe_info.h"
+
+#define SUBSCRIBE_INFO_STREAMS_FIELD "streams"
+#define SUBSCRIBE_INFO_STREAM_STATISTIC_FIELD "stream_statistic"
+#define SUBSCRIBE_INFO_STREAM_STATISTIC_INTERVAL_FIELD "stream_statistic_interval"
+#define SUBSCRIBE_INFO_SERVICE_STATISTIC_FIELD "service_statistic"
+#define SUBSCRIBE_INFO_SERVICE_STATISTIC_INTERVAL_FIELD "service_statistic_interval"
+
+namespace iptv_cloud {
+namespace server {
+namespace service {
+
+SubscribeInfo::SubscribeInfo()
+    : base_class(),
+      streams_(),
+      stream_statistic_(true),
+      stream_statistic_interval_(0),
+      service_statistic_(true),
+      service_statistic_interval_(0) {}
+
+SubscribeInfo::SubscribeInfo(const streams_t& streams,
+                             bool stream_statistic,
+                             common::time64_t stream_statistic_interval,
+                             bool service_statistic,
+                             common::time64_t service_statistic_interval)
+    : base_class(),
+      streams_(streams),
+      stream_statistic_(stream_statistic),
+      stream_statistic_interval_(stream_statistic_interval),
+      service_statistic_(service_statistic),
+      service_statistic_interval_(service_statistic_interval) {}
+
+SubscribeInfo::streams_t SubscribeInfo::GetStreams() const {
+  return streams_;
+}
+
+bool SubscribeInfo::IsStreamStatistic() const {
+  return stream_statistic_;
+}
+
+common::time64_t SubscribeInfo::GetStreamStatisticInterval() const {
+  return stream_statistic_interval_;
+}
+
+bool SubscribeInfo::IsServiceStatistic() const {
+  return service_statistic_;
+}
+
+common::time64_t SubscribeInfo::GetServiceStatisticInterval() const {
+  return service_statistic_interval_;
+}
+
+common::Error SubscribeInfo::DoDeSerialize(json_object* serialized) {
+  SubscribeInfo inf;
+  json_object* jstreams = nullptr;
+  json_bool jstreams_exists = json_object_object_get_ex(serialized, SUBSCRIBE_INFO_STREAMS_FIELD, &jstreams);
+  if (jstreams_exists) {
+    if (!json_object_is_type(jstreams, json_type_array)) {
+      return common::make_error_inval();
+    }
+
+    int len = json_object_array_length(jstreams);
+    for (int i = 0; i < len; ++i) {
+      json_object* jsid = json_object_array_get_idx(jstreams, i);
+      inf.streams_.push_back(json_object_get_string(jsid));
+    }
+  }
+
+  json_object* jstream_statistic = nullptr;
+  json_bool jstream_statistic_exists =
+      json_object_object_get_ex(serialized, SUBSCRIBE_INFO_STREAM_STATISTIC_FIELD, &jstream_statistic);
+  if (jstream_statistic_exists) {
+    inf.stream_statistic_ = json_object_get_boolean(jstream_statistic);
+  }
+
+  json_object* jstream_interval = nullptr;
+  json_bool jstream_interval_exists =
+      json_object_object_get_ex(serialized, SUBSCRIBE_INFO_STREAM_STATISTIC_INTERVAL_FIELD, &jstream_interval);
+  if (jstream_interval_exists) {
+    inf.stream_statistic_interval_ = json_object_get_int64(jstream_interval);
+  }
+
+  json_object* jservice_statistic = nullptr;
+  json_bool jservice_statistic_exists =
+      json_object_object_get_ex(serialized, SUBSCRIBE_INFO_SERVICE_STATISTIC_FIELD, &jservice_statistic);
+  if (jservice_statistic_exists) {
+    inf.service_statistic_ = json_object_get_boolean(jservice_statistic);
+  }
+
+  json_object* jservice_interval = nullptr;
+  json_bool jservice_interval_exists =
+      json_object_object_get_ex(serialized, SUBSCRIBE_INFO_SERVICE_STATISTIC_INTERVAL_FIELD, &jservice_interval);
+  if (jservice_interval_exists) {
+    inf.service_statistic_interval_ = json_object_get_int64(jservice_interval);
+  }
+
+  if (inf.stream_statistic_interval_ < 0 || inf.service_statistic_interval_ < 0) {
+    return common::make_error_inval();
+  }
+
+  *this = inf;
+  return common::Error();
+}
+
+common::Error SubscribeInfo::SerializeFields(json_object* out) const {
+  json_object* jstreams = json_object_new_array();
+  for (const stream_id_t& sid : streams_) {
+    json_object_array_add(jstreams, json_object_new_string(sid.c_str()));
+  }
+  json_object_object_add(out, SUBSCRIBE_INFO_STREAMS_FIELD, jstreams);
+  json_object_object_add(out, SUBSCRIBE_INFO_STREAM_STATISTIC_FIELD, json_object_new_boolean(stream_statistic_));
+  json_object_object_add(out, SUBSCRIBE_INFO_STREAM_STATISTIC_INTERVAL_FIELD,
+                         json_object_new_int64(stream_statistic_interval_));
+  json_object_object_add(out, SUBSCRIBE_INFO_SERVICE_STATISTIC_FIELD, json_object_new_boolean(service_statistic_));
+  json_object_object_add(out, SUBSCRIBE_INFO_SERVICE_STATISTIC_INTERVAL_FIELD,
+                         json_object_new_int64(service_statistic_interval_));
+  return common::Error();
+}
+
+}  // namespace service
+}  // namespace server
+}  // namespace iptv_cloud
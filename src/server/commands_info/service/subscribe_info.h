@@ -0,0 +1,62 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <common/serializer/json_serializer.h>
+#include <common/time.h>
+
+#include "base/types.h"
+
+namespace iptv_cloud {
+namespace server {
+namespace service {
+
+// statistic broadcasts wanted by client, absent fields mean everything as often as produced
+class SubscribeInfo : public common::serializer::JsonSerializer<SubscribeInfo> {
+ public:
+  typedef JsonSerializer<SubscribeInfo> base_class;
+  typedef std::vector<stream_id_t> streams_t;
+
+  SubscribeInfo();
+  SubscribeInfo(const streams_t& streams,
+                bool stream_statistic,
+                common::time64_t stream_statistic_interval,
+                bool service_statistic,
+                common::time64_t service_statistic_interval);
+
+  streams_t GetStreams() const;  // empty - all streams
+  bool IsStreamStatistic() const;
+  common::time64_t GetStreamStatisticInterval() const;  // sec, minimal interval between messages of one stream
+  bool IsServiceStatistic() const;
+  common::time64_t GetServiceStatisticInterval() const;  // sec
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  streams_t streams_;
+  bool stream_statistic_;
+  common::time64_t stream_statistic_interval_;
+  bool service_statistic_;
+  common::time64_t service_statistic_interval_;
+};
+
+}  // namespace service
+}  // namespace server
+}  // namespace iptv_cloud
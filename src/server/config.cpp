@@ -24,11 +24,19 @@
 #define SERVICE_LOG_LEVEL_FIELD "log_level"
 #define SERVICE_HOST_FIELD "host"
 #define SERVICE_HTTP_HOST_FIELD "http_host"
+#define SERVICE_HTTP_CACHE_SIZE_FIELD "http_cache_size"
+#define SERVICE_HTTP_WORKERS_FIELD "http_workers"
+#define SERVICE_ZYGOTE_FIELD "zygote"
+#define SERVICE_INGEST_DIR_FIELD "ingest_dir"
 
 #define DUMMY_LOG_FILE_PATH "/dev/null"
 
 #define CLIENT_PORT 6317
 #define HTTP_HOST_PORT 8000
+#define HTTP_CACHE_SIZE 268435456  // 256 MB
+#define HTTP_WORKERS 0
+#define ZYGOTE false
+#define INGEST_DIR INGEST_DIR_PATH
 
 namespace {
 common::ErrnoError ReadSlaveConfig(const std::string& path, iptv_cloud::utils::ArgsMap* args) {
@@ -59,6 +67,14 @@ common::ErrnoError ReadSlaveConfig(const std::string& path, iptv_cloud::utils::A
       options.push_back(pair);
     } else if (pair.first == SERVICE_HTTP_HOST_FIELD) {
       options.push_back(pair);
+    } else if (pair.first == SERVICE_HTTP_CACHE_SIZE_FIELD) {
+      options.push_back(pair);
+    } else if (pair.first == SERVICE_HTTP_WORKERS_FIELD) {
+      options.push_back(pair);
+    } else if (pair.first == SERVICE_ZYGOTE_FIELD) {
+      options.push_back(pair);
+    } else if (pair.first == SERVICE_INGEST_DIR_FIELD) {
+      options.push_back(pair);
     }
   }
 
@@ -72,7 +88,15 @@ namespace iptv_cloud {
 namespace server {
 
 Config::Config()
-    : id(), host(GetDefaultHost()), log_path(DUMMY_LOG_FILE_PATH), log_level(common::logging::LOG_LEVEL_INFO) {}
+    : id(),
+      host(GetDefaultHost()),
+      log_path(DUMMY_LOG_FILE_PATH),
+      log_level(common::logging::LOG_LEVEL_INFO),
+      http_host(common::net::HostAndPort::CreateLocalHost(HTTP_HOST_PORT)),
+      http_cache_size(HTTP_CACHE_SIZE),
+      http_workers(HTTP_WORKERS),
+      zygote(ZYGOTE),
+      ingest_dir(INGEST_DIR) {}
 
 common::net::HostAndPort Config::GetDefaultHost() {
   return common::net::HostAndPort::CreateLocalHost(CLIENT_PORT);
@@ -123,6 +147,30 @@ common::ErrnoError load_config_from_file(const std::string& config_absolute_path
   }
   lconfig.http_host = http_host;
 
+  size_t http_cache_size;
+  if (!utils::ArgsGetValue(slave_config_args, SERVICE_HTTP_CACHE_SIZE_FIELD, &http_cache_size)) {
+    http_cache_size = HTTP_CACHE_SIZE;
+  }
+  lconfig.http_cache_size = http_cache_size;
+
+  size_t http_workers;
+  if (!utils::ArgsGetValue(slave_config_args, SERVICE_HTTP_WORKERS_FIELD, &http_workers)) {
+    http_workers = HTTP_WORKERS;
+  }
+  lconfig.http_workers = http_workers;
+
+  bool zygote;
+  if (!utils::ArgsGetValue(slave_config_args, SERVICE_ZYGOTE_FIELD, &zygote)) {
+    zygote = ZYGOTE;
+  }
+  lconfig.zygote = zygote;
+
+  std::string ingest_dir;
+  if (!utils::ArgsGetValue(slave_config_args, SERVICE_INGEST_DIR_FIELD, &ingest_dir)) {
+    ingest_dir = INGEST_DIR;
+  }
+  lconfig.ingest_dir = ingest_dir;
+
   *config = lconfig;
   return common::ErrnoError();
 }
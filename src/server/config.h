@@ -32,6 +32,10 @@ struct Config {
   std::string log_path;
   common::logging::LOG_LEVEL log_level;
   common::net::HostAndPort http_host;
+  size_t http_cache_size;  // bytes, 0 - disabled
+  size_t http_workers;     // http loops, 0 - by cpu count
+  bool zygote;             // spawn streams from preloaded helper process
+  std::string ingest_dir;  // shared ingest control sockets and logs
 };
 
 common::ErrnoError load_config_from_file(const std::string& config_absolute_path, Config* config) WARN_UNUSED_RESULT;
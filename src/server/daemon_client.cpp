@@ -14,11 +14,15 @@
 
 #include "server/daemon_client.h"
 
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
 namespace iptv_cloud {
 namespace server {
 
 DaemonClient::DaemonClient(common::libev::IoLoop* server, const common::net::socket_info& info)
-    : base_class(server, info), is_verified_(false) {}
+    : base_class(server, info), is_verified_(false), subscription_() {}
 
 bool DaemonClient::IsVerified() const {
   return is_verified_;
@@ -28,6 +32,28 @@ void DaemonClient::SetVerified(bool verif) {
   is_verified_ = verif;
 }
 
+StatisticSubscription* DaemonClient::GetSubscription() {
+  return &subscription_;
+}
+
+bool DaemonClient::CanWriteWithoutBlocking(size_t size) const {
+  const descriptor_t fd = GetFd();
+  int send_buffer = 0;
+  socklen_t len = sizeof(send_buffer);
+  int queued = 0;
+  if (getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &send_buffer, &len) == ERROR_RESULT_VALUE ||
+      ioctl(fd, SIOCOUTQ, &queued) == ERROR_RESULT_VALUE) {
+    return true;  // unknown, write as usual
+  }
+
+  if (queued == 0) {  // nothing in flight, client keeps up
+    return true;
+  }
+
+  const size_t message_size = size + sizeof(protocol::protocoled_size_t);
+  return queued < send_buffer && message_size <= static_cast<size_t>(send_buffer - queued);
+}
+
 const char* DaemonClient::ClassName() const {
   return "DaemonClient";
 }
@@ -18,6 +18,8 @@
 
 #include "protocol/protocol.h"
 
+#include "server/statistic_subscription.h"
+
 namespace iptv_cloud {
 namespace server {
 
@@ -28,6 +30,11 @@ class DaemonClient : public common::libev::tcp::TcpClient {
   bool IsVerified() const;
   void SetVerified(bool verif);
 
+  StatisticSubscription* GetSubscription();
+
+  // true if message of size fits into socket send buffer, so write will not block on slow client
+  bool CanWriteWithoutBlocking(size_t size) const;
+
   const char* ClassName() const override;
 
  protected:
@@ -35,6 +42,7 @@ class DaemonClient : public common::libev::tcp::TcpClient {
 
  private:
   bool is_verified_;
+  StatisticSubscription subscription_;
 };
 
 class ProtocoledDaemonClient : public protocol::ProtocolClient<DaemonClient> {
@@ -101,6 +101,18 @@ protocol::response_t PingServiceResponceFail(protocol::sequance_id_t id, const s
   return protocol::response_t::MakeError(id, protocol::MakeServerErrorFromText(error_text));
 }
 
+protocol::response_t SubscribeStatisticResponceSuccess(protocol::sequance_id_t id) {
+  return protocol::response_t::MakeMessage(id, protocol::MakeSuccessMessage());
+}
+
+protocol::response_t SubscribeStatisticResponceFail(protocol::sequance_id_t id, const std::string& error_text) {
+  return protocol::response_t::MakeError(id, protocol::MakeServerErrorFromText(error_text));
+}
+
+protocol::response_t UnsubscribeStatisticResponceSuccess(protocol::sequance_id_t id) {
+  return protocol::response_t::MakeMessage(id, protocol::MakeSuccessMessage());
+}
+
 protocol::request_t ChangedSourcesStreamBroadcast(protocol::serializet_params_t params) {
   return protocol::request_t::MakeNotification(CLIENT_CHANGED_SOURCES_STREAM, params);
 }
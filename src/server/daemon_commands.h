@@ -33,6 +33,10 @@
                      // "playlists_directory": "", "dvb_directory": "", "capture_card_directory": "" }
 #define CLIENT_PING_SERVICE "ping_service"
 #define CLIENT_GET_LOG_SERVICE "get_log_service"  // {"path":"http://localhost/service/id"}
+#define CLIENT_SUBSCRIBE_STATISTIC \
+  "subscribe_statistic"  // {"streams": [], "stream_statistic": true, "stream_statistic_interval": 0,
+                         // "service_statistic": true, "service_statistic_interval": 0}
+#define CLIENT_UNSUBSCRIBE_STATISTIC "unsubscribe_statistic"
 
 #define SERVER_PING "ping_client"
 
@@ -67,6 +71,10 @@ protocol::response_t PingServiceResponce(protocol::sequance_id_t id,
                                          const std::string& result);  // ServerPingInfo
 protocol::response_t PingServiceResponceFail(protocol::sequance_id_t id, const std::string& error_text);
 
+protocol::response_t SubscribeStatisticResponceSuccess(protocol::sequance_id_t id);
+protocol::response_t SubscribeStatisticResponceFail(protocol::sequance_id_t id, const std::string& error_text);
+protocol::response_t UnsubscribeStatisticResponceSuccess(protocol::sequance_id_t id);
+
 // responces streams
 protocol::response_t StartStreamResponceSuccess(protocol::sequance_id_t id);
 protocol::response_t StartStreamResponceFail(protocol::sequance_id_t id, const std::string& error_text);
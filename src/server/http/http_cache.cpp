@@ -0,0 +1,155 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/http/http_cache.h"
+
+#define PLAYLIST_EXT ".m3u8"
+#define SEGMENT_EXT ".ts"
+
+namespace {
+
+bool EndsWith(const std::string& str, const char* suffix, size_t suffix_len) {
+  if (str.size() < suffix_len) {
+    return false;
+  }
+
+  return str.compare(str.size() - suffix_len, suffix_len, suffix) == 0;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace server {
+
+HttpCacheStats::HttpCacheStats() : hits(0), misses(0), evictions(0), invalidations(0), size(0), entries(0) {}
+
+HttpCache::CachedFile::CachedFile() : content(), mtime(0) {}
+
+HttpCache::CachedFile::CachedFile(content_t content, time_t mtime) : content(content), mtime(mtime) {}
+
+HttpCache::HttpCache(size_t max_size) : max_size_(max_size), mutex_(), entries_(), lru_(), size_(0), stats_() {}
+
+bool HttpCache::IsEnabled() const {
+  return max_size_ != 0;
+}
+
+size_t HttpCache::GetMaxSize() const {
+  return max_size_;
+}
+
+size_t HttpCache::GetMaxEntrySize() const {
+  return max_size_ / max_entry_part;
+}
+
+bool HttpCache::IsCacheableFile(const std::string& path) {
+  return EndsWith(path, SEGMENT_EXT, sizeof(SEGMENT_EXT) - 1) || EndsWith(path, PLAYLIST_EXT, sizeof(PLAYLIST_EXT) - 1);
+}
+
+bool HttpCache::Find(const std::string& path, CachedFile* file) {
+  if (!file || !IsEnabled()) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entries_.find(path);
+  if (it == entries_.end()) {
+    stats_.misses++;
+    return false;
+  }
+
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  stats_.hits++;
+  *file = it->second.file;
+  return true;
+}
+
+bool HttpCache::Insert(const std::string& path, const CachedFile& file) {
+  if (!file.content || !IsEnabled()) {
+    return false;
+  }
+
+  const size_t file_size = file.content->size();
+  if (file_size > GetMaxEntrySize()) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entries_.find(path);
+  if (it != entries_.end()) {
+    EraseEntry(it);
+  }
+
+  EvictToFit(file_size);
+  lru_.push_front(path);
+  Node node = {file, lru_.begin()};
+  entries_.insert(std::make_pair(path, node));
+  size_ += file_size;
+  return true;
+}
+
+void HttpCache::Invalidate(const std::string& path) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entries_.find(path);
+  if (it == entries_.end()) {
+    return;
+  }
+
+  EraseEntry(it);
+  stats_.invalidations++;
+}
+
+void HttpCache::InvalidateDirectory(const std::string& dir_path) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->first.compare(0, dir_path.size(), dir_path) == 0) {
+      auto to_erase = it++;
+      EraseEntry(to_erase);
+      stats_.invalidations++;
+    } else {
+      ++it;
+    }
+  }
+}
+
+void HttpCache::Clear() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+  size_ = 0;
+}
+
+HttpCacheStats HttpCache::GetStats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  HttpCacheStats stats = stats_;
+  stats.size = size_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+void HttpCache::EraseEntry(entries_t::iterator it) {
+  size_ -= it->second.file.content->size();
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
+
+void HttpCache::EvictToFit(size_t size) {
+  while (!lru_.empty() && size_ + size > max_size_) {
+    auto it = entries_.find(lru_.back());
+    EraseEntry(it);
+    stats_.evictions++;
+  }
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
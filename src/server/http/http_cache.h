@@ -0,0 +1,95 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <common/macros.h>
+
+namespace iptv_cloud {
+namespace server {
+
+struct HttpCacheStats {
+  HttpCacheStats();
+
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint64_t invalidations;
+  uint64_t size;     // bytes
+  uint64_t entries;  // files
+};
+
+// LRU cache of hls playlists and segments, keyed by absolute file path.
+class HttpCache {
+ public:
+  typedef std::shared_ptr<const std::string> content_t;
+  enum { max_entry_part = 8 };  // one file can't take more than 1/8 of cache
+
+  struct CachedFile {
+    CachedFile();
+    CachedFile(content_t content, time_t mtime);
+
+    content_t content;
+    time_t mtime;
+  };
+
+  explicit HttpCache(size_t max_size);
+
+  bool IsEnabled() const;
+  size_t GetMaxSize() const;
+  size_t GetMaxEntrySize() const;
+
+  static bool IsCacheableFile(const std::string& path);
+
+  bool Find(const std::string& path, CachedFile* file);
+  bool Insert(const std::string& path, const CachedFile& file);
+
+  void Invalidate(const std::string& path);
+  void InvalidateDirectory(const std::string& dir_path);
+  void Clear();
+
+  HttpCacheStats GetStats() const;
+
+ private:
+  typedef std::list<std::string> lru_list_t;
+  struct Node {
+    CachedFile file;
+    lru_list_t::iterator lru_it;
+  };
+  typedef std::unordered_map<std::string, Node> entries_t;
+
+  void EraseEntry(entries_t::iterator it);
+  void EvictToFit(size_t size);
+
+  const size_t max_size_;
+  mutable std::mutex mutex_;
+  entries_t entries_;
+  lru_list_t lru_;  // front most recently used
+  size_t size_;
+  HttpCacheStats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCache);
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -14,11 +14,17 @@
 
 #include "server/http/http_client.h"
 
+#include <sys/sendfile.h>
+
+#include <common/time.h>
+
 namespace iptv_cloud {
 namespace server {
 
 HttpClient::HttpClient(common::libev::IoLoop* server, const common::net::socket_info& info)
-    : base_class(server, info), is_verified_(false) {}
+    : base_class(server, info), is_verified_(false), parser_(), last_activity_(0) {
+  UpdateLastActivity();
+}
 
 bool HttpClient::IsVerified() const {
   return is_verified_;
@@ -28,6 +34,40 @@ void HttpClient::SetVerified(bool verif) {
   is_verified_ = verif;
 }
 
+HttpRequestParser* HttpClient::GetParser() {
+  return &parser_;
+}
+
+common::ErrnoError HttpClient::SendFileRange(int file_fd, off_t offset, size_t size) {
+  off_t file_offset = offset;
+  size_t left = size;
+  while (left > 0) {
+    ssize_t res = sendfile(GetFd(), file_fd, &file_offset, left);
+    if (res == ERROR_RESULT_VALUE) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return common::make_errno_error(errno);
+    }
+
+    if (res == 0) {
+      return common::make_errno_error("File truncated while sending.", EIO);
+    }
+
+    left -= res;
+  }
+
+  return common::ErrnoError();
+}
+
+time_t HttpClient::GetLastActivity() const {
+  return last_activity_;
+}
+
+void HttpClient::UpdateLastActivity() {
+  last_activity_ = common::time::current_mstime() / 1000;
+}
+
 const char* HttpClient::ClassName() const {
   return "HttpClient";
 }
@@ -14,10 +14,14 @@
 
 #pragma once
 
+#include <time.h>
+
 #include <common/libev/http/http_client.h>
 
 #include "protocol/protocol.h"
 
+#include "server/http/http_request_parser.h"
+
 namespace iptv_cloud {
 namespace server {
 
@@ -30,10 +34,20 @@ class HttpClient : public common::libev::http::HttpClient {
   bool IsVerified() const;
   void SetVerified(bool verif);
 
+  HttpRequestParser* GetParser();
+
+  // part of file, SendFileByFd sends whole file
+  common::ErrnoError SendFileRange(int file_fd, off_t offset, size_t size) WARN_UNUSED_RESULT;
+
+  time_t GetLastActivity() const;
+  void UpdateLastActivity();
+
   const char* ClassName() const override;
 
  private:
   bool is_verified_;
+  HttpRequestParser parser_;
+  time_t last_activity_;
 };
 
 }  // namespace server
@@ -15,29 +15,87 @@
 #include "server/http/http_handler.h"
 
 #include <fcntl.h>
+#include <sys/inotify.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include <string>
 #include <utility>
+#include <vector>
+
+#include <common/time.h>
 
 #include "server/http/http_client.h"
+#include "server/http/http_range.h"
+#include "server/http/http_server.h"
+#include "server/http/inotify_client.h"
+#include "server/metrics_registry.h"
+
+#define METRICS_FILE_NAME "metrics"
+#define METRICS_MIME "text/plain; version=0.0.4"
+
+namespace {
+
+// not all statuses declared in common::http
+const common::http::http_status kHttpPartialContent = static_cast<common::http::http_status>(206);
+const common::http::http_status kHttpNotModified = static_cast<common::http::http_status>(304);
+const common::http::http_status kHttpRangeNotSatisfiable = static_cast<common::http::http_status>(416);
+
+}  // namespace
 
 namespace iptv_cloud {
 namespace server {
 
-HttpHandler::HttpHandler() : http_root_(http_directory_path_t::MakeHomeDir()) {}
+HttpWorkerStats::HttpWorkerStats() : connections(0), active_connections(0), requests(0), bytes_sent(0) {}
+
+HttpHandler::HttpHandler(HttpCache* cache, const MetricsRegistry* metrics)
+    : http_root_(http_directory_path_t::MakeHomeDir()),
+      cache_(cache),
+      metrics_(metrics),
+      watcher_(nullptr),
+      idle_timer_(INVALID_TIMER_ID),
+      connections_(0),
+      active_connections_(0),
+      requests_(0),
+      bytes_sent_(0) {
+  CHECK(cache);
+}
 
 void HttpHandler::SetHttpRoot(const http_directory_path_t& http_root) {
   http_root_ = http_root;
+  cache_->Clear();
+}
+
+HttpWorkerStats HttpHandler::GetWorkerStats() const {
+  HttpWorkerStats stats;
+  stats.connections = connections_;
+  stats.active_connections = active_connections_;
+  stats.requests = requests_;
+  stats.bytes_sent = bytes_sent_;
+  return stats;
 }
 
 void HttpHandler::PreLooped(common::libev::IoLoop* server) {
-  UNUSED(server);
+  idle_timer_ = server->CreateTimer(idle_check_seconds, true);
+  if (!cache_->IsEnabled()) {
+    return;
+  }
+
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd == ERROR_RESULT_VALUE) {
+    WARNING_LOG() << "Failed to init inotify, http cache disabled, error: " << common::common_strerror(errno);
+    return;
+  }
+
+  watcher_ = new InotifyClient(server, fd);
+  server->RegisterClient(watcher_);
 }
 
 void HttpHandler::Accepted(common::libev::IoClient* client) {
-  UNUSED(client);
+  if (dynamic_cast<HttpClient*>(client)) {
+    connections_++;
+    active_connections_++;
+  }
 }
 
 void HttpHandler::Moved(common::libev::IoLoop* server, common::libev::IoClient* client) {
@@ -46,12 +104,32 @@ void HttpHandler::Moved(common::libev::IoLoop* server, common::libev::IoClient*
 }
 
 void HttpHandler::Closed(common::libev::IoClient* client) {
-  UNUSED(client);
+  if (client == watcher_) {
+    watcher_ = nullptr;
+    cache_->Clear();
+    return;
+  }
+
+  if (dynamic_cast<HttpClient*>(client)) {
+    active_connections_--;
+  }
 }
 
 void HttpHandler::TimerEmited(common::libev::IoLoop* server, common::libev::timer_id_t id) {
-  UNUSED(server);
-  UNUSED(id);
+  if (idle_timer_ != id) {
+    return;
+  }
+
+  const time_t current_time = common::time::current_mstime() / 1000;
+  std::vector<common::libev::IoClient*> online_clients = server->GetClients();
+  for (size_t i = 0; i < online_clients.size(); ++i) {
+    HttpClient* hclient = dynamic_cast<HttpClient*>(online_clients[i]);
+    if (hclient && current_time - hclient->GetLastActivity() > idle_timeout_seconds) {
+      DEBUG_LOG() << "Closed idle http client: " << hclient->GetFormatedName();
+      hclient->Close();
+      delete hclient;
+    }
+  }
 }
 
 #if LIBEV_CHILD_ENABLE
@@ -71,9 +149,20 @@ void HttpHandler::ChildStatusChanged(common::libev::IoChild* child, int status)
 #endif
 
 void HttpHandler::DataReceived(common::libev::IoClient* client) {
-  char buff[BUF_SIZE] = {0};
+  if (client == watcher_) {
+    ProcessFileChanges();
+    return;
+  }
+
+  HttpListener* listener = dynamic_cast<HttpListener*>(client);
+  if (listener) {
+    listener->GetOwner()->AcceptClients();
+    return;
+  }
+
+  char buff[BUF_SIZE];
   size_t nread = 0;
-  common::ErrnoError errn = client->SingleRead(buff, BUF_SIZE - 1, &nread);
+  common::ErrnoError errn = client->SingleRead(buff, BUF_SIZE, &nread);
   if ((errn && errn->GetErrorCode() != EAGAIN) || nread == 0) {
     client->Close();
     delete client;
@@ -81,7 +170,35 @@ void HttpHandler::DataReceived(common::libev::IoClient* client) {
   }
 
   HttpClient* hclient = static_cast<server::HttpClient*>(client);
-  ProcessReceived(hclient, buff, nread);
+  hclient->UpdateLastActivity();
+  HttpRequestParser* parser = hclient->GetParser();
+  parser->Append(buff, nread);
+  while (true) {  // pipelined requests answered in order
+    std::string request;
+    HttpRequestParser::Status status = parser->Next(&request);
+    if (status == HttpRequestParser::NEED_MORE_DATA) {
+      return;
+    }
+
+    bool keep_alive = false;
+    if (status == HttpRequestParser::REQUEST_READY) {
+      keep_alive = ProcessReceived(hclient, request.c_str(), request.size());
+    } else {
+      static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+      const char* error_text = status == HttpRequestParser::REQUEST_TOO_LARGE ? "Request too large." : "Bad request.";
+      common::ErrnoError err =
+          hclient->SendError(common::http::HP_1_1, common::http::HS_BAD_REQUEST, nullptr, error_text, false, hinf);
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+      }
+    }
+
+    if (!keep_alive) {
+      hclient->Close();
+      delete hclient;
+      return;
+    }
+  }
 }
 
 void HttpHandler::DataReadyToWrite(common::libev::IoClient* client) {
@@ -89,15 +206,212 @@ void HttpHandler::DataReadyToWrite(common::libev::IoClient* client) {
 }
 
 void HttpHandler::PostLooped(common::libev::IoLoop* server) {
-  UNUSED(server);
+  if (idle_timer_ != INVALID_TIMER_ID) {
+    server->RemoveTimer(idle_timer_);
+    idle_timer_ = INVALID_TIMER_ID;
+  }
+
+  if (watcher_) {
+    InotifyClient* watcher = watcher_;
+    watcher->Close();  // resets watcher_ in Closed
+    delete watcher;
+    watcher_ = nullptr;
+  }
 }
 
-void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size_t req_len) {
+common::ErrnoError HttpHandler::SendMetrics(HttpClient* hclient,
+                                            const common::http::HttpRequest& hrequest,
+                                            bool keep_alive) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  const std::string body = metrics_->Render();
+  off_t length = body.size();
+  common::ErrnoError err = hclient->SendHeaders(hrequest.GetProtocol(), common::http::HS_OK, "Cache-Control: no-cache",
+                                                METRICS_MIME, &length, nullptr, keep_alive, hinf);
+  if (err) {
+    return err;
+  }
+
+  if (hrequest.GetMethod() != common::http::http_method::HM_GET) {
+    return common::ErrnoError();
+  }
+
+  size_t nwrite = 0;
+  err = hclient->Write(body.data(), body.size(), &nwrite);
+  if (err) {
+    return err;
+  }
+
+  bytes_sent_ += body.size();
+  return common::ErrnoError();
+}
+
+void HttpHandler::ProcessFileChanges() {
+  std::vector<std::string> changed_files;
+  std::vector<std::string> removed_dirs;
+  bool overflowed = false;
+  common::ErrnoError err = watcher_->ReadChanges(&changed_files, &removed_dirs, &overflowed);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+  }
+
+  // lost events can't be replayed, nothing cached is trusted
+  if (overflowed) {
+    WARNING_LOG() << "Http cache watcher queue overflowed, cache cleared";
+    cache_->Clear();
+    return;
+  }
+
+  for (const std::string& file_path : changed_files) {
+    cache_->Invalidate(file_path);
+  }
+
+  for (const std::string& dir_path : removed_dirs) {
+    cache_->InvalidateDirectory(dir_path);
+  }
+}
+
+bool HttpHandler::LoadToCache(const std::string& file_path,
+                              int fd,
+                              size_t size,
+                              time_t mtime,
+                              HttpCache::CachedFile* file) {
+  if (!watcher_ || size > cache_->GetMaxEntrySize()) {
+    return false;
+  }
+
+  const std::string::size_type pos = file_path.find_last_of('/');
+  if (pos == std::string::npos) {
+    return false;
+  }
+
+  // watch before read, so rewrite after read always invalidates the entry
+  common::ErrnoError err = watcher_->AddDirectoryWatch(file_path.substr(0, pos + 1));
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    return false;
+  }
+
+  std::string* content = new std::string(size, 0);
+  size_t offset = 0;
+  while (offset < size) {
+    ssize_t res = pread(fd, &(*content)[offset], size - offset, offset);
+    if (res == ERROR_RESULT_VALUE && errno == EINTR) {
+      continue;
+    }
+
+    if (res <= 0) {
+      delete content;
+      return false;
+    }
+
+    offset += res;
+  }
+
+  HttpCache::CachedFile lfile(HttpCache::content_t(content), mtime);
+  if (!cache_->Insert(file_path, lfile)) {
+    return false;
+  }
+
+  *file = lfile;
+  return true;
+}
+
+common::ErrnoError HttpHandler::SendFile(HttpClient* hclient,
+                                         const common::http::HttpRequest& hrequest,
+                                         const std::string& mime,
+                                         off_t size,
+                                         time_t mtime,
+                                         HttpCache::content_t content,
+                                         int fd,
+                                         bool keep_alive) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  const common::http::http_protocol protocol = hrequest.GetProtocol();
+  const std::string etag = MakeETag(size, mtime);
+  std::string extra_header = "Accept-Ranges: bytes\r\nETag: " + etag;
+
+  // If-None-Match takes precedence over If-Modified-Since
+  common::http::header_t field;
+  bool not_modified = false;
+  if (hrequest.FindHeaderByKey("If-None-Match", false, &field)) {
+    not_modified = IsETagMatched(field.value, etag);
+  } else if (hrequest.FindHeaderByKey("If-Modified-Since", false, &field)) {
+    time_t since = 0;
+    not_modified = ParseHttpDate(field.value, &since) && mtime <= since;
+  }
+
+  if (not_modified) {
+    return hclient->SendHeaders(protocol, kHttpNotModified, extra_header.c_str(), mime.c_str(), nullptr, &mtime,
+                                keep_alive, hinf);
+  }
+
+  HttpRange range;
+  RangeStatus range_status = RANGE_NONE;
+  if (hrequest.FindHeaderByKey("Range", false, &field)) {
+    const std::string range_value = field.value;
+    bool range_valid = true;  // If-Range: validator changed, whole file
+    if (hrequest.FindHeaderByKey("If-Range", false, &field)) {
+      time_t if_range_time = 0;
+      range_valid = IsETagStrongMatched(field.value, etag) ||
+                    (ParseHttpDate(field.value, &if_range_time) && if_range_time == mtime);
+    }
+
+    if (range_valid) {
+      range_status = ParseRangeHeader(range_value, size, &range);
+    }
+  }
+
+  if (range_status == RANGE_NOT_SATISFIABLE) {
+    extra_header += "\r\nContent-Range: " + MakeUnsatisfiedContentRange(size);
+    off_t empty = 0;
+    return hclient->SendHeaders(protocol, kHttpRangeNotSatisfiable, extra_header.c_str(), mime.c_str(), &empty,
+                                &mtime, keep_alive, hinf);
+  }
+
+  common::http::http_status status = common::http::HS_OK;
+  off_t offset = 0;
+  off_t length = size;
+  if (range_status == RANGE_SATISFIABLE) {
+    status = kHttpPartialContent;
+    offset = range.first;
+    length = range.GetLength();
+    extra_header += "\r\nContent-Range: " + MakeContentRange(range, size);
+  }
+
+  common::ErrnoError err = hclient->SendHeaders(protocol, status, extra_header.c_str(), mime.c_str(), &length, &mtime,
+                                                keep_alive, hinf);
+  if (err) {
+    return err;
+  }
+
+  if (hrequest.GetMethod() != common::http::http_method::HM_GET) {
+    return common::ErrnoError();
+  }
+
+  if (content) {
+    size_t nwrite = 0;
+    err = hclient->Write(content->data() + offset, length, &nwrite);
+  } else if (length == size) {
+    err = hclient->SendFileByFd(protocol, fd, size);
+  } else {
+    err = hclient->SendFileRange(fd, offset, length);
+  }
+
+  if (err) {
+    return err;
+  }
+
+  bytes_sent_ += length;
+  DEBUG_LOG() << "Sent file " << (content ? "from cache" : "by fd") << ", status: " << status << ", size: " << length;
+  return common::ErrnoError();
+}
+
+bool HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size_t req_len) {
   static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
   common::http::HttpRequest hrequest;
   std::string request_str(request, req_len);
   std::pair<common::http::http_status, common::Error> result = common::http::parse_http_request(request_str, &hrequest);
-  DEBUG_LOG() << "Http request:\n" << request;
+  requests_++;
+  DEBUG_LOG() << "Http request:\n" << request_str;
 
   if (result.second) {
     const std::string error_text = result.second->GetDescription();
@@ -107,16 +421,15 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
     }
-    hclient->Close();
-    delete hclient;
-    return;
+    return false;
   }
 
   // keep alive
+  const common::http::http_protocol protocol = hrequest.GetProtocol();
   common::http::header_t connection_field;
   bool is_find_connection = hrequest.FindHeaderByKey("Connection", false, &connection_field);
-  bool IsKeepAlive = is_find_connection ? common::EqualsASCII(connection_field.value, "Keep-Alive", false) : false;
-  const common::http::http_protocol protocol = hrequest.GetProtocol();
+  bool IsKeepAlive = HttpRequestParser::IsKeepAlive(is_find_connection ? &connection_field.value : nullptr,
+                                                    protocol == common::http::HP_1_1);
   const char* extra_header = nullptr;
   if (hrequest.GetMethod() == common::http::http_method::HM_GET ||
       hrequest.GetMethod() == common::http::http_method::HM_HEAD) {
@@ -127,7 +440,16 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
       if (err) {
         DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
       }
-      return;
+      return IsKeepAlive;
+    }
+
+    if (metrics_ && path.GetHpath() == "/" && path.GetFileName() == METRICS_FILE_NAME) {
+      common::ErrnoError err = SendMetrics(hclient, hrequest, IsKeepAlive);
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+        return false;
+      }
+      return IsKeepAlive;
     }
 
     const std::string url_dirs = path.GetHpath();
@@ -143,10 +465,23 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
       if (err) {
         DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
       }
-      return;
+      return IsKeepAlive;
     }
 
     const std::string file_path_str = file_path->GetPath();
+    const std::string mime = path.GetMime();
+    const bool is_cacheable = HttpCache::IsCacheableFile(file_path_str);
+    HttpCache::CachedFile cached_file;
+    if (is_cacheable && cache_->Find(file_path_str, &cached_file)) {
+      common::ErrnoError err = SendFile(hclient, hrequest, mime, cached_file.content->size(), cached_file.mtime,
+                                        cached_file.content, INVALID_DESCRIPTOR, IsKeepAlive);
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+        return false;
+      }
+      return IsKeepAlive;
+    }
+
     int open_flags = O_RDONLY;
     struct stat sb;
     if (stat(file_path_str.c_str(), &sb) < 0) {
@@ -155,7 +490,7 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
       if (err) {
         DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
       }
-      return;
+      return IsKeepAlive;
     }
 
     if (S_ISDIR(sb.st_mode)) {
@@ -164,7 +499,7 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
       if (err) {
         DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
       }
-      return;
+      return IsKeepAlive;
     }
 
     int file = open(file_path_str.c_str(), open_flags);
@@ -174,34 +509,23 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
       if (err) {
         DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
       }
-      return;
+      return IsKeepAlive;
     }
 
-    const std::string mime = path.GetMime();
-    common::ErrnoError err = hclient->SendHeaders(protocol, common::http::HS_OK, extra_header, mime.c_str(),
-                                                  &sb.st_size, &sb.st_mtime, IsKeepAlive, hinf);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      ::close(file);
-      return;
-    }
-
-    if (hrequest.GetMethod() == common::http::http_method::HM_GET) {
-      common::ErrnoError err = hclient->SendFileByFd(protocol, file, sb.st_size);
-      if (err) {
-        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      } else {
-        DEBUG_LOG() << "Sent file path: " << file_path_str << ", size: " << sb.st_size;
-      }
+    if (!is_cacheable || !LoadToCache(file_path_str, file, sb.st_size, sb.st_mtime, &cached_file)) {
+      cached_file = HttpCache::CachedFile();
     }
 
+    common::ErrnoError err =
+        SendFile(hclient, hrequest, mime, sb.st_size, sb.st_mtime, cached_file.content, file, IsKeepAlive);
     ::close(file);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+      return false;
+    }
   }
 
-  if (!IsKeepAlive) {
-    hclient->Close();
-    delete hclient;
-  }
+  return IsKeepAlive;
 }
 
 }  // namespace server
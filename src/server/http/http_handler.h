@@ -14,21 +14,39 @@
 
 #pragma once
 
+#include <atomic>
+#include <string>
+
 #include <common/file_system/path.h>
+#include <common/http/http.h>
 #include <common/libev/io_loop_observer.h>
 
+#include "server/http/http_cache.h"
+
 namespace iptv_cloud {
 namespace server {
 
 class HttpClient;
+class InotifyClient;
+class MetricsRegistry;
+
+struct HttpWorkerStats {
+  HttpWorkerStats();
+
+  uint64_t connections;         // accepted total
+  uint64_t active_connections;  // now
+  uint64_t requests;
+  uint64_t bytes_sent;  // bodies
+};
 
 class HttpHandler : public common::libev::IoLoopObserver {
  public:
-  enum { BUF_SIZE = 4096 };
+  enum { BUF_SIZE = 4096, idle_timeout_seconds = 60, idle_check_seconds = 5 };
   typedef common::file_system::ascii_directory_string_path http_directory_path_t;
-  HttpHandler();
+  HttpHandler(HttpCache* cache, const MetricsRegistry* metrics);  // shared between workers, metrics can be null
 
   void SetHttpRoot(const http_directory_path_t& http_root);
+  HttpWorkerStats GetWorkerStats() const;
 
   void PreLooped(common::libev::IoLoop* server) override;
 
@@ -48,9 +66,31 @@ class HttpHandler : public common::libev::IoLoopObserver {
   void PostLooped(common::libev::IoLoop* server) override;
 
  private:
-  void ProcessReceived(HttpClient* hclient, const char* request, size_t req_len);
+  bool ProcessReceived(HttpClient* hclient, const char* request, size_t req_len);  // false if should be closed
+  common::ErrnoError SendFile(HttpClient* hclient,
+                              const common::http::HttpRequest& hrequest,
+                              const std::string& mime,
+                              off_t size,
+                              time_t mtime,
+                              HttpCache::content_t content,  // if empty file sent by fd
+                              int fd,
+                              bool keep_alive) WARN_UNUSED_RESULT;
+  common::ErrnoError SendMetrics(HttpClient* hclient,
+                                 const common::http::HttpRequest& hrequest,
+                                 bool keep_alive) WARN_UNUSED_RESULT;
+  void ProcessFileChanges();
+  bool LoadToCache(const std::string& file_path, int fd, size_t size, time_t mtime, HttpCache::CachedFile* file);
 
   http_directory_path_t http_root_;
+  HttpCache* const cache_;
+  const MetricsRegistry* const metrics_;
+  InotifyClient* watcher_;
+  common::libev::timer_id_t idle_timer_;
+
+  std::atomic<uint64_t> connections_;
+  std::atomic<uint64_t> active_connections_;
+  std::atomic<uint64_t> requests_;
+  std::atomic<uint64_t> bytes_sent_;
 };
 
 }  // namespace server
@@ -0,0 +1,211 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/http/http_range.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#define BYTES_UNIT "bytes="
+#define WEAK_PREFIX "W/"
+
+namespace {
+
+std::string Trim(const std::string& str) {
+  const char* spaces = " \t";
+  std::string::size_type start = str.find_first_not_of(spaces);
+  if (start == std::string::npos) {
+    return std::string();
+  }
+
+  std::string::size_type end = str.find_last_not_of(spaces);
+  return str.substr(start, end - start + 1);
+}
+
+bool ParsePosition(const std::string& str, off_t* out) {
+  if (str.empty()) {
+    return false;
+  }
+
+  off_t result = 0;
+  for (char c : str) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+
+    const off_t digit = c - '0';
+    if (result > (INT64_MAX - digit) / 10) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+
+  *out = result;
+  return true;
+}
+
+std::string StripWeak(const std::string& tag) {
+  if (tag.compare(0, sizeof(WEAK_PREFIX) - 1, WEAK_PREFIX) == 0) {
+    return tag.substr(sizeof(WEAK_PREFIX) - 1);
+  }
+  return tag;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace server {
+
+HttpRange::HttpRange() : first(0), last(0) {}
+
+HttpRange::HttpRange(off_t first, off_t last) : first(first), last(last) {}
+
+off_t HttpRange::GetLength() const {
+  return last - first + 1;
+}
+
+RangeStatus ParseRangeHeader(const std::string& value, off_t file_size, HttpRange* range) {
+  if (!range) {
+    return RANGE_NONE;
+  }
+
+  const std::string trimmed = Trim(value);
+  if (strncasecmp(trimmed.c_str(), BYTES_UNIT, sizeof(BYTES_UNIT) - 1) != 0) {
+    return RANGE_NONE;  // unknown unit
+  }
+
+  const std::string spec = Trim(trimmed.substr(sizeof(BYTES_UNIT) - 1));
+  if (spec.find(',') != std::string::npos) {
+    return RANGE_NONE;  // multipart/byteranges not supported
+  }
+
+  const std::string::size_type dash = spec.find('-');
+  if (dash == std::string::npos) {
+    return RANGE_NONE;
+  }
+
+  const std::string first_str = Trim(spec.substr(0, dash));
+  const std::string last_str = Trim(spec.substr(dash + 1));
+  if (first_str.empty()) {  // suffix: last N bytes
+    off_t suffix = 0;
+    if (!ParsePosition(last_str, &suffix)) {
+      return RANGE_NONE;
+    }
+
+    if (suffix == 0 || file_size == 0) {
+      return RANGE_NOT_SATISFIABLE;
+    }
+
+    *range = HttpRange(suffix >= file_size ? 0 : file_size - suffix, file_size - 1);
+    return RANGE_SATISFIABLE;
+  }
+
+  off_t first = 0;
+  if (!ParsePosition(first_str, &first)) {
+    return RANGE_NONE;
+  }
+
+  off_t last = file_size - 1;
+  if (!last_str.empty()) {
+    if (!ParsePosition(last_str, &last)) {
+      return RANGE_NONE;
+    }
+
+    if (last < first) {
+      return RANGE_NONE;  // invalid, ignored
+    }
+  }
+
+  if (first >= file_size) {
+    return RANGE_NOT_SATISFIABLE;
+  }
+
+  if (last >= file_size) {
+    last = file_size - 1;
+  }
+
+  *range = HttpRange(first, last);
+  return RANGE_SATISFIABLE;
+}
+
+std::string MakeContentRange(const HttpRange& range, off_t file_size) {
+  char buff[96];
+  snprintf(buff, sizeof(buff), "bytes %lld-%lld/%lld", static_cast<long long>(range.first),
+           static_cast<long long>(range.last), static_cast<long long>(file_size));
+  return buff;
+}
+
+std::string MakeUnsatisfiedContentRange(off_t file_size) {
+  char buff[64];
+  snprintf(buff, sizeof(buff), "bytes */%lld", static_cast<long long>(file_size));
+  return buff;
+}
+
+std::string MakeETag(off_t file_size, time_t mtime) {
+  char buff[64];
+  snprintf(buff, sizeof(buff), "\"%llx-%llx\"", static_cast<unsigned long long>(mtime),
+           static_cast<unsigned long long>(file_size));
+  return buff;
+}
+
+bool IsETagMatched(const std::string& if_none_match, const std::string& etag) {
+  const std::string etag_opaque = StripWeak(etag);
+  std::string::size_type start = 0;
+  while (start <= if_none_match.size()) {
+    std::string::size_type end = if_none_match.find(',', start);
+    if (end == std::string::npos) {
+      end = if_none_match.size();
+    }
+
+    const std::string tag = Trim(if_none_match.substr(start, end - start));
+    if (tag == "*" || StripWeak(tag) == etag_opaque) {
+      return true;
+    }
+    start = end + 1;
+  }
+
+  return false;
+}
+
+bool IsETagStrongMatched(const std::string& if_range, const std::string& etag) {
+  const std::string tag = Trim(if_range);
+  if (tag.compare(0, sizeof(WEAK_PREFIX) - 1, WEAK_PREFIX) == 0 ||
+      etag.compare(0, sizeof(WEAK_PREFIX) - 1, WEAK_PREFIX) == 0) {
+    return false;
+  }
+
+  return tag == etag;
+}
+
+bool ParseHttpDate(const std::string& value, time_t* out) {
+  if (!out) {
+    return false;
+  }
+
+  struct tm tm;
+  memset(&tm, 0, sizeof(tm));
+  const std::string date = Trim(value);
+  const char* end = strptime(date.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+  if (!end || *end != 0) {
+    return false;
+  }
+
+  *out = timegm(&tm);
+  return true;
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,53 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <sys/types.h>
+#include <time.h>
+
+#include <string>
+
+namespace iptv_cloud {
+namespace server {
+
+struct HttpRange {
+  HttpRange();
+  HttpRange(off_t first, off_t last);
+
+  off_t GetLength() const;
+
+  off_t first;
+  off_t last;  // inclusive
+};
+
+enum RangeStatus {
+  RANGE_NONE,             // no range or range should be ignored, whole file with 200
+  RANGE_SATISFIABLE,      // 206
+  RANGE_NOT_SATISFIABLE,  // 416
+};
+
+// only one byte range supported, multiple ranges ignored and whole file sent
+RangeStatus ParseRangeHeader(const std::string& value, off_t file_size, HttpRange* range);
+std::string MakeContentRange(const HttpRange& range, off_t file_size);
+std::string MakeUnsatisfiedContentRange(off_t file_size);
+
+std::string MakeETag(off_t file_size, time_t mtime);
+bool IsETagMatched(const std::string& if_none_match, const std::string& etag);  // weak comparison
+bool IsETagStrongMatched(const std::string& if_range, const std::string& etag);
+
+bool ParseHttpDate(const std::string& value, time_t* out);  // IMF-fixdate
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,188 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/http/http_request_parser.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define HEADERS_END "\r\n\r\n"
+#define CONTENT_LENGTH_HEADER "Content-Length"
+#define TRANSFER_ENCODING_HEADER "Transfer-Encoding"
+
+namespace {
+
+std::string Trim(const std::string& str) {
+  const char* spaces = " \t\r\n";
+  std::string::size_type start = str.find_first_not_of(spaces);
+  if (start == std::string::npos) {
+    return std::string();
+  }
+
+  std::string::size_type end = str.find_last_not_of(spaces);
+  return str.substr(start, end - start + 1);
+}
+
+// header name compared case insensitive, value trimmed
+bool FindHeader(const std::string& headers, const char* name, std::string* value) {
+  const size_t name_len = strlen(name);
+  std::string::size_type line_start = headers.find("\r\n");
+  while (line_start != std::string::npos) {
+    line_start += 2;
+    std::string::size_type line_end = headers.find("\r\n", line_start);
+    if (line_end == std::string::npos) {
+      line_end = headers.size();
+    }
+
+    if (line_end - line_start > name_len && headers[line_start + name_len] == ':' &&
+        strncasecmp(headers.c_str() + line_start, name, name_len) == 0) {
+      *value = Trim(headers.substr(line_start + name_len + 1, line_end - line_start - name_len - 1));
+      return true;
+    }
+
+    if (line_end == headers.size()) {
+      break;
+    }
+    line_start = line_end;
+  }
+
+  return false;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace server {
+
+HttpRequestParser::HttpRequestParser() : buffer_(), offset_(0), scan_pos_(0) {}
+
+void HttpRequestParser::Append(const char* data, size_t size) {
+  Compact();
+  buffer_.append(data, size);
+}
+
+HttpRequestParser::Status HttpRequestParser::Next(std::string* request) {
+  if (!request) {
+    return BAD_REQUEST;
+  }
+
+  // empty lines between pipelined requests are allowed
+  while (offset_ < buffer_.size() && (buffer_[offset_] == '\r' || buffer_[offset_] == '\n')) {
+    offset_++;
+  }
+  if (scan_pos_ < offset_) {
+    scan_pos_ = offset_;
+  }
+
+  const std::string::size_type headers_end = buffer_.find(HEADERS_END, scan_pos_);
+  if (headers_end == std::string::npos) {
+    if (GetBufferedSize() > max_request_size) {
+      return REQUEST_TOO_LARGE;
+    }
+
+    // last 3 bytes can be start of delimiter
+    scan_pos_ = buffer_.size() > sizeof(HEADERS_END) - 2 ? buffer_.size() - (sizeof(HEADERS_END) - 2) : 0;
+    if (scan_pos_ < offset_) {
+      scan_pos_ = offset_;
+    }
+    return NEED_MORE_DATA;
+  }
+
+  const size_t headers_size = headers_end + sizeof(HEADERS_END) - 1 - offset_;
+  const std::string headers = buffer_.substr(offset_, headers_size - 2);
+  std::string value;
+  if (FindHeader(headers, TRANSFER_ENCODING_HEADER, &value)) {
+    return BAD_REQUEST;  // only requests without body or with length
+  }
+
+  size_t content_length = 0;
+  if (FindHeader(headers, CONTENT_LENGTH_HEADER, &value)) {
+    char* end = nullptr;
+    unsigned long long length = strtoull(value.c_str(), &end, 10);
+    if (value.empty() || *end != 0) {
+      return BAD_REQUEST;
+    }
+
+    if (length > max_request_size) {
+      return REQUEST_TOO_LARGE;
+    }
+    content_length = length;
+  }
+
+  const size_t request_size = headers_size + content_length;
+  if (request_size > max_request_size) {
+    return REQUEST_TOO_LARGE;
+  }
+
+  if (GetBufferedSize() < request_size) {
+    scan_pos_ = headers_end;
+    return NEED_MORE_DATA;
+  }
+
+  *request = buffer_.substr(offset_, request_size);
+  offset_ += request_size;
+  scan_pos_ = offset_;
+  return REQUEST_READY;
+}
+
+size_t HttpRequestParser::GetBufferedSize() const {
+  return buffer_.size() - offset_;
+}
+
+void HttpRequestParser::Reset() {
+  buffer_.clear();
+  offset_ = 0;
+  scan_pos_ = 0;
+}
+
+bool HttpRequestParser::IsKeepAlive(const std::string* connection_value, bool http_1_1) {
+  if (!connection_value) {
+    return http_1_1;
+  }
+
+  bool keep_alive = http_1_1;
+  std::string::size_type start = 0;
+  while (start <= connection_value->size()) {
+    std::string::size_type end = connection_value->find(',', start);
+    if (end == std::string::npos) {
+      end = connection_value->size();
+    }
+
+    const std::string token = Trim(connection_value->substr(start, end - start));
+    if (strcasecmp(token.c_str(), "close") == 0) {
+      return false;
+    }
+
+    if (strcasecmp(token.c_str(), "keep-alive") == 0) {
+      keep_alive = true;
+    }
+    start = end + 1;
+  }
+
+  return keep_alive;
+}
+
+void HttpRequestParser::Compact() {
+  if (offset_ == 0) {
+    return;
+  }
+
+  buffer_.erase(0, offset_);
+  scan_pos_ -= offset_;
+  offset_ = 0;
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
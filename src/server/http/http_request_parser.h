@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+namespace iptv_cloud {
+namespace server {
+
+// splits stream of connection bytes into separate http requests, keeps tail until request completed
+class HttpRequestParser {
+ public:
+  enum { max_request_size = 16384 };  // headers + body
+  enum Status { NEED_MORE_DATA, REQUEST_READY, BAD_REQUEST, REQUEST_TOO_LARGE };
+
+  HttpRequestParser();
+
+  void Append(const char* data, size_t size);
+  Status Next(std::string* request);  // pops oldest complete request
+  size_t GetBufferedSize() const;
+  void Reset();
+
+  // Connection header tokens, without header http/1.1 is persistent and http/1.0 not
+  static bool IsKeepAlive(const std::string* connection_value, bool http_1_1);
+
+ private:
+  void Compact();
+
+  std::string buffer_;
+  size_t offset_;  // start of not parsed request
+  size_t scan_pos_;  // headers end not found before this position
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -14,17 +14,195 @@
 
 #include "server/http/http_server.h"
 
+#include <netdb.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include <common/convert2string.h>
+#include <common/file_system/file_system.h>
+
 #include "server/http/http_client.h"
 
 namespace iptv_cloud {
 namespace server {
 
+HttpListener::HttpListener(HttpServer* server, descriptor_t fd) : base_class(server), owner_(server), fd_(fd) {}
+
+HttpListener::~HttpListener() {}
+
+HttpServer* HttpListener::GetOwner() const {
+  return owner_;
+}
+
+const char* HttpListener::ClassName() const {
+  return "HttpListener";
+}
+
+common::ErrnoError HttpListener::Listen(int backlog) {
+  if (listen(fd_, backlog) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  return common::ErrnoError();
+}
+
+common::ErrnoError HttpListener::Accept(common::net::socket_info* info) {
+  if (!info) {
+    return common::make_errno_error_inval();
+  }
+
+  int fd = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+  if (fd == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  *info = common::net::socket_info(fd);
+  return common::ErrnoError();
+}
+
+common::ErrnoError HttpListener::SingleWrite(const void* data, size_t size, size_t* nwrite_out) {
+  UNUSED(data);
+  UNUSED(size);
+  UNUSED(nwrite_out);
+  return common::make_errno_error("Listening socket can't be written.", EINVAL);
+}
+
+common::ErrnoError HttpListener::SingleRead(void* out, size_t max_size, size_t* nread) {
+  UNUSED(out);
+  UNUSED(max_size);
+  UNUSED(nread);
+  return common::make_errno_error("Listening socket can't be read.", EINVAL);
+}
+
+descriptor_t HttpListener::GetFd() const {
+  return fd_;
+}
+
+common::ErrnoError HttpListener::DoClose() {
+  return common::file_system::close_descriptor(fd_);
+}
+
 HttpServer::HttpServer(const common::net::HostAndPort& host, common::libev::IoLoopObserver* observer)
-    : base_class(host, false, observer) {}
+    : base_class(new common::libev::LibEvLoop, observer), host_(host), listener_(nullptr) {}
 
-common::libev::tcp::TcpClient* HttpServer::CreateClient(const common::net::socket_info& info) {
+HttpServer::~HttpServer() {
+  if (listener_) {
+    common::ErrnoError err = listener_->Close();
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    }
+    delete listener_;
+    listener_ = nullptr;
+  }
+}
+
+common::ErrnoError HttpServer::Bind(bool reuseport) {
+  if (listener_) {
+    return common::make_errno_error("Already binded.", EINVAL);
+  }
+
+  const std::string host_str = host_.GetHost();
+  const std::string port_str = common::ConvertToString(host_.GetPort());
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  struct addrinfo* addrs = nullptr;
+  int res = getaddrinfo(host_str.c_str(), port_str.c_str(), &hints, &addrs);
+  if (res != 0) {
+    return common::make_errno_error(gai_strerror(res), EINVAL);
+  }
+
+  common::ErrnoError err = common::make_errno_error("Can't bind http host: " + host_str + ":" + port_str, EINVAL);
+  for (struct addrinfo* rp = addrs; rp != nullptr; rp = rp->ai_next) {
+    int fd = socket(rp->ai_family, rp->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, rp->ai_protocol);
+    if (fd == INVALID_DESCRIPTOR) {
+      err = common::make_errno_error(errno);
+      continue;
+    }
+
+    int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) == ERROR_RESULT_VALUE ||
+        (reuseport && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == ERROR_RESULT_VALUE) ||
+        ::bind(fd, rp->ai_addr, rp->ai_addrlen) == ERROR_RESULT_VALUE) {
+      err = common::make_errno_error(errno);
+      ::close(fd);
+      continue;
+    }
+
+    listener_ = new HttpListener(this, fd);
+    err = common::ErrnoError();
+    break;
+  }
+
+  freeaddrinfo(addrs);
+  return err;
+}
+
+common::ErrnoError HttpServer::Listen(int backlog) {
+  if (!listener_) {
+    return common::make_errno_error("Not binded.", EINVAL);
+  }
+
+  return listener_->Listen(backlog);
+}
+
+void HttpServer::AcceptClients() {
+  while (true) {
+    common::net::socket_info info;
+    common::ErrnoError err = listener_->Accept(&info);
+    if (err) {
+      if (err->GetErrorCode() != EAGAIN && err->GetErrorCode() != EWOULDBLOCK) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+      }
+      return;
+    }
+
+    common::libev::IoClient* client = CreateClient(info);
+    RegisterClient(client);
+  }
+}
+
+common::net::HostAndPort HttpServer::GetHost() const {
+  return host_;
+}
+
+const char* HttpServer::ClassName() const {
+  return "HttpServer";
+}
+
+common::libev::IoClient* HttpServer::CreateClient(const common::net::socket_info& info) {
   return new HttpClient(this, info);
 }
 
+common::libev::IoChild* HttpServer::CreateChild() {
+  NOTREACHED();
+  return nullptr;
+}
+
+void HttpServer::Started(common::libev::LibEvLoop* loop) {
+  if (listener_) {
+    RegisterClient(listener_);
+  }
+  base_class::Started(loop);
+}
+
+void HttpServer::Stopped(common::libev::LibEvLoop* loop) {
+  if (listener_) {
+    HttpListener* listener = listener_;
+    listener_ = nullptr;
+    common::ErrnoError err = listener->Close();
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    }
+    delete listener;
+  }
+  base_class::Stopped(loop);
+}
+
 }  // namespace server
 }  // namespace iptv_cloud
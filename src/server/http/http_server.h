@@ -14,18 +14,69 @@
 
 #pragma once
 
-#include <common/libev/http/http_server.h>
+#include <common/libev/io_client.h>
+#include <common/libev/io_loop.h>
+#include <common/net/types.h>
 
 namespace iptv_cloud {
 namespace server {
 
-class HttpServer : public common::libev::http::HttpServer {
+class HttpServer;
+
+// listening socket of http worker, readable when clients are pending
+class HttpListener : public common::libev::IoClient {
+ public:
+  typedef common::libev::IoClient base_class;
+
+  HttpListener(HttpServer* server, descriptor_t fd);
+  ~HttpListener() override;
+
+  HttpServer* GetOwner() const;
+  const char* ClassName() const override;
+
+  common::ErrnoError Listen(int backlog) WARN_UNUSED_RESULT;
+  common::ErrnoError Accept(common::net::socket_info* info) WARN_UNUSED_RESULT;
+
+ protected:
+  common::ErrnoError SingleWrite(const void* data, size_t size, size_t* nwrite_out) override;
+  common::ErrnoError SingleRead(void* out, size_t max_size, size_t* nread) override;
+
+  descriptor_t GetFd() const override;
+
+ private:
+  common::ErrnoError DoClose() override;
+
+  HttpServer* const owner_;
+  descriptor_t fd_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpListener);
+};
+
+// http worker loop, several workers can listen same host because of SO_REUSEPORT
+class HttpServer : public common::libev::IoLoop {
  public:
-  typedef common::libev::http::HttpServer base_class;
+  typedef common::libev::IoLoop base_class;
   explicit HttpServer(const common::net::HostAndPort& host, common::libev::IoLoopObserver* observer = nullptr);
+  ~HttpServer() override;
+
+  common::ErrnoError Bind(bool reuseport) WARN_UNUSED_RESULT;
+  common::ErrnoError Listen(int backlog) WARN_UNUSED_RESULT;
+
+  void AcceptClients();
+
+  common::net::HostAndPort GetHost() const;
+  const char* ClassName() const override;
+
+ protected:
+  common::libev::IoClient* CreateClient(const common::net::socket_info& info) override;
+  common::libev::IoChild* CreateChild() override;
+
+  void Started(common::libev::LibEvLoop* loop) override;
+  void Stopped(common::libev::LibEvLoop* loop) override;
 
  private:
-  common::libev::tcp::TcpClient* CreateClient(const common::net::socket_info& info) override;
+  const common::net::HostAndPort host_;
+  HttpListener* listener_;
 };
 
 }  // namespace server
@@ -0,0 +1,162 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/http/inotify_client.h"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <common/file_system/file_system.h>
+
+// hlssink writes playlists through rename and segments in place, old segments are deleted
+#define WATCH_MASK (IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF)
+
+namespace iptv_cloud {
+namespace server {
+
+InotifyClient::InotifyClient(common::libev::IoLoop* server, descriptor_t fd)
+    : base_class(server), fd_(fd), watches_(), watched_dirs_() {}
+
+InotifyClient::~InotifyClient() {}
+
+const char* InotifyClient::ClassName() const {
+  return "InotifyClient";
+}
+
+common::ErrnoError InotifyClient::AddDirectoryWatch(const std::string& dir_path) {
+  if (dir_path.empty() || dir_path.back() != '/') {
+    return common::make_errno_error_inval();
+  }
+
+  if (watched_dirs_.find(dir_path) != watched_dirs_.end()) {
+    return common::ErrnoError();
+  }
+
+  int wd = inotify_add_watch(fd_, dir_path.c_str(), WATCH_MASK);
+  if (wd == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  watches_[wd] = dir_path;
+  watched_dirs_[dir_path] = wd;
+  return common::ErrnoError();
+}
+
+common::ErrnoError InotifyClient::ReadChanges(std::vector<std::string>* changed_files,
+                                              std::vector<std::string>* removed_dirs,
+                                              bool* overflowed) {
+  if (!changed_files || !removed_dirs || !overflowed) {
+    return common::make_errno_error_inval();
+  }
+
+  *overflowed = false;
+
+  char buff[BUF_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+  while (true) {
+    size_t nread = 0;
+    common::ErrnoError err = SingleRead(buff, BUF_SIZE, &nread);
+    if (err) {
+      if (err->GetErrorCode() == EAGAIN) {
+        return common::ErrnoError();
+      }
+      return err;
+    }
+
+    if (nread == 0) {
+      return common::ErrnoError();
+    }
+
+    for (char* ptr = buff; ptr < buff + nread;) {
+      const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+      ptr += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {  // wd is -1
+        if (!*overflowed) {
+          *overflowed = true;
+          RearmWatches(removed_dirs);
+        }
+        continue;
+      }
+
+      auto it = watches_.find(event->wd);
+      if (it == watches_.end()) {
+        continue;
+      }
+
+      const std::string dir_path = it->second;
+      if (event->mask & (IN_DELETE_SELF | IN_IGNORED)) {
+        removed_dirs->push_back(dir_path);
+        watched_dirs_.erase(dir_path);
+        watches_.erase(it);
+        continue;
+      }
+
+      if (event->len) {
+        changed_files->push_back(dir_path + event->name);
+      }
+    }
+  }
+
+  return common::ErrnoError();
+}
+
+void InotifyClient::RearmWatches(std::vector<std::string>* removed_dirs) {
+  for (auto it = watched_dirs_.begin(); it != watched_dirs_.end();) {
+    // same wd is returned for directory which is still watched
+    int wd = inotify_add_watch(fd_, it->first.c_str(), WATCH_MASK);
+    if (wd == ERROR_RESULT_VALUE) {
+      removed_dirs->push_back(it->first);
+      watches_.erase(it->second);
+      it = watched_dirs_.erase(it);
+      continue;
+    }
+
+    if (wd != it->second) {
+      watches_.erase(it->second);
+      watches_[wd] = it->first;
+      it->second = wd;
+    }
+    ++it;
+  }
+}
+
+common::ErrnoError InotifyClient::SingleWrite(const void* data, size_t size, size_t* nwrite_out) {
+  UNUSED(data);
+  UNUSED(size);
+  UNUSED(nwrite_out);
+  return common::make_errno_error("Inotify descriptor is read only.", EINVAL);
+}
+
+common::ErrnoError InotifyClient::SingleRead(void* out, size_t max_size, size_t* nread) {
+  ssize_t res = ::read(fd_, out, max_size);
+  if (res == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  *nread = res;
+  return common::ErrnoError();
+}
+
+descriptor_t InotifyClient::GetFd() const {
+  return fd_;
+}
+
+common::ErrnoError InotifyClient::DoClose() {
+  watches_.clear();
+  watched_dirs_.clear();
+  return common::file_system::close_descriptor(fd_);
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,64 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common/libev/io_client.h>
+
+namespace iptv_cloud {
+namespace server {
+
+// watches http directories, used to invalidate cached files when hlssink rewrites them
+class InotifyClient : public common::libev::IoClient {
+ public:
+  typedef common::libev::IoClient base_class;
+  enum { BUF_SIZE = 4096 };
+
+  InotifyClient(common::libev::IoLoop* server, descriptor_t fd);
+  ~InotifyClient() override;
+
+  const char* ClassName() const override;
+
+  // dir_path should ends with '/', changed files reported as dir_path + file name
+  common::ErrnoError AddDirectoryWatch(const std::string& dir_path) WARN_UNUSED_RESULT;
+  // overflowed: kernel queue overflowed and events were lost, any watched file could be changed,
+  // watches are re-armed then
+  common::ErrnoError ReadChanges(std::vector<std::string>* changed_files,
+                                 std::vector<std::string>* removed_dirs,
+                                 bool* overflowed) WARN_UNUSED_RESULT;
+
+ protected:
+  common::ErrnoError SingleWrite(const void* data, size_t size, size_t* nwrite_out) override;
+  common::ErrnoError SingleRead(void* out, size_t max_size, size_t* nread) override;
+
+  descriptor_t GetFd() const override;
+
+ private:
+  common::ErrnoError DoClose() override;
+
+  void RearmWatches(std::vector<std::string>* removed_dirs);
+
+  descriptor_t fd_;
+  std::map<int, std::string> watches_;  // wd => dir path
+  std::map<std::string, int> watched_dirs_;
+
+  DISALLOW_COPY_AND_ASSIGN(InotifyClient);
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
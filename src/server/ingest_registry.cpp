@@ -0,0 +1,138 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ingest_registry.h"
+
+#include <stdint.h>
+
+#include <common/sprintf.h>
+
+#define INGEST_ID_PREFIX "ingest_"
+#define INGEST_SOCKET_EXT ".sock"
+
+namespace iptv_cloud {
+namespace server {
+
+IngestRegistry::IngestRegistry(const std::string& sockets_dir)
+    : sockets_dir_(sockets_dir), ingests_(), ids_(), consumers_() {}
+
+stream_id_t IngestRegistry::MakeIngestID(const std::string& input) {
+  uint64_t hash = 14695981039346656037ULL;  // fnv-1a, the same on every daemon restart
+  for (unsigned char c : input) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return common::MemSPrintf(INGEST_ID_PREFIX "%016llx", static_cast<unsigned long long>(hash));
+}
+
+IngestRegistry::Ingest* IngestRegistry::Acquire(const std::string& input, const stream_id_t& consumer, bool* spawn) {
+  if (input.empty() || consumer.empty() || !spawn) {
+    return nullptr;
+  }
+
+  auto cit = consumers_.find(consumer);
+  if (cit != consumers_.end() && cit->second != input) {
+    return nullptr;
+  }
+
+  auto it = ingests_.find(input);
+  if (it == ingests_.end()) {
+    Ingest ingest;
+    ingest.id = MakeIngestID(input);
+    ingest.input = input;
+    ingest.socket_path = sockets_dir_ + "/" + ingest.id + INGEST_SOCKET_EXT;
+    ingest.running = false;
+    it = ingests_.insert(std::make_pair(input, ingest)).first;
+    ids_[ingest.id] = input;
+  }
+
+  Ingest* ingest = &it->second;
+  ingest->consumers.insert(consumer);
+  consumers_[consumer] = input;
+  *spawn = !ingest->running;
+  ingest->running = true;
+  return ingest;
+}
+
+IngestRegistry::Ingest* IngestRegistry::Release(const stream_id_t& consumer) {
+  auto cit = consumers_.find(consumer);
+  if (cit == consumers_.end()) {
+    return nullptr;
+  }
+
+  auto it = ingests_.find(cit->second);
+  consumers_.erase(cit);
+  if (it == ingests_.end()) {
+    return nullptr;
+  }
+
+  Ingest* ingest = &it->second;
+  ingest->consumers.erase(consumer);
+  if (!ingest->consumers.empty()) {
+    return nullptr;
+  }
+
+  if (!ingest->running) {
+    Erase(it);
+    return nullptr;
+  }
+  return ingest;
+}
+
+IngestRegistry::Ingest* IngestRegistry::SetStopped(const stream_id_t& ingest_id) {
+  auto iit = ids_.find(ingest_id);
+  if (iit == ids_.end()) {
+    return nullptr;
+  }
+
+  auto it = ingests_.find(iit->second);
+  if (it == ingests_.end()) {
+    return nullptr;
+  }
+
+  Ingest* ingest = &it->second;
+  if (ingest->consumers.empty()) {
+    Erase(it);
+    return nullptr;
+  }
+
+  ingest->running = true;  // caller starts it again
+  return ingest;
+}
+
+IngestRegistry::Ingest* IngestRegistry::FindByID(const stream_id_t& ingest_id) {
+  auto iit = ids_.find(ingest_id);
+  if (iit == ids_.end()) {
+    return nullptr;
+  }
+
+  auto it = ingests_.find(iit->second);
+  if (it == ingests_.end()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+size_t IngestRegistry::Size() const {
+  return ingests_.size();
+}
+
+void IngestRegistry::Erase(ingests_t::iterator it) {
+  ids_.erase(it->second.id);
+  ingests_.erase(it);
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,70 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include <common/macros.h>
+
+#include "base/types.h"
+
+namespace iptv_cloud {
+namespace server {
+
+// streams with the same input share one ingest process, it owns the source and publishes it over shared memory,
+// started for the first consumer and stopped after the last one, loop thread only
+class IngestRegistry {
+ public:
+  struct Ingest {
+    stream_id_t id;
+    std::string input;        // input url, registry key
+    std::string socket_path;  // control socket of shared memory
+    std::string config;       // json config of ingest stream, set by owner before start
+    std::set<stream_id_t> consumers;
+    bool running;
+  };
+
+  explicit IngestRegistry(const std::string& sockets_dir);
+
+  // stable id of ingest for input url
+  static stream_id_t MakeIngestID(const std::string& input);
+
+  // consumer attached to ingest of input, spawn is true if ingest process should be started now
+  Ingest* Acquire(const std::string& input, const stream_id_t& consumer, bool* spawn);
+  // returns ingest left without consumers, it should be stopped
+  Ingest* Release(const stream_id_t& consumer);
+  // ingest process exited, returns ingest still needed by consumers, it should be started again
+  Ingest* SetStopped(const stream_id_t& ingest_id);
+
+  Ingest* FindByID(const stream_id_t& ingest_id);
+  size_t Size() const;
+
+ private:
+  typedef std::unordered_map<std::string, Ingest> ingests_t;  // input url => ingest
+
+  void Erase(ingests_t::iterator it);
+
+  const std::string sockets_dir_;
+  ingests_t ingests_;
+  std::unordered_map<stream_id_t, std::string> ids_;        // ingest id => input url
+  std::unordered_map<stream_id_t, std::string> consumers_;  // consumer id => input url
+
+  DISALLOW_COPY_AND_ASSIGN(IngestRegistry);
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,351 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/metrics_registry.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "base/channel_stats.h"
+
+#include "server/http/http_cache.h"
+#include "server/http/http_handler.h"
+
+#include "stream_commands_info/statistic_info.h"
+
+#include "utils/utils.h"
+
+#define METRICS_PREFIX "iptv_cloud_"
+
+namespace {
+
+std::string EscapeLabel(const std::string& value) {
+  std::string result;
+  result.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      result += '\\';
+      result += c;
+    } else if (c == '\n') {
+      result += "\\n";
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+void AddHeader(std::string* out, const char* name, const char* type, const char* help) {
+  out->append("# HELP " METRICS_PREFIX).append(name).append(" ").append(help).append("\n");
+  out->append("# TYPE " METRICS_PREFIX).append(name).append(" ").append(type).append("\n");
+}
+
+void AddValue(std::string* out, const char* name, const std::string& labels, uint64_t value) {
+  char buff[32];
+  snprintf(buff, sizeof(buff), "%" PRIu64, value);
+  out->append(METRICS_PREFIX).append(name);
+  if (!labels.empty()) {
+    out->append("{").append(labels).append("}");
+  }
+  out->append(" ").append(buff).append("\n");
+}
+
+void AddValue(std::string* out, const char* name, const std::string& labels, double value) {
+  char buff[32];
+  snprintf(buff, sizeof(buff), "%.6g", value);
+  out->append(METRICS_PREFIX).append(name);
+  if (!labels.empty()) {
+    out->append("{").append(labels).append("}");
+  }
+  out->append(" ").append(buff).append("\n");
+}
+
+std::string StreamLabels(const iptv_cloud::server::StreamMetrics& stream) {
+  return "id=\"" + EscapeLabel(stream.id) + "\",type=\"" + std::to_string(stream.type) + "\"";
+}
+
+std::string ChannelLabels(const iptv_cloud::server::StreamMetrics& stream,
+                          const iptv_cloud::server::ChannelMetrics& channel) {
+  return "id=\"" + EscapeLabel(stream.id) + "\",channel=\"" + std::to_string(channel.id) + "\"";
+}
+
+std::vector<iptv_cloud::server::ChannelMetrics> MakeChannelsMetrics(
+    const std::vector<iptv_cloud::ChannelStats*>& channels) {
+  std::vector<iptv_cloud::server::ChannelMetrics> result;
+  for (const iptv_cloud::ChannelStats* stats : channels) {
+    iptv_cloud::server::ChannelMetrics channel;
+    channel.id = stats->GetID();
+    channel.total_bytes = stats->GetTotalBytes();
+    channel.total_packets = stats->GetTotalPackets();
+    channel.bps = stats->GetBps();
+    result.push_back(channel);
+  }
+  return result;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace server {
+
+ChannelMetrics::ChannelMetrics() : id(0), total_bytes(0), total_packets(0), bps(0) {}
+
+StreamMetrics::StreamMetrics()
+    : id(),
+      type(RELAY),
+      status(NEW),
+      restarts(0),
+      start_time(0),
+      loop_start_time(0),
+      cpu_load(0),
+      rss(0),
+      timestamp(0),
+      first_output(0),
+      input(),
+      output() {}
+
+MetricsRegistry::MetricsRegistry(const HttpCache* cache)
+    : cache_(cache), workers_(), streams_mutex_(), streams_(), startup_stats_() {}
+
+void MetricsRegistry::AddHttpWorker(const HttpHandler* handler) {
+  workers_.push_back(handler);
+}
+
+void MetricsRegistry::UpdateStream(const StatisticInfo& stat) {
+  StatisticInfo::stream_struct_t str = stat.GetStreamStruct();
+  if (!str) {
+    return;
+  }
+
+  StreamMetrics stream;
+  stream.id = str->id;
+  stream.type = str->type;
+  stream.status = str->status;
+  stream.restarts = str->restarts;
+  stream.start_time = str->start_time;
+  stream.loop_start_time = str->loop_start_time;
+  stream.cpu_load = stat.GetCpuLoad();
+  stream.rss = stat.GetRss();
+  stream.timestamp = stat.GetTimestamp();
+  stream.first_output = stat.GetFirstOutput();
+  stream.input = MakeChannelsMetrics(str->input);
+  stream.output = MakeChannelsMetrics(str->output);
+  UpdateStream(stream);
+}
+
+void MetricsRegistry::UpdateStream(const StreamMetrics& stream) {
+  std::unique_lock<std::mutex> lock(streams_mutex_);
+  streams_[stream.id] = stream;
+}
+
+void MetricsRegistry::RemoveStream(stream_id_t sid) {
+  std::unique_lock<std::mutex> lock(streams_mutex_);
+  streams_.erase(sid);
+}
+
+void MetricsRegistry::SetStartupStats(const StreamsStartupStats& stats) {
+  std::unique_lock<std::mutex> lock(streams_mutex_);
+  startup_stats_ = stats;
+}
+
+std::string MetricsRegistry::Render() const {
+  std::string out;
+  out.reserve(16384);
+  RenderNode(&out);
+  RenderStreams(&out);
+  RenderHttp(&out);
+  return out;
+}
+
+void MetricsRegistry::RenderNode(std::string* out) const {
+  static const long clk_tck = sysconf(_SC_CLK_TCK);
+  const double ticks = clk_tck > 0 ? clk_tck : 100;
+
+  const utils::CpuShot cpu = utils::GetMachineCpuShot();
+  AddHeader(out, "node_cpu_seconds_total", "counter", "Seconds the cpus spent in each mode.");
+  AddValue(out, "node_cpu_seconds_total", "mode=\"user\"", cpu.user / ticks);
+  AddValue(out, "node_cpu_seconds_total", "mode=\"nice\"", cpu.nice / ticks);
+  AddValue(out, "node_cpu_seconds_total", "mode=\"system\"", cpu.system / ticks);
+  AddValue(out, "node_cpu_seconds_total", "mode=\"idle\"", cpu.idle / ticks);
+  AddValue(out, "node_cpu_seconds_total", "mode=\"iowait\"", cpu.iowait / ticks);
+  AddValue(out, "node_cpu_seconds_total", "mode=\"irq\"", cpu.irq / ticks);
+  AddValue(out, "node_cpu_seconds_total", "mode=\"softirq\"", cpu.softirq / ticks);
+  AddValue(out, "node_cpu_seconds_total", "mode=\"steal\"", cpu.steal / ticks);
+
+  const utils::MemoryShot mem = utils::GetMachineMemoryShot();
+  AddHeader(out, "node_memory_total_bytes", "gauge", "Total memory.");
+  AddValue(out, "node_memory_total_bytes", std::string(), mem.total_ram * 1024);
+  AddHeader(out, "node_memory_free_bytes", "gauge", "Free memory.");
+  AddValue(out, "node_memory_free_bytes", std::string(), mem.free_ram * 1024);
+  AddHeader(out, "node_memory_available_bytes", "gauge", "Available memory.");
+  AddValue(out, "node_memory_available_bytes", std::string(), mem.avail_ram * 1024);
+
+  const utils::NetShot net = utils::GetMachineNetShot();
+  AddHeader(out, "node_network_receive_bytes_total", "counter", "Received bytes, all interfaces except loopback.");
+  AddValue(out, "node_network_receive_bytes_total", std::string(), net.bytes_recv);
+  AddHeader(out, "node_network_transmit_bytes_total", "counter", "Sent bytes, all interfaces except loopback.");
+  AddValue(out, "node_network_transmit_bytes_total", std::string(), net.bytes_send);
+
+  const utils::SysinfoShot sys = utils::GetMachineSysinfoShot();
+  AddHeader(out, "node_load", "gauge", "Load average.");
+  AddValue(out, "node_load", "period=\"1m\"", sys.loads[0] / 65536.0);
+  AddValue(out, "node_load", "period=\"5m\"", sys.loads[1] / 65536.0);
+  AddValue(out, "node_load", "period=\"15m\"", sys.loads[2] / 65536.0);
+  AddHeader(out, "node_uptime_seconds", "gauge", "Node uptime.");
+  AddValue(out, "node_uptime_seconds", std::string(), static_cast<uint64_t>(sys.uptime));
+}
+
+void MetricsRegistry::RenderStreams(std::string* out) const {
+  std::map<stream_id_t, StreamMetrics> streams;
+  StreamsStartupStats startup;
+  {
+    std::unique_lock<std::mutex> lock(streams_mutex_);
+    streams = streams_;
+    startup = startup_stats_;
+  }
+
+  AddHeader(out, "stream_startups_total", "counter", "Stream processes started, by fork from daemon or by zygote.");
+  AddValue(out, "stream_startups_total", "mode=\"fork\"", startup.fork_starts);
+  AddValue(out, "stream_startups_total", "mode=\"zygote\"", startup.zygote_starts);
+  AddHeader(out, "stream_startup_latency_seconds_sum", "counter", "Sum of times from spawn to initialized stream.");
+  AddValue(out, "stream_startup_latency_seconds_sum", "mode=\"fork\"", startup.fork_latency_msec / 1000.0);
+  AddValue(out, "stream_startup_latency_seconds_sum", "mode=\"zygote\"", startup.zygote_latency_msec / 1000.0);
+
+  AddHeader(out, "stream_status", "gauge",
+            "Stream status: 0 new, 1 init, 2 started, 3 ready, 4 playing, 5 frozen, 6 waiting.");
+  for (const auto& it : streams) {
+    AddValue(out, "stream_status", StreamLabels(it.second), static_cast<uint64_t>(it.second.status));
+  }
+
+  AddHeader(out, "stream_restarts_total", "counter", "Stream restarts.");
+  for (const auto& it : streams) {
+    AddValue(out, "stream_restarts_total", StreamLabels(it.second), static_cast<uint64_t>(it.second.restarts));
+  }
+
+  AddHeader(out, "stream_start_time_seconds", "gauge", "Stream start time since epoch.");
+  for (const auto& it : streams) {
+    AddValue(out, "stream_start_time_seconds", StreamLabels(it.second), static_cast<uint64_t>(it.second.start_time));
+  }
+
+  AddHeader(out, "stream_first_output_seconds", "gauge", "Time from pipeline start to first output buffer.");
+  for (const auto& it : streams) {
+    AddValue(out, "stream_first_output_seconds", StreamLabels(it.second), it.second.first_output / 1000.0);
+  }
+
+  AddHeader(out, "stream_cpu_load", "gauge", "Stream process cpu load.");
+  for (const auto& it : streams) {
+    AddValue(out, "stream_cpu_load", StreamLabels(it.second), it.second.cpu_load);
+  }
+
+  AddHeader(out, "stream_rss_bytes", "gauge", "Stream process resident memory.");
+  for (const auto& it : streams) {
+    AddValue(out, "stream_rss_bytes", StreamLabels(it.second), static_cast<uint64_t>(it.second.rss));
+  }
+
+  AddHeader(out, "stream_last_report_seconds", "gauge", "Time of last stream statistic since epoch.");
+  for (const auto& it : streams) {
+    AddValue(out, "stream_last_report_seconds", StreamLabels(it.second), static_cast<uint64_t>(it.second.timestamp));
+  }
+
+  AddHeader(out, "stream_input_bytes_total", "counter", "Bytes received by stream input.");
+  for (const auto& it : streams) {
+    for (const ChannelMetrics& channel : it.second.input) {
+      AddValue(out, "stream_input_bytes_total", ChannelLabels(it.second, channel), channel.total_bytes);
+    }
+  }
+
+  AddHeader(out, "stream_input_packets_total", "counter", "Buffers received by stream input.");
+  for (const auto& it : streams) {
+    for (const ChannelMetrics& channel : it.second.input) {
+      AddValue(out, "stream_input_packets_total", ChannelLabels(it.second, channel), channel.total_packets);
+    }
+  }
+
+  AddHeader(out, "stream_input_bytes_per_second", "gauge", "Stream input bandwidth.");
+  for (const auto& it : streams) {
+    for (const ChannelMetrics& channel : it.second.input) {
+      AddValue(out, "stream_input_bytes_per_second", ChannelLabels(it.second, channel), channel.bps);
+    }
+  }
+
+  AddHeader(out, "stream_output_bytes_total", "counter", "Bytes sent by stream output.");
+  for (const auto& it : streams) {
+    for (const ChannelMetrics& channel : it.second.output) {
+      AddValue(out, "stream_output_bytes_total", ChannelLabels(it.second, channel), channel.total_bytes);
+    }
+  }
+
+  AddHeader(out, "stream_output_packets_total", "counter", "Buffers sent by stream output.");
+  for (const auto& it : streams) {
+    for (const ChannelMetrics& channel : it.second.output) {
+      AddValue(out, "stream_output_packets_total", ChannelLabels(it.second, channel), channel.total_packets);
+    }
+  }
+
+  AddHeader(out, "stream_output_bytes_per_second", "gauge", "Stream output bandwidth.");
+  for (const auto& it : streams) {
+    for (const ChannelMetrics& channel : it.second.output) {
+      AddValue(out, "stream_output_bytes_per_second", ChannelLabels(it.second, channel), channel.bps);
+    }
+  }
+}
+
+void MetricsRegistry::RenderHttp(std::string* out) const {
+  std::vector<HttpWorkerStats> workers;
+  for (const HttpHandler* handler : workers_) {
+    workers.push_back(handler->GetWorkerStats());
+  }
+
+  AddHeader(out, "http_connections_total", "counter", "Accepted http connections.");
+  for (size_t i = 0; i < workers.size(); ++i) {
+    AddValue(out, "http_connections_total", "worker=\"" + std::to_string(i) + "\"", workers[i].connections);
+  }
+
+  AddHeader(out, "http_active_connections", "gauge", "Open http connections.");
+  for (size_t i = 0; i < workers.size(); ++i) {
+    AddValue(out, "http_active_connections", "worker=\"" + std::to_string(i) + "\"", workers[i].active_connections);
+  }
+
+  AddHeader(out, "http_requests_total", "counter", "Http requests.");
+  for (size_t i = 0; i < workers.size(); ++i) {
+    AddValue(out, "http_requests_total", "worker=\"" + std::to_string(i) + "\"", workers[i].requests);
+  }
+
+  AddHeader(out, "http_sent_bytes_total", "counter", "Http response bodies bytes.");
+  for (size_t i = 0; i < workers.size(); ++i) {
+    AddValue(out, "http_sent_bytes_total", "worker=\"" + std::to_string(i) + "\"", workers[i].bytes_sent);
+  }
+
+  if (!cache_) {
+    return;
+  }
+
+  const HttpCacheStats cache = cache_->GetStats();
+  AddHeader(out, "http_cache_hits_total", "counter", "Http cache hits.");
+  AddValue(out, "http_cache_hits_total", std::string(), cache.hits);
+  AddHeader(out, "http_cache_misses_total", "counter", "Http cache misses.");
+  AddValue(out, "http_cache_misses_total", std::string(), cache.misses);
+  AddHeader(out, "http_cache_evictions_total", "counter", "Http cache evictions.");
+  AddValue(out, "http_cache_evictions_total", std::string(), cache.evictions);
+  AddHeader(out, "http_cache_invalidations_total", "counter", "Http cache invalidations.");
+  AddValue(out, "http_cache_invalidations_total", std::string(), cache.invalidations);
+  AddHeader(out, "http_cache_size_bytes", "gauge", "Http cache size.");
+  AddValue(out, "http_cache_size_bytes", std::string(), cache.size);
+  AddHeader(out, "http_cache_entries", "gauge", "Http cache files.");
+  AddValue(out, "http_cache_entries", std::string(), cache.entries);
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
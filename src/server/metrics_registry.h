@@ -0,0 +1,94 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+
+#include "base/stream_struct.h"
+#include "base/types.h"
+
+#include "server/zygote.h"
+
+namespace iptv_cloud {
+class StatisticInfo;
+namespace server {
+
+class HttpCache;
+class HttpHandler;
+
+struct ChannelMetrics {
+  ChannelMetrics();
+
+  channel_id_t id;
+  uint64_t total_bytes;
+  uint64_t total_packets;
+  uint64_t bps;  // bytes per second
+};
+
+struct StreamMetrics {
+  StreamMetrics();
+
+  stream_id_t id;
+  StreamType type;
+  StreamStatus status;
+  size_t restarts;
+  time_t start_time;
+  time_t loop_start_time;
+  double cpu_load;
+  long rss;
+  time_t timestamp;
+  time_t first_output;  // msec
+  std::vector<ChannelMetrics> input;
+  std::vector<ChannelMetrics> output;
+};
+
+// last known state of node, streams and http delivery, rendered as prometheus text exposition
+class MetricsRegistry {
+ public:
+  explicit MetricsRegistry(const HttpCache* cache);
+
+  // should be registered before http loops started
+  void AddHttpWorker(const HttpHandler* handler);
+
+  void UpdateStream(const StatisticInfo& stat);
+  void UpdateStream(const StreamMetrics& stream);
+  void RemoveStream(stream_id_t sid);
+
+  void SetStartupStats(const StreamsStartupStats& stats);
+
+  std::string Render() const;
+
+ private:
+  void RenderNode(std::string* out) const;
+  void RenderStreams(std::string* out) const;
+  void RenderHttp(std::string* out) const;
+
+  const HttpCache* const cache_;
+  std::vector<const HttpHandler*> workers_;
+
+  mutable std::mutex streams_mutex_;
+  std::map<stream_id_t, StreamMetrics> streams_;
+  StreamsStartupStats startup_stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(MetricsRegistry);
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
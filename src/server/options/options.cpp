@@ -29,6 +29,7 @@
 #include "base/gst_constants.h"
 #include "base/inputs_outputs.h"
 #include "base/logo.h"
+#include "base/rendition.h"
 
 #include "utils/arg_converter.h"
 
@@ -159,6 +160,34 @@ Validity validate_timeshift_chunk_duration(const std::string& value) {
   return validate_is_positive(value, false);
 }
 
+Validity validate_playlist_block_size(const std::string& value) {
+  return validate_range<size_t>(value, MIN_PLAYLIST_BLOCK_SIZE, MAX_PLAYLIST_BLOCK_SIZE, false);
+}
+
+Validity validate_output_queue_max_time(const std::string& value) {
+  return validate_range<int>(value, MIN_OUTPUT_QUEUE_MAX_TIME, MAX_OUTPUT_QUEUE_MAX_TIME, false);
+}
+
+Validity validate_output_queue_max_bytes(const std::string& value) {
+  return validate_range<size_t>(value, MIN_OUTPUT_QUEUE_MAX_BYTES, MAX_OUTPUT_QUEUE_MAX_BYTES, false);
+}
+
+Validity validate_udp_input_rcvbuf(const std::string& value) {
+  return validate_range<int>(value, MIN_UDP_INPUT_RCVBUF, MAX_UDP_INPUT_RCVBUF, false);
+}
+
+Validity validate_udp_input_latency(const std::string& value) {
+  return validate_range<int>(value, MIN_UDP_INPUT_LATENCY, MAX_UDP_INPUT_LATENCY, false);
+}
+
+Validity validate_tcp_client_queue_bytes(const std::string& value) {
+  return validate_range<size_t>(value, MIN_TCP_CLIENT_QUEUE_BYTES, MAX_TCP_CLIENT_QUEUE_BYTES, false);
+}
+
+Validity validate_tcp_client_evict_time(const std::string& value) {
+  return validate_range<int>(value, MIN_TCP_CLIENT_EVICT_TIME, MAX_TCP_CLIENT_EVICT_TIME, false);
+}
+
 Validity validate_auto_exit_time(const std::string& value) {
   return validate_is_positive(value, false);
 }
@@ -173,6 +202,24 @@ Validity validate_logo(const std::string& value) {
   return common::ConvertFromString(value, &logo) ? Validity::VALID : Validity::INVALID;
 }
 
+Validity validate_renditions(const std::string& value) {
+  renditions_t renditions;
+  return common::ConvertFromString(value, &renditions) ? Validity::VALID : Validity::INVALID;
+}
+
+Validity validate_hls_master_playlist(const std::string& value) {
+  static const std::string ext = ".m3u8";
+  if (value.size() <= ext.size() || value.find('/') != std::string::npos) {
+    return Validity::INVALID;
+  }
+
+  return value.compare(value.size() - ext.size(), ext.size(), ext) == 0 ? Validity::VALID : Validity::INVALID;
+}
+
+Validity validate_key_frame_interval(const std::string& value) {
+  return validate_range<int>(value, MIN_KEY_FRAME_INTERVAL, MAX_KEY_FRAME_INTERVAL, false);
+}
+
 Validity validate_framerate(const std::string& value) {
   return validate_is_positive(value, false);
 }
@@ -421,6 +468,20 @@ bool FindOption(const std::string& key, option_t* opt) {
                                                   {LOG_LEVEL_FIELD, validate_log_level},
                                                   {INPUT_FIELD, validate_input},
                                                   {OUTPUT_FIELD, validate_output},
+                                                  {OUTPUT_ISOLATION_FIELD, dont_validate},
+                                                  {OUTPUT_QUEUE_MAX_TIME_FIELD, validate_output_queue_max_time},
+                                                  {OUTPUT_QUEUE_MAX_BYTES_FIELD, validate_output_queue_max_bytes},
+                                                  {OUTPUT_RECONNECT_FIELD, dont_validate},
+                                                  {UDP_BATCH_FIELD, dont_validate},
+                                                  {UDP_INPUT_BATCH_FIELD, dont_validate},
+                                                  {UDP_INPUT_RCVBUF_FIELD, validate_udp_input_rcvbuf},
+                                                  {UDP_INPUT_LATENCY_FIELD, validate_udp_input_latency},
+                                                  {TCP_CLIENTS_FIELD, dont_validate},
+                                                  {TCP_CLIENT_QUEUE_BYTES_FIELD, validate_tcp_client_queue_bytes},
+                                                  {TCP_CLIENT_EVICT_TIME_FIELD, validate_tcp_client_evict_time},
+                                                  {SHARED_INGEST_FIELD, dont_validate},
+                                                  {INGEST_SOCKET_FIELD, dont_validate},
+                                                  {INGEST_PUBLISH_FIELD, dont_validate},
                                                   {RESTART_ATTEMPTS_FIELD, validate_restart_attempts},
                                                   {AUTO_EXIT_TIME_FIELD, validate_auto_exit_time},
                                                   {TIMESHIFT_DIR_FIELD, validate_timeshift_dir},
@@ -433,6 +494,7 @@ bool FindOption(const std::string& key, option_t* opt) {
                                                   {TIMESHIFT_CHUNK_DURATION_FIELD, validate_timeshift_chunk_duration},
                                                   {VIDEO_PARSER_FIELD, validate_video_parser},
                                                   {AUDIO_PARSER_FIELD, validate_audio_parser},
+                                                  {RELAY_FAST_PATH_FIELD, dont_validate},
                                                   {AUDIO_CODEC_FIELD, validate_audio_codec},
                                                   {VIDEO_CODEC_FIELD, validate_video_codec},
                                                   {HAVE_VIDEO_FIELD, dont_validate},
@@ -441,10 +503,14 @@ bool FindOption(const std::string& key, option_t* opt) {
                                                   {RELAY_AUDIO_FIELD, dont_validate},
                                                   {RELAY_VIDEO_FIELD, dont_validate},
                                                   {LOOP_FIELD, dont_validate},
+                                                  {PLAYLIST_BLOCK_SIZE_FIELD, validate_playlist_block_size},
                                                   {SIZE_FIELD, validate_size},
                                                   {LOGO_FIELD, validate_logo},
                                                   {FRAME_RATE_FIELD, validate_framerate},
                                                   {ASPECT_RATIO_FIELD, validate_aspect_ratio},
+                                                  {RENDITIONS_FIELD, validate_renditions},
+                                                  {KEY_FRAME_INTERVAL_FIELD, validate_key_frame_interval},
+                                                  {HLS_MASTER_PLAYLIST_FIELD, validate_hls_master_playlist},
                                                   {VIDEO_BIT_RATE_FIELD, validate_video_bitrate},
                                                   {AUDIO_BIT_RATE_FIELD, validate_audio_bitrate},
                                                   {AUDIO_CHANNELS_FIELD, validate_audio_channels},
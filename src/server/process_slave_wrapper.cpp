@@ -19,11 +19,15 @@
 
 #include <dlfcn.h>
 
+#include <algorithm>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include <json-c/json_object.h>
+#include <json-c/json_tokener.h>
+
 #include <common/file_system/file_system.h>
 #include <common/file_system/string_path_utils.h>
 #include <common/net/http_client.h>
@@ -36,16 +40,21 @@
 #include "base/stream_commands.h"
 
 #include "stream/main_wrapper.h"
+#include "stream/stypes.h"
 
 #include "pipe/pipe_client.h"
 
+#include "protocol/request_parser.h"
+
 #include "server/child_stream.h"
+#include "server/child_streams_registry.h"
 #include "server/commands_info/service/activate_info.h"
 #include "server/commands_info/service/get_log_info.h"
 #include "server/commands_info/service/ping_info.h"
 #include "server/commands_info/service/prepare_info.h"
 #include "server/commands_info/service/server_info.h"
 #include "server/commands_info/service/stop_info.h"
+#include "server/commands_info/service/subscribe_info.h"
 #include "server/commands_info/stream/get_log_info.h"
 #include "server/commands_info/stream/quit_status_info.h"
 #include "server/commands_info/stream/restart_info.h"
@@ -55,8 +64,11 @@
 #include "server/daemon_server.h"
 #include "server/http/http_handler.h"
 #include "server/http/http_server.h"
+#include "server/ingest_registry.h"
+#include "server/metrics_registry.h"
 #include "server/options/options.h"
 #include "server/stream_struct_utils.h"
+#include "server/zygote.h"
 
 #include "stream_commands_info/changed_sources_info.h"
 #include "stream_commands_info/statistic_info.h"
@@ -66,6 +78,8 @@
 #include "utils/arg_converter.h"
 #include "utils/utils.h"
 
+#define INGEST_OUTPUT "{\"urls\":[{\"id\":0,\"uri\":\"" FAKE_URL "\"}]}"  // clients of output 0 - attached streams
+
 namespace {
 
 bool GetHttpHostAndPort(const std::string& host, common::net::HostAndPort* out) {
@@ -239,6 +253,61 @@ common::ErrnoError MakeStreamInfo(const utils::ArgsMap& config_args,
   *sha = lsha;
   return common::ErrnoError();
 }
+
+// ingest stream gets only options of source from its first consumer
+common::ErrnoError MakeIngestConfig(const std::string& consumer_config,
+                                    const stream_id_t& ingest_id,
+                                    const std::string& socket_path,
+                                    const std::string& feedback_dir,
+                                    std::string* ingest_config) {
+  if (!ingest_config) {
+    return common::make_errno_error_inval();
+  }
+
+  json_object* consumer = json_tokener_parse(consumer_config.c_str());
+  if (!consumer) {
+    return common::make_errno_error("Invalid config data.", EINVAL);
+  }
+
+  json_object* ingest = json_object_new_object();
+  json_object_object_add(ingest, ID_FIELD, json_object_new_string(ingest_id.c_str()));
+  json_object_object_add(ingest, TYPE_FIELD, json_object_new_int(RELAY));
+  json_object_object_add(ingest, FEEDBACK_DIR_FIELD, json_object_new_string(feedback_dir.c_str()));
+  json_object_object_add(ingest, OUTPUT_FIELD, json_object_new_string(INGEST_OUTPUT));
+  json_object_object_add(ingest, INGEST_PUBLISH_FIELD, json_object_new_string(socket_path.c_str()));
+  static const char* const source_fields[] = {INPUT_FIELD, LOG_LEVEL_FIELD, UDP_INPUT_BATCH_FIELD,
+                                              UDP_INPUT_RCVBUF_FIELD, UDP_INPUT_LATENCY_FIELD};
+  for (const char* field : source_fields) {
+    json_object* jfield = nullptr;
+    if (json_object_object_get_ex(consumer, field, &jfield)) {
+      json_object_object_add(ingest, field, json_object_get(jfield));
+    }
+  }
+
+  *ingest_config = json_object_to_json_string(ingest);
+  json_object_put(ingest);
+  json_object_put(consumer);
+  return common::ErrnoError();
+}
+
+common::ErrnoError MakeIngestConsumerConfig(const std::string& config,
+                                            const std::string& socket_path,
+                                            std::string* consumer_config) {
+  if (!consumer_config) {
+    return common::make_errno_error_inval();
+  }
+
+  json_object* consumer = json_tokener_parse(config.c_str());
+  if (!consumer) {
+    return common::make_errno_error("Invalid config data.", EINVAL);
+  }
+
+  json_object_object_del(consumer, SHARED_INGEST_FIELD);
+  json_object_object_add(consumer, INGEST_SOCKET_FIELD, json_object_new_string(socket_path.c_str()));
+  *consumer_config = json_object_to_json_string(consumer);
+  json_object_put(consumer);
+  return common::ErrnoError();
+}
 }  // namespace
 namespace server {
 struct ProcessSlaveWrapper::NodeStats {
@@ -256,19 +325,57 @@ ProcessSlaveWrapper::ProcessSlaveWrapper(const std::string& license_key, const C
       process_argc_(0),
       process_argv_(nullptr),
       loop_(),
-      http_server_(),
-      http_handler_(nullptr),
+      streams_registry_(nullptr),
+      ingests_(nullptr),
+      http_cache_(nullptr),
+      metrics_registry_(nullptr),
+      http_servers_(),
+      http_handlers_(),
       id_(0),
       ping_client_id_timer_(INVALID_TIMER_ID),
       node_stats_timer_(INVALID_TIMER_ID),
       cleanup_timer_(INVALID_TIMER_ID),
       node_stats_(new NodeStats),
-      stream_exec_func_(nullptr) {
+      daemon_dispatcher_(this),
+      pipe_dispatcher_(this),
+      stream_exec_func_(nullptr),
+      zygote_(nullptr),
+      startup_stats_() {
   loop_ = new DaemonServer(config.host, this);
   loop_->SetName(config.id);
-
-  http_handler_ = new HttpHandler;
-  http_server_ = new HttpServer(config.http_host, http_handler_);
+  streams_registry_ = new ChildStreamsRegistry;
+  ingests_ = new IngestRegistry(config.ingest_dir);
+
+  daemon_dispatcher_.Register(CLIENT_START_STREAM, &ProcessSlaveWrapper::HandleRequestClientStartStream);
+  daemon_dispatcher_.Register(CLIENT_STOP_STREAM, &ProcessSlaveWrapper::HandleRequestClientStopStream);
+  daemon_dispatcher_.Register(CLIENT_RESTART_STREAM, &ProcessSlaveWrapper::HandleRequestClientRestartStream);
+  daemon_dispatcher_.Register(CLIENT_GET_LOG_STREAM, &ProcessSlaveWrapper::HandleRequestClientGetLogStream);
+  daemon_dispatcher_.Register(CLIENT_PREPARE_SERVICE, &ProcessSlaveWrapper::HandleRequestClientPrepareService);
+  daemon_dispatcher_.Register(CLIENT_STOP_SERVICE, &ProcessSlaveWrapper::HandleRequestClientStopService);
+  daemon_dispatcher_.Register(CLIENT_ACTIVATE, &ProcessSlaveWrapper::HandleRequestClientActivate);
+  daemon_dispatcher_.Register(CLIENT_PING_SERVICE, &ProcessSlaveWrapper::HandleRequestClientPingService);
+  daemon_dispatcher_.Register(CLIENT_GET_LOG_SERVICE, &ProcessSlaveWrapper::HandleRequestClientGetLogService);
+  daemon_dispatcher_.Register(CLIENT_SUBSCRIBE_STATISTIC, &ProcessSlaveWrapper::HandleRequestClientSubscribeStatistic);
+  daemon_dispatcher_.Register(CLIENT_UNSUBSCRIBE_STATISTIC,
+                              &ProcessSlaveWrapper::HandleRequestClientUnsubscribeStatistic);
+
+  pipe_dispatcher_.Register(CHANGED_SOURCES_STREAM, &ProcessSlaveWrapper::HandleRequestChangedSourcesStream);
+
+  size_t http_workers = config.http_workers;
+  if (http_workers == 0) {
+    http_workers = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  http_cache_ = new HttpCache(config.http_cache_size);
+  metrics_registry_ = new MetricsRegistry(http_cache_);
+  for (size_t i = 0; i < http_workers; ++i) {
+    HttpHandler* http_handler = new HttpHandler(http_cache_, metrics_registry_);
+    metrics_registry_->AddHttpWorker(http_handler);
+    HttpServer* http_server = new HttpServer(config.http_host, http_handler);
+    http_server->SetName("http_worker_" + std::to_string(i));
+    http_handlers_.push_back(http_handler);
+    http_servers_.push_back(http_server);
+  }
 }
 
 int ProcessSlaveWrapper::SendStopDaemonRequest(const std::string& license) {
@@ -303,9 +410,15 @@ int ProcessSlaveWrapper::SendStopDaemonRequest(const std::string& license) {
 }
 
 ProcessSlaveWrapper::~ProcessSlaveWrapper() {
-  destroy(&http_server_);
-  destroy(&http_handler_);
+  for (size_t i = 0; i < http_servers_.size(); ++i) {
+    destroy(&http_servers_[i]);
+    destroy(&http_handlers_[i]);
+  }
+  destroy(&metrics_registry_);
+  destroy(&http_cache_);
   destroy(&loop_);
+  destroy(&streams_registry_);
+  destroy(&ingests_);
   destroy(&node_stats_);
 }
 
@@ -330,7 +443,26 @@ int ProcessSlaveWrapper::Exec(int argc, char** argv) {
   process_argc_ = argc;
   process_argv_ = argv;
 
-  std::thread http_thread;
+  if (config_.zygote) {  // should be forked before any threads started
+    stream_preload_t stream_preload_func = reinterpret_cast<stream_preload_t>(dlsym(handle, "stream_preload"));
+    error = dlerror();
+    if (error) {
+      WARNING_LOG() << "Failed to load preload stream function error: " << error;
+    } else {
+      zygote_ = new Zygote(stream_preload_func, [this](const std::string& config, int read_command_client,
+                                                       int write_responce_client, int stats_fd) {
+        return ExecZygoteStream(config, read_command_client, write_responce_client, stats_fd);
+      });
+      common::ErrnoError err = zygote_->Start();
+      if (err) {
+        WARNING_LOG() << "Failed to start zygote, streams will be forked from daemon, error: "
+                      << err->GetDescription();
+        destroy(&zygote_);
+      }
+    }
+  }
+
+  std::vector<std::thread> http_threads;
 
   // gpu statistic monitor
   std::thread perf_thread;
@@ -339,23 +471,25 @@ int ProcessSlaveWrapper::Exec(int argc, char** argv) {
     perf_thread = std::thread([perf_monitor] { perf_monitor->Exec(); });
   }
 
-  HttpServer* http_server = static_cast<HttpServer*>(http_server_);
-  http_thread = std::thread([http_server] {
-    common::ErrnoError err = http_server->Bind(true);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      return;
-    }
+  for (size_t i = 0; i < http_servers_.size(); ++i) {
+    HttpServer* http_server = static_cast<HttpServer*>(http_servers_[i]);
+    http_threads.push_back(std::thread([http_server] {
+      common::ErrnoError err = http_server->Bind(true);  // SO_REUSEPORT, kernel balances connections
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+        return;
+      }
 
-    err = http_server->Listen(5);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      return;
-    }
+      err = http_server->Listen(5);
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+        return;
+      }
 
-    int res = http_server->Exec();
-    UNUSED(res);
-  });
+      int res = http_server->Exec();
+      UNUSED(res);
+    }));
+  }
 
   int res = EXIT_FAILURE;
   DaemonServer* server = static_cast<DaemonServer*>(loop_);
@@ -377,7 +511,9 @@ int ProcessSlaveWrapper::Exec(int argc, char** argv) {
   res = server->Exec();
 
 finished:
-  http_thread.join();
+  for (size_t i = 0; i < http_threads.size(); ++i) {
+    http_threads[i].join();
+  }
   if (perf_monitor) {
     perf_monitor->Stop();
   }
@@ -385,6 +521,7 @@ finished:
     perf_thread.join();
   }
   delete perf_monitor;
+  destroy(&zygote_);
   stream_exec_func_ = nullptr;
   dlclose(handle);
   return res;
@@ -436,10 +573,16 @@ void ProcessSlaveWrapper::TimerEmited(common::libev::IoLoop* server, common::lib
       }
     }
   } else if (node_stats_timer_ == id) {
-    const std::string node_stats = MakeServiceStats(false);
-    BroadcastClients(StatisitcServiceBroadcast(node_stats));
+    const std::vector<ProtocoledDaemonClient*> clients = GetVerifiedClients();
+    for (ProtocoledDaemonClient* dclient : clients) {  // what was left from previous tick
+      FlushStatistic(dclient);
+    }
+    BroadcastServiceStatistic();
+    BroadcastStreamsStatistic();
   } else if (cleanup_timer_ == id) {
-    http_server_->Stop();
+    for (size_t i = 0; i < http_servers_.size(); ++i) {
+      http_servers_[i]->Stop();
+    }
     loop_->Stop();
   }
 }
@@ -473,12 +616,20 @@ void ProcessSlaveWrapper::ChildStatusChanged(common::libev::IoChild* child, int
              << ", signal: " << signal_number;
 
   loop_->UnRegisterChild(child);
+  streams_registry_->Remove(sid);
+  metrics_registry_->RemoveStream(sid);
+  const std::vector<ProtocoledDaemonClient*> clients = GetVerifiedClients();
+  for (ProtocoledDaemonClient* dclient : clients) {
+    dclient->GetSubscription()->RemoveStream(sid);
+  }
 
   StreamStruct* mem = channel->GetMem();
   FreeSharedStreamStruct(&mem);
   DCHECK(!channel->GetClient()) << "In this place client should be nulled.";
   delete channel;
 
+  HandleSharedIngestExit(sid);
+
   std::string quit_json;
   stream::QuitStatusInfo ch_status_info(sid, !stabled_status, signal_number);  // reverse status
   common::Error err_ser = ch_status_info.SerializeToString(&quit_json);
@@ -492,23 +643,26 @@ void ProcessSlaveWrapper::ChildStatusChanged(common::libev::IoChild* child, int
 }
 
 ChildStream* ProcessSlaveWrapper::FindChildByID(stream_id_t cid) const {
-  auto childs = loop_->GetChilds();
-  for (auto* child : childs) {
-    ChildStream* channel = static_cast<ChildStream*>(child);
-    if (channel->GetStreamID() == cid) {
-      return channel;
-    }
+  return streams_registry_->FindByID(cid);
+}
+
+void ProcessSlaveWrapper::BroadcastClients(const protocol::request_t& req) {
+  std::string message;
+  common::Error err = common::protocols::json_rpc::MakeJsonRPCRequest(req, &message);
+  if (err) {
+    WARNING_LOG() << "BroadcastClients error: " << err->GetDescription();
+    return;
   }
 
-  return nullptr;
+  BroadcastClientsMessage(message);
 }
 
-void ProcessSlaveWrapper::BroadcastClients(const protocol::request_t& req) {
+void ProcessSlaveWrapper::BroadcastClientsMessage(const std::string& message) {
   std::vector<common::libev::IoClient*> clients = loop_->GetClients();
   for (size_t i = 0; i < clients.size(); ++i) {
     ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(clients[i]);
     if (dclient && dclient->IsVerified()) {
-      common::ErrnoError err = dclient->WriteRequest(req);
+      common::ErrnoError err = dclient->WriteMessage(message);
       if (err) {
         WARNING_LOG() << "BroadcastClients error: " << err->GetDescription();
       }
@@ -516,6 +670,134 @@ void ProcessSlaveWrapper::BroadcastClients(const protocol::request_t& req) {
   }
 }
 
+void ProcessSlaveWrapper::BroadcastStreamsStatistic() {
+  const time_t now = common::time::current_mstime();
+  auto childs = loop_->GetChilds();
+  for (auto* child : childs) {
+    ChildStream* channel = static_cast<ChildStream*>(child);
+    UpdateStartupStats(channel);
+
+    const stream_id_t sid = channel->GetStreamID();
+    StatisticInfo stat;
+    if (!ReadSharedStatisticInfo(channel->GetMem(), &stat)) {
+      WARNING_LOG() << "Statistic of stream id: " << sid << " is not available now.";
+      continue;
+    }
+
+    metrics_registry_->UpdateStream(stat);
+
+    const std::vector<ProtocoledDaemonClient*> subscribers = GetStreamStatisticSubscribers(sid, now);
+    if (subscribers.empty()) {
+      continue;
+    }
+
+    std::string stream_stats;
+    common::Error err_ser = stat.SerializeToString(&stream_stats);
+    if (err_ser) {
+      const std::string err_str = err_ser->GetDescription();
+      WARNING_LOG() << "Failed to generate stream statistic message: " << err_str;
+      continue;
+    }
+
+    std::string message;
+    err_ser = common::protocols::json_rpc::MakeJsonRPCRequest(StatisitcStreamBroadcast(stream_stats), &message);
+    if (err_ser) {
+      WARNING_LOG() << "Failed to generate stream statistic message: " << err_ser->GetDescription();
+      continue;
+    }
+
+    SendStreamStatistic(subscribers, sid, message, now);
+  }
+}
+
+std::vector<ProtocoledDaemonClient*> ProcessSlaveWrapper::GetVerifiedClients() const {
+  std::vector<ProtocoledDaemonClient*> result;
+  std::vector<common::libev::IoClient*> clients = loop_->GetClients();
+  for (size_t i = 0; i < clients.size(); ++i) {
+    ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(clients[i]);
+    if (dclient && dclient->IsVerified()) {
+      result.push_back(dclient);
+    }
+  }
+  return result;
+}
+
+std::vector<ProtocoledDaemonClient*> ProcessSlaveWrapper::GetStreamStatisticSubscribers(const stream_id_t& sid,
+                                                                                        time_t now) const {
+  std::vector<ProtocoledDaemonClient*> result;
+  const std::vector<ProtocoledDaemonClient*> clients = GetVerifiedClients();
+  for (ProtocoledDaemonClient* dclient : clients) {
+    if (dclient->GetSubscription()->WantsStreamStatistic(sid, now)) {
+      result.push_back(dclient);
+    }
+  }
+  return result;
+}
+
+void ProcessSlaveWrapper::SendStreamStatistic(const std::vector<ProtocoledDaemonClient*>& subscribers,
+                                              const stream_id_t& sid,
+                                              const std::string& message,
+                                              time_t now) {
+  for (ProtocoledDaemonClient* dclient : subscribers) {
+    dclient->GetSubscription()->AddStreamStatistic(sid, message, now);
+    FlushStatistic(dclient);
+  }
+}
+
+void ProcessSlaveWrapper::SendStreamEvent(const stream_id_t& sid, const std::string& message) {
+  const std::vector<ProtocoledDaemonClient*> clients = GetVerifiedClients();
+  for (ProtocoledDaemonClient* dclient : clients) {
+    if (dclient->GetSubscription()->WantsStreamEvent(sid)) {
+      dclient->GetSubscription()->AddStreamEvent(sid, message);
+      FlushStatistic(dclient);
+    }
+  }
+}
+
+void ProcessSlaveWrapper::BroadcastServiceStatistic() {
+  const time_t now = common::time::current_mstime();
+  std::vector<ProtocoledDaemonClient*> subscribers;
+  const std::vector<ProtocoledDaemonClient*> clients = GetVerifiedClients();
+  for (ProtocoledDaemonClient* dclient : clients) {
+    if (dclient->GetSubscription()->WantsServiceStatistic(now)) {
+      subscribers.push_back(dclient);
+    }
+  }
+
+  if (subscribers.empty()) {
+    return;
+  }
+
+  const std::string node_stats = MakeServiceStats(false);
+  std::string message;
+  common::Error err = common::protocols::json_rpc::MakeJsonRPCRequest(StatisitcServiceBroadcast(node_stats), &message);
+  if (err) {
+    WARNING_LOG() << "Failed to generate service statistic message: " << err->GetDescription();
+    return;
+  }
+
+  for (ProtocoledDaemonClient* dclient : subscribers) {
+    dclient->GetSubscription()->AddServiceStatistic(message, now);
+    FlushStatistic(dclient);
+  }
+}
+
+void ProcessSlaveWrapper::FlushStatistic(ProtocoledDaemonClient* dclient) {
+  StatisticSubscription* subscription = dclient->GetSubscription();
+  while (subscription->HasPending()) {
+    const StatisticSubscription::PendingMessage& pending = subscription->FrontPending();
+    if (!dclient->CanWriteWithoutBlocking(pending.message.size())) {
+      return;  // slow client, latest statistic waits for next tick
+    }
+
+    common::ErrnoError err = dclient->WriteMessage(pending.message);
+    if (err) {
+      WARNING_LOG() << "Send statistic error: " << err->GetDescription();
+    }
+    subscription->PopPending();
+  }
+}
+
 common::ErrnoError ProcessSlaveWrapper::DaemonDataReceived(ProtocoledDaemonClient* dclient) {
   CHECK(loop_->IsLoopThread());
   std::string input_command;
@@ -525,6 +807,31 @@ common::ErrnoError ProcessSlaveWrapper::DaemonDataReceived(ProtocoledDaemonClien
                  // protocol
   }
 
+  protocol::MessageHeader header;
+  if (!protocol::PeekMessageHeader(input_command, &header)) {
+    return common::make_errno_error("Invalid json-rpc message.", EAGAIN);
+  }
+
+  if (header.IsRequest()) {
+    protocol::request_t req;
+    json_object* params = nullptr;
+    common::Error err_parse = protocol::ParseRequest(input_command, &req, &params);
+    if (err_parse) {
+      const std::string err_str = err_parse->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    INFO_LOG() << "Received daemon request: " << input_command;
+    err = HandleRequestServiceCommand(dclient, &req, params);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    if (params) {
+      json_object_put(params);
+    }
+    return common::ErrnoError();
+  }
+
   protocol::request_t* req = nullptr;
   protocol::response_t* resp = nullptr;
   common::Error err_parse = common::protocols::json_rpc::ParseJsonRPC(input_command, &req, &resp);
@@ -533,25 +840,18 @@ common::ErrnoError ProcessSlaveWrapper::DaemonDataReceived(ProtocoledDaemonClien
     return common::make_errno_error(err_str, EAGAIN);
   }
 
-  if (req) {
-    INFO_LOG() << "Received daemon request: " << input_command;
-    err = HandleRequestServiceCommand(dclient, req);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-    }
+  if (!resp) {
     delete req;
-  } else if (resp) {
-    INFO_LOG() << "Received daemon responce: " << input_command;
-    err = HandleResponceServiceCommand(dclient, resp);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-    }
-    delete resp;
-  } else {
     NOTREACHED();
     return common::make_errno_error("Invalid command type.", EINVAL);
   }
 
+  INFO_LOG() << "Received daemon responce: " << input_command;
+  err = HandleResponceServiceCommand(dclient, resp);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+  }
+  delete resp;
   return common::ErrnoError();
 }
 
@@ -564,6 +864,61 @@ common::ErrnoError ProcessSlaveWrapper::PipeDataReceived(pipe::ProtocoledPipeCli
                  // protocol
   }
 
+  protocol::MessageHeader header;
+  if (!protocol::PeekMessageHeader(input_command, &header)) {
+    return common::make_errno_error("Invalid json-rpc message.", EAGAIN);
+  }
+
+  if (header.method == STATISTIC_STREAM) {
+    // stream sends the same notification as clients receive (CLIENT_STATISTIC_STREAM) on status changes, relay it
+    // as is to every subscriber without interval, metrics are taken from shared statistic block
+    ChildStream* channel = streams_registry_->FindByClient(pipe_client);
+    if (!channel) {
+      return common::ErrnoError();
+    }
+
+    if (header.IsNotification()) {
+      SendStreamEvent(channel->GetStreamID(), input_command);
+      return common::ErrnoError();
+    }
+
+    // request form carries id, clients get notification with the same params
+    if (header.params.empty()) {
+      return common::make_errno_error_inval();
+    }
+
+    std::string message;
+    common::Error err_ser =
+        common::protocols::json_rpc::MakeJsonRPCRequest(StatisitcStreamBroadcast(header.params), &message);
+    if (err_ser) {
+      const std::string err_str = err_ser->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    SendStreamEvent(channel->GetStreamID(), message);
+    return common::ErrnoError();
+  }
+
+  if (header.IsRequest()) {
+    protocol::request_t req;
+    json_object* params = nullptr;
+    common::Error err_parse = protocol::ParseRequest(input_command, &req, &params);
+    if (err_parse) {
+      const std::string err_str = err_parse->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    INFO_LOG() << "Received stream request: " << input_command;
+    err = HandleRequestStreamsCommand(pipe_client, &req, params);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    if (params) {
+      json_object_put(params);
+    }
+    return common::ErrnoError();
+  }
+
   protocol::request_t* req = nullptr;
   protocol::response_t* resp = nullptr;
   common::Error err_parse = common::protocols::json_rpc::ParseJsonRPC(input_command, &req, &resp);
@@ -572,53 +927,52 @@ common::ErrnoError ProcessSlaveWrapper::PipeDataReceived(pipe::ProtocoledPipeCli
     return common::make_errno_error(err_str, EAGAIN);
   }
 
-  if (req) {
-    INFO_LOG() << "Received stream responce: " << input_command;
-    err = HandleRequestStreamsCommand(pipe_client, req);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-    }
+  if (!resp) {
     delete req;
-  } else if (resp) {
-    INFO_LOG() << "Received stream responce: " << input_command;
-    err = HandleResponceStreamsCommand(pipe_client, resp);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-    }
-    delete resp;
-  } else {
     NOTREACHED();
     return common::make_errno_error("Invalid command type.", EINVAL);
   }
+
+  INFO_LOG() << "Received stream responce: " << input_command;
+  err = HandleResponceStreamsCommand(pipe_client, resp);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+  }
+  delete resp;
   return common::ErrnoError();
 }
 
 void ProcessSlaveWrapper::DataReceived(common::libev::IoClient* client) {
-  if (ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(client)) {
+  pipe::ProtocoledPipeClient* pipe_client = nullptr;
+  if (ChildStream* channel = streams_registry_->FindByClient(client)) {  // most traffic, skip casts
+    pipe_client = static_cast<pipe::ProtocoledPipeClient*>(channel->GetClient());
+  } else if (ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(client)) {
     common::ErrnoError err = DaemonDataReceived(dclient);
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
       dclient->Close();
       delete dclient;
     }
-  } else if (pipe::ProtocoledPipeClient* pipe_client = dynamic_cast<pipe::ProtocoledPipeClient*>(client)) {
-    common::ErrnoError err = PipeDataReceived(pipe_client);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      auto childs = loop_->GetChilds();
-      for (auto* child : childs) {
-        ChildStream* channel = static_cast<ChildStream*>(child);
-        if (pipe_client == channel->GetClient()) {
-          channel->SetClient(nullptr);
-          break;
-        }
-      }
-
-      pipe_client->Close();
-      delete pipe_client;
-    }
+    return;
   } else {
+    pipe_client = dynamic_cast<pipe::ProtocoledPipeClient*>(client);  // stream already finished
+  }
+
+  if (!pipe_client) {
     NOTREACHED();
+    return;
+  }
+
+  common::ErrnoError err = PipeDataReceived(pipe_client);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    ChildStream* channel = streams_registry_->UnBindClient(pipe_client);
+    if (channel) {
+      channel->SetClient(nullptr);
+    }
+
+    pipe_client->Close();
+    delete pipe_client;
   }
 }
 
@@ -639,18 +993,12 @@ void ProcessSlaveWrapper::PostLooped(common::libev::IoLoop* server) {
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopService(ProtocoledDaemonClient* dclient,
-                                                                       protocol::request_t* req) {
+                                                                       protocol::request_t* req,
+                                                                       json_object* params) {
   CHECK(loop_->IsLoopThread());
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jstop = json_tokener_parse(params_ptr);
-    if (!jstop) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     service::StopInfo stop_info;
-    common::Error err_des = stop_info.DeSerialize(jstop);
-    json_object_put(jstop);
+    common::Error err_des = stop_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
@@ -708,10 +1056,8 @@ common::ErrnoError ProcessSlaveWrapper::HandleResponcePingService(ProtocoledDaem
   return common::ErrnoError();
 }
 
-common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const stream::StartInfo& start_info) {
+common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const std::string& config_str) {
   CHECK(loop_->IsLoopThread());
-  const std::string config_str = start_info.GetConfig();
-
   utils::ArgsMap config_args = options::ValidateConfig(config_str);
   StreamInfo sha;
   std::string feedback_dir;
@@ -727,8 +1073,14 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const stream::StartInf
     return common::make_errno_error(common::MemSPrintf("Stream with id: %s exist, skip request.", sha.id), EINVAL);
   }
 
+  bool shared_ingest;
+  if (utils::ArgsGetValue(config_args, SHARED_INGEST_FIELD, &shared_ingest) && shared_ingest) {
+    return CreateSharedIngestConsumer(config_str, config_args, sha);
+  }
+
   StreamStruct* mem = nullptr;
-  err = AllocSharedStreamStruct(sha, &mem);
+  int stats_fd = INVALID_DESCRIPTOR;
+  err = AllocSharedStreamStruct(sha, &mem, &stats_fd);
   if (err) {
     return err;
   }
@@ -737,6 +1089,7 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const stream::StartInf
   int write_requests_client = 0;
   err = CreatePipe(&read_command_client, &write_requests_client);
   if (err) {
+    ::close(stats_fd);
     FreeSharedStreamStruct(&mem);
     return err;
   }
@@ -745,30 +1098,41 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const stream::StartInf
   int write_responce_client = 0;
   err = CreatePipe(&read_responce_client, &write_responce_client);
   if (err) {
+    ::close(stats_fd);
     FreeSharedStreamStruct(&mem);
     return err;
   }
 
+  const time_t spawn_time = common::time::current_mstime();
+  bool by_zygote = false;
+  pid_t pid = 0;
+  if (zygote_ && zygote_->IsRunning()) {
+    err = zygote_->Spawn(config_str, read_command_client, write_responce_client, stats_fd, &pid);
+    if (err) {
+      WARNING_LOG() << "Failed to spawn stream id: " << sha.id << " by zygote, fallback to fork, error: "
+                    << err->GetDescription();
+    } else {
+      by_zygote = true;
+    }
+  }
+
+  if (!by_zygote) {
 #if !defined(TEST)
-  pid_t pid = fork();
+    pid = fork();
 #else
-  pid_t pid = 0;
+    pid = 0;
 #endif
+  }
+
   if (pid == 0) {  // child
-    const struct cmd_args client_args = {feedback_dir.c_str(), logs_level};
-    const std::string new_process_name = common::MemSPrintf(STREAMER_NAME "_%s", sha.id);
-    for (int i = 0; i < process_argc_; ++i) {
-      memset(process_argv_[i], 0, strlen(process_argv_[i]));
+    destroy(&zygote_);  // only own copy of zygote connection
+    common::ErrnoError errn = common::file_system::close_descriptor(stats_fd);  // block already mapped
+    if (errn) {
+      DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
     }
-    const char* new_name = new_process_name.c_str();
-    char* app_name = process_argv_[0];
-    strncpy(app_name, new_name, new_process_name.length());
-    app_name[new_process_name.length()] = 0;
-    prctl(PR_SET_NAME, new_name);
-
 #if !defined(TEST)
     // close not needed pipes
-    common::ErrnoError errn = common::file_system::close_descriptor(read_responce_client);
+    errn = common::file_system::close_descriptor(read_responce_client);
     if (errn) {
       DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
     }
@@ -778,12 +1142,7 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const stream::StartInf
     }
 #endif
 
-    pipe::ProtocoledPipeClient* client =
-        new pipe::ProtocoledPipeClient(nullptr, read_command_client, write_responce_client);
-    client->SetName(sha.id);
-    int res = stream_exec_func_(new_name, &client_args, &config_args, client, mem);
-    client->Close();
-    delete client;
+    int res = ExecStream(config_args, feedback_dir, logs_level, read_command_client, write_responce_client, mem);
     _exit(res);
   } else if (pid < 0) {
     NOTICE_LOG() << "Failed to start children!";
@@ -794,7 +1153,11 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const stream::StartInf
       DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
     }
     errn = common::file_system::close_descriptor(write_responce_client);
-    if (err) {
+    if (errn) {
+      DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+    }
+    errn = common::file_system::close_descriptor(stats_fd);
+    if (errn) {
       DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
     }
 
@@ -802,74 +1165,199 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const stream::StartInf
         new pipe::ProtocoledPipeClient(loop_, read_responce_client, write_requests_client);
     pipe_client->SetName(sha.id);
     loop_->RegisterClient(pipe_client);
-    ChildStream* new_channel = new ChildStream(loop_, mem);
+    ChildStream* new_channel = new ChildStream(loop_, mem, spawn_time, by_zygote);
     new_channel->SetClient(pipe_client);
     loop_->RegisterChild(new_channel, pid);
+    if (!streams_registry_->Add(new_channel) || !streams_registry_->BindClient(pipe_client, new_channel)) {
+      WARNING_LOG() << "Stream id: " << sha.id << " already registered.";
+    }
   }
 
   return common::ErrnoError();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestChangedSourcesStream(pipe::ProtocoledPipeClient* pclient,
-                                                                          protocol::request_t* req) {
-  UNUSED(pclient);
-  CHECK(loop_->IsLoopThread());
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jrequest_changed_sources = json_tokener_parse(params_ptr);
-    if (!jrequest_changed_sources) {
-      return common::make_errno_error_inval();
+common::ErrnoError ProcessSlaveWrapper::CreateSharedIngestConsumer(const std::string& config_str,
+                                                                   const utils::ArgsMap& config_args,
+                                                                   const StreamInfo& sha) {
+  if (sha.type != RELAY && sha.type != ENCODE) {
+    return common::make_errno_error("Shared ingest supported only by relay and encoding streams.", EINVAL);
+  }
+
+  input_t input;
+  if (!read_input(config_args, &input) || input.size() != 1) {
+    return common::make_errno_error("Shared ingest needs single " INPUT_FIELD ".", EINVAL);
+  }
+
+  const std::string input_url = input[0].GetInput().GetUrl();
+  bool spawn = false;
+  IngestRegistry::Ingest* ingest = ingests_->Acquire(input_url, sha.id, &spawn);
+  if (!ingest) {
+    return common::make_errno_error_inval();
+  }
+
+  if (spawn) {
+    const std::string feedback_dir = common::file_system::make_path(config_.ingest_dir, ingest->id);
+    common::ErrnoError err =
+        MakeIngestConfig(config_str, ingest->id, ingest->socket_path, feedback_dir, &ingest->config);
+    if (!err) {
+      INFO_LOG() << "Start ingest id: " << ingest->id << " for input: " << input_url;
+      err = CreateChildStream(ingest->config);
+    }
+    if (err) {
+      const stream_id_t ingest_id = ingest->id;
+      ingests_->Release(sha.id);
+      ingests_->SetStopped(ingest_id);
+      return err;
     }
+  }
 
-    ChangedSouresInfo ch_sources_info;
-    common::Error err_des = ch_sources_info.DeSerialize(jrequest_changed_sources);
-    json_object_put(jrequest_changed_sources);
-    if (err_des) {
-      const std::string err_str = err_des->GetDescription();
-      return common::make_errno_error(err_str, EAGAIN);
+  // consumer started at once, till ingest socket is ready its pipeline restarts as on source errors
+  std::string consumer_config;
+  common::ErrnoError err = MakeIngestConsumerConfig(config_str, ingest->socket_path, &consumer_config);
+  if (!err) {
+    err = CreateChildStream(consumer_config);
+  }
+  if (err) {
+    HandleSharedIngestExit(sha.id);
+    return err;
+  }
+
+  INFO_LOG() << "Stream id: " << sha.id << " attached to ingest id: " << ingest->id
+             << ", streams: " << ingest->consumers.size();
+  return common::ErrnoError();
+}
+
+void ProcessSlaveWrapper::HandleSharedIngestExit(const stream_id_t& sid) {
+  IngestRegistry::Ingest* unused = ingests_->Release(sid);
+  if (unused) {
+    INFO_LOG() << "Stop ingest id: " << unused->id << ", no streams attached.";
+    ChildStream* ingest_stream = FindChildByID(unused->id);
+    if (ingest_stream) {
+      common::ErrnoError err = ingest_stream->SendStop(NextRequestID());
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+      }
+    } else {
+      ingests_->SetStopped(unused->id);
     }
+    return;
+  }
 
-    std::string changed_json;
-    common::Error err_ser = ch_sources_info.SerializeToString(&changed_json);
-    if (err_ser) {
-      const std::string err_str = err_ser->GetDescription();
-      return common::make_errno_error(err_str, EAGAIN);
+  if (cleanup_timer_ != INVALID_TIMER_ID) {  // service stopping, everything goes down
+    ingests_->SetStopped(sid);
+    return;
+  }
+
+  IngestRegistry::Ingest* needed = ingests_->SetStopped(sid);
+  if (needed) {
+    WARNING_LOG() << "Ingest id: " << needed->id << " exited, restart it for " << needed->consumers.size()
+                  << " stream(s).";
+    common::ErrnoError err = CreateChildStream(needed->config);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
     }
+  }
+}
 
-    BroadcastClients(ChangedSourcesStreamBroadcast(changed_json));
-    return common::ErrnoError();
+int ProcessSlaveWrapper::ExecStream(const utils::ArgsMap& config_args,
+                                    const std::string& feedback_dir,
+                                    common::logging::LOG_LEVEL logs_level,
+                                    int read_command_client,
+                                    int write_responce_client,
+                                    StreamStruct* mem) {
+  const struct cmd_args client_args = {feedback_dir.c_str(), logs_level};
+  const std::string new_process_name = common::MemSPrintf(STREAMER_NAME "_%s", mem->id);
+  for (int i = 0; i < process_argc_; ++i) {
+    memset(process_argv_[i], 0, strlen(process_argv_[i]));
+  }
+  const char* new_name = new_process_name.c_str();
+  char* app_name = process_argv_[0];
+  strncpy(app_name, new_name, new_process_name.length());
+  app_name[new_process_name.length()] = 0;
+  prctl(PR_SET_NAME, new_name);
+
+  utils::ArgsMap lconfig_args = config_args;
+  pipe::ProtocoledPipeClient* client =
+      new pipe::ProtocoledPipeClient(nullptr, read_command_client, write_responce_client);
+  client->SetName(mem->id);
+  int res = stream_exec_func_(new_name, &client_args, &lconfig_args, client, mem);
+  client->Close();
+  delete client;
+  return res;
+}
+
+int ProcessSlaveWrapper::ExecZygoteStream(const std::string& config_str,
+                                          int read_command_client,
+                                          int write_responce_client,
+                                          int stats_fd) {
+  utils::ArgsMap config_args = options::ValidateConfig(config_str);
+  StreamInfo sha;
+  std::string feedback_dir;
+  common::logging::LOG_LEVEL logs_level;
+  common::ErrnoError err = MakeStreamInfo(config_args, &sha, &feedback_dir, &logs_level);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    return EXIT_FAILURE;
   }
 
-  return common::make_errno_error_inval();
+  StreamStruct* mem = new StreamStruct(sha);
+  err = AttachSharedStatsBlock(stats_fd, &mem->shared_stats);
+  common::ErrnoError errn = common::file_system::close_descriptor(stats_fd);
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+  }
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    delete mem;
+    return EXIT_FAILURE;
+  }
+
+  int res = ExecStream(config_args, feedback_dir, logs_level, read_command_client, write_responce_client, mem);
+  FreeSharedStreamStruct(&mem);
+  return res;
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestStatisticStream(pipe::ProtocoledPipeClient* pclient,
-                                                                     protocol::request_t* req) {
+void ProcessSlaveWrapper::UpdateStartupStats(ChildStream* channel) {
+  if (channel->IsStartupReported()) {
+    return;
+  }
+
+  StreamStatsSnapshot snapshot;
+  if (!channel->GetMem()->shared_stats->Read(&snapshot) || !snapshot.init_time) {
+    return;
+  }
+
+  const time_t latency = std::max<time_t>(snapshot.init_time - channel->GetSpawnTime(), 0);
+  const bool by_zygote = channel->IsSpawnedByZygote();
+  startup_stats_.Add(by_zygote, latency);
+  metrics_registry_->SetStartupStats(startup_stats_);
+  channel->SetStartupReported();
+  INFO_LOG() << "Stream id: " << channel->GetStreamID() << " started in " << latency << " msec by "
+             << (by_zygote ? "zygote" : "fork");
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestChangedSourcesStream(pipe::ProtocoledPipeClient* pclient,
+                                                                          protocol::request_t* req,
+                                                                          json_object* params) {
   UNUSED(pclient);
+  UNUSED(req);
   CHECK(loop_->IsLoopThread());
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jrequest_stat = json_tokener_parse(params_ptr);
-    if (!jrequest_stat) {
-      return common::make_errno_error_inval();
-    }
-
-    StatisticInfo stat;
-    common::Error err_des = stat.DeSerialize(jrequest_stat);
-    json_object_put(jrequest_stat);
+  if (params) {
+    ChangedSouresInfo ch_sources_info;
+    common::Error err_des = ch_sources_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    std::string stream_stats;
-    common::Error err_ser = stat.SerializeToString(&stream_stats);
+    std::string changed_json;
+    common::Error err_ser = ch_sources_info.SerializeToString(&changed_json);
     if (err_ser) {
       const std::string err_str = err_ser->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    BroadcastClients(StatisitcStreamBroadcast(stream_stats));
+    BroadcastClients(ChangedSourcesStreamBroadcast(changed_json));
     return common::ErrnoError();
   }
 
@@ -877,28 +1365,22 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestStatisticStream(pipe::Proto
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStartStream(ProtocoledDaemonClient* dclient,
-                                                                       protocol::request_t* req) {
+                                                                       protocol::request_t* req,
+                                                                       json_object* params) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->IsVerified()) {
     return common::make_errno_error_inval();
   }
 
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jstart_info = json_tokener_parse(params_ptr);
-    if (!jstart_info) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     stream::StartInfo start_info;
-    common::Error err_des = start_info.DeSerialize(jstart_info);
-    json_object_put(jstart_info);
+    common::Error err_des = start_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    common::ErrnoError err = CreateChildStream(start_info);
+    common::ErrnoError err = CreateChildStream(start_info.GetConfig());
     if (err) {
       protocol::response_t resp = StartStreamResponceFail(req->id, err->GetDescription());
       dclient->WriteResponce(resp);
@@ -919,22 +1401,16 @@ protocol::sequance_id_t ProcessSlaveWrapper::NextRequestID() {
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopStream(ProtocoledDaemonClient* dclient,
-                                                                      protocol::request_t* req) {
+                                                                      protocol::request_t* req,
+                                                                      json_object* params) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->IsVerified()) {
     return common::make_errno_error_inval();
   }
 
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jstop_info = json_tokener_parse(params_ptr);
-    if (!jstop_info) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     stream::StopInfo stop_info;
-    common::Error err_des = stop_info.DeSerialize(jstop_info);
-    json_object_put(jstop_info);
+    common::Error err_des = stop_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
@@ -957,22 +1433,16 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopStream(Protocoled
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientRestartStream(ProtocoledDaemonClient* dclient,
-                                                                         protocol::request_t* req) {
+                                                                         protocol::request_t* req,
+                                                                         json_object* params) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->IsVerified()) {
     return common::make_errno_error_inval();
   }
 
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jrestart_info = json_tokener_parse(params_ptr);
-    if (!jrestart_info) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     stream::RestartInfo restart_info;
-    common::Error err_des = restart_info.DeSerialize(jrestart_info);
-    json_object_put(jrestart_info);
+    common::Error err_des = restart_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
@@ -995,22 +1465,16 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientRestartStream(Protoco
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogStream(ProtocoledDaemonClient* dclient,
-                                                                        protocol::request_t* req) {
+                                                                        protocol::request_t* req,
+                                                                        json_object* params) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->IsVerified()) {
     return common::make_errno_error_inval();
   }
 
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jgetlog_info = json_tokener_parse(params_ptr);
-    if (!jgetlog_info) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     stream::GetLogInfo log_info;
-    common::Error err_des = log_info.DeSerialize(jgetlog_info);
-    json_object_put(jgetlog_info);
+    common::Error err_des = log_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
@@ -1033,29 +1497,26 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogStream(Protocol
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientPrepareService(ProtocoledDaemonClient* dclient,
-                                                                          protocol::request_t* req) {
+                                                                          protocol::request_t* req,
+                                                                          json_object* params) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->IsVerified()) {
     return common::make_errno_error_inval();
   }
 
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jservice_state = json_tokener_parse(params_ptr);
-    if (!jservice_state) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     service::PrepareInfo state_info;
-    common::Error err_des = state_info.DeSerialize(jservice_state);
-    json_object_put(jservice_state);
+    common::Error err_des = state_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
     const auto http_root = HttpHandler::http_directory_path_t(state_info.GetHlsDirectory());
-    static_cast<HttpHandler*>(http_handler_)->SetHttpRoot(http_root);
+    for (size_t i = 0; i < http_servers_.size(); ++i) {
+      HttpHandler* http_handler = static_cast<HttpHandler*>(http_handlers_[i]);
+      http_servers_[i]->ExecInLoopThread([http_handler, http_root] { http_handler->SetHttpRoot(http_root); });
+    }
 
     service::Directories dirs(state_info);
     std::string resp_str = service::MakeDirectoryResponce(dirs);
@@ -1068,18 +1529,12 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientPrepareService(Protoc
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientActivate(ProtocoledDaemonClient* dclient,
-                                                                    protocol::request_t* req) {
+                                                                    protocol::request_t* req,
+                                                                    json_object* params) {
   CHECK(loop_->IsLoopThread());
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jactivate = json_tokener_parse(params_ptr);
-    if (!jactivate) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     service::ActivateInfo activate_info;
-    common::Error err_des = activate_info.DeSerialize(jactivate);
-    json_object_put(jactivate);
+    common::Error err_des = activate_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       protocol::response_t resp = ActivateResponceFail(req->id, err_str);
@@ -1105,22 +1560,16 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientActivate(ProtocoledDa
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientPingService(ProtocoledDaemonClient* dclient,
-                                                                       protocol::request_t* req) {
+                                                                       protocol::request_t* req,
+                                                                       json_object* params) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->IsVerified()) {
     return common::make_errno_error_inval();
   }
 
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jstop = json_tokener_parse(params_ptr);
-    if (!jstop) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     service::ClientPingInfo client_ping_info;
-    common::Error err_des = client_ping_info.DeSerialize(jstop);
-    json_object_put(jstop);
+    common::Error err_des = client_ping_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
@@ -1143,22 +1592,16 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientPingService(Protocole
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogService(ProtocoledDaemonClient* dclient,
-                                                                         protocol::request_t* req) {
+                                                                         protocol::request_t* req,
+                                                                         json_object* params) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->IsVerified()) {
     return common::make_errno_error_inval();
   }
 
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jlog = json_tokener_parse(params_ptr);
-    if (!jlog) {
-      return common::make_errno_error_inval();
-    }
-
+  if (params) {
     service::GetLogInfo get_log_info;
-    common::Error err_des = get_log_info.DeSerialize(jlog);
-    json_object_put(jlog);
+    common::Error err_des = get_log_info.DeSerialize(params);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
@@ -1178,32 +1621,60 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogService(Protoco
   return common::make_errno_error_inval();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestServiceCommand(ProtocoledDaemonClient* dclient,
-                                                                    protocol::request_t* req) {
-  if (req->method == CLIENT_START_STREAM) {
-    return HandleRequestClientStartStream(dclient, req);
-  } else if (req->method == CLIENT_STOP_STREAM) {
-    return HandleRequestClientStopStream(dclient, req);
-  } else if (req->method == CLIENT_RESTART_STREAM) {
-    return HandleRequestClientRestartStream(dclient, req);
-  } else if (req->method == CLIENT_GET_LOG_STREAM) {
-    return HandleRequestClientGetLogStream(dclient, req);
-  } else if (req->method == CLIENT_PREPARE_SERVICE) {
-    return HandleRequestClientPrepareService(dclient, req);
-  } else if (req->method == CLIENT_STOP_SERVICE) {
-    return HandleRequestClientStopService(dclient, req);
-  } else if (req->method == CLIENT_ACTIVATE) {
-    return HandleRequestClientActivate(dclient, req);
-  } else if (req->method == CLIENT_PING_SERVICE) {
-    return HandleRequestClientPingService(dclient, req);
-  } else if (req->method == CLIENT_GET_LOG_SERVICE) {
-    return HandleRequestClientGetLogService(dclient, req);
-  }
-
-  WARNING_LOG() << "Received unknown method: " << req->method;
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientSubscribeStatistic(ProtocoledDaemonClient* dclient,
+                                                                              protocol::request_t* req,
+                                                                              json_object* params) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->IsVerified()) {
+    return common::make_errno_error_inval();
+  }
+
+  if (params) {
+    service::SubscribeInfo subscribe_info;
+    common::Error err_des = subscribe_info.DeSerialize(params);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      protocol::response_t resp = SubscribeStatisticResponceFail(req->id, err_str);
+      dclient->WriteResponce(resp);
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    dclient->GetSubscription()->Subscribe(subscribe_info);
+    protocol::response_t resp = SubscribeStatisticResponceSuccess(req->id);
+    dclient->WriteResponce(resp);
+    return common::ErrnoError();
+  }
+
+  return common::make_errno_error_inval();
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientUnsubscribeStatistic(ProtocoledDaemonClient* dclient,
+                                                                                protocol::request_t* req,
+                                                                                json_object* params) {
+  UNUSED(params);
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->IsVerified()) {
+    return common::make_errno_error_inval();
+  }
+
+  dclient->GetSubscription()->Unsubscribe();
+  protocol::response_t resp = UnsubscribeStatisticResponceSuccess(req->id);
+  dclient->WriteResponce(resp);
   return common::ErrnoError();
 }
 
+common::ErrnoError ProcessSlaveWrapper::HandleRequestServiceCommand(ProtocoledDaemonClient* dclient,
+                                                                    protocol::request_t* req,
+                                                                    json_object* params) {
+  const auto method = daemon_dispatcher_.FindMethod(req->method);
+  if (method == daemon_dispatcher_.invalid_method) {
+    WARNING_LOG() << "Received unknown method: " << req->method;
+    return common::ErrnoError();
+  }
+
+  return daemon_dispatcher_.Dispatch(method, dclient, req, params);
+}
+
 common::ErrnoError ProcessSlaveWrapper::HandleResponceServiceCommand(ProtocoledDaemonClient* dclient,
                                                                      protocol::response_t* resp) {
   CHECK(loop_->IsLoopThread());
@@ -1224,15 +1695,15 @@ common::ErrnoError ProcessSlaveWrapper::HandleResponceServiceCommand(ProtocoledD
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestStreamsCommand(pipe::ProtocoledPipeClient* pclient,
-                                                                    protocol::request_t* req) {
-  if (req->method == CHANGED_SOURCES_STREAM) {
-    return HandleRequestChangedSourcesStream(pclient, req);
-  } else if (req->method == STATISTIC_STREAM) {
-    return HandleRequestStatisticStream(pclient, req);
+                                                                    protocol::request_t* req,
+                                                                    json_object* params) {
+  const auto method = pipe_dispatcher_.FindMethod(req->method);
+  if (method == pipe_dispatcher_.invalid_method) {
+    WARNING_LOG() << "Received unknown command: " << req->method;
+    return common::ErrnoError();
   }
 
-  WARNING_LOG() << "Received unknown command: " << req->method;
-  return common::ErrnoError();
+  return pipe_dispatcher_.Dispatch(method, pclient, req, params);
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleResponceStreamsCommand(pipe::ProtocoledPipeClient* pclient,
@@ -1269,8 +1740,13 @@ std::string ProcessSlaveWrapper::MakeServiceStats(bool full_stat) const {
   }
   node_stats_->timestamp = current_time;
 
+  const HttpCacheStats http_cache = http_cache_->GetStats();
+  std::vector<HttpWorkerStats> http_workers;
+  for (size_t i = 0; i < http_handlers_.size(); ++i) {
+    http_workers.push_back(static_cast<HttpHandler*>(http_handlers_[i])->GetWorkerStats());
+  }
   service::ServerInfo stat(cpu_load * 100, node_stats_->gpu_load, uptime_str, mem_shot, hdd_shot, bytes_recv / ts_diff,
-                           bytes_send / ts_diff, sshot, current_time);
+                           bytes_send / ts_diff, sshot, current_time, http_cache, http_workers);
 
   std::string node_stats;
   if (full_stat) {
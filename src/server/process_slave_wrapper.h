@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/libev/io_loop_observer.h>
 #include <common/net/types.h>
@@ -23,14 +24,26 @@
 #include "protocol/types.h"
 #include "server/commands_info/stream/start_info.h"
 #include "server/config.h"
+#include "server/requests_dispatcher.h"
+#include "server/zygote.h"
+#include "utils/arg_reader.h"
+
+struct json_object;
 
 namespace iptv_cloud {
+struct StreamInfo;
+struct StreamStruct;
 namespace server {
 class ChildStream;
+class ChildStreamsRegistry;
+class IngestRegistry;
 namespace pipe {
 class ProtocoledPipeClient;
 }
 class ProtocoledDaemonClient;
+class HttpCache;
+class MetricsRegistry;
+class Zygote;
 
 class ProcessSlaveWrapper : public common::libev::IoLoopObserver {
  public:
@@ -61,12 +74,14 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver {
   void PostLooped(common::libev::IoLoop* server) override;
 
   virtual common::ErrnoError HandleRequestServiceCommand(ProtocoledDaemonClient* dclient,
-                                                         protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                         protocol::request_t* req,
+                                                         json_object* params) WARN_UNUSED_RESULT;
   virtual common::ErrnoError HandleResponceServiceCommand(ProtocoledDaemonClient* dclient,
                                                           protocol::response_t* resp) WARN_UNUSED_RESULT;
 
   virtual common::ErrnoError HandleRequestStreamsCommand(pipe::ProtocoledPipeClient* pclient,
-                                                         protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                         protocol::request_t* req,
+                                                         json_object* params) WARN_UNUSED_RESULT;
   virtual common::ErrnoError HandleResponceStreamsCommand(pipe::ProtocoledPipeClient* pclient,
                                                           protocol::response_t* resp) WARN_UNUSED_RESULT;
 
@@ -76,44 +91,85 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver {
                                void* config_args,
                                void* command_client,
                                void* mem);
+  typedef int (*stream_preload_t)();
 
   ChildStream* FindChildByID(stream_id_t cid) const;
   void BroadcastClients(const protocol::request_t& req);
+  void BroadcastClientsMessage(const std::string& message);  // serialized notification
+  void BroadcastStreamsStatistic();
+
+  // statistic goes only to subscribed clients, message generated once and only if somebody waits for it
+  std::vector<ProtocoledDaemonClient*> GetVerifiedClients() const;
+  std::vector<ProtocoledDaemonClient*> GetStreamStatisticSubscribers(const stream_id_t& sid, time_t now) const;
+  void SendStreamStatistic(const std::vector<ProtocoledDaemonClient*>& subscribers,
+                           const stream_id_t& sid,
+                           const std::string& message,
+                           time_t now);
+  void SendStreamEvent(const stream_id_t& sid, const std::string& message);  // immediately, no interval
+  void BroadcastServiceStatistic();
+  void FlushStatistic(ProtocoledDaemonClient* dclient);
 
   common::ErrnoError DaemonDataReceived(ProtocoledDaemonClient* dclient) WARN_UNUSED_RESULT;
   common::ErrnoError PipeDataReceived(pipe::ProtocoledPipeClient* pclient) WARN_UNUSED_RESULT;
 
   protocol::sequance_id_t NextRequestID();
 
-  common::ErrnoError CreateChildStream(const stream::StartInfo& start_info);
+  common::ErrnoError CreateChildStream(const std::string& config_str);
+  // first consumer of input starts ingest process, consumer started with shared memory input
+  common::ErrnoError CreateSharedIngestConsumer(const std::string& config_str,
+                                                const utils::ArgsMap& config_args,
+                                                const StreamInfo& sha);
+  void HandleSharedIngestExit(const stream_id_t& sid);
+  // stream process side
+  int ExecStream(const utils::ArgsMap& config_args,
+                 const std::string& feedback_dir,
+                 common::logging::LOG_LEVEL logs_level,
+                 int read_command_client,
+                 int write_responce_client,
+                 StreamStruct* mem);
+  int ExecZygoteStream(const std::string& config_str, int read_command_client, int write_responce_client, int stats_fd);
+  void UpdateStartupStats(ChildStream* channel);
 
   // stream
   common::ErrnoError HandleRequestChangedSourcesStream(pipe::ProtocoledPipeClient* pclient,
-                                                       protocol::request_t* req) WARN_UNUSED_RESULT;
-
-  common::ErrnoError HandleRequestStatisticStream(pipe::ProtocoledPipeClient* pclient,
-                                                  protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                       protocol::request_t* req,
+                                                       json_object* params) WARN_UNUSED_RESULT;
 
   common::ErrnoError HandleRequestClientStartStream(ProtocoledDaemonClient* dclient,
-                                                    protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                    protocol::request_t* req,
+                                                    json_object* params) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientStopStream(ProtocoledDaemonClient* dclient,
-                                                   protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                   protocol::request_t* req,
+                                                   json_object* params) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientRestartStream(ProtocoledDaemonClient* dclient,
-                                                      protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                      protocol::request_t* req,
+                                                      json_object* params) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientGetLogStream(ProtocoledDaemonClient* dclient,
-                                                     protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                     protocol::request_t* req,
+                                                     json_object* params) WARN_UNUSED_RESULT;
 
   // service
   common::ErrnoError HandleRequestClientPrepareService(ProtocoledDaemonClient* dclient,
-                                                       protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                       protocol::request_t* req,
+                                                       json_object* params) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientActivate(ProtocoledDaemonClient* dclient,
-                                                 protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                 protocol::request_t* req,
+                                                 json_object* params) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientPingService(ProtocoledDaemonClient* dclient,
-                                                    protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                    protocol::request_t* req,
+                                                    json_object* params) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientGetLogService(ProtocoledDaemonClient* dclient,
-                                                      protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                      protocol::request_t* req,
+                                                      json_object* params) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientStopService(ProtocoledDaemonClient* dclient,
-                                                    protocol::request_t* req) WARN_UNUSED_RESULT;
+                                                    protocol::request_t* req,
+                                                    json_object* params) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientSubscribeStatistic(ProtocoledDaemonClient* dclient,
+                                                           protocol::request_t* req,
+                                                           json_object* params) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientUnsubscribeStatistic(ProtocoledDaemonClient* dclient,
+                                                             protocol::request_t* req,
+                                                             json_object* params) WARN_UNUSED_RESULT;
 
   common::ErrnoError HandleResponcePingService(ProtocoledDaemonClient* dclient,
                                                protocol::response_t* resp) WARN_UNUSED_RESULT;
@@ -129,15 +185,23 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver {
   char** process_argv_;
 
   common::libev::IoLoop* loop_;
-  common::libev::IoLoop* http_server_;
-  common::libev::IoLoopObserver* http_handler_;
+  ChildStreamsRegistry* streams_registry_;
+  IngestRegistry* ingests_;
+  HttpCache* http_cache_;
+  MetricsRegistry* metrics_registry_;
+  std::vector<common::libev::IoLoop*> http_servers_;
+  std::vector<common::libev::IoLoopObserver*> http_handlers_;
 
   std::atomic<protocol::seq_id_t> id_;
   common::libev::timer_id_t ping_client_id_timer_;
   common::libev::timer_id_t node_stats_timer_;
   common::libev::timer_id_t cleanup_timer_;
   NodeStats* node_stats_;
+  RequestsDispatcher<ProcessSlaveWrapper, ProtocoledDaemonClient> daemon_dispatcher_;
+  RequestsDispatcher<ProcessSlaveWrapper, pipe::ProtocoledPipeClient> pipe_dispatcher_;
   stream_exec_t stream_exec_func_;
+  Zygote* zygote_;
+  StreamsStartupStats startup_stats_;
 };
 
 }  // namespace server
@@ -0,0 +1,81 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <common/error.h>
+
+#include "protocol/types.h"
+
+struct json_object;
+
+namespace iptv_cloud {
+namespace server {
+
+// table of json-rpc handlers, method names are interned into ids on registration
+template <typename Owner, typename Client>
+class RequestsDispatcher {
+ public:
+  typedef size_t method_id_t;
+  typedef common::ErrnoError (Owner::*handler_t)(Client* client, protocol::request_t* req, json_object* params);
+  enum : method_id_t { invalid_method = 0 };
+
+  explicit RequestsDispatcher(Owner* owner) : owner_(owner), methods_(), handlers_() {}
+
+  // should be registered before loop started
+  method_id_t Register(const std::string& method, handler_t handler) {
+    auto it = methods_.find(method);
+    if (it != methods_.end()) {
+      handlers_[it->second - 1] = handler;
+      return it->second;
+    }
+
+    handlers_.push_back(handler);
+    const method_id_t mid = handlers_.size();
+    methods_[method] = mid;
+    return mid;
+  }
+
+  method_id_t FindMethod(const std::string& method) const {
+    auto it = methods_.find(method);
+    if (it == methods_.end()) {
+      return invalid_method;
+    }
+
+    return it->second;
+  }
+
+  common::ErrnoError Dispatch(method_id_t mid, Client* client, protocol::request_t* req, json_object* params) const
+      WARN_UNUSED_RESULT {
+    if (mid == invalid_method || mid > handlers_.size()) {
+      return common::make_errno_error_inval();
+    }
+
+    return (owner_->*handlers_[mid - 1])(client, req, params);
+  }
+
+ private:
+  Owner* const owner_;
+  std::unordered_map<std::string, method_id_t> methods_;
+  std::vector<handler_t> handlers_;  // method_id - 1 => handler
+
+  DISALLOW_COPY_AND_ASSIGN(RequestsDispatcher);
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,139 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/statistic_subscription.h"
+
+#include "server/commands_info/service/subscribe_info.h"
+
+namespace {
+bool IsIntervalPassed(time_t last_sent, time_t interval, time_t now) {
+  return last_sent == 0 || now - last_sent >= interval;
+}
+}  // namespace
+
+namespace iptv_cloud {
+namespace server {
+
+StatisticSubscription::StatisticSubscription()
+    : stream_statistic_(true),
+      stream_interval_(0),
+      streams_(),
+      service_statistic_(true),
+      service_interval_(0),
+      streams_last_sent_(),
+      service_last_sent_(0),
+      pending_(),
+      pending_index_() {}
+
+void StatisticSubscription::Subscribe(const service::SubscribeInfo& info) {
+  stream_statistic_ = info.IsStreamStatistic();
+  stream_interval_ = info.GetStreamStatisticInterval() * 1000;
+  const auto streams = info.GetStreams();
+  streams_ = std::unordered_set<stream_id_t>(streams.begin(), streams.end());
+  service_statistic_ = info.IsServiceStatistic();
+  service_interval_ = info.GetServiceStatisticInterval() * 1000;
+  streams_last_sent_.clear();
+  service_last_sent_ = 0;
+}
+
+void StatisticSubscription::Unsubscribe() {
+  stream_statistic_ = false;
+  service_statistic_ = false;
+  streams_.clear();
+  streams_last_sent_.clear();
+  pending_.clear();
+  pending_index_.clear();
+}
+
+bool StatisticSubscription::WantsStreamStatistic(const stream_id_t& sid, time_t now) const {
+  if (!IsStreamSubscribed(sid)) {
+    return false;
+  }
+
+  auto it = streams_last_sent_.find(sid);
+  return it == streams_last_sent_.end() || IsIntervalPassed(it->second, stream_interval_, now);
+}
+
+bool StatisticSubscription::WantsServiceStatistic(time_t now) const {
+  return service_statistic_ && IsIntervalPassed(service_last_sent_, service_interval_, now);
+}
+
+bool StatisticSubscription::WantsStreamEvent(const stream_id_t& sid) const {
+  return IsStreamSubscribed(sid);
+}
+
+void StatisticSubscription::AddStreamStatistic(const stream_id_t& sid, const std::string& message, time_t now) {
+  streams_last_sent_[sid] = now;
+  AddPending(sid, message);
+}
+
+void StatisticSubscription::AddServiceStatistic(const std::string& message, time_t now) {
+  service_last_sent_ = now;
+  AddPending(stream_id_t(), message);
+}
+
+void StatisticSubscription::AddStreamEvent(const stream_id_t& sid, const std::string& message) {
+  PendingMessage pending = {sid, message, true};
+  pending_.push_back(pending);
+}
+
+void StatisticSubscription::RemoveStream(const stream_id_t& sid) {
+  streams_last_sent_.erase(sid);
+  auto it = pending_index_.find(sid);
+  if (it != pending_index_.end()) {
+    pending_.erase(it->second);
+    pending_index_.erase(it);
+  }
+}
+
+bool StatisticSubscription::HasPending() const {
+  return !pending_.empty();
+}
+
+const StatisticSubscription::PendingMessage& StatisticSubscription::FrontPending() const {
+  return pending_.front();
+}
+
+void StatisticSubscription::PopPending() {
+  if (pending_.empty()) {
+    return;
+  }
+
+  if (!pending_.front().event) {
+    pending_index_.erase(pending_.front().sid);
+  }
+  pending_.pop_front();
+}
+
+size_t StatisticSubscription::GetPendingCount() const {
+  return pending_.size();
+}
+
+bool StatisticSubscription::IsStreamSubscribed(const stream_id_t& sid) const {
+  return stream_statistic_ && (streams_.empty() || streams_.find(sid) != streams_.end());
+}
+
+void StatisticSubscription::AddPending(const stream_id_t& sid, const std::string& message) {
+  auto it = pending_index_.find(sid);
+  if (it != pending_index_.end()) {
+    it->second->message = message;
+    return;
+  }
+
+  PendingMessage pending = {sid, message, false};
+  pending_index_[sid] = pending_.insert(pending_.end(), pending);
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
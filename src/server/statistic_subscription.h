@@ -0,0 +1,83 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <time.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "base/types.h"
+
+namespace iptv_cloud {
+namespace server {
+namespace service {
+class SubscribeInfo;
+}
+
+// statistic broadcasts of one daemon client: filters checked before message generated and latest messages which
+// were not written yet because client is slow
+class StatisticSubscription {
+ public:
+  struct PendingMessage {
+    stream_id_t sid;  // empty for service statistic
+    std::string message;
+    bool event;  // status change, never replaced by later messages
+  };
+
+  StatisticSubscription();  // everything, like before subscriptions
+
+  void Subscribe(const service::SubscribeInfo& info);
+  void Unsubscribe();  // no statistic at all
+
+  bool WantsStreamStatistic(const stream_id_t& sid, time_t now) const;  // now in msec
+  bool WantsServiceStatistic(time_t now) const;
+  bool WantsStreamEvent(const stream_id_t& sid) const;  // status changes, interval not applied
+
+  // queues message, pending message of same stream is replaced, so only latest waits for client
+  void AddStreamStatistic(const stream_id_t& sid, const std::string& message, time_t now);
+  void AddServiceStatistic(const std::string& message, time_t now);
+  void AddStreamEvent(const stream_id_t& sid, const std::string& message);
+
+  void RemoveStream(const stream_id_t& sid);  // stream finished
+
+  bool HasPending() const;
+  const PendingMessage& FrontPending() const;
+  void PopPending();
+  size_t GetPendingCount() const;
+
+ private:
+  typedef std::list<PendingMessage> pending_t;
+
+  bool IsStreamSubscribed(const stream_id_t& sid) const;
+  void AddPending(const stream_id_t& sid, const std::string& message);
+
+  bool stream_statistic_;
+  time_t stream_interval_;  // msec
+  std::unordered_set<stream_id_t> streams_;  // empty - all
+  bool service_statistic_;
+  time_t service_interval_;  // msec
+
+  std::unordered_map<stream_id_t, time_t> streams_last_sent_;
+  time_t service_last_sent_;
+
+  pending_t pending_;  // in order of first queuing
+  std::unordered_map<stream_id_t, pending_t::iterator> pending_index_;  // statistic messages only
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
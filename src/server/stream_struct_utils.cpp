@@ -14,19 +14,56 @@
 
 #include "server/stream_struct_utils.h"
 
-#include <sys/mman.h>
+#include "base/channel_stats.h"
+
+#include "stream_commands_info/statistic_info.h"
+
+namespace {
+iptv_cloud::ChannelStats* MakeChannelStats(const iptv_cloud::ChannelStatsSnapshot& snapshot) {
+  iptv_cloud::ChannelStats* stats = new iptv_cloud::ChannelStats(snapshot.id);
+  stats->SetTotalBytes(snapshot.total_bytes);
+  stats->SetTotalPackets(snapshot.total_packets);
+  stats->SetLastUpdateTime(snapshot.last_update_time);
+  stats->SetBps(snapshot.bps);
+  stats->SetBufferSizeHistogram(snapshot.buffer_size);
+  stats->SetArrivalHistogram(snapshot.arrival);
+  stats->SetTimestampGapHistogram(snapshot.timestamp_gap);
+  stats->SetMaxGap(snapshot.max_gap);
+  stats->SetTransitionStallHistogram(snapshot.transition_stall);
+  stats->SetTransitionJumpHistogram(snapshot.transition_jump);
+  stats->SetDroppedBytes(snapshot.dropped_bytes);
+  stats->SetDroppedPackets(snapshot.dropped_packets);
+  stats->SetDegraded(snapshot.degraded);
+  stats->SetReconnects(snapshot.reconnects);
+  stats->SetDowntime(snapshot.downtime);
+  stats->SetLostPackets(snapshot.lost_packets);
+  stats->SetReorderedPackets(snapshot.reordered_packets);
+  stats->SetDuplicatePackets(snapshot.duplicate_packets);
+  stats->SetClients(snapshot.clients);
+  stats->SetEvictedClients(snapshot.evicted_clients);
+  return stats;
+}
+}  // namespace
 
 namespace iptv_cloud {
 namespace server {
 
-common::ErrnoError AllocSharedStreamStruct(const StreamInfo& sha, StreamStruct** stream) {
-  StreamStruct* mem = static_cast<StreamStruct*>(
-      mmap(nullptr, sizeof(StreamStruct), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
-  if (!mem) {
-    return common::make_errno_error("Failed to allocate memory.", ENOMEM);
+common::ErrnoError AllocSharedStreamStruct(const StreamInfo& sha, StreamStruct** stream, int* shared_fd) {
+  if (!stream || !shared_fd) {
+    return common::make_errno_error_inval();
+  }
+
+  StreamStatsBlock* block = nullptr;
+  int fd = INVALID_DESCRIPTOR;
+  common::ErrnoError err = CreateSharedStatsBlock(&fd, &block);
+  if (err) {
+    return err;
   }
 
-  *stream = new (mem) StreamStruct(sha);
+  StreamStruct* mem = new StreamStruct(sha);  // forked process gets own copy, only statistic block is shared
+  mem->shared_stats = block;
+  *stream = mem;
+  *shared_fd = fd;
   return common::ErrnoError();
 }
 
@@ -40,10 +77,36 @@ void FreeSharedStreamStruct(StreamStruct** data) {
     return;
   }
 
-  ldata->~StreamStruct();
-  munmap(ldata, sizeof(StreamStruct));
+  DetachSharedStatsBlock(&ldata->shared_stats);
+  delete ldata;
   *data = nullptr;
 }
 
+bool ReadSharedStatisticInfo(const StreamStruct* data, StatisticInfo* info) {
+  if (!data || !info) {
+    return false;
+  }
+
+  StreamStatsSnapshot snapshot;
+  if (!data->shared_stats || !data->shared_stats->Read(&snapshot)) {
+    return false;
+  }
+
+  input_channels_info_t input;
+  for (size_t i = 0; i < snapshot.input_count; ++i) {
+    input.push_back(MakeChannelStats(snapshot.input[i]));
+  }
+
+  output_channels_info_t output;
+  for (size_t i = 0; i < snapshot.output_count; ++i) {
+    output.push_back(MakeChannelStats(snapshot.output[i]));
+  }
+
+  const StreamStruct str(data->id, data->type, static_cast<StreamStatus>(snapshot.status), input, output,
+                         snapshot.start_time, snapshot.loop_start_time, snapshot.restarts);
+  *info = StatisticInfo(str, snapshot.cpu_load, snapshot.rss, snapshot.timestamp, snapshot.first_output);
+  return true;
+}
+
 }  // namespace server
 }  // namespace iptv_cloud
@@ -19,11 +19,15 @@
 #include "base/stream_struct.h"
 
 namespace iptv_cloud {
+class StatisticInfo;
 namespace server {
-// id, type, input, output
-common::ErrnoError AllocSharedStreamStruct(const StreamInfo& sha, StreamStruct** stream);
+// id, type, input, output; shared_fd of statistic block should be closed by caller after process spawned
+common::ErrnoError AllocSharedStreamStruct(const StreamInfo& sha, StreamStruct** stream, int* shared_fd);
 
 void FreeSharedStreamStruct(StreamStruct** data);
 
+// last statistic published by stream process, false if not consistent now
+bool ReadSharedStatisticInfo(const StreamStruct* data, StatisticInfo* info) WARN_UNUSED_RESULT;
+
 }  // namespace server
 }  // namespace iptv_cloud
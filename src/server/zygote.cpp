@@ -0,0 +1,286 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/zygote.h"
+
+#include <signal.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <common/file_system/file_system.h>
+
+#define ZYGOTE_PROCESS_NAME "stream_zygote"
+#define INVALID_PID -1
+
+namespace {
+
+enum { spawn_fds_count = 3 };
+
+void CloseDescriptors(const int* fds, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (fds[i] != INVALID_DESCRIPTOR) {
+      ::close(fds[i]);
+    }
+  }
+}
+
+common::ErrnoError SendWithDescriptors(int sock, const void* data, size_t size, const int* fds, size_t fds_count) {
+  struct iovec iov;
+  iov.iov_base = const_cast<void*>(data);
+  iov.iov_len = size;
+
+  char control[CMSG_SPACE(sizeof(int) * spawn_fds_count)];
+  memset(control, 0, sizeof(control));
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds_count);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds_count);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fds_count);
+
+  ssize_t res = sendmsg(sock, &msg, MSG_NOSIGNAL);
+  if (res == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  return common::ErrnoError();
+}
+
+// nread 0 if other side closed
+common::ErrnoError RecvWithDescriptors(int sock, void* data, size_t size, size_t* nread, int* fds, size_t fds_count) {
+  struct iovec iov;
+  iov.iov_base = data;
+  iov.iov_len = size;
+
+  char control[CMSG_SPACE(sizeof(int) * spawn_fds_count)];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t res = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+  if (res == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  for (size_t i = 0; i < fds_count; ++i) {
+    fds[i] = INVALID_DESCRIPTOR;
+  }
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+    const size_t received = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * std::min(received, fds_count));
+  }
+
+  if (res != 0 && (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC))) {
+    CloseDescriptors(fds, fds_count);
+    return common::make_errno_error("Too big spawn request.", EMSGSIZE);
+  }
+
+  *nread = res;
+  return common::ErrnoError();
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace server {
+
+StreamsStartupStats::StreamsStartupStats()
+    : fork_starts(0), fork_latency_msec(0), zygote_starts(0), zygote_latency_msec(0) {}
+
+void StreamsStartupStats::Add(bool by_zygote, uint64_t latency_msec) {
+  if (by_zygote) {
+    zygote_starts++;
+    zygote_latency_msec += latency_msec;
+  } else {
+    fork_starts++;
+    fork_latency_msec += latency_msec;
+  }
+}
+
+Zygote::Zygote(preload_t preload, child_main_t child_main)
+    : preload_(preload), child_main_(child_main), sock_(INVALID_DESCRIPTOR), pid_(INVALID_PID) {}
+
+Zygote::~Zygote() {
+  Stop();
+}
+
+common::ErrnoError Zygote::Start() {
+  if (IsRunning()) {
+    return common::make_errno_error_inval();
+  }
+
+  if (prctl(PR_SET_CHILD_SUBREAPER, 1) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    ::close(sv[0]);
+    Exec(sv[1]);
+  } else if (pid < 0) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    CloseDescriptors(sv, 2);
+    return err;
+  }
+
+  ::close(sv[1]);
+  sock_ = sv[0];
+  pid_ = pid;
+  return common::ErrnoError();
+}
+
+bool Zygote::IsRunning() const {
+  return sock_ != INVALID_DESCRIPTOR;
+}
+
+void Zygote::Stop() {
+  if (!IsRunning()) {
+    return;
+  }
+
+  ::close(sock_);  // zygote exits when reads eof
+  sock_ = INVALID_DESCRIPTOR;
+  waitpid(pid_, nullptr, 0);  // can be already reaped by loop
+  pid_ = INVALID_PID;
+}
+
+common::ErrnoError Zygote::Spawn(const std::string& config,
+                                 int read_command_fd,
+                                 int write_responce_fd,
+                                 int stats_fd,
+                                 pid_t* pid) {
+  if (!pid || config.empty() || config.size() > max_request_size) {
+    return common::make_errno_error_inval();
+  }
+
+  if (!IsRunning()) {
+    return common::make_errno_error("Zygote is not running.", ECHILD);
+  }
+
+  const int fds[spawn_fds_count] = {read_command_fd, write_responce_fd, stats_fd};
+  common::ErrnoError err = SendWithDescriptors(sock_, config.data(), config.size(), fds, spawn_fds_count);
+  if (err) {
+    Stop();
+    return err;
+  }
+
+  pid_t lpid = INVALID_PID;
+  ssize_t res = recv(sock_, &lpid, sizeof(lpid), 0);
+  if (res != sizeof(lpid)) {
+    err = res == ERROR_RESULT_VALUE ? common::make_errno_error(errno)
+                                    : common::make_errno_error("Zygote is not responding.", ECHILD);
+    Stop();
+    return err;
+  }
+
+  if (lpid <= 0) {
+    return common::make_errno_error("Zygote failed to fork stream process.", EAGAIN);
+  }
+
+  *pid = lpid;
+  return common::ErrnoError();
+}
+
+void Zygote::Exec(int sock) {
+  prctl(PR_SET_NAME, ZYGOTE_PROCESS_NAME);
+  prctl(PR_SET_PDEATHSIG, SIGKILL);  // not inherited by forked processes
+
+  int res = preload_();
+  if (res != EXIT_SUCCESS) {
+    _exit(res);
+  }
+
+  while (true) {
+    common::ErrnoError err = HandleSpawnRequest(sock);
+    if (err) {
+      if (err->GetErrorCode() == ECONNRESET) {  // daemon closed connection or socket is broken
+        break;
+      }
+      WARNING_LOG() << "Zygote spawn request error: " << err->GetDescription();
+    }
+  }
+
+  _exit(EXIT_SUCCESS);
+}
+
+common::ErrnoError Zygote::HandleSpawnRequest(int sock) {
+  std::string config(max_request_size, 0);
+  int fds[spawn_fds_count];
+  size_t nread = 0;
+  common::ErrnoError err = RecvWithDescriptors(sock, &config[0], config.size(), &nread, fds, spawn_fds_count);
+  if (err) {
+    const int code = err->GetErrorCode();
+    if (code == EINTR || code == EAGAIN) {
+      return common::ErrnoError();
+    }
+    if (code == EMSGSIZE) {
+      return err;
+    }
+    // EBADF, ECONNRESET, ENOTSOCK and others are not going away on retry
+    return common::make_errno_error("Zygote connection error: " + err->GetDescription(), ECONNRESET);
+  }
+
+  if (nread == 0) {
+    return common::make_errno_error("Daemon closed zygote connection.", ECONNRESET);
+  }
+  config.resize(nread);
+
+  pid_t intermediate = fork();
+  if (intermediate == 0) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      ::close(sock);
+      _exit(child_main_(config, fds[0], fds[1], fds[2]));
+    }
+
+    // intermediate exits at once, stream process reparented to daemon
+    ssize_t res = send(sock, &pid, sizeof(pid), MSG_NOSIGNAL);
+    _exit(res == sizeof(pid) ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  CloseDescriptors(fds, spawn_fds_count);
+  if (intermediate < 0) {
+    err = common::make_errno_error(errno);
+    pid_t failed = INVALID_PID;
+    send(sock, &failed, sizeof(failed), MSG_NOSIGNAL);
+    return err;
+  }
+
+  waitpid(intermediate, nullptr, 0);
+  return common::ErrnoError();
+}
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -0,0 +1,77 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <functional>
+#include <string>
+
+#include <common/error.h>
+
+namespace iptv_cloud {
+namespace server {
+
+// stream processes startup latency: spawn request => stream backend inited in process
+struct StreamsStartupStats {
+  StreamsStartupStats();
+
+  void Add(bool by_zygote, uint64_t latency_msec);
+
+  uint64_t fork_starts;
+  uint64_t fork_latency_msec;  // sum
+  uint64_t zygote_starts;
+  uint64_t zygote_latency_msec;  // sum
+};
+
+// Warm helper process forked from daemon before any threads, preloads stream backend once and forks stream
+// processes on demand. Stream process is forked through short living intermediate process, so it is reparented
+// to daemon (child subreaper) and daemon waits it as own child.
+class Zygote {
+ public:
+  enum { max_request_size = 65536 };
+  typedef std::function<int()> preload_t;
+  typedef std::function<int(const std::string& config, int read_command_fd, int write_responce_fd, int stats_fd)>
+      child_main_t;
+
+  Zygote(preload_t preload, child_main_t child_main);
+  ~Zygote();
+
+  common::ErrnoError Start() WARN_UNUSED_RESULT;  // daemon side
+  bool IsRunning() const;
+  void Stop();
+
+  // fds are duplicated into stream process, caller closes own copies
+  common::ErrnoError Spawn(const std::string& config,
+                           int read_command_fd,
+                           int write_responce_fd,
+                           int stats_fd,
+                           pid_t* pid) WARN_UNUSED_RESULT;
+
+ private:
+  void Exec(int sock);  // zygote side, never returns
+  common::ErrnoError HandleSpawnRequest(int sock);
+
+  const preload_t preload_;
+  const child_main_t child_main_;
+  int sock_;
+  pid_t pid_;
+
+  DISALLOW_COPY_AND_ASSIGN(Zygote);
+};
+
+}  // namespace server
+}  // namespace iptv_cloud
@@ -14,11 +14,30 @@
 
 #include "stream/config.h"
 
+#include "base/constants.h"
+
 namespace iptv_cloud {
 namespace stream {
 
 Config::Config(StreamType type, size_t max_restart_attempts, const input_t& input, const output_t& output)
-    : type_(type), max_restart_attempts_(max_restart_attempts), ttl_sec_(), input_(input), output_(output) {}
+    : type_(type),
+      max_restart_attempts_(max_restart_attempts),
+      ttl_sec_(),
+      output_isolated_(false),
+      output_queue_max_time_(DEFAULT_OUTPUT_QUEUE_MAX_TIME),
+      output_queue_max_bytes_(DEFAULT_OUTPUT_QUEUE_MAX_BYTES),
+      output_reconnect_(false),
+      udp_batch_(false),
+      udp_input_batch_(false),
+      udp_input_rcvbuf_(DEFAULT_UDP_INPUT_RCVBUF),
+      udp_input_latency_(DEFAULT_UDP_INPUT_LATENCY),
+      tcp_clients_(false),
+      tcp_client_queue_bytes_(DEFAULT_TCP_CLIENT_QUEUE_BYTES),
+      tcp_client_evict_time_(DEFAULT_TCP_CLIENT_EVICT_TIME),
+      ingest_socket_(),
+      ingest_publish_(),
+      input_(input),
+      output_(output) {}
 
 StreamType Config::GetType() const {
   return type_;
@@ -60,5 +79,109 @@ void Config::SetTimeToLigeStream(ttl_t ttl) {
   ttl_sec_ = ttl;
 }
 
+bool Config::IsOutputIsolated() const {
+  return output_isolated_;
+}
+
+void Config::SetOutputIsolated(bool isolated) {
+  output_isolated_ = isolated;
+}
+
+time_t Config::GetOutputQueueMaxTime() const {
+  return output_queue_max_time_;
+}
+
+void Config::SetOutputQueueMaxTime(time_t max_time) {
+  output_queue_max_time_ = max_time;
+}
+
+size_t Config::GetOutputQueueMaxBytes() const {
+  return output_queue_max_bytes_;
+}
+
+void Config::SetOutputQueueMaxBytes(size_t max_bytes) {
+  output_queue_max_bytes_ = max_bytes;
+}
+
+bool Config::IsOutputReconnect() const {
+  return output_reconnect_;
+}
+
+void Config::SetOutputReconnect(bool reconnect) {
+  output_reconnect_ = reconnect;
+}
+
+bool Config::IsUdpBatch() const {
+  return udp_batch_;
+}
+
+void Config::SetUdpBatch(bool batch) {
+  udp_batch_ = batch;
+}
+
+bool Config::IsUdpInputBatch() const {
+  return udp_input_batch_;
+}
+
+void Config::SetUdpInputBatch(bool batch) {
+  udp_input_batch_ = batch;
+}
+
+int Config::GetUdpInputRcvbuf() const {
+  return udp_input_rcvbuf_;
+}
+
+void Config::SetUdpInputRcvbuf(int rcvbuf) {
+  udp_input_rcvbuf_ = rcvbuf;
+}
+
+time_t Config::GetUdpInputLatency() const {
+  return udp_input_latency_;
+}
+
+void Config::SetUdpInputLatency(time_t latency) {
+  udp_input_latency_ = latency;
+}
+
+bool Config::IsTcpClients() const {
+  return tcp_clients_;
+}
+
+void Config::SetTcpClients(bool clients) {
+  tcp_clients_ = clients;
+}
+
+size_t Config::GetTcpClientQueueBytes() const {
+  return tcp_client_queue_bytes_;
+}
+
+void Config::SetTcpClientQueueBytes(size_t bytes) {
+  tcp_client_queue_bytes_ = bytes;
+}
+
+time_t Config::GetTcpClientEvictTime() const {
+  return tcp_client_evict_time_;
+}
+
+void Config::SetTcpClientEvictTime(time_t evict_time) {
+  tcp_client_evict_time_ = evict_time;
+}
+
+std::string Config::GetIngestSocket() const {
+  return ingest_socket_;
+}
+
+void Config::SetIngestSocket(const std::string& socket_path) {
+  ingest_socket_ = socket_path;
+}
+
+std::string Config::GetIngestPublish() const {
+  return ingest_publish_;
+}
+
+void Config::SetIngestPublish(const std::string& socket_path) {
+  ingest_publish_ = socket_path;
+}
+
 }  // namespace stream
 }  // namespace iptv_cloud
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "base/inputs_outputs.h"
 
 namespace iptv_cloud {
@@ -40,10 +42,69 @@ class Config {
   ttl_t GetTimeToLifeStream() const;
   void SetTimeToLigeStream(ttl_t ttl);
 
+  // every output gets own leaky queue, stalled output drops its buffers instead of blocking others
+  bool IsOutputIsolated() const;
+  void SetOutputIsolated(bool isolated);
+
+  time_t GetOutputQueueMaxTime() const;  // msec
+  void SetOutputQueueMaxTime(time_t max_time);
+
+  size_t GetOutputQueueMaxBytes() const;
+  void SetOutputQueueMaxBytes(size_t max_bytes);
+
+  // rtmp and tcp outputs reconnected on their own, pipeline keeps running
+  bool IsOutputReconnect() const;
+  void SetOutputReconnect(bool reconnect);
+
+  // udp outputs send mpeg-ts by paced sendmmsg bursts of 7 ts packets datagrams instead of rtp
+  bool IsUdpBatch() const;
+  void SetUdpBatch(bool batch);
+
+  // udp inputs read by recvmmsg batches, rtp reordered by sequence numbers
+  bool IsUdpInputBatch() const;
+  void SetUdpInputBatch(bool batch);
+
+  int GetUdpInputRcvbuf() const;  // bytes
+  void SetUdpInputRcvbuf(int rcvbuf);
+
+  time_t GetUdpInputLatency() const;  // msec, rtp reorder
+  void SetUdpInputLatency(time_t latency);
+
+  // tcp outputs served by own server with bounded queue per client, slow clients evicted
+  bool IsTcpClients() const;
+  void SetTcpClients(bool clients);
+
+  size_t GetTcpClientQueueBytes() const;
+  void SetTcpClientQueueBytes(size_t bytes);
+
+  time_t GetTcpClientEvictTime() const;  // msec
+  void SetTcpClientEvictTime(time_t evict_time);
+
+  // set by daemon: input 0 read from shared memory of ingest process, not from its url
+  std::string GetIngestSocket() const;
+  void SetIngestSocket(const std::string& socket_path);
+
+  // set by daemon: ingest process publishes its input into shared memory
+  std::string GetIngestPublish() const;
+  void SetIngestPublish(const std::string& socket_path);
+
  private:
   StreamType type_;
   size_t max_restart_attempts_;
   ttl_t ttl_sec_;
+  bool output_isolated_;
+  time_t output_queue_max_time_;
+  size_t output_queue_max_bytes_;
+  bool output_reconnect_;
+  bool udp_batch_;
+  bool udp_input_batch_;
+  int udp_input_rcvbuf_;
+  time_t udp_input_latency_;
+  bool tcp_clients_;
+  size_t tcp_client_queue_bytes_;
+  time_t tcp_client_evict_time_;
+  std::string ingest_socket_;
+  std::string ingest_publish_;
 
   input_t input_;
   output_t output_;
@@ -14,11 +14,14 @@
 
 #include "stream/configs_factory.h"
 
+#include <stdint.h>
+
 #include <map>
 #include <string>
 
 #include "base/config_fields.h"
 #include "base/gst_constants.h"
+#include "base/rendition.h"
 
 #include "stream/streams/configs/encoding_config.h"
 #include "stream/streams/configs/relay_config.h"
@@ -137,6 +140,22 @@ bool InitVideoEncodersWithArgs(const utils::ArgsMap& config,
   return true;
 }
 
+// gops of renditions are aligned by force key unit events of renditions tee, so encoders must not insert key frames
+// on their own: periodic key frames are pushed far away and scene cut detection is disabled
+void DisableEncoderKeyFrameDecisions(video_encoders_args_t* video_encoder_args,
+                                     video_encoders_str_args_t* video_encoder_str_args) {
+  (*video_encoder_args)[X264_ENC_KEY_INT_MAX] = INT32_MAX;
+  (*video_encoder_args)[NV_H264_ENC_GOP_SIZE] = static_cast<uint32_t>(-1);  // infinite
+  (*video_encoder_args)[OPEN_H264_ENC_GOP_SIZE] = UINT32_MAX;
+  (*video_encoder_args)[OPEN_H264_ENC_SCENE_CHANGE_DETECTION] = 0;
+  (*video_encoder_args)[VAAPI_H264_ENC_KEYFRAME_PERIOD] = 1024;  // max of vaapi
+  (*video_encoder_args)[MFX_H264_GOP_SIZE] = UINT16_MAX;
+  (*video_encoder_args)[EAVC_ENC_GOP_ADAPTIVE] = 0;
+
+  std::string& x264_options = (*video_encoder_str_args)[X264_ENC_OPTION_STRING];
+  x264_options += x264_options.empty() ? "scenecut=0" : ":scenecut=0";
+}
+
 }  // namespace
 
 common::Error make_config(const utils::ArgsMap& config_args, Config** config) {
@@ -178,6 +197,71 @@ common::Error make_config(const utils::ArgsMap& config_args, Config** config) {
     conf.SetTimeToLigeStream(ttl_sec);
   }
 
+  bool output_isolated;
+  if (utils::ArgsGetValue(config_args, OUTPUT_ISOLATION_FIELD, &output_isolated)) {
+    conf.SetOutputIsolated(output_isolated);
+  }
+
+  time_t output_queue_max_time;
+  if (utils::ArgsGetValue(config_args, OUTPUT_QUEUE_MAX_TIME_FIELD, &output_queue_max_time)) {
+    conf.SetOutputQueueMaxTime(output_queue_max_time);
+  }
+
+  size_t output_queue_max_bytes;
+  if (utils::ArgsGetValue(config_args, OUTPUT_QUEUE_MAX_BYTES_FIELD, &output_queue_max_bytes)) {
+    conf.SetOutputQueueMaxBytes(output_queue_max_bytes);
+  }
+
+  bool output_reconnect;
+  if (utils::ArgsGetValue(config_args, OUTPUT_RECONNECT_FIELD, &output_reconnect)) {
+    conf.SetOutputReconnect(output_reconnect);
+  }
+
+  bool udp_batch;
+  if (utils::ArgsGetValue(config_args, UDP_BATCH_FIELD, &udp_batch)) {
+    conf.SetUdpBatch(udp_batch);
+  }
+
+  bool udp_input_batch;
+  if (utils::ArgsGetValue(config_args, UDP_INPUT_BATCH_FIELD, &udp_input_batch)) {
+    conf.SetUdpInputBatch(udp_input_batch);
+  }
+
+  int udp_input_rcvbuf;
+  if (utils::ArgsGetValue(config_args, UDP_INPUT_RCVBUF_FIELD, &udp_input_rcvbuf)) {
+    conf.SetUdpInputRcvbuf(udp_input_rcvbuf);
+  }
+
+  time_t udp_input_latency;
+  if (utils::ArgsGetValue(config_args, UDP_INPUT_LATENCY_FIELD, &udp_input_latency)) {
+    conf.SetUdpInputLatency(udp_input_latency);
+  }
+
+  bool tcp_clients;
+  if (utils::ArgsGetValue(config_args, TCP_CLIENTS_FIELD, &tcp_clients)) {
+    conf.SetTcpClients(tcp_clients);
+  }
+
+  size_t tcp_client_queue_bytes;
+  if (utils::ArgsGetValue(config_args, TCP_CLIENT_QUEUE_BYTES_FIELD, &tcp_client_queue_bytes)) {
+    conf.SetTcpClientQueueBytes(tcp_client_queue_bytes);
+  }
+
+  time_t tcp_client_evict_time;
+  if (utils::ArgsGetValue(config_args, TCP_CLIENT_EVICT_TIME_FIELD, &tcp_client_evict_time)) {
+    conf.SetTcpClientEvictTime(tcp_client_evict_time);
+  }
+
+  std::string ingest_socket;
+  if (utils::ArgsGetValue(config_args, INGEST_SOCKET_FIELD, &ingest_socket)) {
+    conf.SetIngestSocket(ingest_socket);
+  }
+
+  std::string ingest_publish;
+  if (utils::ArgsGetValue(config_args, INGEST_PUBLISH_FIELD, &ingest_publish)) {
+    conf.SetIngestPublish(ingest_publish);
+  }
+
   streams::AudioVideoConfig aconf(conf);
   bool have_video;
   if (utils::ArgsGetValue(config_args, HAVE_VIDEO_FIELD, &have_video)) {
@@ -199,6 +283,11 @@ common::Error make_config(const utils::ArgsMap& config_args, Config** config) {
     aconf.SetLoop(loop);
   }
 
+  size_t playlist_block_size;
+  if (utils::ArgsGetValue(config_args, PLAYLIST_BLOCK_SIZE_FIELD, &playlist_block_size)) {
+    aconf.SetPlaylistBlockSize(playlist_block_size);
+  }
+
   if (stream_type == SCREEN) {
     *config = new streams::AudioVideoConfig(aconf);
     return common::Error();
@@ -213,6 +302,10 @@ common::Error make_config(const utils::ArgsMap& config_args, Config** config) {
     if (utils::ArgsGetValue(config_args, AUDIO_PARSER_FIELD, &audio_parser)) {
       rconfig->SetAudioParser(audio_parser);
     }
+    bool fast_path;
+    if (utils::ArgsGetValue(config_args, RELAY_FAST_PATH_FIELD, &fast_path)) {
+      rconfig->SetFastPath(fast_path);
+    }
 
     *config = rconfig;
     return common::Error();
@@ -291,6 +384,37 @@ common::Error make_config(const utils::ArgsMap& config_args, Config** config) {
       econfig->SetVideoEncoderStrArgs(video_encoder_str_args);
     }
 
+    renditions_t renditions;
+    if (utils::ArgsGetValue(config_args, RENDITIONS_FIELD, &renditions)) {
+      streams::video_renditions_t video_renditions;
+      for (const Rendition& rend : renditions) {
+        streams::VideoRendition vrend;
+        vrend.size = rend.GetSize();
+        vrend.video_bitrate = rend.GetVideoBitrate() ? rend.GetVideoBitrate() : econfig->GetVideoBitrate();
+        vrend.outputs = rend.GetOutputs();
+        // rendition args first, lookup takes first match so they override stream args
+        utils::ArgsMap rend_args = rend.GetEncoderArgs();
+        rend_args.insert(rend_args.end(), config_args.begin(), config_args.end());
+        if (!InitVideoEncodersWithArgs(rend_args, &vrend.video_encoder_args, &vrend.video_encoder_str_args)) {
+          delete econfig;
+          return common::make_error("Invalid encoder args of rendition: " + common::ConvertToString(vrend.size));
+        }
+        DisableEncoderKeyFrameDecisions(&vrend.video_encoder_args, &vrend.video_encoder_str_args);
+        video_renditions.push_back(vrend);
+      }
+      econfig->SetVideoRenditions(video_renditions);
+    }
+
+    int key_frame_interval;
+    if (utils::ArgsGetValue(config_args, KEY_FRAME_INTERVAL_FIELD, &key_frame_interval)) {
+      econfig->SetKeyFrameInterval(key_frame_interval);
+    }
+
+    std::string hls_master_playlist;
+    if (utils::ArgsGetValue(config_args, HLS_MASTER_PLAYLIST_FIELD, &hls_master_playlist)) {
+      econfig->SetHlsMasterPlaylist(hls_master_playlist);
+    }
+
     *config = econfig;
     return common::Error();
   } else if (stream_type == TIMESHIFT_RECORDER || stream_type == CATCHUP) {
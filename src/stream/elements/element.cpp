@@ -229,14 +229,22 @@ void ElementQueue::SetMaxSizeBuffers(guint val) {
   SetProperty("max-size-buffers", val);
 }
 
-void ElementQueue::SetMaxSizeTime(guint val) {
+void ElementQueue::SetMaxSizeTime(guint64 val) {
   SetProperty("max-size-time", val);
 }
 
-void ElementQueue::SetMaxSizeBytes(guint64 val) {
+void ElementQueue::SetMaxSizeBytes(guint val) {
   SetProperty("max-size-bytes", val);
 }
 
+void ElementQueue::SetLeaky(Leaky leaky) {
+  SetProperty("leaky", static_cast<gint>(leaky));
+}
+
+void ElementTee::SetAllowNotLinked(bool allow) {
+  SetProperty("allow-not-linked", allow);
+}
+
 void ElementCapsFilter::SetCaps(GstCaps* caps) {
   SetProperty("caps", caps);
 }
@@ -333,6 +341,14 @@ void ElementTsDemux::SetParsePrivateSections(gboolean parse_private_sections) {
   SetProperty("parse-private-sections", parse_private_sections);
 }
 
+gboolean ElementTsDemux::RegisterPadAddedCallback(pad_added_callback_t cb, gpointer user_data) {
+  return RegisterCallback("pad-added", G_CALLBACK(cb), user_data);
+}
+
+gboolean ElementFlvDemux::RegisterPadAddedCallback(pad_added_callback_t cb, gpointer user_data) {
+  return RegisterCallback("pad-added", G_CALLBACK(cb), user_data);
+}
+
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(DECODEBIN)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(FAKE_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(TEST_SINK)
@@ -364,6 +380,7 @@ DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SPLIT_MUX_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(ALSA_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MULTIFILE_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(APP_SRC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(APP_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(FILE_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(IMAGE_FREEZE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(CAPS_FILTER)
@@ -423,6 +440,9 @@ DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VAAPI_DECODEBIN)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VAAPI_POST_PROC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MFX_VPP)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MFX_H264_DEC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SHM_SINK)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SHM_SRC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(FLV_DEMUX)
 
 }  // namespace elements
 }  // namespace stream
@@ -62,6 +62,7 @@ enum SupportedElements {
   ELEMENT_ALSA_SRC,
   ELEMENT_MULTIFILE_SRC,
   ELEMENT_APP_SRC,
+  ELEMENT_APP_SINK,
   ELEMENT_FILE_SRC,
   ELEMENT_IMAGE_FREEZE,
   ELEMENT_CAPS_FILTER,
@@ -122,6 +123,9 @@ enum SupportedElements {
   ELEMENT_VAAPI_POST_PROC,
   ELEMENT_MFX_VPP,
   ELEMENT_MFX_H264_DEC,
+  ELEMENT_SHM_SINK,
+  ELEMENT_SHM_SRC,
+  ELEMENT_FLV_DEMUX,
   ELEMENTS_COUNT
 };
 
@@ -346,7 +350,21 @@ class ElementTsDemux : public ElementBinEx<ELEMENT_TS_DEMUX> {
   typedef ElementBinEx<ELEMENT_TS_DEMUX> base_class;
   using base_class::base_class;
 
+  typedef void (*pad_added_callback_t)(GstElement* src, GstPad* new_pad, gpointer user_data);
+
   void SetParsePrivateSections(gboolean parse_private_sections = true);  // Default value: true
+
+  gboolean RegisterPadAddedCallback(pad_added_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
+};
+
+class ElementFlvDemux : public ElementEx<ELEMENT_FLV_DEMUX> {
+ public:
+  typedef ElementEx<ELEMENT_FLV_DEMUX> base_class;
+  using base_class::base_class;
+
+  typedef void (*pad_added_callback_t)(GstElement* src, GstPad* new_pad, gpointer user_data);
+
+  gboolean RegisterPadAddedCallback(pad_added_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
 };
 
 // common elements
@@ -355,9 +373,12 @@ class ElementQueue : public ElementEx<ELEMENT_QUEUE> {
   typedef ElementEx<ELEMENT_QUEUE> base_class;
   using base_class::base_class;
 
+  enum Leaky { LEAKY_NO = 0, LEAKY_UPSTREAM = 1, LEAKY_DOWNSTREAM = 2 };
+
   void SetMaxSizeBuffers(guint val = 200);         // 0 - 4294967295 Default: 200
-  void SetMaxSizeTime(guint val = 10485760);       // 0 - 4294967295 Default: 10485760
-  void SetMaxSizeBytes(guint64 val = 1000000000);  // 0 - 18446744073709551615 Default: 1000000000
+  void SetMaxSizeTime(guint64 val = 1000000000);   // 0 - 18446744073709551615 Default: 1000000000
+  void SetMaxSizeBytes(guint val = 10485760);      // 0 - 4294967295 Default: 10485760
+  void SetLeaky(Leaky leaky = LEAKY_NO);           // no, upstream, downstream Default: no
 };
 
 class ElementQueue2 : public ElementEx<ELEMENT_QUEUE2> {
@@ -375,6 +396,8 @@ class ElementTee : public ElementEx<ELEMENT_TEE> {
  public:
   typedef ElementEx<ELEMENT_TEE> base_class;
   using base_class::base_class;
+
+  void SetAllowNotLinked(bool allow = false);  // true - false: false
 };
 
 class ElementCapsFilter : public ElementEx<ELEMENT_CAPS_FILTER> {
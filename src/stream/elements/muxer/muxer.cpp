@@ -33,9 +33,11 @@ ElementRTPMux* make_rtpmux(element_id_t muxer_id) {
   return make_muxer<ElementRTPMux>(muxer_id);
 }
 
-Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id) {
+Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id, bool udp_batch) {
   if (scheme == common::uri::Url::rtmp) {
     return make_flvmux(true, muxer_id);
+  } else if (scheme == common::uri::Url::udp && udp_batch) {
+    return make_mpegtsmux(muxer_id);
   } else if (scheme == common::uri::Url::udp) {
     return make_rtpmux(muxer_id);
   } else if (scheme == common::uri::Url::tcp) {
@@ -48,6 +50,19 @@ Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id) {
   return nullptr;
 }
 
+SupportedElements get_muxer_type(common::uri::Url::scheme scheme, bool udp_batch) {
+  if (scheme == common::uri::Url::rtmp) {
+    return ELEMENT_FLV_MUX;
+  } else if (scheme == common::uri::Url::udp && !udp_batch) {
+    return ELEMENT_RTP_MUX;
+  } else if (scheme == common::uri::Url::udp || scheme == common::uri::Url::tcp || scheme == common::uri::Url::http) {
+    return ELEMENT_MPEGTS_MUX;
+  }
+
+  NOTREACHED() << "Unknown output scheme: " << scheme;
+  return ELEMENT_MPEGTS_MUX;
+}
+
 void ElementFLVMux::SetStreamable(bool streamable) {
   SetProperty("streamable", streamable);
 }
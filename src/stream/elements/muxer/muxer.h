@@ -50,7 +50,10 @@ ElementFLVMux* make_flvmux(bool streamable, element_id_t muxer_id);
 ElementRTPMux* make_rtpmux(element_id_t muxer_id);
 ElementMPEGTSMux* make_mpegtsmux(element_id_t muxer_id);
 
-Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id);
+// udp outputs are rtp, batched udp outputs (udp_batch) carry plain mpeg-ts
+Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id, bool udp_batch = false);
+// outputs of the same type can share muxer
+SupportedElements get_muxer_type(common::uri::Url::scheme scheme, bool udp_batch = false);
 
 }  // namespace muxer
 }  // namespace elements
@@ -30,7 +30,7 @@ namespace stream {
 namespace elements {
 namespace sink {
 
-Element* build_output(const OutputUri& output, element_id_t sink_id) {
+Element* build_output(const OutputUri& output, element_id_t sink_id, bool udp_batch, bool behind_queue) {
   common::uri::Url uri = output.GetOutput();
   common::uri::Url::scheme scheme = uri.GetScheme();
 
@@ -41,6 +41,10 @@ Element* build_output(const OutputUri& output, element_id_t sink_id) {
       NOTREACHED() << "Unknownt output url: " << url;
       return nullptr;
     }
+    if (udp_batch) {
+      ElementUDPBatchSink* udp_batch_sink = elements::sink::make_udp_batch_sink(host, sink_id, behind_queue);
+      return udp_batch_sink;
+    }
     ElementUDPSink* udp_sink = elements::sink::make_udp_sink(host, sink_id);
     return udp_sink;
   } else if (scheme == common::uri::Url::tcp) {
@@ -72,6 +76,19 @@ Element* build_output(const OutputUri& output, element_id_t sink_id) {
   return nullptr;
 }
 
+ElementTCPClientsSink* make_tcp_clients_sink(const common::uri::Url& uri,
+                                             element_id_t sink_id,
+                                             size_t queue_bytes,
+                                             time_t evict_time) {
+  const std::string url = uri.GetHost();
+  common::net::HostAndPort host;
+  if (!common::ConvertFromString(url, &host)) {
+    NOTREACHED() << "Unknownt output url: " << url;
+    return nullptr;
+  }
+  return make_tcp_clients_sink(host, sink_id, queue_bytes, evict_time);
+}
+
 }  // namespace sink
 }  // namespace elements
 }  // namespace stream
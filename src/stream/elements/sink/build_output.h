@@ -16,8 +16,16 @@
 
 // for element_id_t
 
+#include <time.h>
+
 #include "stream/stypes.h"
 
+namespace common {
+namespace uri {
+class Url;
+}
+}  // namespace common
+
 namespace iptv_cloud {
 class OutputUri;
 namespace stream {
@@ -26,7 +34,18 @@ class Element;
 
 namespace sink {
 
-Element* build_output(const OutputUri& output, element_id_t sink_id);
+class ElementTCPClientsSink;
+
+// behind_queue: sink has own streaming thread, so batched udp output can be paced
+Element* build_output(const OutputUri& output,
+                      element_id_t sink_id,
+                      bool udp_batch = false,
+                      bool behind_queue = false);
+// tcp output served to many clients, queue_bytes limit of one client, evict_time in msec
+ElementTCPClientsSink* make_tcp_clients_sink(const common::uri::Url& uri,
+                                             element_id_t sink_id,
+                                             size_t queue_bytes,
+                                             time_t evict_time);
 
 }  // namespace sink
 }  // namespace elements
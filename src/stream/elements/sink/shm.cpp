@@ -0,0 +1,55 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/shm.h"
+
+namespace iptv_cloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+gboolean ElementShmSink::RegisterClientConnectedCallback(client_callback_t cb, gpointer user_data) {
+  return RegisterCallback("client-connected", G_CALLBACK(cb), user_data);
+}
+
+gboolean ElementShmSink::RegisterClientDisconnectedCallback(client_callback_t cb, gpointer user_data) {
+  return RegisterCallback("client-disconnected", G_CALLBACK(cb), user_data);
+}
+
+void ElementShmSink::SetSocketPath(const std::string& path) {
+  SetProperty("socket-path", path);
+}
+
+void ElementShmSink::SetShmSize(guint size) {
+  SetProperty("shm-size", size);
+}
+
+void ElementShmSink::SetWaitForConnection(bool wait) {
+  SetProperty("wait-for-connection", wait);
+}
+
+ElementShmSink* make_shm_sink(const std::string& socket_path, guint shm_size, element_id_t sink_id) {
+  ElementShmSink* shm_sink = make_sink<ElementShmSink>(sink_id);
+  shm_sink->SetSocketPath(socket_path);
+  shm_sink->SetShmSize(shm_size);
+  // ingest runs without readers too, reader holding buffers stalls sink (and other readers) once shm area is full
+  shm_sink->SetWaitForConnection(false);
+  shm_sink->SetSync(false);
+  return shm_sink;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace iptv_cloud
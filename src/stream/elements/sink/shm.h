@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "stream/elements/element.h"    // for SupportedElements::ELEMENT_SHM_SINK
+#include "stream/elements/sink/sink.h"  // for ElementSync
+
+namespace iptv_cloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+// publishes buffers into shared memory, readers attach through control socket
+class ElementShmSink : public ElementSync<ELEMENT_SHM_SINK> {
+ public:
+  typedef ElementSync<ELEMENT_SHM_SINK> base_class;
+  typedef void (*client_callback_t)(GstElement* shmsink, gint fd, gpointer user_data);
+  using base_class::base_class;
+
+  gboolean RegisterClientConnectedCallback(client_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
+  gboolean RegisterClientDisconnectedCallback(client_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
+
+  void SetSocketPath(const std::string& path);
+  void SetShmSize(guint size);                  // bytes; Default: 67108864
+  void SetWaitForConnection(bool wait = true);  // Default: true
+};
+
+ElementShmSink* make_shm_sink(const std::string& socket_path, guint shm_size, element_id_t sink_id);
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -14,13 +14,56 @@
 
 #include "stream/elements/sink/tcp.h"
 
+#include <string.h>
+
 #include <string>
 
+#include <gst/app/gstappsink.h>  // for GST_APP_SINK
+
+#include <common/utils.h>
+
+#include "stream/tcp_clients_server.h"
+
 namespace iptv_cloud {
 namespace stream {
 namespace elements {
 namespace sink {
 
+namespace {
+
+GstFlowReturn tcp_clients_new_sample(GstAppSink* appsink, gpointer user_data) {
+  TcpClientsServer* server = static_cast<TcpClientsServer*>(user_data);
+  if (!server->IsOpen()) {
+    GST_ELEMENT_ERROR(appsink, RESOURCE, OPEN_WRITE, ("Tcp clients server not listening."), (NULL));
+    return GST_FLOW_ERROR;
+  }
+
+  GstSample* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  GstMapInfo map;
+  if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    // mpegtsmux marks buffers starting with keyframe by absence of delta unit flag
+    server->Write(map.data, map.size, !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT));
+    gst_buffer_unmap(buffer, &map);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+void tcp_clients_destroy(gpointer user_data) {
+  TcpClientsServer* server = static_cast<TcpClientsServer*>(user_data);
+  const TcpClientsServer::Stats stats = server->GetStats();
+  INFO_LOG() << "Tcp clients output accepted clients: " << stats.accepted << ", rejected: " << stats.rejected
+             << ", evicted: " << stats.evicted;
+  delete server;
+}
+
+}  // namespace
+
 void ElementTCPServerSink::SetHost(const std::string& host) {
   SetProperty("host", host);
 }
@@ -29,6 +72,22 @@ void ElementTCPServerSink::SetPort(uint16_t port) {
   SetProperty("port", port);
 }
 
+ElementTCPClientsSink::ElementTCPClientsSink(const std::string& name) : base_class(name), server_(nullptr) {}
+
+void ElementTCPClientsSink::SetServer(TcpClientsServer* server) {
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.new_sample = tcp_clients_new_sample;
+  gst_app_sink_set_callbacks(GST_APP_SINK(GetGstElement()), &callbacks, server, tcp_clients_destroy);
+  server_ = server;
+}
+
+void ElementTCPClientsSink::SetStats(ChannelStats* stats) {
+  if (server_) {
+    server_->SetStats(stats);
+  }
+}
+
 ElementTCPServerSink* make_tcp_server_sink(const common::net::HostAndPort& host, element_id_t sink_id) {
   ElementTCPServerSink* tcp_out = make_sink<ElementTCPServerSink>(sink_id);
   tcp_out->SetHost(host.GetHost());
@@ -36,6 +95,20 @@ ElementTCPServerSink* make_tcp_server_sink(const common::net::HostAndPort& host,
   return tcp_out;
 }
 
+ElementTCPClientsSink* make_tcp_clients_sink(const common::net::HostAndPort& host,
+                                             element_id_t sink_id,
+                                             size_t queue_bytes,
+                                             time_t evict_time) {
+  ElementTCPClientsSink* tcp_out = make_sink<ElementTCPClientsSink>(sink_id);
+  TcpClientsServer* server = new TcpClientsServer(queue_bytes, evict_time);
+  common::ErrnoError err = server->Open(host);
+  if (err) {  // element error posted from streaming thread
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+  }
+  tcp_out->SetServer(server);
+  return tcp_out;
+}
+
 }  // namespace sink
 }  // namespace elements
 }  // namespace stream
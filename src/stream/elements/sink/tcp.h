@@ -28,7 +28,11 @@ struct HostAndPort;
 }
 
 namespace iptv_cloud {
+class ChannelStats;
 namespace stream {
+
+class TcpClientsServer;
+
 namespace elements {
 namespace sink {
 
@@ -41,7 +45,27 @@ class ElementTCPServerSink : public ElementSync<ELEMENT_TCP_SERVER_SINK> {
   void SetPort(uint16_t port = 5004);                   // 0 - 65535; Default: 5004
 };
 
+// mpeg-ts for many tcp clients, bounded queue per client, clients start from keyframe, slow ones evicted
+class ElementTCPClientsSink : public ElementSync<ELEMENT_APP_SINK> {
+ public:
+  typedef ElementSync<ELEMENT_APP_SINK> base_class;
+
+  explicit ElementTCPClientsSink(const std::string& name);
+
+  // takes ownership, server deleted with gst element, after streaming thread is stopped
+  void SetServer(TcpClientsServer* server);
+  void SetStats(ChannelStats* stats);
+
+ private:
+  TcpClientsServer* server_;
+};
+
 ElementTCPServerSink* make_tcp_server_sink(const common::net::HostAndPort& host, element_id_t sink_id);
+// queue_bytes limit of one client, evict_time in msec
+ElementTCPClientsSink* make_tcp_clients_sink(const common::net::HostAndPort& host,
+                                             element_id_t sink_id,
+                                             size_t queue_bytes,
+                                             time_t evict_time);
 
 }  // namespace sink
 }  // namespace elements
@@ -14,13 +14,66 @@
 
 #include "stream/elements/sink/udp.h"
 
+#include <string.h>
+
 #include <string>
 
+#include <gst/app/gstappsink.h>  // for GST_APP_SINK
+
+#include <common/utils.h>
+
+#include "stream/udp_batch_sender.h"
+
 namespace iptv_cloud {
 namespace stream {
 namespace elements {
 namespace sink {
 
+namespace {
+
+GstFlowReturn udp_batch_new_sample(GstAppSink* appsink, gpointer user_data) {
+  UdpBatchSender* sender = static_cast<UdpBatchSender*>(user_data);
+  GstSample* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  common::ErrnoError err;
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  GstMapInfo map;
+  if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    err = sender->Write(map.data, map.size);
+    gst_buffer_unmap(buffer, &map);
+  }
+  gst_sample_unref(sample);
+
+  if (err) {
+    GST_ELEMENT_ERROR(appsink, RESOURCE, WRITE, ("%s", err->GetDescription().c_str()), (NULL));
+    return GST_FLOW_ERROR;
+  }
+  return GST_FLOW_OK;
+}
+
+void udp_batch_eos(GstAppSink* appsink, gpointer user_data) {
+  UNUSED(appsink);
+  UdpBatchSender* sender = static_cast<UdpBatchSender*>(user_data);
+  common::ErrnoError err = sender->Flush();
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+  }
+}
+
+void udp_batch_destroy(gpointer user_data) {
+  UdpBatchSender* sender = static_cast<UdpBatchSender*>(user_data);
+  const UdpBatchSender::Stats stats = sender->GetStats();
+  INFO_LOG() << "Udp batch output sent datagrams: " << stats.datagrams << ", ts packets: " << stats.ts_packets
+             << ", bursts: " << stats.bursts << ", paced waits: " << stats.paced_waits
+             << ", send errors: " << stats.send_errors;
+  delete sender;
+}
+
+}  // namespace
+
 void ElementUDPSink::SetHost(const std::string& host) {
   SetProperty("host", host);
 }
@@ -29,6 +82,14 @@ void ElementUDPSink::SetPort(uint16_t port) {
   SetProperty("port", port);
 }
 
+void ElementUDPBatchSink::SetSender(UdpBatchSender* sender) {
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.eos = udp_batch_eos;
+  callbacks.new_sample = udp_batch_new_sample;
+  gst_app_sink_set_callbacks(GST_APP_SINK(GetGstElement()), &callbacks, sender, udp_batch_destroy);
+}
+
 ElementUDPSink* make_udp_sink(const common::net::HostAndPort& host, element_id_t sink_id) {
   ElementUDPSink* udp_out = make_sink<ElementUDPSink>(sink_id);
   udp_out->SetHost(host.GetHost());
@@ -36,6 +97,21 @@ ElementUDPSink* make_udp_sink(const common::net::HostAndPort& host, element_id_t
   return udp_out;
 }
 
+ElementUDPBatchSink* make_udp_batch_sink(const common::net::HostAndPort& host, element_id_t sink_id, bool pacing) {
+  UdpBatchSender* sender = new UdpBatchSender;
+  sender->SetPacing(pacing);
+  common::ErrnoError err = sender->Open(host);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    delete sender;
+    return nullptr;
+  }
+
+  ElementUDPBatchSink* udp_out = make_sink<ElementUDPBatchSink>(sink_id);
+  udp_out->SetSender(sender);
+  return udp_out;
+}
+
 }  // namespace sink
 }  // namespace elements
 }  // namespace stream
@@ -29,6 +29,9 @@ struct HostAndPort;
 
 namespace iptv_cloud {
 namespace stream {
+
+class UdpBatchSender;
+
 namespace elements {
 namespace sink {
 
@@ -41,7 +44,19 @@ class ElementUDPSink : public ElementSync<ELEMENT_UDP_SINK> {
   void SetPort(uint16_t port = 5004);                   // 0 - 65535; Default: 5004
 };
 
+// mpeg-ts over udp without rtp, 7 ts packets per datagram, datagrams sent by paced sendmmsg bursts
+class ElementUDPBatchSink : public ElementSync<ELEMENT_APP_SINK> {
+ public:
+  typedef ElementSync<ELEMENT_APP_SINK> base_class;
+  using base_class::base_class;
+
+  // takes ownership, sender deleted with gst element, after streaming thread is stopped
+  void SetSender(UdpBatchSender* sender);
+};
+
 ElementUDPSink* make_udp_sink(const common::net::HostAndPort& host, element_id_t sink_id);
+// pacing blocks streaming thread, only sink behind own queue is paced; nullptr if socket can't be opened
+ElementUDPBatchSink* make_udp_batch_sink(const common::net::HostAndPort& host, element_id_t sink_id, bool pacing);
 
 }  // namespace sink
 }  // namespace elements
@@ -60,6 +60,16 @@ Element* make_src(const common::uri::Url& uri, element_id_t input_id, gint timeo
   return nullptr;
 }
 
+ElementUDPBatchSrc* make_udp_batch_src(const common::uri::Url& uri, element_id_t input_id, int rcvbuf, time_t latency) {
+  std::string host_str = uri.GetHost();
+  common::net::HostAndPort host;
+  if (!common::ConvertFromString(host_str, &host)) {
+    NOTREACHED() << "Unknownt input url: " << host_str;
+    return nullptr;
+  }
+  return make_udp_batch_src(host, input_id, rcvbuf, latency);
+}
+
 }  // namespace sources
 }  // namespace elements
 }  // namespace stream
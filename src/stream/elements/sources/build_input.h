@@ -29,7 +29,11 @@ namespace stream {
 namespace elements {
 namespace sources {
 
+class ElementUDPBatchSrc;
+
 Element* make_src(const common::uri::Url& uri, element_id_t input_id, gint timeout_secs);
+// udp input read by recvmmsg batches with rtp reorder buffer, rcvbuf in bytes, latency in msec
+ElementUDPBatchSrc* make_udp_batch_src(const common::uri::Url& uri, element_id_t input_id, int rcvbuf, time_t latency);
 
 }  // namespace sources
 }  // namespace elements
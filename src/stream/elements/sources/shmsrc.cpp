@@ -0,0 +1,42 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sources/shmsrc.h"
+
+namespace iptv_cloud {
+namespace stream {
+namespace elements {
+namespace sources {
+
+void ElementShmSrc::SetSocketPath(const std::string& path) {
+  SetProperty("socket-path", path);
+}
+
+void ElementShmSrc::SetIsLive(bool live) {
+  SetProperty("is-live", live);
+}
+
+ElementShmSrc* make_shm_src(const std::string& socket_path, element_id_t input_id) {
+  ElementShmSrc* shm_src = make_sources<ElementShmSrc>(input_id);
+  shm_src->SetSocketPath(socket_path);
+  shm_src->SetIsLive(true);
+  // caps not transferred over shm, decodebin typefinds container
+  shm_src->SetProperty("do-timestamp", true);
+  return shm_src;
+}
+
+}  // namespace sources
+}  // namespace elements
+}  // namespace stream
+}  // namespace iptv_cloud
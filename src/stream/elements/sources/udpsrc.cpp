@@ -14,11 +14,67 @@
 
 #include "stream/elements/sources/udpsrc.h"
 
+#include <string.h>
+
+#include <vector>
+
+#include <gst/app/gstappsrc.h>  // for GST_APP_SRC
+
+#include <common/utils.h>
+
+#include "stream/udp_batch_receiver.h"
+
 namespace iptv_cloud {
 namespace stream {
 namespace elements {
 namespace sources {
 
+namespace {
+
+const int udp_batch_read_timeout_msec = 100;  // how fast stopping source is noticed
+
+void udp_batch_free_data(gpointer data) {
+  delete static_cast<std::vector<uint8_t>*>(data);
+}
+
+void udp_batch_need_data(GstAppSrc* appsrc, guint length, gpointer user_data) {
+  UNUSED(length);
+  UdpBatchReceiver* receiver = static_cast<UdpBatchReceiver*>(user_data);
+  GstPad* pad = GST_BASE_SRC_PAD(appsrc);
+  std::vector<uint8_t>* data = new std::vector<uint8_t>;
+  data->reserve(UdpBatchReceiver::max_batch_datagrams * UdpBatchReceiver::max_datagram_size);
+
+  // appsrc waits for buffer after need-data, so read till something comes or source is stopped
+  while (data->empty() && !GST_PAD_IS_FLUSHING(pad)) {
+    common::ErrnoError err = receiver->Read(udp_batch_read_timeout_msec, data);
+    if (err) {
+      delete data;
+      GST_ELEMENT_ERROR(appsrc, RESOURCE, READ, ("%s", err->GetDescription().c_str()), (NULL));
+      return;
+    }
+  }
+
+  if (data->empty()) {
+    delete data;
+    return;
+  }
+
+  GstBuffer* buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, data->data(), data->size(), 0,
+                                                  data->size(), data, udp_batch_free_data);
+  gst_app_src_push_buffer(appsrc, buffer);
+}
+
+void udp_batch_destroy(gpointer user_data) {
+  UdpBatchReceiver* receiver = static_cast<UdpBatchReceiver*>(user_data);
+  const RtpJitterBuffer* jitter = receiver->GetJitterBuffer();
+  INFO_LOG() << "Udp batch input received datagrams: " << receiver->GetDatagrams()
+             << ", rtp lost: " << jitter->GetLost() << ", reordered: " << jitter->GetReordered()
+             << ", duplicates: " << jitter->GetDuplicates();
+  delete receiver;
+}
+
+}  // namespace
+
 void ElementUDPSrc::SetUri(const std::string& uri) {
   SetProperty("uri", uri);
 }
@@ -31,6 +87,22 @@ void ElementUDPSrc::SetPort(uint16_t port) {
   SetProperty("port", port);
 }
 
+ElementUDPBatchSrc::ElementUDPBatchSrc(const std::string& name) : base_class(name), receiver_(nullptr) {}
+
+void ElementUDPBatchSrc::SetReceiver(UdpBatchReceiver* receiver) {
+  GstAppSrcCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.need_data = udp_batch_need_data;
+  gst_app_src_set_callbacks(GST_APP_SRC(GetGstElement()), &callbacks, receiver, udp_batch_destroy);
+  receiver_ = receiver;
+}
+
+void ElementUDPBatchSrc::SetStats(ChannelStats* stats) {
+  if (receiver_) {
+    receiver_->SetStats(stats);
+  }
+}
+
 ElementUDPSrc* make_udp_src(const common::net::HostAndPort& host, element_id_t input_id) {
   ElementUDPSrc* udpsrc = make_sources<ElementUDPSrc>(input_id);
   udpsrc->SetAddress(host.GetHost());
@@ -38,6 +110,30 @@ ElementUDPSrc* make_udp_src(const common::net::HostAndPort& host, element_id_t i
   return udpsrc;
 }
 
+ElementUDPBatchSrc* make_udp_batch_src(const common::net::HostAndPort& host,
+                                       element_id_t input_id,
+                                       int rcvbuf,
+                                       time_t latency) {
+  ElementUDPBatchSrc* udpsrc = make_sources<ElementUDPBatchSrc>(input_id);
+  udpsrc->SetProperty("is-live", true);
+  udpsrc->SetProperty("do-timestamp", true);
+  udpsrc->SetProperty("format", static_cast<gint>(GST_FORMAT_TIME));
+  GstCaps* caps = gst_caps_new_simple("video/mpegts", "systemstream", G_TYPE_BOOLEAN, TRUE, nullptr);
+  gst_app_src_set_caps(GST_APP_SRC(udpsrc->GetGstElement()), caps);
+  gst_caps_unref(caps);
+
+  UdpBatchReceiver* receiver = new UdpBatchReceiver(latency * GST_MSECOND);
+  common::ErrnoError err = receiver->Open(host, rcvbuf);
+  if (err) {  // reads fail, element error posted from streaming thread
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+  } else if (receiver->GetReceiveBufferSize() < rcvbuf) {
+    WARNING_LOG() << "Udp input receive buffer limited by kernel: " << receiver->GetReceiveBufferSize()
+                  << " bytes instead of " << rcvbuf << ", raise net.core.rmem_max";
+  }
+  udpsrc->SetReceiver(receiver);
+  return udpsrc;
+}
+
 }  // namespace sources
 }  // namespace elements
 }  // namespace stream
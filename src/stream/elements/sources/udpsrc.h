@@ -24,7 +24,11 @@
 #include "stream/elements/sources/sources.h"
 
 namespace iptv_cloud {
+class ChannelStats;
 namespace stream {
+
+class UdpBatchReceiver;
+
 namespace elements {
 namespace sources {
 
@@ -38,7 +42,27 @@ class ElementUDPSrc : public ElementEx<ELEMENT_UDP_SRC> {
   void SetUri(const std::string& uri = "udp://0.0.0.0:5004");  // String. Default: "udp://0.0.0.0:5004"
 };
 
+// mpeg-ts of udp input read by recvmmsg batches, rtp reordered by sequence numbers and unwrapped
+class ElementUDPBatchSrc : public ElementEx<ELEMENT_APP_SRC> {
+ public:
+  typedef ElementEx<ELEMENT_APP_SRC> base_class;
+
+  explicit ElementUDPBatchSrc(const std::string& name);
+
+  // takes ownership, receiver deleted with gst element, after streaming thread is stopped
+  void SetReceiver(UdpBatchReceiver* receiver);
+  void SetStats(ChannelStats* stats);
+
+ private:
+  UdpBatchReceiver* receiver_;
+};
+
 ElementUDPSrc* make_udp_src(const common::net::HostAndPort& host, element_id_t input_id);
+// rcvbuf in bytes, latency of rtp reorder in msec
+ElementUDPBatchSrc* make_udp_batch_src(const common::net::HostAndPort& host,
+                                       element_id_t input_id,
+                                       int rcvbuf,
+                                       time_t latency);
 
 }  // namespace sources
 }  // namespace elements
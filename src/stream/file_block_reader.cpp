@@ -0,0 +1,247 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/file_block_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace iptv_cloud {
+namespace stream {
+
+struct FileBlockReader::Mapping {
+  static Mapping* Create(void* data, size_t size) {
+    Mapping* mapping = new Mapping;
+    mapping->data = data;
+    mapping->size = size;
+    mapping->refs = 1;
+    return mapping;
+  }
+
+  static void Ref(Mapping* mapping) { g_atomic_int_inc(&mapping->refs); }
+
+  static void Unref(gpointer user_data) {
+    Mapping* mapping = static_cast<Mapping*>(user_data);
+    if (g_atomic_int_dec_and_test(&mapping->refs)) {
+      munmap(mapping->data, mapping->size);
+      delete mapping;
+    }
+  }
+
+  void* data;
+  size_t size;
+  gint refs;  // reader and blocks in flight
+};
+
+FileBlockReader::FileBlockReader(size_t block_size)
+    : block_size_(block_size),
+      fd_(INVALID_DESCRIPTOR),
+      file_size_(0),
+      offset_(0),
+      read_ahead_offset_(0),
+      mapping_(nullptr),
+      pool_(nullptr) {
+  CHECK(block_size_) << "Block size must be!";
+}
+
+FileBlockReader::~FileBlockReader() {
+  Close();
+  if (pool_) {
+    gst_buffer_pool_set_active(pool_, FALSE);
+    gst_object_unref(pool_);
+    pool_ = nullptr;
+  }
+}
+
+common::ErrnoError FileBlockReader::Open(const std::string& path) {
+  Close();
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == ERROR_RESULT_VALUE) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    ::close(fd);
+    return err;
+  }
+
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  fd_ = fd;
+  file_size_ = st.st_size;
+  offset_ = 0;
+  read_ahead_offset_ = 0;
+
+  if (S_ISREG(st.st_mode) && file_size_ != 0) {
+    void* data = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      madvise(data, file_size_, MADV_SEQUENTIAL);
+      mapping_ = Mapping::Create(data, file_size_);
+      return common::ErrnoError();
+    }
+  }
+
+  return ActivatePool();  // pipes, empty (growing) files or mmap failure
+}
+
+bool FileBlockReader::IsOpen() const {
+  return fd_ != INVALID_DESCRIPTOR;
+}
+
+bool FileBlockReader::IsMapped() const {
+  return mapping_ != nullptr;
+}
+
+void FileBlockReader::Close() {
+  if (mapping_) {
+    Mapping::Unref(mapping_);  // pushed blocks keep their own references
+    mapping_ = nullptr;
+  }
+
+  if (fd_ != INVALID_DESCRIPTOR) {
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);  // playlist files are played once per loop
+    ::close(fd_);
+    fd_ = INVALID_DESCRIPTOR;
+  }
+  file_size_ = 0;
+  offset_ = 0;
+  read_ahead_offset_ = 0;
+}
+
+void FileBlockReader::Prefetch() {
+  if (!mapping_) {  // not regular files can't be read twice
+    return;
+  }
+
+  const size_t size = std::min(file_size_, block_size_ * read_ahead_blocks);
+  readahead(fd_, 0, size);
+  read_ahead_offset_ = size;
+}
+
+common::ErrnoError FileBlockReader::ReadBlock(GstBuffer** buffer) {
+  if (!buffer || !IsOpen()) {
+    return common::make_errno_error_inval();
+  }
+
+  if (mapping_) {
+    return ReadMappedBlock(buffer);
+  }
+
+  return ReadPoolBlock(buffer);
+}
+
+size_t FileBlockReader::GetBlockSize() const {
+  return block_size_;
+}
+
+common::ErrnoError FileBlockReader::ReadMappedBlock(GstBuffer** buffer) {
+  if (offset_ >= file_size_) {
+    *buffer = nullptr;
+    return common::ErrnoError();
+  }
+
+  ReadAhead();
+  const size_t size = std::min(block_size_, file_size_ - offset_);
+  Mapping::Ref(mapping_);
+  GstMemory* memory = gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, mapping_->data, mapping_->size, offset_, size,
+                                             mapping_, Mapping::Unref);
+  GstBuffer* block = gst_buffer_new();
+  gst_buffer_append_memory(block, memory);
+  offset_ += size;
+  *buffer = block;
+  return common::ErrnoError();
+}
+
+common::ErrnoError FileBlockReader::ReadPoolBlock(GstBuffer** buffer) {
+  GstBuffer* block = nullptr;
+  GstFlowReturn ret = gst_buffer_pool_acquire_buffer(pool_, &block, nullptr);
+  if (ret != GST_FLOW_OK) {
+    return common::make_errno_error(gst_flow_get_name(ret), EAGAIN);
+  }
+
+  GstMapInfo info;
+  if (!gst_buffer_map(block, &info, GST_MAP_WRITE)) {
+    gst_buffer_unref(block);
+    return common::make_errno_error("Can't map pool buffer.", EINVAL);
+  }
+
+  size_t size = 0;
+  while (size < block_size_) {  // one syscall per block for regular files
+    ssize_t nread = ::read(fd_, info.data + size, block_size_ - size);
+    if (nread == ERROR_RESULT_VALUE) {
+      if (errno == EINTR) {
+        continue;
+      }
+      common::ErrnoError err = common::make_errno_error(errno);
+      gst_buffer_unmap(block, &info);
+      gst_buffer_unref(block);
+      return err;
+    }
+    if (nread == 0) {
+      break;
+    }
+    size += nread;
+  }
+  gst_buffer_unmap(block, &info);
+
+  if (size == 0) {
+    gst_buffer_unref(block);
+    *buffer = nullptr;
+    return common::ErrnoError();
+  }
+
+  gst_buffer_set_size(block, size);  // pool restores full size when buffer released
+  offset_ += size;
+  *buffer = block;
+  return common::ErrnoError();
+}
+
+common::ErrnoError FileBlockReader::ActivatePool() {
+  if (pool_) {
+    return common::ErrnoError();
+  }
+
+  GstBufferPool* pool = gst_buffer_pool_new();
+  GstStructure* config = gst_buffer_pool_get_config(pool);
+  gst_buffer_pool_config_set_params(config, nullptr, block_size_, read_ahead_blocks, 0);
+  if (!gst_buffer_pool_set_config(pool, config) || !gst_buffer_pool_set_active(pool, TRUE)) {
+    gst_object_unref(pool);
+    Close();
+    return common::make_errno_error("Can't activate blocks pool.", EINVAL);
+  }
+
+  pool_ = pool;
+  return common::ErrnoError();
+}
+
+void FileBlockReader::ReadAhead() {
+  // keep read_ahead_blocks ahead of demuxer in page cache, mapping faults then don't wait for disk
+  const size_t wanted = std::min(file_size_, offset_ + block_size_ * read_ahead_blocks);
+  if (read_ahead_offset_ >= wanted) {
+    return;
+  }
+
+  const size_t from = std::max(read_ahead_offset_, offset_);
+  posix_fadvise(fd_, from, wanted - from, POSIX_FADV_WILLNEED);
+  read_ahead_offset_ = wanted;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
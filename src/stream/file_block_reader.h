@@ -0,0 +1,71 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <gst/gstbuffer.h>
+#include <gst/gstbufferpool.h>
+
+#include <common/error.h>
+#include <common/types.h>
+
+namespace iptv_cloud {
+namespace stream {
+
+// Reads file by big blocks for appsrc of playlist streams.
+// Regular files are mapped and blocks are GstMemory over mapping (no copy), mapping lives while any buffer uses it.
+// If file can't be mapped, blocks are read into buffers of pool, buffers return to pool when downstream frees them.
+class FileBlockReader {
+ public:
+  enum { read_ahead_blocks = 4 };
+
+  explicit FileBlockReader(size_t block_size);
+  ~FileBlockReader();
+
+  common::ErrnoError Open(const std::string& path) WARN_UNUSED_RESULT;
+  bool IsOpen() const;
+  bool IsMapped() const;
+  void Close();
+
+  // blocks until first blocks are in page cache, for opening of next file in background
+  void Prefetch();
+
+  // next block, *buffer is nullptr at the end of file
+  common::ErrnoError ReadBlock(GstBuffer** buffer) WARN_UNUSED_RESULT;
+
+  size_t GetBlockSize() const;
+
+ private:
+  struct Mapping;
+
+  common::ErrnoError ReadMappedBlock(GstBuffer** buffer) WARN_UNUSED_RESULT;
+  common::ErrnoError ReadPoolBlock(GstBuffer** buffer) WARN_UNUSED_RESULT;
+  common::ErrnoError ActivatePool() WARN_UNUSED_RESULT;
+  void ReadAhead();
+
+  const size_t block_size_;
+  int fd_;
+  size_t file_size_;
+  size_t offset_;
+  size_t read_ahead_offset_;
+  Mapping* mapping_;
+  GstBufferPool* pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileBlockReader);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,192 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/hls_master_playlist.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include <common/sprintf.h>
+
+#include "utils/m3u8_writer.h"
+
+namespace iptv_cloud {
+namespace stream {
+
+HlsMasterPlaylist::Variant::Variant()
+    : info(), video_codec(), audio_codec(), have_video_caps(false), have_audio_caps(false) {}
+
+HlsMasterPlaylist::HlsMasterPlaylist(const common::file_system::ascii_file_string_path& path, bool have_audio)
+    : path_(path), have_audio_(have_audio), mutex_(), variants_(), written_() {}
+
+size_t HlsMasterPlaylist::AddVariant(const std::string& uri, uint64_t bandwidth) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  Variant var;
+  var.info.uri = uri;
+  var.info.bandwidth = bandwidth;
+  variants_.push_back(var);
+  return variants_.size() - 1;
+}
+
+void HlsMasterPlaylist::LinkPad(size_t variant, Track track, GstPad* pad) {
+  if (!pad) {
+    return;
+  }
+
+  VariantPad* vpad = new VariantPad{shared_from_this(), variant, track};
+  const GstPadProbeType mask =
+      static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_EVENT_UPSTREAM);
+  gst_pad_add_probe(pad, mask, variant_probe_callback, vpad, destroy_variant_pad);
+}
+
+GstPadProbeReturn HlsMasterPlaylist::variant_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  VariantPad* vpad = static_cast<VariantPad*>(user_data);
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    vpad->master->HandleCaps(vpad->variant, vpad->track, caps);
+    return GST_PAD_PROBE_OK;
+  }
+
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CUSTOM_UPSTREAM &&
+      gst_structure_has_name(gst_event_get_structure(event), "GstForceKeyUnit")) {
+    return GST_PAD_PROBE_DROP;  // hlssink schedule, not aligned with other variants
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+void HlsMasterPlaylist::destroy_variant_pad(gpointer user_data) {
+  delete static_cast<VariantPad*>(user_data);
+}
+
+void HlsMasterPlaylist::HandleCaps(size_t variant, Track track, GstCaps* caps) {
+  if (!caps || gst_caps_is_empty(caps)) {
+    return;
+  }
+
+  const GstStructure* st = gst_caps_get_structure(caps, 0);
+  const std::string name = gst_structure_get_name(st);
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (variant >= variants_.size()) {
+    return;
+  }
+
+  Variant* var = &variants_[variant];
+  if (track == VIDEO_TRACK) {
+    gint width = 0;
+    gint height = 0;
+    if (gst_structure_get_int(st, "width", &width) && gst_structure_get_int(st, "height", &height)) {
+      var->info.width = width;
+      var->info.height = height;
+    }
+
+    const gchar* profile = gst_structure_get_string(st, "profile");
+    const gchar* level = gst_structure_get_string(st, "level");
+    if (profile && level) {
+      if (name == "video/x-h264") {
+        var->video_codec = utils::MakeH264CodecTag(profile, level);
+      } else if (name == "video/x-h265") {
+        var->video_codec = utils::MakeH265CodecTag(profile, level);
+      }
+    }
+    var->have_video_caps = true;
+  } else {
+    gint mpegversion = 0;
+    if (name == "audio/mpeg" && gst_structure_get_int(st, "mpegversion", &mpegversion)) {
+      var->audio_codec = utils::MakeMpegAudioCodecTag(mpegversion);
+    }
+    var->have_audio_caps = true;
+  }
+
+  if (!IsReady()) {
+    return;
+  }
+
+  common::ErrnoError err = WriteContent();
+  if (err) {
+    WARNING_LOG() << "Failed to write master playlist " << path_.GetPath() << ": " << err->GetDescription();
+  }
+}
+
+bool HlsMasterPlaylist::IsReady() const {
+  for (const Variant& var : variants_) {
+    if (!var.have_video_caps || (have_audio_ && !var.have_audio_caps)) {
+      return false;
+    }
+  }
+
+  return !variants_.empty();
+}
+
+utils::VariantInfo HlsMasterPlaylist::MakeVariantInfo(const Variant& var) const {
+  utils::VariantInfo info = var.info;
+  info.codecs = var.video_codec;
+  // CODECS must list every codec of variant, omitted when one of them is unknown
+  if (have_audio_ && !info.codecs.empty()) {
+    info.codecs = var.audio_codec.empty() ? std::string() : info.codecs + "," + var.audio_codec;
+  }
+  return info;
+}
+
+common::ErrnoError HlsMasterPlaylist::WriteContent() {
+  std::vector<utils::VariantInfo> infos;
+  std::string content;
+  for (const Variant& var : variants_) {
+    const utils::VariantInfo info = MakeVariantInfo(var);
+    content += common::MemSPrintf("%s %d %d %s\n", info.uri, info.width, info.height, info.codecs);
+    infos.push_back(info);
+  }
+
+  if (content == written_) {
+    return common::ErrnoError();
+  }
+
+  // players can read master at any time, so it is replaced atomically
+  const std::string path = path_.GetPath();
+  const std::string tmp_path = path + ".tmp";
+  utils::M3u8Writer writer;
+  common::ErrnoError err =
+      writer.Open(common::file_system::ascii_file_string_path(tmp_path),
+                  common::file_system::File::FLAG_CREATE | common::file_system::File::FLAG_WRITE);
+  if (err) {
+    return err;
+  }
+
+  err = writer.WriteMasterHeader();
+  for (size_t i = 0; i < infos.size() && !err; ++i) {
+    err = writer.WriteVariant(infos[i]);
+  }
+
+  common::ErrnoError close_err = writer.Close();
+  if (err) {
+    return err;
+  }
+  if (close_err) {
+    return close_err;
+  }
+
+  if (rename(tmp_path.c_str(), path.c_str()) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  written_ = content;
+  return common::ErrnoError();
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
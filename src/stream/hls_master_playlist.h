@@ -0,0 +1,82 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gst/gstpad.h>
+
+#include <common/error.h>
+#include <common/file_system/path.h>
+
+#include "utils/variant_info.h"
+
+namespace iptv_cloud {
+namespace stream {
+
+// Master playlist of abr hls output, its variants are hls outputs of renditions.
+// Resolution and codecs are taken from negotiated caps, file is (re)written when all variants have them.
+// Variants are cut only on keyframes aligned across renditions, so own key unit requests of hlssinks are dropped.
+class HlsMasterPlaylist : public std::enable_shared_from_this<HlsMasterPlaylist> {
+ public:
+  enum Track { VIDEO_TRACK = 0, AUDIO_TRACK = 1 };
+
+  HlsMasterPlaylist(const common::file_system::ascii_file_string_path& path, bool have_audio);
+
+  size_t AddVariant(const std::string& uri, uint64_t bandwidth);  // returns variant index
+
+  // encoded pad of variant output
+  void LinkPad(size_t variant, Track track, GstPad* pad);
+
+ private:
+  struct Variant {
+    Variant();
+
+    utils::VariantInfo info;
+    std::string video_codec;
+    std::string audio_codec;
+    bool have_video_caps;
+    bool have_audio_caps;
+  };
+
+  struct VariantPad {
+    std::shared_ptr<HlsMasterPlaylist> master;
+    size_t variant;
+    Track track;
+  };
+
+  static GstPadProbeReturn variant_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void destroy_variant_pad(gpointer user_data);
+  void HandleCaps(size_t variant, Track track, GstCaps* caps);
+
+  bool IsReady() const;
+  utils::VariantInfo MakeVariantInfo(const Variant& var) const;
+  common::ErrnoError WriteContent() WARN_UNUSED_RESULT;
+
+  const common::file_system::ascii_file_string_path path_;
+  const bool have_audio_;
+
+  std::mutex mutex_;
+  std::vector<Variant> variants_;
+  std::string written_;  // variants of file on disk
+
+  DISALLOW_COPY_AND_ASSIGN(HlsMasterPlaylist);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -21,6 +21,10 @@
 
 #include "stream/elements/element.h"
 #include "stream/elements/sink/build_output.h"
+#include "stream/elements/sink/tcp.h"
+#include "stream/elements/sources/build_input.h"
+#include "stream/elements/sources/shmsrc.h"
+#include "stream/elements/sources/udpsrc.h"
 #include "stream/ibase_builder_observer.h"
 
 #include "pad/pad.h"
@@ -81,8 +85,25 @@ IBaseBuilderObserver* IBaseBuilder::GetObserver() const {
   return observer_;
 }
 
-elements::Element* IBaseBuilder::BuildGenericOutput(const OutputUri& output, element_id_t sink_id) {
-  elements::Element* sink = CreateSink(output, sink_id);
+elements::Element* IBaseBuilder::CreateSrc(const common::uri::Url& uri, element_id_t input_id, gint timeout_secs) {
+  const std::string ingest_socket = config_->GetIngestSocket();
+  if (!ingest_socket.empty()) {  // source owned by ingest process, only one input
+    return elements::sources::make_shm_src(ingest_socket, input_id);
+  }
+
+  if (config_->IsUdpInputBatch() && uri.GetScheme() == common::uri::Url::udp) {
+    elements::sources::ElementUDPBatchSrc* src = elements::sources::make_udp_batch_src(
+        uri, input_id, config_->GetUdpInputRcvbuf(), config_->GetUdpInputLatency());
+    HandleUdpBatchSrcCreated(src, input_id);
+    return src;
+  }
+
+  return elements::sources::make_src(uri, input_id, timeout_secs);
+}
+
+elements::Element* IBaseBuilder::BuildGenericOutput(const OutputUri& output, element_id_t sink_id, bool behind_queue) {
+  elements::Element* sink = CreateSink(output, sink_id, behind_queue);
+  CHECK(sink) << "Can't create output: " << output.GetOutput().GetUrl();
   pad::Pad* sink_pad = sink->StaticPad("sink");
   if (sink_pad->IsValid()) {
     common::uri::Url uri = output.GetOutput();
@@ -93,8 +114,16 @@ elements::Element* IBaseBuilder::BuildGenericOutput(const OutputUri& output, ele
   return sink;
 }
 
-elements::Element* IBaseBuilder::CreateSink(const OutputUri& output, element_id_t sink_id) {
-  elements::Element* sink = elements::sink::build_output(output, sink_id);
+elements::Element* IBaseBuilder::CreateSink(const OutputUri& output, element_id_t sink_id, bool behind_queue) {
+  common::uri::Url uri = output.GetOutput();
+  if (config_->IsTcpClients() && uri.GetScheme() == common::uri::Url::tcp) {
+    elements::sink::ElementTCPClientsSink* sink = elements::sink::make_tcp_clients_sink(
+        uri, sink_id, config_->GetTcpClientQueueBytes(), config_->GetTcpClientEvictTime());
+    HandleTcpClientsSinkCreated(sink, sink_id);
+    return sink;
+  }
+
+  elements::Element* sink = elements::sink::build_output(output, sink_id, config_->IsUdpBatch(), behind_queue);
   return sink;
 }
 
@@ -104,12 +133,36 @@ void IBaseBuilder::HandleInputSrcPadCreated(common::uri::Url::scheme scheme, pad
   }
 }
 
+void IBaseBuilder::HandleUdpBatchSrcCreated(elements::sources::ElementUDPBatchSrc* src, element_id_t id) {
+  if (observer_) {
+    observer_->OnUdpBatchSrcCreated(src, id);
+  }
+}
+
+void IBaseBuilder::HandleTcpClientsSinkCreated(elements::sink::ElementTCPClientsSink* sink, element_id_t id) {
+  if (observer_) {
+    observer_->OnTcpClientsSinkCreated(sink, id);
+  }
+}
+
 void IBaseBuilder::HandleOutputSinkPadCreated(common::uri::Url::scheme scheme, pad::Pad* pad, element_id_t id) {
   if (observer_) {
     observer_->OnOutputSinkPadCreated(scheme, pad, id);
   }
 }
 
+void IBaseBuilder::HandleOutputQueueCreated(elements::Element* queue, element_id_t id) {
+  if (observer_) {
+    observer_->OnOutputQueueCreated(queue, id);
+  }
+}
+
+void IBaseBuilder::HandleOutputBranchCreated(elements::Element* queue, elements::Element* sink, element_id_t id) {
+  if (observer_) {
+    observer_->OnOutputBranchCreated(queue, sink, id);
+  }
+}
+
 bool IBaseBuilder::CreatePipeLine(GstElement** pipeline, elements_line_t* elements) {
   if (!elements) {
     return false;
@@ -34,6 +34,15 @@ namespace pad {
 class Pad;
 }
 
+namespace elements {
+namespace sources {
+class ElementUDPBatchSrc;
+}
+namespace sink {
+class ElementTCPClientsSink;
+}
+}  // namespace elements
+
 class IBaseBuilder : public ILinker {
  public:
   IBaseBuilder(const Config* config, IBaseBuilderObserver* observer);
@@ -53,13 +62,18 @@ class IBaseBuilder : public ILinker {
  protected:
   IBaseBuilderObserver* GetObserver() const;
 
-  elements::Element* BuildGenericOutput(const OutputUri& output, element_id_t sink_id);
-  virtual elements::Element* CreateSink(const OutputUri& output, element_id_t sink_id);
+  elements::Element* CreateSrc(const common::uri::Url& uri, element_id_t input_id, gint timeout_secs);
+  elements::Element* BuildGenericOutput(const OutputUri& output, element_id_t sink_id, bool behind_queue = false);
+  virtual elements::Element* CreateSink(const OutputUri& output, element_id_t sink_id, bool behind_queue);
 
   virtual bool InitPipeline() WARN_UNUSED_RESULT = 0;
 
   void HandleInputSrcPadCreated(common::uri::Url::scheme scheme, pad::Pad* pad, element_id_t id);
+  void HandleUdpBatchSrcCreated(elements::sources::ElementUDPBatchSrc* src, element_id_t id);
+  void HandleTcpClientsSinkCreated(elements::sink::ElementTCPClientsSink* sink, element_id_t id);
   void HandleOutputSinkPadCreated(common::uri::Url::scheme scheme, pad::Pad* pad, element_id_t id);
+  void HandleOutputQueueCreated(elements::Element* queue, element_id_t id);
+  void HandleOutputBranchCreated(elements::Element* queue, elements::Element* sink, element_id_t id);
 
  private:
   const Config* const config_;
@@ -21,6 +21,16 @@
 namespace iptv_cloud {
 namespace stream {
 
+namespace elements {
+class Element;
+namespace sources {
+class ElementUDPBatchSrc;
+}
+namespace sink {
+class ElementTCPClientsSink;
+}
+}  // namespace elements
+
 namespace pad {
 class Pad;
 }
@@ -28,7 +38,12 @@ class Pad;
 class IBaseBuilderObserver {
  public:
   virtual void OnInpudSrcPadCreated(common::uri::Url::scheme scheme, pad::Pad* src_pad, element_id_t id) = 0;
+  virtual void OnUdpBatchSrcCreated(elements::sources::ElementUDPBatchSrc* src, element_id_t id) = 0;
+  virtual void OnTcpClientsSinkCreated(elements::sink::ElementTCPClientsSink* sink, element_id_t id) = 0;
   virtual void OnOutputSinkPadCreated(common::uri::Url::scheme scheme, pad::Pad* sink_pad, element_id_t id) = 0;
+  virtual void OnOutputQueueCreated(elements::Element* queue, element_id_t id) = 0;  // leaky queue of output
+  // tee -> queue -> sink of output which can be reconnected, queue already linked to tee
+  virtual void OnOutputBranchCreated(elements::Element* queue, elements::Element* sink, element_id_t id) = 0;
 
   virtual ~IBaseBuilderObserver();
 };
@@ -21,6 +21,7 @@
 #include <gst/base/gstbasesrc.h>  // for GstBaseSrc
 
 #include <map>
+#include <set>
 #include <memory>
 #include <string>
 #include <vector>
@@ -31,8 +32,11 @@
 
 #include "stream/dumpers/dumpers_factory.h"
 #include "stream/elements/element.h"
+#include "stream/elements/sink/tcp.h"
+#include "stream/elements/sources/udpsrc.h"
 #include "stream/gstreamer_utils.h"
 #include "stream/ibase_builder.h"
+#include "stream/output_reconnector.h"
 #include "stream/probes.h"  // for Probe (ptr only), PROBE_IN, PROBE_OUT
 
 #include "utils/utils.h"
@@ -100,22 +104,8 @@ void RedirectGstLog(GstDebugCategory* category,
   }
 }
 
-}  // namespace
-
-namespace iptv_cloud {
-namespace stream {
-
-void streams_init(int argc, char** argv, EncoderType enc) {
-  if (gst_is_initialized()) {
-    return;
-  }
-
-  signal(SIGPIPE, SIG_IGN);
-#ifdef HAVE_X11
-  XInitThreads();
-#endif
-
-  if (enc == GPU_MFX) {
+void SetEncoderEnvironment(iptv_cloud::stream::EncoderType enc) {
+  if (enc == iptv_cloud::stream::GPU_MFX) {
     int res = ::setenv("LIBVA_DRIVER_NAME", MFX_ENV, 1);
     if (res == ERROR_RESULT_VALUE) {
       WARNING_LOG() << "Failed to set enviroment variable LIBVA_DRIVER_NAME to " MFX_ENV;
@@ -125,7 +115,7 @@ void streams_init(int argc, char** argv, EncoderType enc) {
       WARNING_LOG() << "Failed to set enviroment variable LIBVA_DRIVERS_PATH "
                        "to " MFX_DRIVER_PATH;
     }
-  } else if (enc == GPU_VAAPI) {
+  } else if (enc == iptv_cloud::stream::GPU_VAAPI) {
     int res = ::setenv("LIBVA_DRIVER_NAME", VAAPI_I965_ENV, 1);
     if (res == ERROR_RESULT_VALUE) {
       WARNING_LOG() << "Failed to set enviroment variable LIBVA_DRIVER_NAME "
@@ -137,6 +127,29 @@ void streams_init(int argc, char** argv, EncoderType enc) {
                        "to " VAAPI_I965_DRIVER_PATH;
     }
   }
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace stream {
+
+void streams_init(int argc, char** argv, EncoderType enc) {
+  if (gst_is_initialized()) {  // preloaded by zygote, only per stream settings
+    SetEncoderEnvironment(enc);  // libva reads it when encoder opened
+    if (common::logging::CURRENT_LOG_LEVEL() == common::logging::LOG_LEVEL_DEBUG) {
+      gst_debug_set_default_threshold(GST_LEVEL_FIXME);
+      gst_debug_add_log_function(RedirectGstLog, nullptr, nullptr);
+    }
+    return;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+#ifdef HAVE_X11
+  XInitThreads();
+#endif
+
+  SetEncoderEnvironment(enc);
   if (common::logging::CURRENT_LOG_LEVEL() == common::logging::LOG_LEVEL_DEBUG) {
     int res = ::setenv("GST_DEBUG", "3", 1);
     if (res == SUCCESS_RESULT_VALUE) {
@@ -167,10 +180,14 @@ IBaseStream::IBaseStream(const Config* config, IStreamClient* client, StreamStru
       config_(config),
       probe_in_(),
       probe_out_(),
+      probe_drops_(),
+      reconnectors_(),
       loop_(g_main_loop_new(ctx_holder::instance()->ctx, FALSE)),
       pipeline_(nullptr),
       status_tick_(0),
       no_data_panic_tick_(0),
+      play_time_(0),
+      first_output_pending_(false),
       stats_(stats),
       last_exit_status_(EXIT_INNER),
       is_live_(false),
@@ -187,17 +204,41 @@ IBaseStream::IBaseStream(const Config* config, IStreamClient* client, StreamStru
 }
 
 void IBaseStream::LinkInputPad(GstPad* pad, element_id_t id) {
-  Probe* probe = new Probe(PROBE_IN, id, this);
+  ChannelStats* stats = id < stats_->input.size() ? stats_->input[id] : nullptr;
+  Probe* probe = new Probe(PROBE_IN, id, stats, this);
   probe->LinkPads(pad);
   probe_in_.push_back(probe);
 }
 
 void IBaseStream::LinkOutputPad(GstPad* pad, element_id_t id) {
-  Probe* probe = new Probe(PROBE_OUT, id, this);
+  ChannelStats* stats = id < stats_->output.size() ? stats_->output[id] : nullptr;
+  Probe* probe = new Probe(PROBE_OUT, id, stats, this);
   probe->LinkPads(pad);
   probe_out_.push_back(probe);
 }
 
+void IBaseStream::OnUdpBatchSrcCreated(elements::sources::ElementUDPBatchSrc* src, element_id_t id) {
+  ChannelStats* stats = id < stats_->input.size() ? stats_->input[id] : nullptr;
+  src->SetStats(stats);
+}
+
+void IBaseStream::OnTcpClientsSinkCreated(elements::sink::ElementTCPClientsSink* sink, element_id_t id) {
+  ChannelStats* stats = id < stats_->output.size() ? stats_->output[id] : nullptr;
+  sink->SetStats(stats);
+}
+
+void IBaseStream::OnOutputQueueCreated(elements::Element* queue, element_id_t id) {
+  ChannelStats* stats = id < stats_->output.size() ? stats_->output[id] : nullptr;
+  DropProbe* probe = new DropProbe(id, stats);
+  probe->Link(queue->GetGstElement());
+  probe_drops_.push_back(probe);
+}
+
+void IBaseStream::OnOutputBranchCreated(elements::Element* queue, elements::Element* sink, element_id_t id) {
+  ChannelStats* stats = id < stats_->output.size() ? stats_->output[id] : nullptr;
+  reconnectors_.push_back(new OutputReconnector(id, stats, queue->GetGstElement(), sink->GetGstElement()));
+}
+
 void IBaseStream::RuntimeCleanup() {
   const time_t max_life_time = common::time::current_mstime() / 1000 - cleanup_period_sec;
   for (const OutputUri& output : config_->GetOutput()) {
@@ -231,6 +272,11 @@ void IBaseStream::ClearOutProbes() {
     delete probe;
   }
   probe_out_.clear();
+
+  for (DropProbe* probe : probe_drops_) {
+    delete probe;
+  }
+  probe_drops_.clear();
 }
 
 void IBaseStream::ClearInProbes() {
@@ -301,6 +347,10 @@ IBaseStream::~IBaseStream() {
   // pipeline
 
   SetPipelineState(GST_STATE_NULL);
+  for (OutputReconnector* reconnector : reconnectors_) {  // after streaming threads stopped
+    delete reconnector;
+  }
+  reconnectors_.clear();
   if (pipeline_) {
     g_object_unref(pipeline_);
     pipeline_ = nullptr;
@@ -323,6 +373,7 @@ ExitStatus IBaseStream::Exec() {
 
   stats_->loop_start_time = common::time::current_mstime() / 1000;
   ResetDataWait();
+  ResetFirstOutput();
 
   Play();
 
@@ -340,6 +391,7 @@ ExitStatus IBaseStream::Exec() {
   Stop();
 
   stats_->restarts++;
+  stats_->PublishStats();
   return last_exit_status_;
 }
 
@@ -441,12 +493,14 @@ void IBaseStream::SetVideoInited(bool val) {
 void IBaseStream::Restart() {
   stats_->loop_start_time = common::time::current_mstime() / 1000;
   ResetDataWait();
+  ResetFirstOutput();
 
   Pause();
   SetStatus(INIT);  // emulating loop statuses
   Play();
 
   stats_->restarts++;
+  stats_->PublishStats();
 }
 
 void IBaseStream::Stop() {
@@ -471,6 +525,11 @@ void IBaseStream::ResetDataWait() {
   stats_->ResetDataWait();
 }
 
+void IBaseStream::ResetFirstOutput() {
+  play_time_ = common::time::current_mstime();
+  first_output_pending_.store(true);
+}
+
 void IBaseStream::Quit(ExitStatus status) {
   GstElement* pipeline = pipeline_;
   GstStructure* result = gst_structure_new("exit_info", "status", G_TYPE_INT, status, nullptr);
@@ -509,6 +568,17 @@ GstBusSyncReply IBaseStream::HandleSyncBusMessageReceived(GstBus* bus, GstMessag
       g_main_loop_quit(loop_);
       last_exit_status_ = static_cast<ExitStatus>(exit_status);
     }
+  } else if (type == GST_MESSAGE_ERROR) {
+    for (OutputReconnector* reconnector : reconnectors_) {
+      if (reconnector->IsSink(src)) {  // streaming thread of sink, before it returns error upstream
+        GError* err = nullptr;
+        gst_message_parse_error(message, &err, nullptr);
+        WARNING_LOG() << "Output " << reconnector->GetID() << " failed: " << (err ? err->message : "unknown error");
+        g_clear_error(&err);
+        reconnector->HandleError();
+        return GST_BUS_DROP;
+      }
+    }
   }
 
   if (client_) {
@@ -552,6 +622,7 @@ gboolean IBaseStream::HandleMainTimerTick() {
 
   const time_t up_time = GetElipsedTime();
   const size_t diff = (no_data_panic_sec - no_data_panic_tick_ + up_time) + 1;
+  const gint64 now = g_get_monotonic_time();  // same clock as probes arrivals
 
   size_t checkpoint_diff_in_total = 0;
   common::media::DesireBytesPerSec checkpoint_desire_in_total;
@@ -560,6 +631,7 @@ gboolean IBaseStream::HandleMainTimerTick() {
   for (size_t i = 0; i < input_stream_count; ++i) {
     size_t checkpoint_diff_out_stream = in[i]->GetDiffTotalBytes();
     in[i]->UpdateBps(diff);
+    in[i]->UpdateGapWindow(now);
     checkpoint_diff_in_total += checkpoint_diff_out_stream;
     checkpoint_desire_in_total += in[i]->GetDesireBytesPerSecond();
   }
@@ -570,9 +642,19 @@ gboolean IBaseStream::HandleMainTimerTick() {
   for (size_t i = 0; i < output_stream_count; ++i) {
     size_t checkpoint_diff_out_stream = out[i]->GetDiffTotalBytes();
     out[i]->UpdateBps(diff);
+    out[i]->UpdateGapWindow(now);
     checkpoint_diff_out_total += checkpoint_diff_out_stream;
   }
 
+  std::set<element_id_t> reconnecting_outputs;
+  for (OutputReconnector* reconnector : reconnectors_) {
+    reconnector->Check(now);
+    if (reconnector->IsReconnecting()) {
+      reconnecting_outputs.insert(reconnector->GetID());
+    }
+  }
+  stats_->PublishStats();
+
   if (up_time > no_data_panic_tick_) {  // check is stream in noraml state
     size_t count_in_eos = CountInputEOS();
     size_t count_out_eos = CountOutEOS();
@@ -594,7 +676,34 @@ gboolean IBaseStream::HandleMainTimerTick() {
       }
     }
 
-    bool is_output_failed = checkpoint_diff_out_total < MIN_OUT_DATA;
+    // single output can't block others in isolation mode, so stream restarted only if all of them stalled,
+    // outputs being reconnected are left out, pipeline isn't the reason of their stall and restart wouldn't help them
+    size_t count_out_stalled = 0;
+    size_t count_out_checked = 0;
+    size_t checkpoint_diff_out_checked = 0;
+    for (size_t i = 0; i < output_stream_count; ++i) {
+      const bool is_reconnecting = reconnecting_outputs.find(i) != reconnecting_outputs.end();
+      const bool is_stalled = out[i]->GetDiffTotalBytes() < MIN_OUT_DATA && !is_reconnecting;
+      const bool is_degraded = is_stalled || is_reconnecting || out[i]->GetDiffDroppedPackets() != 0;
+      if (is_degraded != out[i]->IsDegraded()) {
+        WARNING_LOG() << "Output " << out[i]->GetID() << (is_degraded ? " degraded" : " recovered") << ", sended bytes "
+                      << out[i]->GetDiffTotalBytes() << ", dropped buffers " << out[i]->GetDiffDroppedPackets();
+      }
+      out[i]->SetDegraded(is_degraded);
+      if (is_stalled) {
+        count_out_stalled++;
+      }
+      if (!is_reconnecting) {
+        count_out_checked++;
+        checkpoint_diff_out_checked += out[i]->GetDiffTotalBytes();
+      }
+    }
+
+    bool is_output_failed = false;
+    if (count_out_checked || reconnecting_outputs.empty()) {
+      is_output_failed = config_->IsOutputIsolated() ? count_out_stalled == count_out_checked
+                                                     : checkpoint_diff_out_checked < MIN_OUT_DATA;
+    }
     if (is_output_failed) {
       OnOutputDataFailed();
     } else {
@@ -635,7 +744,7 @@ gboolean IBaseStream::HandleAsyncBusMessageReceived(GstBus* bus, GstMessage* mes
       common::uri::Url input_url = input[i].GetInput();
       if (input_url.GetScheme() == common::uri::Url::http) {
         GstBaseSrc* basesrc = reinterpret_cast<GstBaseSrc*>(src);
-        UpdateStats(probe_in_[i], basesrc->segment.duration);
+        UpdateStats(probe_in_[i], basesrc->segment.duration, 0);
       }
     }
   } else if (type == GST_MESSAGE_STATE_CHANGED) {
@@ -667,6 +776,7 @@ gboolean IBaseStream::HandleAsyncBusMessageReceived(GstBus* bus, GstMessage* mes
 
 void IBaseStream::SetStatus(StreamStatus status) {
   stats_->status = status;
+  stats_->PublishStats();
   INFO_LOG() << "Changing status to: " << common::ConvertToString(status);
   if (client_) {
     client_->OnStatusChanged(this, status);
@@ -739,21 +849,23 @@ gboolean IBaseStream::main_timer_callback(gpointer user_data) {
   return res;
 }
 
-void IBaseStream::UpdateStats(const Probe* probe, gsize size) {
-  if (probe->GetName() == PROBE_IN) {
-    input_channels_info_t ins = stats_->input;
-    if (probe->GetID() < ins.size()) {
-      ChannelStats* cahnnel_info = ins[probe->GetID()];
-      const size_t prev_total = cahnnel_info->GetTotalBytes();
-      cahnnel_info->SetTotalBytes(prev_total + size);
-    }
-  } else if (probe->GetName() == PROBE_OUT) {
-    output_channels_info_t outs = stats_->output;
-    if (probe->GetID() < outs.size()) {
-      ChannelStats* cahnnel_info = outs[probe->GetID()];
-      const size_t prev_total = cahnnel_info->GetTotalBytes();
-      cahnnel_info->SetTotalBytes(prev_total + size);
-    }
+void IBaseStream::UpdateStats(const Probe* probe, gsize size, guint packets) {
+  ChannelStats* channel_info = probe->GetStats();  // resolved when probe created, called for every buffer
+  if (channel_info) {
+    channel_info->UpdateData(size, packets);
+  }
+}
+
+void IBaseStream::MarkOutputData() {
+  // relaxed check first, exchange only once per run
+  if (!first_output_pending_.load(std::memory_order_relaxed) || !first_output_pending_.exchange(false)) {
+    return;
+  }
+
+  const time_t first_output = common::time::current_mstime() - play_time_;
+  INFO_LOG() << "First output data after " << first_output << " msec.";
+  if (stats_->shared_stats) {
+    stats_->shared_stats->PublishFirstOutput(first_output);
   }
 }
 
@@ -16,6 +16,7 @@
 
 #include <gst/gstevent.h>
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -32,7 +33,10 @@ namespace iptv_cloud {
 namespace stream {
 
 class IBaseBuilder;
+struct InputCaps;
 class Probe;
+class DropProbe;
+class OutputReconnector;
 class Config;
 
 enum ExitStatus { EXIT_SELF, EXIT_INNER };
@@ -53,6 +57,9 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
     virtual GstPadProbeInfo* OnCheckReveivedOutputData(IBaseStream* stream, Probe* probe, GstPadProbeInfo* info) = 0;
     virtual GstPadProbeInfo* OnCheckReveivedData(IBaseStream* stream, Probe* probe, GstPadProbeInfo* info) = 0;
     virtual void OnInputChanged(const InputUri& uri) = 0;
+    virtual bool OnFindInputCaps(const InputUri& uri, InputCaps* caps) = 0;
+    virtual void OnInputCapsDetected(const InputUri& uri, const InputCaps& caps) = 0;
+    virtual void OnInputCapsMismatch(const InputUri& uri) = 0;
     virtual void OnPipelineCreated(IBaseStream* stream) = 0;
     virtual ~IStreamClient();
   };
@@ -89,7 +96,8 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
   virtual GstPadProbeInfo* CheckProbeData(Probe* probe, GstPadProbeInfo* buff);
   virtual GstPadProbeInfo* CheckProbeDataOutput(Probe* probe, GstPadProbeInfo* buff);
 
-  void UpdateStats(const Probe* probe, gsize size);
+  void UpdateStats(const Probe* probe, gsize size, guint packets);
+  void MarkOutputData();  // called for every output buffer, publishes time to first output once per run
 
   const Config* GetConfig() const;
 
@@ -115,6 +123,10 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
 
   void OnInpudSrcPadCreated(common::uri::Url::scheme scheme, pad::Pad* src_pad, element_id_t id) override = 0;
   void OnOutputSinkPadCreated(common::uri::Url::scheme scheme, pad::Pad* sink_pad, element_id_t id) override = 0;
+  void OnUdpBatchSrcCreated(elements::sources::ElementUDPBatchSrc* src, element_id_t id) override;
+  void OnTcpClientsSinkCreated(elements::sink::ElementTCPClientsSink* sink, element_id_t id) override;
+  void OnOutputQueueCreated(elements::Element* queue, element_id_t id) override;
+  void OnOutputBranchCreated(elements::Element* queue, elements::Element* sink, element_id_t id) override;
 
   virtual IBaseBuilder* CreateBuilder() = 0;
 
@@ -149,12 +161,15 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
 
   std::vector<Probe*> probe_in_;
   std::vector<Probe*> probe_out_;
+  std::vector<DropProbe*> probe_drops_;
+  std::vector<OutputReconnector*> reconnectors_;
 
   void RuntimeCleanup();
   bool InitPipeLine();
   void ClearOutProbes();
   void ClearInProbes();
   void ResetDataWait();
+  void ResetFirstOutput();
 
   static GstBusSyncReply sync_bus_callback(GstBus* bus, GstMessage* message, gpointer user_data);
   static gboolean main_timer_callback(gpointer user_data);
@@ -168,6 +183,9 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
   time_t status_tick_;
   time_t no_data_panic_tick_;
 
+  time_t play_time_;  // msec
+  std::atomic<bool> first_output_pending_;
+
   StreamStruct* const stats_;
 
   ExitStatus last_exit_status_;
@@ -0,0 +1,153 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/input_caps_cache.h"
+
+#include <stdio.h>
+
+#include <fstream>
+#include <vector>
+
+#define FIELDS_SEPARATOR '\t'
+#define FIELDS_COUNT 4
+
+namespace {
+std::vector<std::string> SplitFields(const std::string& line) {
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (true) {
+    const size_t pos = line.find(FIELDS_SEPARATOR, start);
+    if (pos == std::string::npos) {
+      fields.push_back(line.substr(start));
+      return fields;
+    }
+    fields.push_back(line.substr(start, pos - start));
+    start = pos + 1;
+  }
+}
+}  // namespace
+
+namespace iptv_cloud {
+namespace stream {
+
+InputCaps::InputCaps() : demuxer(), video(), audio() {}
+
+InputCaps::InputCaps(const std::string& demuxer, const std::string& video, const std::string& audio)
+    : demuxer(demuxer), video(video), audio(audio) {}
+
+bool InputCaps::IsValid() const {
+  return !demuxer.empty();
+}
+
+InputCapsCache::InputCapsCache(const std::string& path) : path_(path), mutex_(), entries_() {}
+
+common::ErrnoError InputCapsCache::Load() {
+  std::ifstream file(path_);
+  if (!file.is_open()) {
+    return common::ErrnoError();
+  }
+
+  std::map<std::string, InputCaps> entries;
+  std::string line;
+  while (getline(file, line)) {
+    const std::vector<std::string> fields = SplitFields(line);
+    if (fields.size() != FIELDS_COUNT || fields[0].empty()) {
+      continue;
+    }
+
+    const InputCaps caps(fields[1], fields[2], fields[3]);
+    if (caps.IsValid()) {
+      entries[fields[0]] = caps;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  entries_ = entries;
+  return common::ErrnoError();
+}
+
+bool InputCapsCache::Find(const std::string& url, InputCaps* caps) const {
+  if (!caps) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entries_.find(url);
+  if (it == entries_.end()) {
+    return false;
+  }
+
+  *caps = it->second;
+  return true;
+}
+
+common::ErrnoError InputCapsCache::Insert(const std::string& url, const InputCaps& caps) {
+  if (url.empty() || !caps.IsValid()) {
+    return common::make_errno_error_inval();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entries_.find(url);
+  if (it != entries_.end() && it->second == caps) {
+    return common::ErrnoError();
+  }
+
+  entries_[url] = caps;
+  return Save();
+}
+
+common::ErrnoError InputCapsCache::Remove(const std::string& url) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!entries_.erase(url)) {
+    return common::ErrnoError();
+  }
+
+  return Save();
+}
+
+size_t InputCapsCache::Size() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+common::ErrnoError InputCapsCache::Save() const {
+  // stream can be killed in the middle of write, so file is replaced atomically
+  const std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    if (!file.is_open()) {
+      return common::make_errno_error("Failed to open caps cache file: " + tmp_path, EIO);
+    }
+
+    for (const auto& it : entries_) {
+      const InputCaps& caps = it.second;
+      file << it.first << FIELDS_SEPARATOR << caps.demuxer << FIELDS_SEPARATOR << caps.video << FIELDS_SEPARATOR
+           << caps.audio << '\n';
+    }
+
+    file.flush();
+    if (!file) {
+      return common::make_errno_error("Failed to write caps cache file: " + tmp_path, EIO);
+    }
+  }
+
+  if (rename(tmp_path.c_str(), path_.c_str()) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  return common::ErrnoError();
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,70 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <common/error.h>
+#include <common/macros.h>
+
+namespace iptv_cloud {
+namespace stream {
+
+// Result of autoplugging of input: container and media types of elementary streams linked to parsers.
+struct InputCaps {
+  InputCaps();
+  InputCaps(const std::string& demuxer, const std::string& video, const std::string& audio);
+
+  bool IsValid() const;  // container known
+
+  std::string demuxer;  // video/mpegts, video/x-flv
+  std::string video;    // video/x-h264, empty if not linked
+  std::string audio;    // audio/mpeg, empty if not linked
+};
+
+inline bool operator==(const InputCaps& left, const InputCaps& right) {
+  return left.demuxer == right.demuxer && left.video == right.video && left.audio == right.audio;
+}
+
+// Caps of stream inputs keyed by input url, kept in file of feedback directory so restarts of stream
+// build the same chain without typefind. One line per input: url, demuxer, video and audio separated by tabs.
+class InputCapsCache {
+ public:
+  explicit InputCapsCache(const std::string& path);
+
+  common::ErrnoError Load() WARN_UNUSED_RESULT;  // missing file is empty cache
+
+  bool Find(const std::string& url, InputCaps* caps) const;
+
+  // file is rewritten only if entries changed
+  common::ErrnoError Insert(const std::string& url, const InputCaps& caps) WARN_UNUSED_RESULT;
+  common::ErrnoError Remove(const std::string& url) WARN_UNUSED_RESULT;
+
+  size_t Size() const;
+
+ private:
+  common::ErrnoError Save() const WARN_UNUSED_RESULT;
+
+  const std::string path_;
+  mutable std::mutex mutex_;
+  std::map<std::string, InputCaps> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(InputCapsCache);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,57 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/key_unit_scheduler.h"
+
+namespace iptv_cloud {
+namespace stream {
+
+KeyUnitScheduler::KeyUnitScheduler(uint64_t interval) : interval_(interval), next_pts_(invalid_timestamp), count_(0) {}
+
+bool KeyUnitScheduler::Check(uint64_t pts) {
+  if (pts == invalid_timestamp || interval_ == 0) {
+    return false;
+  }
+
+  if (next_pts_ == invalid_timestamp) {  // first frame is keyframe anyway
+    next_pts_ = pts + interval_;
+    return false;
+  }
+
+  // timestamps went back or far forward (discontinuity), restart schedule from this frame
+  if (pts + interval_ < next_pts_ || pts >= next_pts_ + interval_) {
+    next_pts_ = pts + interval_;
+    count_++;
+    return true;
+  }
+
+  if (pts < next_pts_) {
+    return false;
+  }
+
+  next_pts_ += interval_;
+  count_++;
+  return true;
+}
+
+uint64_t KeyUnitScheduler::GetInterval() const {
+  return interval_;
+}
+
+uint32_t KeyUnitScheduler::GetCount() const {
+  return count_;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <common/macros.h>
+
+namespace iptv_cloud {
+namespace stream {
+
+// Decides on which frames all renditions of abr ladder should start new gop, so segments of every rendition
+// begin with keyframe at the same timestamp and players can switch between them on segment boundaries.
+class KeyUnitScheduler {
+ public:
+  static const uint64_t invalid_timestamp = UINT64_MAX;  // same as GST_CLOCK_TIME_NONE
+
+  explicit KeyUnitScheduler(uint64_t interval);  // nsec
+
+  // streaming thread, pts in nsec, true if keyframe should be forced on this frame
+  bool Check(uint64_t pts);
+
+  uint64_t GetInterval() const;
+  uint32_t GetCount() const;  // forced keyframes
+
+ private:
+  const uint64_t interval_;
+  uint64_t next_pts_;
+  uint32_t count_;
+
+  DISALLOW_COPY_AND_ASSIGN(KeyUnitScheduler);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -27,6 +27,7 @@
 
 #include "base/config_fields.h"
 
+#include "stream/ibase_stream.h"
 #include "stream/stream_controller.h"
 
 #include "utils/arg_converter.h"
@@ -79,3 +80,8 @@ int stream_exec(const char* process_name,
   iptv_cloud::StreamStruct* smem = static_cast<iptv_cloud::StreamStruct*>(mem);
   return start_stream(process_name, feedback_dir_ptr, logs_level, config_args, client, smem);
 }
+
+int stream_preload() {
+  iptv_cloud::stream::streams_init(0, nullptr);
+  return EXIT_SUCCESS;
+}
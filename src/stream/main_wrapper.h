@@ -26,3 +26,6 @@ extern "C" int stream_exec(const char* process_name,
                            void* config_args,
                            void* command_client,
                            void* mem);
+
+// loads stream backend (plugins registry) once, processes forked after it start faster
+extern "C" int stream_preload();
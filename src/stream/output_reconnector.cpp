@@ -0,0 +1,239 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/output_reconnector.h"
+
+#include <algorithm>
+
+#include "base/channel_stats.h"
+
+namespace iptv_cloud {
+namespace stream {
+
+ReconnectBackoff::ReconnectBackoff(gint64 min_backoff, gint64 max_backoff)
+    : min_backoff_(min_backoff), max_backoff_(max_backoff), backoff_(min_backoff), outage_start_(0), connected_at_(0) {}
+
+bool ReconnectBackoff::IsOutage() const {
+  return outage_start_ != 0;
+}
+
+gint64 ReconnectBackoff::GetOutageStart() const {
+  return outage_start_;
+}
+
+gint64 ReconnectBackoff::GetBackoff() const {
+  return backoff_;
+}
+
+gint64 ReconnectBackoff::Failed(gint64 failed_at) {
+  if (!outage_start_) {
+    outage_start_ = failed_at;
+    if (!connected_at_ || failed_at - connected_at_ > max_backoff_) {
+      backoff_ = min_backoff_;
+      return failed_at + backoff_;
+    }
+  }
+
+  backoff_ = std::min(backoff_ * 2, max_backoff_);
+  return failed_at + backoff_;
+}
+
+void ReconnectBackoff::Connected(gint64 connected_at) {
+  outage_start_ = 0;
+  connected_at_ = connected_at;
+}
+
+OutputReconnector::OutputReconnector(element_id_t id, ChannelStats* stats, GstElement* queue, GstElement* sink)
+    : id_(id),
+      stats_(stats),
+      queue_(queue),
+      sink_(sink),
+      queue_pad_(gst_element_get_static_pad(queue, "sink")),
+      queue_src_pad_(gst_element_get_static_pad(queue, "src")),
+      tee_pad_(nullptr),
+      gate_probe_(0),
+      unlink_probe_(0),
+      confirm_probe_(0),
+      state_(CONNECTED),
+      wait_keyframe_(false),
+      failed_at_(0),
+      passed_buffers_(0),
+      confirmed_at_(0),
+      backoff_(min_backoff_msec * G_TIME_SPAN_MILLISECOND, max_backoff_msec * G_TIME_SPAN_MILLISECOND),
+      retry_at_(0) {
+  tee_pad_ = gst_pad_get_peer(queue_pad_);
+  CHECK(tee_pad_) << "Output queue " << id << " must be linked to tee";
+  const GstPadProbeType mask = static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST);
+  gate_probe_ = gst_pad_add_probe(tee_pad_, mask, gate_probe_callback, this, nullptr);
+  // queue pushes next buffer only when sink returned from render of previous one
+  confirm_probe_ = gst_pad_add_probe(queue_src_pad_, mask, confirm_probe_callback, this, nullptr);
+}
+
+OutputReconnector::~OutputReconnector() {
+  if (state_ == FAILED && unlink_probe_) {  // tee pad never became idle
+    gst_pad_remove_probe(tee_pad_, unlink_probe_);
+  }
+  if (gate_probe_) {
+    gst_pad_remove_probe(tee_pad_, gate_probe_);
+  }
+  if (confirm_probe_) {
+    gst_pad_remove_probe(queue_src_pad_, confirm_probe_);
+  }
+  gst_object_unref(tee_pad_);
+  gst_object_unref(queue_src_pad_);
+  gst_object_unref(queue_pad_);
+}
+
+element_id_t OutputReconnector::GetID() const {
+  return id_;
+}
+
+OutputReconnector::State OutputReconnector::GetState() const {
+  return static_cast<State>(state_.load());
+}
+
+bool OutputReconnector::IsReconnecting() const {
+  return GetState() != CONNECTED || backoff_.IsOutage();
+}
+
+bool OutputReconnector::IsSink(GstObject* object) const {
+  GstObject* sink = GST_OBJECT(sink_);
+  return object == sink || gst_object_has_as_ancestor(object, sink);
+}
+
+void OutputReconnector::HandleError() {
+  int expected = CONNECTED;
+  if (!state_.compare_exchange_strong(expected, FAILED)) {  // error of already failed sink
+    return;
+  }
+
+  // gate drops data from now, sink still in its render so queue didn't return error to tee yet
+  failed_at_ = g_get_monotonic_time();
+  unlink_probe_ = gst_pad_add_probe(tee_pad_, GST_PAD_PROBE_TYPE_IDLE, unlink_probe_callback, this, nullptr);
+}
+
+void OutputReconnector::Check(gint64 now) {
+  const State state = GetState();
+  if (state == CONNECTED) {
+    const gint64 confirmed_at = confirmed_at_;
+    if (backoff_.IsOutage() && confirmed_at) {
+      const time_t downtime = (confirmed_at - backoff_.GetOutageStart()) / G_TIME_SPAN_MILLISECOND;
+      backoff_.Connected(confirmed_at);
+      if (stats_) {
+        stats_->RecordReconnect(downtime);
+      }
+      INFO_LOG() << "Output " << id_ << " reconnected after " << downtime << " msec.";
+    }
+    return;
+  }
+
+  if (state != DISCONNECTED) {
+    return;
+  }
+
+  if (!retry_at_) {  // sink failed, connected one or restarted which didn't take data yet
+    retry_at_ = backoff_.Failed(failed_at_);
+    WARNING_LOG() << "Output " << id_ << " disconnected, reconnect in "
+                  << backoff_.GetBackoff() / G_TIME_SPAN_MILLISECOND << " msec.";
+  }
+
+  if (now < retry_at_) {
+    return;
+  }
+
+  if (!Reconnect()) {
+    retry_at_ = backoff_.Failed(now);
+    WARNING_LOG() << "Output " << id_ << " reconnect failed, next attempt in "
+                  << backoff_.GetBackoff() / G_TIME_SPAN_MILLISECOND << " msec.";
+    return;
+  }
+
+  retry_at_ = 0;
+  INFO_LOG() << "Output " << id_ << " relinked, waiting for data to pass sink.";
+}
+
+bool OutputReconnector::Reconnect() {
+  // restarted sink shouldn't preroll, running pipeline would lose its state
+  g_object_set(sink_, "async", FALSE, nullptr);
+  gst_element_set_state(queue_, GST_STATE_NULL);
+  gst_element_set_state(sink_, GST_STATE_NULL);
+  if (!gst_element_sync_state_with_parent(sink_) || !gst_element_sync_state_with_parent(queue_)) {
+    return false;
+  }
+
+  wait_keyframe_ = true;
+  passed_buffers_ = 0;
+  confirmed_at_ = 0;
+  state_ = CONNECTED;
+  if (GST_PAD_LINK_FAILED(gst_pad_link(tee_pad_, queue_pad_))) {
+    state_ = DISCONNECTED;
+    return false;
+  }
+
+  return true;
+}
+
+GstPadProbeReturn OutputReconnector::gate_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  OutputReconnector* reconnector = reinterpret_cast<OutputReconnector*>(user_data);
+  if (reconnector->state_ != CONNECTED) {
+    return GST_PAD_PROBE_DROP;
+  }
+
+  if (!reconnector->wait_keyframe_) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstBuffer* buffer = nullptr;
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  } else {
+    GstBufferList* buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    if (gst_buffer_list_length(buffer_list)) {
+      buffer = gst_buffer_list_get(buffer_list, 0);
+    }
+  }
+
+  if (!buffer || GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    return GST_PAD_PROBE_DROP;
+  }
+
+  reconnector->wait_keyframe_ = false;
+  return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn OutputReconnector::confirm_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  UNUSED(info);
+  OutputReconnector* reconnector = reinterpret_cast<OutputReconnector*>(user_data);
+  if (reconnector->state_ != CONNECTED || reconnector->confirmed_at_) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  if (++reconnector->passed_buffers_ >= confirm_buffers) {  // sink took previous buffers without error
+    reconnector->confirmed_at_ = g_get_monotonic_time();
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn OutputReconnector::unlink_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(info);
+  OutputReconnector* reconnector = reinterpret_cast<OutputReconnector*>(user_data);
+  gst_pad_unlink(pad, reconnector->queue_pad_);
+  reconnector->state_ = DISCONNECTED;
+  return GST_PAD_PROBE_REMOVE;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,108 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+
+#include <gst/gstelement.h>
+#include <gst/gstpad.h>
+
+#include <common/utils.h>
+
+#include "stream/stypes.h"
+
+namespace iptv_cloud {
+class ChannelStats;
+namespace stream {
+
+// Exponential backoff of one output, usec. Outage lasts from sink error till data passed restarted sink,
+// every failure inside it doubles backoff, outage shortly after previous one continues its backoff.
+class ReconnectBackoff {
+ public:
+  ReconnectBackoff(gint64 min_backoff, gint64 max_backoff);
+
+  bool IsOutage() const;
+  gint64 GetOutageStart() const;
+  gint64 GetBackoff() const;
+
+  gint64 Failed(gint64 failed_at);  // sink error or failed attempt, returns time of next attempt
+  void Connected(gint64 connected_at);
+
+ private:
+  const gint64 min_backoff_;
+  const gint64 max_backoff_;
+  gint64 backoff_;
+  gint64 outage_start_;  // 0 if connected
+  gint64 connected_at_;  // 0 if never reconnected
+};
+
+// Reconnects network output in place: tee pad -> queue -> sink branch is unlinked when sink posts error,
+// queue and sink are reset with exponential backoff and branch relinked from next keyframe,
+// relink replays sticky events (caps with stream headers) into restarted sink.
+// Sinks like rtmpsink connect lazily in render, so output is reconnected only when data passed restarted sink.
+// Should be destroyed when pipeline is in NULL state.
+class OutputReconnector {
+ public:
+  enum State { CONNECTED = 0, FAILED, DISCONNECTED };
+  enum { min_backoff_msec = 1000, max_backoff_msec = 30000 };
+  enum { confirm_buffers = 3 };  // sink may keep first buffer (stream header) without sending
+
+  // queue fed by tee request pad, both elements owned by pipeline
+  OutputReconnector(element_id_t id, ChannelStats* stats, GstElement* queue, GstElement* sink);
+  ~OutputReconnector();
+
+  element_id_t GetID() const;
+  State GetState() const;
+  bool IsReconnecting() const;  // main loop, from sink error till data passed restarted sink
+  bool IsSink(GstObject* object) const;
+
+  // streaming thread of sink (sync bus handler), branch gated at once and unlinked when tee pad is idle
+  void HandleError();
+  // main loop, now in monotonic usec
+  void Check(gint64 now);
+
+ private:
+  static GstPadProbeReturn gate_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static GstPadProbeReturn unlink_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static GstPadProbeReturn confirm_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+
+  bool Reconnect();
+
+  const element_id_t id_;
+  ChannelStats* const stats_;
+  GstElement* const queue_;
+  GstElement* const sink_;
+  GstPad* queue_pad_;
+  GstPad* queue_src_pad_;
+  GstPad* tee_pad_;
+  gulong gate_probe_;
+  gulong unlink_probe_;
+  gulong confirm_probe_;
+
+  std::atomic<int> state_;
+  std::atomic<bool> wait_keyframe_;
+  std::atomic<gint64> failed_at_;  // usec
+  std::atomic<int> passed_buffers_;  // pushed into sink since relink
+  std::atomic<gint64> confirmed_at_;  // usec, 0 while restarted sink didn't take data
+
+  // main loop only
+  ReconnectBackoff backoff_;
+  gint64 retry_at_;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputReconnector);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,312 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/playlist_engine.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "base/channel_stats.h"
+#include "base/stream_struct.h"
+
+#include "stream/gstreamer_utils.h"  // for pad_get_type
+#include "stream/streams/configs/audio_video_config.h"
+
+namespace iptv_cloud {
+namespace stream {
+
+PlaylistEngine::IPlaylistObserver::~IPlaylistObserver() {}
+
+PlaylistEngine::PlaylistEngine(const streams::AudioVideoConfig* config,
+                               StreamStruct* stats,
+                               IPlaylistObserver* observer)
+    : input_(config->GetInput()),
+      loop_(!config->GetLoop() || *config->GetLoop()),
+      block_size_(config->GetPlaylistBlockSize()),
+      stats_(stats && !stats->input.empty() ? stats->input[0] : nullptr),
+      observer_(observer),
+      current_(),
+      next_pos_(0),
+      file_started_(false),
+      eof_time_(0),
+      empty_files_(0),
+      prefetch_mutex_(),
+      prefetch_cond_(),
+      stop_(false),
+      prefetch_requested_(false),
+      prefetch_running_(false),
+      prefetch_index_(0),
+      prefetched_index_(0),
+      prefetched_(),
+      prefetch_thread_(),
+      stitcher_(),
+      stitch_pads_() {
+  for (size_t i = 0; i < TimestampStitcher::max_tracks; ++i) {
+    stitch_pads_[i].engine = this;
+    stitch_pads_[i].track = static_cast<Track>(i);
+    stitch_pads_[i].segment_sent = false;
+  }
+
+  prefetch_thread_ = std::thread([this] { PrefetchRoutine(); });
+  RequestPrefetch(next_pos_);  // first file warm too
+}
+
+PlaylistEngine::~PlaylistEngine() {
+  {
+    std::unique_lock<std::mutex> lock(prefetch_mutex_);
+    stop_ = true;
+    prefetch_cond_.notify_all();
+  }
+  prefetch_thread_.join();
+}
+
+void PlaylistEngine::Reset() {
+  stitcher_.Reset();
+  for (size_t i = 0; i < TimestampStitcher::max_tracks; ++i) {
+    stitch_pads_[i].segment_sent = false;
+  }
+  eof_time_ = 0;
+}
+
+common::ErrnoError PlaylistEngine::ReadBlock(GstBuffer** buffer) {
+  if (!buffer) {
+    return common::make_errno_error_inval();
+  }
+
+  *buffer = nullptr;
+  while (true) {
+    if (!current_) {
+      if (empty_files_ > input_.size()) {
+        return common::make_errno_error("Playlist files without data.", EINVAL);
+      }
+
+      common::ErrnoError err = OpenNextFile();
+      if (err) {
+        return err;
+      }
+
+      if (!current_) {  // playlist finished
+        return common::ErrnoError();
+      }
+    }
+
+    GstBuffer* block = nullptr;
+    common::ErrnoError err = current_->ReadBlock(&block);
+    if (err) {
+      WARNING_LOG() << "Read playlist file failed: " << err->GetDescription();
+    }
+
+    if (!block) {  // end of file or error, go to next
+      if (!file_started_) {
+        empty_files_++;
+      }
+      current_.reset();
+      eof_time_ = g_get_monotonic_time();
+      continue;
+    }
+
+    if (!file_started_) {
+      file_started_ = true;
+      empty_files_ = 0;
+      if (eof_time_) {  // transition, demuxer should resync
+        GST_BUFFER_FLAG_SET(block, GST_BUFFER_FLAG_DISCONT);
+        stitcher_.MarkTransition();
+        if (stats_) {
+          stats_->RecordTransitionStall(g_get_monotonic_time() - eof_time_);
+        }
+      }
+    }
+
+    *buffer = block;
+    return common::ErrnoError();
+  }
+}
+
+void PlaylistEngine::LinkPad(GstPad* pad) {
+  const gchar* pad_type = pad_get_type(pad);
+  if (!pad_type) {
+    return;
+  }
+
+  Track track;
+  if (strncmp(pad_type, "video", 5) == 0) {
+    track = VIDEO_TRACK;
+  } else if (strncmp(pad_type, "audio", 5) == 0) {
+    track = AUDIO_TRACK;
+  } else {
+    return;
+  }
+
+  gst_pad_add_probe(pad,
+                    static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+                    stitch_probe_callback, &stitch_pads_[track], nullptr);
+}
+
+bool PlaylistEngine::GetFileIndex(size_t pos, size_t* index) const {
+  if (input_.empty()) {
+    return false;
+  }
+
+  if (pos >= input_.size()) {
+    if (!loop_) {
+      return false;
+    }
+    pos = 0;
+  }
+
+  *index = pos;
+  return true;
+}
+
+std::string PlaylistEngine::GetFilePath(size_t index) const {
+  common::uri::Url uri = input_[index].GetInput();
+  common::uri::Upath path = uri.GetPath();
+  return path.GetPath();
+}
+
+common::ErrnoError PlaylistEngine::OpenNextFile() {
+  size_t index = 0;
+  if (!GetFileIndex(next_pos_, &index)) {
+    INFO_LOG() << "No more files for playing";
+    return common::ErrnoError();
+  }
+
+  next_pos_ = index + 1;
+  const std::string path = GetFilePath(index);
+  std::unique_ptr<FileBlockReader> reader(TakePrefetched(index));
+  if (!reader) {
+    reader.reset(new FileBlockReader(block_size_));
+    common::ErrnoError err = reader->Open(path);
+    if (err) {
+      return common::make_errno_error("File " + path + " can't open for playing: " + err->GetDescription(),
+                                      err->GetErrorCode());
+    }
+  }
+
+  INFO_LOG() << "File " << path << " open for playing";
+  current_ = std::move(reader);
+  file_started_ = false;
+  if (observer_) {
+    observer_->OnPlaylistFileChanged(input_[index]);
+  }
+  RequestPrefetch(next_pos_);
+  return common::ErrnoError();
+}
+
+void PlaylistEngine::RequestPrefetch(size_t pos) {
+  size_t index = 0;
+  if (!GetFileIndex(pos, &index)) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  prefetch_index_ = index;
+  prefetch_requested_ = true;
+  prefetch_cond_.notify_all();
+}
+
+FileBlockReader* PlaylistEngine::TakePrefetched(size_t index) {
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  while ((prefetch_requested_ || prefetch_running_) && prefetch_index_ == index) {  // not longer than open it here
+    prefetch_cond_.wait(lock);
+  }
+
+  if (!prefetched_ || prefetched_index_ != index) {
+    prefetched_.reset();
+    return nullptr;
+  }
+
+  return prefetched_.release();
+}
+
+void PlaylistEngine::PrefetchRoutine() {
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  while (true) {
+    while (!stop_ && !prefetch_requested_) {
+      prefetch_cond_.wait(lock);
+    }
+
+    if (stop_) {
+      return;
+    }
+
+    const size_t index = prefetch_index_;
+    prefetch_requested_ = false;
+    prefetch_running_ = true;
+    lock.unlock();
+
+    const std::string path = GetFilePath(index);
+    std::unique_ptr<FileBlockReader> reader(new FileBlockReader(block_size_));
+    common::ErrnoError err = reader->Open(path);
+    if (err) {
+      DEBUG_LOG() << "Prefetch of " << path << " failed: " << err->GetDescription();
+      reader.reset();
+    } else {
+      reader->Prefetch();
+    }
+
+    lock.lock();
+    prefetch_running_ = false;
+    prefetched_ = std::move(reader);
+    prefetched_index_ = index;
+    prefetch_cond_.notify_all();
+  }
+}
+
+GstPadProbeReturn PlaylistEngine::stitch_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  StitchPad* spad = static_cast<StitchPad*>(user_data);
+  return spad->engine->HandleStitchProbe(spad, info);
+}
+
+GstPadProbeReturn PlaylistEngine::HandleStitchProbe(StitchPad* spad, GstPadProbeInfo* info) {
+  if (info->type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+    GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+    if (GST_EVENT_TYPE(event) != GST_EVENT_SEGMENT) {
+      return GST_PAD_PROBE_OK;
+    }
+
+    if (spad->segment_sent) {  // stitched timestamps stay in first segment
+      return GST_PAD_PROBE_DROP;
+    }
+    spad->segment_sent = true;
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (!buffer) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  uint64_t pts = GST_BUFFER_PTS(buffer);
+  uint64_t dts = GST_BUFFER_DTS(buffer);
+  uint64_t jump = 0;
+  if (stitcher_.Stitch(spad->track, &pts, &dts, GST_BUFFER_DURATION(buffer), &jump) && stats_) {
+    stats_->RecordTransitionJump(jump);
+  }
+
+  if (pts == GST_BUFFER_PTS(buffer) && dts == GST_BUFFER_DTS(buffer)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  buffer = gst_buffer_make_writable(buffer);
+  GST_BUFFER_PTS(buffer) = pts;
+  GST_BUFFER_DTS(buffer) = dts;
+  GST_PAD_PROBE_INFO_DATA(info) = buffer;
+  return GST_PAD_PROBE_OK;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
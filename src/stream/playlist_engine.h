@@ -0,0 +1,111 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <gst/gstpad.h>
+
+#include "base/inputs_outputs.h"
+
+#include "stream/file_block_reader.h"
+#include "stream/timestamp_stitcher.h"
+
+namespace iptv_cloud {
+
+class ChannelStats;
+struct StreamStruct;
+
+namespace stream {
+namespace streams {
+class AudioVideoConfig;
+}
+
+// Files of playlist streams as one gapless input for appsrc:
+// next file is opened and pre-read in background while current one is playing,
+// timestamps of demuxed pads continue across files, transitions recorded in stats of input channel.
+class PlaylistEngine {
+ public:
+  enum Track { VIDEO_TRACK = 0, AUDIO_TRACK = 1 };
+
+  class IPlaylistObserver {
+   public:
+    virtual void OnPlaylistFileChanged(const InputUri& uri) = 0;
+    virtual ~IPlaylistObserver();
+  };
+
+  PlaylistEngine(const streams::AudioVideoConfig* config, StreamStruct* stats, IPlaylistObserver* observer);
+  ~PlaylistEngine();
+
+  void Reset();  // new pipeline, playlist position kept
+
+  // appsrc need-data thread, *buffer is nullptr when playlist finished
+  common::ErrnoError ReadBlock(GstBuffer** buffer) WARN_UNUSED_RESULT;
+
+  // demuxed pad of decodebin, its timestamps stitched
+  void LinkPad(GstPad* pad);
+
+ private:
+  struct StitchPad {
+    PlaylistEngine* engine;
+    Track track;
+    bool segment_sent;
+  };
+
+  bool GetFileIndex(size_t pos, size_t* index) const;
+  std::string GetFilePath(size_t index) const;
+  common::ErrnoError OpenNextFile() WARN_UNUSED_RESULT;
+
+  void RequestPrefetch(size_t pos);
+  FileBlockReader* TakePrefetched(size_t index);
+  void PrefetchRoutine();
+
+  static GstPadProbeReturn stitch_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  GstPadProbeReturn HandleStitchProbe(StitchPad* spad, GstPadProbeInfo* info);
+
+  const input_t input_;
+  const bool loop_;
+  const size_t block_size_;
+  ChannelStats* const stats_;
+  IPlaylistObserver* const observer_;
+
+  std::unique_ptr<FileBlockReader> current_;
+  size_t next_pos_;     // position of file to open next
+  bool file_started_;   // first block of current file pushed
+  gint64 eof_time_;     // monotonic usec when previous file finished, 0 before first file
+  size_t empty_files_;  // in a row, whole playlist without data stops it
+
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_cond_;
+  bool stop_;
+  bool prefetch_requested_;
+  bool prefetch_running_;
+  size_t prefetch_index_;  // requested
+  size_t prefetched_index_;
+  std::unique_ptr<FileBlockReader> prefetched_;
+  std::thread prefetch_thread_;
+
+  TimestampStitcher stitcher_;
+  StitchPad stitch_pads_[TimestampStitcher::max_tracks];
+
+  DISALLOW_COPY_AND_ASSIGN(PlaylistEngine);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -14,6 +14,8 @@
 
 #include "stream/probes.h"
 
+#include "base/channel_stats.h"
+
 #include "stream/ibase_stream.h"
 
 namespace iptv_cloud {
@@ -27,8 +29,8 @@ Consistency::Consistency()
       saw_stream_start(FALSE),
       saw_serialized_event(FALSE) {}
 
-Probe::Probe(const std::string& name, element_id_t id, IBaseStream* stream)
-    : stream_(stream), name_(name), id_(id), id_buffer_(0), pad_(nullptr), consistency_() {
+Probe::Probe(const std::string& name, element_id_t id, ChannelStats* stats, IBaseStream* stream)
+    : stream_(stream), name_(name), id_(id), stats_(stats), id_buffer_(0), pad_(nullptr), consistency_() {
   CHECK(stream);
 }
 
@@ -40,6 +42,10 @@ const std::string& Probe::GetName() const {
   return name_;
 }
 
+ChannelStats* Probe::GetStats() const {
+  return stats_;
+}
+
 void Probe::Link(GstPad* pad) {
   if (!pad) {
     return;
@@ -107,6 +113,36 @@ void Probe::destroy_callback_probe(gpointer user_data) {
   probe->ClearInner();
 }
 
+void Probe::UpdateStatsFromData(Probe* probe, GstPadProbeInfo* info) {
+  ChannelStats* stats = probe->stats_;
+  if (stats) {
+    stats->RecordArrival(g_get_monotonic_time());
+  }
+
+  GstPadProbeType type = GST_PAD_PROBE_INFO_TYPE(info);
+  if (type & GST_PAD_PROBE_TYPE_BUFFER) {
+    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    const gsize size = gst_buffer_get_size(buffer);
+    probe->stream_->UpdateStats(probe, size, 1);
+    if (stats) {
+      stats->RecordBuffer(size, GST_BUFFER_DTS_OR_PTS(buffer));
+    }
+  } else if (type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList* buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    const guint len = gst_buffer_list_length(buffer_list);
+    gsize size = 0;
+    for (guint i = 0; i < len; ++i) {
+      GstBuffer* buffer = gst_buffer_list_get(buffer_list, i);
+      const gsize buffer_size = gst_buffer_get_size(buffer);
+      size += buffer_size;
+      if (stats) {
+        stats->RecordBuffer(buffer_size, GST_BUFFER_DTS_OR_PTS(buffer));
+      }
+    }
+    probe->stream_->UpdateStats(probe, size, len);  // one update for whole list
+  }
+}
+
 GstPadProbeReturn Probe::source_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
   Probe* probe = reinterpret_cast<Probe*>(user_data);
   IBaseStream* stream = probe->stream_;
@@ -115,11 +151,14 @@ GstPadProbeReturn Probe::source_callback_probe_buffer(GstPad* pad, GstPadProbeIn
     return GST_PAD_PROBE_DROP;
   }
 
+  // probe type is set by gstreamer, cheaper than GST_IS_* type checks of data
+  if (GST_PAD_PROBE_INFO_TYPE(checked_info) & (GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST)) {
+    UpdateStatsFromData(probe, checked_info);
+    return GST_PAD_PROBE_OK;
+  }
+
   void* data = GST_PAD_PROBE_INFO_DATA(checked_info);
-  if (GST_IS_BUFFER(data)) {
-    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(checked_info);
-    stream->UpdateStats(probe, gst_buffer_get_size(buffer));
-  } else if (GST_IS_EVENT(data)) {
+  if (GST_IS_EVENT(data)) {
     GstEvent* event = GST_EVENT(data);
     const gchar* event_name = GST_EVENT_TYPE_NAME(event);
     GstEventType event_type = GST_EVENT_TYPE(event);
@@ -207,18 +246,14 @@ GstPadProbeReturn Probe::sink_callback_probe_buffer(GstPad* pad, GstPadProbeInfo
     return GST_PAD_PROBE_DROP;
   }
 
+  if (GST_PAD_PROBE_INFO_TYPE(checked_info) & (GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST)) {
+    UpdateStatsFromData(probe, checked_info);
+    stream->MarkOutputData();
+    return GST_PAD_PROBE_OK;
+  }
+
   void* data = GST_PAD_PROBE_INFO_DATA(checked_info);
-  if (GST_IS_BUFFER(data)) {
-    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(checked_info);
-    stream->UpdateStats(probe, gst_buffer_get_size(buffer));
-  } else if (GST_IS_BUFFER_LIST(data)) {
-    GstBufferList* buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST(checked_info);
-    guint len = gst_buffer_list_length(buffer_list);
-    for (guint i = 0; i < len; ++i) {
-      GstBuffer* buffer = gst_buffer_list_get(buffer_list, i);
-      stream->UpdateStats(probe, gst_buffer_get_size(buffer));
-    }
-  } else if (GST_IS_EVENT(data)) {
+  if (GST_IS_EVENT(data)) {
     GstEvent* event = GST_EVENT(data);
     const gchar* event_name = GST_EVENT_TYPE_NAME(event);
     GstEventType event_type = GST_EVENT_TYPE(event);
@@ -265,5 +300,82 @@ GstPadProbeReturn Probe::sink_callback_probe_buffer(GstPad* pad, GstPadProbeInfo
   return GST_PAD_PROBE_OK;
 }
 
+DropProbe::DropProbe(element_id_t id, ChannelStats* stats)
+    : id_(id),
+      stats_(stats),
+      queue_(nullptr),
+      pad_(nullptr),
+      id_buffer_(0),
+      id_overrun_(0),
+      last_bytes_(0),
+      last_packets_(0) {}
+
+DropProbe::~DropProbe() {
+  Clear();
+}
+
+void DropProbe::Link(GstElement* queue) {
+  if (!queue || !stats_) {
+    return;
+  }
+
+  Clear();
+
+  GstPad* pad = gst_element_get_static_pad(queue, "sink");
+  if (!pad) {
+    CRITICAL_LOG() << "Cannot get sink pad of output queue " << id_;
+    return;
+  }
+
+  const GstPadProbeType mask = static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST);
+  id_buffer_ = gst_pad_add_probe(pad, mask, sink_callback_probe_buffer, this, nullptr);
+  id_overrun_ = g_signal_connect(queue, "overrun", G_CALLBACK(overrun_callback), this);
+  queue_ = queue;
+  pad_ = pad;
+  DEBUG_LOG() << "drop probe added, output " << id_;
+}
+
+element_id_t DropProbe::GetID() const {
+  return id_;
+}
+
+void DropProbe::Clear() {
+  if (pad_) {
+    if (id_buffer_) {
+      gst_pad_remove_probe(pad_, id_buffer_);
+    }
+    gst_object_unref(pad_);
+  }
+
+  if (queue_ && id_overrun_) {
+    g_signal_handler_disconnect(queue_, id_overrun_);
+  }
+
+  queue_ = nullptr;
+  pad_ = nullptr;
+  id_buffer_ = 0;
+  id_overrun_ = 0;
+}
+
+GstPadProbeReturn DropProbe::sink_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  DropProbe* probe = reinterpret_cast<DropProbe*>(user_data);
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    probe->last_bytes_ = gst_buffer_get_size(GST_PAD_PROBE_INFO_BUFFER(info));
+    probe->last_packets_ = 1;
+  } else {
+    GstBufferList* buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    probe->last_bytes_ = gst_buffer_list_calculate_size(buffer_list);
+    probe->last_packets_ = gst_buffer_list_length(buffer_list);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void DropProbe::overrun_callback(GstElement* queue, gpointer user_data) {
+  UNUSED(queue);
+  DropProbe* probe = reinterpret_cast<DropProbe*>(user_data);
+  probe->stats_->RecordDrop(probe->last_bytes_, probe->last_packets_);
+}
+
 }  // namespace stream
 }  // namespace iptv_cloud
@@ -26,6 +26,7 @@
 #define PROBE_OUT "out"
 
 namespace iptv_cloud {
+class ChannelStats;
 namespace stream {
 
 class IBaseStream;
@@ -43,10 +44,12 @@ struct Consistency {
 
 class Probe {
  public:
-  Probe(const std::string& name, element_id_t id, IBaseStream* stream);
+  // stats is channel slot of this probe resolved once, null if id out of stream channels
+  Probe(const std::string& name, element_id_t id, ChannelStats* stats, IBaseStream* stream);
   ~Probe();
 
   const std::string& GetName() const;
+  ChannelStats* GetStats() const;
 
   void LinkPads(GstPad* pad);
   element_id_t GetID() const;
@@ -58,6 +61,7 @@ class Probe {
   static GstPadProbeReturn sink_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
   static GstPadProbeReturn source_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
   static void destroy_callback_probe(gpointer user_data);
+  static void UpdateStatsFromData(Probe* probe, GstPadProbeInfo* info);
 
   void Link(GstPad* pad);
   void Clear();
@@ -67,6 +71,7 @@ class Probe {
 
   const std::string name_;
   const element_id_t id_;
+  ChannelStats* const stats_;
   gulong id_buffer_;
   GstPad* pad_;
   Consistency consistency_;
@@ -74,5 +79,33 @@ class Probe {
   DISALLOW_COPY_AND_ASSIGN(Probe);
 };
 
+// Counts data dropped by leaky upstream queue: sink pad probe remembers size of incoming buffer (list),
+// queue emits overrun in the same streaming thread right before it drops exactly that data.
+class DropProbe {
+ public:
+  DropProbe(element_id_t id, ChannelStats* stats);
+  ~DropProbe();
+
+  void Link(GstElement* queue);
+  element_id_t GetID() const;
+
+ private:
+  static GstPadProbeReturn sink_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void overrun_callback(GstElement* queue, gpointer user_data);
+
+  void Clear();
+
+  const element_id_t id_;
+  ChannelStats* const stats_;
+  GstElement* queue_;
+  GstPad* pad_;
+  gulong id_buffer_;
+  gulong id_overrun_;
+  gsize last_bytes_;  // streaming thread only
+  guint last_packets_;
+
+  DISALLOW_COPY_AND_ASSIGN(DropProbe);
+};
+
 }  // namespace stream
 }  // namespace iptv_cloud
@@ -0,0 +1,177 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/rtp_jitter_buffer.h"
+
+namespace iptv_cloud {
+namespace stream {
+
+const uint64_t RtpJitterBuffer::invalid_deadline;
+
+RtpJitterBuffer::Slot::Slot() : seq(-1), state(SLOT_EMPTY), arrival(0), payload() {}
+
+RtpJitterBuffer::RtpJitterBuffer(uint64_t latency)
+    : latency_(latency),
+      slots_(capacity),
+      started_(false),
+      next_(0),
+      highest_(0),
+      held_(0),
+      deadline_(invalid_deadline),
+      lost_(0),
+      reordered_(0),
+      duplicates_(0) {}
+
+RtpJitterBuffer::~RtpJitterBuffer() {}
+
+void RtpJitterBuffer::Push(uint16_t seq,
+                           const uint8_t* payload,
+                           size_t size,
+                           uint64_t arrival,
+                           std::vector<uint8_t>* out) {
+  if (!started_) {
+    started_ = true;
+    next_ = highest_ = seq;
+  }
+
+  int64_t ext = Extend(seq);
+  if (ext - highest_ >= capacity || next_ - ext >= capacity) {  // sender restarted
+    Flush(out);
+    Reset();
+    ext = next_ = highest_ = seq;
+  } else if (ext < next_) {
+    Slot* slot = GetSlot(ext);
+    if (slot->seq == ext && slot->state == SLOT_RELEASED) {
+      duplicates_++;
+    } else {
+      reordered_++;  // too late, already skipped as lost
+    }
+    return;
+  }
+
+  // long gap is still waiting, but window is over
+  while (ext - next_ >= capacity) {
+    Advance(out);
+  }
+
+  Slot* slot = GetSlot(ext);
+  if (slot->seq == ext && slot->state == SLOT_HELD) {
+    duplicates_++;
+    return;
+  }
+
+  if (ext < highest_) {
+    reordered_++;
+  } else {
+    highest_ = ext;
+  }
+  slot->seq = ext;
+  slot->state = SLOT_HELD;
+  slot->arrival = arrival;
+  slot->payload.assign(payload, payload + size);
+  held_++;
+}
+
+void RtpJitterBuffer::Pop(uint64_t now, std::vector<uint8_t>* out) {
+  deadline_ = invalid_deadline;
+  while (held_) {
+    Slot* slot = GetSlot(next_);
+    if (slot->seq == next_ && slot->state == SLOT_HELD) {
+      Advance(out);
+      continue;
+    }
+
+    // gap, first held packet after it waits for missing ones
+    int64_t seq = next_ + 1;
+    while (seq <= highest_) {
+      Slot* held = GetSlot(seq);
+      if (held->seq == seq && held->state == SLOT_HELD) {
+        break;
+      }
+      seq++;
+    }
+
+    const uint64_t deadline = GetSlot(seq)->arrival + latency_;
+    if (now < deadline) {
+      deadline_ = deadline;
+      return;
+    }
+
+    while (next_ < seq) {
+      Advance(out);
+    }
+  }
+}
+
+void RtpJitterBuffer::Flush(std::vector<uint8_t>* out) {
+  while (held_) {
+    Advance(out);
+  }
+  deadline_ = invalid_deadline;
+}
+
+size_t RtpJitterBuffer::GetSize() const {
+  return held_;
+}
+
+uint64_t RtpJitterBuffer::GetDeadline() const {
+  return deadline_;
+}
+
+uint64_t RtpJitterBuffer::GetLost() const {
+  return lost_;
+}
+
+uint64_t RtpJitterBuffer::GetReordered() const {
+  return reordered_;
+}
+
+uint64_t RtpJitterBuffer::GetDuplicates() const {
+  return duplicates_;
+}
+
+int64_t RtpJitterBuffer::Extend(uint16_t seq) const {
+  const int16_t delta = static_cast<int16_t>(seq - static_cast<uint16_t>(highest_));
+  return highest_ + delta;
+}
+
+RtpJitterBuffer::Slot* RtpJitterBuffer::GetSlot(int64_t seq) {
+  return &slots_[seq & (capacity - 1)];
+}
+
+void RtpJitterBuffer::Advance(std::vector<uint8_t>* out) {
+  Slot* slot = GetSlot(next_);
+  if (slot->seq == next_ && slot->state == SLOT_HELD) {
+    out->insert(out->end(), slot->payload.begin(), slot->payload.end());
+    slot->state = SLOT_RELEASED;
+    held_--;
+  } else {
+    slot->seq = next_;
+    slot->state = SLOT_SKIPPED;
+    lost_++;
+  }
+  next_++;
+}
+
+void RtpJitterBuffer::Reset() {
+  for (Slot& slot : slots_) {
+    slot.seq = -1;
+    slot.state = SLOT_EMPTY;
+  }
+  held_ = 0;
+  deadline_ = invalid_deadline;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,84 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <common/macros.h>
+
+namespace iptv_cloud {
+namespace stream {
+
+// Reorders rtp payloads by sequence numbers. Packet after a gap is held not longer than latency, when it expires
+// missing packets are counted lost and skipped. Sender restart (jump of sequence out of window) flushes buffer
+// and starts new sequence without losses.
+class RtpJitterBuffer {
+ public:
+  static const uint64_t invalid_deadline = UINT64_MAX;
+  enum { capacity = 2048 };  // packets window, power of 2
+
+  explicit RtpJitterBuffer(uint64_t latency);  // nsec
+  ~RtpJitterBuffer();
+
+  // arrival monotonic nsec, payloads released by resync appended to out
+  void Push(uint16_t seq, const uint8_t* payload, size_t size, uint64_t arrival, std::vector<uint8_t>* out);
+  // payloads in sequence order: next expected one is here or gap before held packet waited latency
+  void Pop(uint64_t now, std::vector<uint8_t>* out);
+  // all held payloads, gaps between them lost
+  void Flush(std::vector<uint8_t>* out);
+
+  size_t GetSize() const;         // held packets
+  uint64_t GetDeadline() const;   // when held packet after gap expires, invalid_deadline if nothing waits
+
+  uint64_t GetLost() const;        // skipped sequence numbers
+  uint64_t GetReordered() const;   // arrived after packet with bigger sequence number, late ones included
+  uint64_t GetDuplicates() const;  // same sequence number again
+
+ private:
+  enum SlotState { SLOT_EMPTY, SLOT_HELD, SLOT_RELEASED, SLOT_SKIPPED };
+  struct Slot {
+    Slot();
+
+    int64_t seq;  // extended
+    SlotState state;
+    uint64_t arrival;
+    std::vector<uint8_t> payload;
+  };
+
+  int64_t Extend(uint16_t seq) const;
+  Slot* GetSlot(int64_t seq);
+  void Advance(std::vector<uint8_t>* out);  // releases next expected packet or counts it lost
+  void Reset();
+
+  const uint64_t latency_;
+  std::vector<Slot> slots_;
+  bool started_;
+  int64_t next_;     // expected extended sequence number
+  int64_t highest_;  // biggest extended sequence number received
+  size_t held_;
+  uint64_t deadline_;
+
+  uint64_t lost_;
+  uint64_t reordered_;
+  uint64_t duplicates_;
+
+  DISALLOW_COPY_AND_ASSIGN(RtpJitterBuffer);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
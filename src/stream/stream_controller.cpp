@@ -43,6 +43,7 @@
 #include "utils/arg_converter.h"
 
 #define DUMP_FILE_NAME "dump.html"
+#define CAPS_CACHE_FILE_NAME "caps.cache"
 
 namespace iptv_cloud {
 namespace stream {
@@ -70,16 +71,11 @@ TimeShiftInfo make_timeshift_info(const utils::ArgsMap& args) {
   return tinfo;
 }
 
-bool PrepareStatus(StreamStruct* stats, double cpu_load, std::string* status_out) {
+bool PrepareStatus(StreamStruct* stats, double cpu_load, long rss, std::string* status_out) {
   if (!stats || !status_out) {
     return false;
   }
 
-  if (isnan(cpu_load) || isinf(cpu_load)) {  // stable double
-    cpu_load = 0.0;
-  }
-
-  long rss = common::system_info::GetProcessRss(getpid());
   const time_t current_time = common::time::current_mstime() / 1000;
   StatisticInfo sinf(*stats, cpu_load, rss, current_time);
 
@@ -144,6 +140,7 @@ StreamController::StreamController(const std::string& feedback_dir,
       config_(nullptr),
       timeshift_info_(),
       restart_attempts_(0),
+      caps_cache_(common::file_system::make_path(feedback_dir, CAPS_CACHE_FILE_NAME)),
       stop_mutex_(),
       stop_cond_(),
       stop_(false),
@@ -166,6 +163,11 @@ common::Error StreamController::Init(const utils::ArgsMap& config_args) {
   }
 
   config_ = lconfig;
+  common::ErrnoError errn = caps_cache_.Load();
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+  }
+
   StreamType stream_type = config_->GetType();
   if (stream_type == TIMESHIFT_RECORDER || stream_type == TIMESHIFT_PLAYER || stream_type == CATCHUP) {
     timeshift_info_ = make_timeshift_info(config_args);
@@ -180,7 +182,10 @@ common::Error StreamController::Init(const utils::ArgsMap& config_args) {
     }
   }
 
-  streams_init(0, nullptr, enc);
+  streams_init(0, nullptr, enc);  // fast if backend preloaded by zygote
+  if (mem_->shared_stats) {
+    mem_->shared_stats->PublishInitTime(common::time::current_mstime());
+  }
   return common::Error();
 }
 
@@ -214,6 +219,7 @@ int StreamController::Exec() {
           std::cv_status interrupt_status = stop_cond_.wait_for(lock, std::chrono::seconds(timeshift_chunk_duration));
           if (interrupt_status == std::cv_status::no_timeout) {  // if notify
             mem_->restarts++;
+            mem_->PublishStats();
             break;
           }
         }
@@ -492,7 +498,7 @@ void StreamController::OnPipelineEOS(IBaseStream* stream) {
 }
 
 void StreamController::OnTimeoutUpdated(IBaseStream* stream) {
-  DumpStreamStatus(stream->GetStats());
+  UpdateProcessInfo(stream->GetStats());  // daemon reads periodic statistic from shared memory
 }
 
 void StreamController::OnASyncMessageReceived(IBaseStream* stream, GstMessage* message) {
@@ -517,6 +523,33 @@ void StreamController::OnInputChanged(const InputUri& uri) {
   static_cast<StreamServer*>(loop_)->WriteRequest(req);
 }
 
+bool StreamController::OnFindInputCaps(const InputUri& uri, InputCaps* caps) {
+  return caps_cache_.Find(uri.GetInput().GetUrl(), caps);
+}
+
+// called from streaming threads, cache file is written by loop thread
+void StreamController::OnInputCapsDetected(const InputUri& uri, const InputCaps& caps) {
+  const std::string url = uri.GetInput().GetUrl();
+  auto cb = [this, url, caps] {
+    common::ErrnoError errn = caps_cache_.Insert(url, caps);
+    if (errn) {
+      DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+    }
+  };
+  loop_->ExecInLoopThread(cb);
+}
+
+void StreamController::OnInputCapsMismatch(const InputUri& uri) {
+  const std::string url = uri.GetInput().GetUrl();
+  auto cb = [this, url] {
+    common::ErrnoError errn = caps_cache_.Remove(url);
+    if (errn) {
+      DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+    }
+  };
+  loop_->ExecInLoopThread(cb);
+}
+
 void StreamController::OnPipelineCreated(IBaseStream* stream) {
   common::file_system::ascii_directory_string_path feedback_dir(feedback_dir_);
   auto dump_file = feedback_dir.MakeFileStringPath(DUMP_FILE_NAME);
@@ -525,9 +558,32 @@ void StreamController::OnPipelineCreated(IBaseStream* stream) {
   }
 }
 
+void StreamController::UpdateProcessInfo(StreamStruct* stat, double* cpu_load, long* rss) {
+  double lcpu_load = common::system_info::GetCpuLoad(getpid());
+  if (isnan(lcpu_load) || isinf(lcpu_load)) {  // stable double
+    lcpu_load = 0.0;
+  }
+
+  const long lrss = common::system_info::GetProcessRss(getpid());
+  if (stat->shared_stats) {
+    stat->shared_stats->PublishProcessInfo(lcpu_load, lrss);
+  }
+  if (cpu_load) {
+    *cpu_load = lcpu_load;
+  }
+  if (rss) {
+    *rss = lrss;
+  }
+}
+
 void StreamController::DumpStreamStatus(StreamStruct* stat) {
+  stat->PublishStats();
+  double cpu_load = 0.0;
+  long rss = 0;
+  UpdateProcessInfo(stat, &cpu_load, &rss);
+
   std::string status_json;
-  if (PrepareStatus(stat, common::system_info::GetCpuLoad(getpid()), &status_json)) {
+  if (PrepareStatus(stat, cpu_load, rss, &status_json)) {
     protocol::request_t req = StatisticStreamBroadcast(status_json);
     static_cast<StreamServer*>(loop_)->WriteRequest(req);
   }
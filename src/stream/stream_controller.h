@@ -23,6 +23,7 @@
 
 #include "protocol/types.h"
 #include "stream/ibase_stream.h"
+#include "stream/input_caps_cache.h"
 #include "stream/timeshift.h"
 #include "utils/arg_converter.h"
 #include "utils/utils.h"
@@ -87,17 +88,22 @@ class StreamController : public common::libev::IoLoopObserver, public IBaseStrea
   void OnSyncMessageReceived(IBaseStream* stream, GstMessage* message) override;
   void OnASyncMessageReceived(IBaseStream* stream, GstMessage* message) override;
   void OnInputChanged(const InputUri& uri) override;
+  bool OnFindInputCaps(const InputUri& uri, InputCaps* caps) override;
+  void OnInputCapsDetected(const InputUri& uri, const InputCaps& caps) override;
+  void OnInputCapsMismatch(const InputUri& uri) override;
 
   void OnPipelineCreated(IBaseStream* stream) override;
 
   common::ErrnoError SendResponceToParent(const std::string& cmd) WARN_UNUSED_RESULT;
 
+  void UpdateProcessInfo(StreamStruct* stat, double* cpu_load = nullptr, long* rss = nullptr);
   void DumpStreamStatus(StreamStruct* stat);
 
   const std::string feedback_dir_;
   const Config* config_;
   TimeShiftInfo timeshift_info_;
   size_t restart_attempts_;
+  InputCapsCache caps_cache_;
 
   std::mutex stop_mutex_;
   std::condition_variable stop_cond_;
@@ -14,6 +14,8 @@
 
 #include "stream/streams/builders/encoding/encoding_stream_builder.h"
 
+#include <algorithm>
+#include <memory>
 #include <string>
 
 #include <common/sprintf.h>
@@ -25,18 +27,43 @@
 #include "stream/elements/encoders/video_encoders.h"
 #include "stream/elements/parser/audio_parsers.h"
 #include "stream/elements/parser/video_parsers.h"
+#include "stream/elements/sink/http.h"
 #include "stream/elements/sink/screen.h"
 #include "stream/elements/video/video.h"
 
+#include "stream/hls_master_playlist.h"
+#include "stream/key_unit_scheduler.h"
+
 #include "stream/pad/pad.h"
 
 namespace iptv_cloud {
 namespace stream {
+namespace {
+// GstForceKeyUnit travels through renditions tee, so every encoder gets it before the same frame
+GstPadProbeReturn force_key_unit_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  KeyUnitScheduler* scheduler = static_cast<KeyUnitScheduler*>(user_data);
+  GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (!scheduler->Check(GST_BUFFER_PTS(buffer))) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstStructure* force_key_unit = gst_structure_new(
+      "GstForceKeyUnit", "timestamp", G_TYPE_UINT64, GST_BUFFER_PTS(buffer), "stream-time", G_TYPE_UINT64,
+      GST_CLOCK_TIME_NONE, "running-time", G_TYPE_UINT64, GST_CLOCK_TIME_NONE, "all-headers", G_TYPE_BOOLEAN, TRUE,
+      "count", G_TYPE_UINT, scheduler->GetCount(), nullptr);
+  gst_pad_send_event(pad, gst_event_new_custom(GST_EVENT_CUSTOM_DOWNSTREAM, force_key_unit));
+  return GST_PAD_PROBE_OK;
+}
+
+void destroy_key_unit_scheduler(gpointer user_data) {
+  delete static_cast<KeyUnitScheduler*>(user_data);
+}
+}  // namespace
 namespace streams {
 namespace builders {
 
 EncodingStreamBuilder::EncodingStreamBuilder(const EncodingConfig* api, SrcDecodeBinStream* observer)
-    : SrcDecodeStreamBuilder(api, observer) {}
+    : SrcDecodeStreamBuilder(api, observer), rendition_tees_() {}
 
 Connector EncodingStreamBuilder::BuildPostProc(Connector conn) {
   const EncodingConfig* config = static_cast<const EncodingConfig*>(GetConfig());
@@ -90,7 +117,9 @@ SupportedAudioCodec EncodingStreamBuilder::GetAudioCodecType() const {
 
 Connector EncodingStreamBuilder::BuildConverter(Connector conn) {
   const EncodingConfig* config = static_cast<const EncodingConfig*>(GetConfig());
-  if (config->HaveVideo()) {
+  if (config->HaveVideo() && !config->GetVideoRenditions().empty()) {
+    conn.video = BuildVideoRenditions(conn.video);
+  } else if (config->HaveVideo()) {
     elements_line_t video_encoder = BuildVideoConverter(0);
     if (!video_encoder.empty()) {
       ElementLink(conn.video, video_encoder.front());
@@ -134,12 +163,184 @@ Connector EncodingStreamBuilder::BuildConverter(Connector conn) {
   return conn;
 }
 
+elements::Element* EncodingStreamBuilder::BuildVideoRenditions(elements::Element* link_to) {
+  const EncodingConfig* config = static_cast<const EncodingConfig*>(GetConfig());
+  const video_renditions_t renditions = config->GetVideoRenditions();
+
+  elements::ElementTee* split = new elements::ElementTee(common::MemSPrintf(RENDITIONS_TEE_NAME_1U, 0));
+  ElementAdd(split);
+  ElementLink(link_to, split);
+
+  pad::Pad* split_pad = split->StaticPad("sink");
+  if (split_pad->IsValid()) {
+    const uint64_t interval = static_cast<uint64_t>(config->GetKeyFrameInterval()) * GST_MSECOND;
+    gst_pad_add_probe(split_pad->GetGstPad(), GST_PAD_PROBE_TYPE_BUFFER, force_key_unit_probe_callback,
+                      new KeyUnitScheduler(interval), destroy_key_unit_scheduler);
+  }
+  delete split_pad;
+
+  rendition_tees_.clear();
+  for (size_t i = 0; i < renditions.size(); ++i) {
+    elements_line_t rendition_line = BuildVideoRendition(renditions[i], i);
+    ElementLink(split, rendition_line.front());
+
+    elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(VIDEO_TEE_NAME_1U, i));
+    ElementAdd(tee);
+    ElementLink(rendition_line.back(), tee);
+    rendition_tees_.push_back(tee);
+  }
+
+  return rendition_tees_.front();
+}
+
+elements_line_t EncodingStreamBuilder::BuildVideoRendition(const VideoRendition& rendition, element_id_t rendition_id) {
+  const EncodingConfig* conf = static_cast<const EncodingConfig*>(GetConfig());
+  elements::ElementQueue* queue = new elements::ElementQueue(common::MemSPrintf(RENDITION_QUEUE_NAME_1U, rendition_id));
+  ElementAdd(queue);
+  elements::Element* last = queue;
+
+  const common::draw::Size size = rendition.size;
+  if (conf->IsGpu()) {
+    const std::string post_name = common::MemSPrintf(RENDITION_POST_PROC_NAME_1U, rendition_id);
+    if (conf->IsMfxGpu()) {
+      elements::ElementMFXVpp* post = new elements::ElementMFXVpp(post_name);
+      post->SetForceAspectRatio(false);
+      post->SetWidth(size.width);
+      post->SetHeight(size.height);
+      ElementAdd(post);
+      ElementLink(last, post);
+      last = post;
+    } else {
+      elements::ElementVaapiPostProc* post = new elements::ElementVaapiPostProc(post_name);
+      post->SetDinterlaceMode(2);  // (2): disabled - done by shared post proc
+      post->SetFormat(2);          // GST_VIDEO_FORMAT_I420
+      post->SetForceAspectRatio(false);
+      post->SetWidth(size.width);
+      post->SetHeight(size.height);
+      ElementAdd(post);
+      ElementLink(last, post);
+      last = post;
+    }
+  } else {
+    last = elements::encoders::build_video_scale(size.width, size.height, this, last, rendition_id);
+  }
+
+  elements_line_t video_encoder =
+      elements::encoders::build_video_encoder(conf->GetVideoEncoder(), rendition.video_bitrate,
+                                              rendition.video_encoder_args, rendition.video_encoder_str_args, this,
+                                              rendition_id);
+  ElementLink(last, video_encoder.front());
+  last = video_encoder.back();
+
+  if (elements::encoders::IsH264Encoder(conf->GetVideoEncoder())) {
+    elements::parser::ElementH264Parse* premux_parser = elements::parser::make_h264_parser(rendition_id);
+    ElementAdd(premux_parser);
+    ElementLink(last, premux_parser);
+    last = premux_parser;
+  }
+
+  return {queue, last};
+}
+
+size_t EncodingStreamBuilder::FindOutputRendition(const OutputUri& output) const {
+  const EncodingConfig* config = static_cast<const EncodingConfig*>(GetConfig());
+  const video_renditions_t renditions = config->GetVideoRenditions();
+  for (size_t i = 0; i < renditions.size(); ++i) {
+    const auto& outputs = renditions[i].outputs;
+    if (std::find(outputs.begin(), outputs.end(), output.GetID()) != outputs.end()) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+elements::Element* EncodingStreamBuilder::SelectOutputVideoSource(const OutputUri& output, elements::Element* video) {
+  const size_t rendition = FindOutputRendition(output);
+  if (rendition < rendition_tees_.size()) {
+    return rendition_tees_[rendition];
+  }
+
+  return video;
+}
+
+Connector EncodingStreamBuilder::BuildOutput(Connector conn) {
+  conn = SrcDecodeStreamBuilder::BuildOutput(conn);
+
+  const EncodingConfig* config = static_cast<const EncodingConfig*>(GetConfig());
+  if (config->HaveVideo() && !rendition_tees_.empty() && !config->GetHlsMasterPlaylist().empty()) {
+    BuildHlsMasterPlaylist();
+  }
+  return conn;
+}
+
+void EncodingStreamBuilder::BuildHlsMasterPlaylist() {
+  const EncodingConfig* config = static_cast<const EncodingConfig*>(GetConfig());
+  const video_renditions_t renditions = config->GetVideoRenditions();
+  const output_t out = config->GetOutput();
+  const auto audio_bitrate = config->GetAudioBitrate();
+  const guint target_duration = (config->GetKeyFrameInterval() + 999) / 1000;
+
+  std::shared_ptr<HlsMasterPlaylist> master;
+  OutputUri::http_root_t master_root;
+  for (size_t i = 0; i < out.size(); ++i) {
+    const common::uri::Url uri = out[i].GetOutput();
+    if (uri.GetScheme() != common::uri::Url::http) {
+      continue;
+    }
+
+    if (!master) {
+      master_root = out[i].GetHttpRoot();
+      auto master_path = master_root.MakeFileStringPath(config->GetHlsMasterPlaylist());
+      if (!master_path) {
+        WARNING_LOG() << "Invalid hls master playlist path, http root: " << master_root.GetPath();
+        return;
+      }
+      master = std::make_shared<HlsMasterPlaylist>(*master_path, config->HaveAudio());
+    }
+
+    // variants of the same directory are relative, others are absolute urls
+    const bool same_root = out[i].GetHttpRoot().GetPath() == master_root.GetPath();
+    const std::string variant_uri = same_root ? uri.GetPath().GetFileName() : uri.GetUrl();
+    const VideoRendition& rendition = renditions[FindOutputRendition(out[i])];
+    uint64_t bandwidth = rendition.video_bitrate ? *rendition.video_bitrate : 0;
+    if (config->HaveAudio() && audio_bitrate) {
+      bandwidth += *audio_bitrate;
+    }
+    bandwidth = bandwidth * 1024 * 11 / 10;  // kbit/s of encoders, plus mpegts overhead
+    const size_t variant = master->AddVariant(variant_uri, bandwidth);
+
+    // segments are cut on aligned keyframes only, playlist target duration must cover them
+    elements::Element* sink = GetElementByName(common::MemSPrintf(SINK_NAME_1U, i));
+    if (sink) {
+      static_cast<elements::sink::ElementHLSSink*>(sink)->SetTargetDuration(target_duration);
+    }
+
+    // outputs of the same rendition share muxer and its tee queues
+    const element_id_t mux_id = GetOutputMuxerId(i);
+    elements::Element* video_queue = GetElementByName(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, mux_id));
+    if (video_queue) {
+      pad::Pad* src_pad = video_queue->StaticPad("src");
+      master->LinkPad(variant, HlsMasterPlaylist::VIDEO_TRACK, src_pad->GetGstPad());
+      delete src_pad;
+    }
+
+    elements::Element* audio_queue = GetElementByName(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, mux_id));
+    if (audio_queue) {
+      pad::Pad* src_pad = audio_queue->StaticPad("src");
+      master->LinkPad(variant, HlsMasterPlaylist::AUDIO_TRACK, src_pad->GetGstPad());
+      delete src_pad;
+    }
+  }
+}
+
 elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id) {
   const EncodingConfig* conf = static_cast<const EncodingConfig*>(GetConfig());
   elements::Element* first = nullptr;
   elements::Element* last = nullptr;
 
-  const common::draw::Size size = conf->GetSize();
+  // renditions are scaled after split, each to own size
+  const common::draw::Size size = conf->GetVideoRenditions().empty() ? conf->GetSize() : common::draw::Size();
   const auto framerate = conf->GetFramerate();
   if (conf->IsGpu()) {
     if (conf->IsMfxGpu()) {
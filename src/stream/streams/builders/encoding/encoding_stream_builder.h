@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "stream/streams/builders/src_decodebin_stream_builder.h"
 
 #include "stream/streams/configs/encoding_config.h"
@@ -31,6 +33,8 @@ class EncodingStreamBuilder : public SrcDecodeStreamBuilder {
   EncodingStreamBuilder(const EncodingConfig* api, SrcDecodeBinStream* observer);
   Connector BuildPostProc(Connector conn) override;
   Connector BuildConverter(Connector conn) override;
+  Connector BuildOutput(Connector conn) override;
+  elements::Element* SelectOutputVideoSource(const OutputUri& output, elements::Element* video) override;
 
   SupportedVideoCodec GetVideoCodecType() const override;
   SupportedAudioCodec GetAudioCodecType() const override;
@@ -41,6 +45,16 @@ class EncodingStreamBuilder : public SrcDecodeStreamBuilder {
 
   virtual elements_line_t BuildVideoConverter(element_id_t video_id);
   virtual elements_line_t BuildAudioConverter(element_id_t audio_id);
+
+  // scaler and encoder of one rendition, fed from tee after shared post processing
+  virtual elements_line_t BuildVideoRendition(const VideoRendition& rendition, element_id_t rendition_id);
+
+ private:
+  elements::Element* BuildVideoRenditions(elements::Element* link_to);
+  size_t FindOutputRendition(const OutputUri& output) const;  // not listed outputs get first rendition
+  void BuildHlsMasterPlaylist();
+
+  std::vector<elements::Element*> rendition_tees_;
 };
 
 }  // namespace builders
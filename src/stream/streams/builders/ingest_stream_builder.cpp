@@ -0,0 +1,101 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streams/builders/ingest_stream_builder.h"
+
+#include <common/sprintf.h>
+
+#include "base/constants.h"
+
+#include "stream/elements/element.h"
+#include "stream/elements/sink/shm.h"
+#include "stream/ibase_stream.h"
+#include "stream/streams/ingest_stream.h"
+
+#include "stream/pad/pad.h"
+
+namespace iptv_cloud {
+namespace stream {
+namespace streams {
+namespace builders {
+
+elements::ElementQueue* make_ingest_queue() {
+  elements::ElementQueue* queue = new elements::ElementQueue(common::MemSPrintf(UDB_VIDEO_NAME_1U, 0));
+  queue->SetMaxSizeBuffers(0);
+  queue->SetMaxSizeTime(INGEST_QUEUE_MAX_TIME * GST_MSECOND);
+  queue->SetMaxSizeBytes(INGEST_QUEUE_MAX_BYTES);
+  queue->SetLeaky(elements::ElementQueue::LEAKY_DOWNSTREAM);
+  return queue;
+}
+
+IngestStreamBuilder::IngestStreamBuilder(const Config* config, IngestStream* observer)
+    : GstBaseBuilder(config, observer) {}
+
+Connector IngestStreamBuilder::BuildInput() {
+  const Config* config = GetConfig();
+  input_t prepared = config->GetInput();
+  const common::uri::Url uri = prepared[0].GetInput();
+  elements::Element* src = CreateSrc(uri, 0, IBaseStream::src_timeout_sec);
+  pad::Pad* src_pad = src->StaticPad("src");
+  if (src_pad->IsValid()) {
+    HandleInputSrcPadCreated(uri.GetScheme(), src_pad, 0);
+  }
+  delete src_pad;
+  ElementAdd(src);
+
+  // slow reader stalls shmsink, consumers lose oldest data then, but source connection stays served
+  elements::ElementQueue* queue = make_ingest_queue();
+  ElementAdd(queue);
+  ElementLink(src, queue);
+  return {queue, nullptr};
+}
+
+Connector IngestStreamBuilder::BuildUdbConnections(Connector conn) {
+  return conn;
+}
+
+Connector IngestStreamBuilder::BuildPostProc(Connector conn) {
+  return conn;
+}
+
+Connector IngestStreamBuilder::BuildConverter(Connector conn) {
+  return conn;
+}
+
+Connector IngestStreamBuilder::BuildOutput(Connector conn) {
+  const Config* config = GetConfig();
+  elements::sink::ElementShmSink* sink =
+      elements::sink::make_shm_sink(config->GetIngestPublish(), DEFAULT_INGEST_SHM_SIZE, 0);
+  ElementAdd(sink);
+  pad::Pad* sink_pad = sink->StaticPad("sink");
+  if (sink_pad->IsValid()) {
+    HandleOutputSinkPadCreated(common::uri::Url::unknown, sink_pad, 0);
+  }
+  delete sink_pad;
+  ElementLink(conn.video, sink);
+  HandleShmSinkCreated(sink);
+  return conn;
+}
+
+void IngestStreamBuilder::HandleShmSinkCreated(elements::sink::ElementShmSink* sink) {
+  IngestStream* stream = static_cast<IngestStream*>(GetObserver());
+  if (stream) {
+    stream->OnShmSinkCreated(sink);
+  }
+}
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,52 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "stream/streams/builders/gst_base_builder.h"
+
+namespace iptv_cloud {
+namespace stream {
+namespace elements {
+class ElementQueue;
+namespace sink {
+class ElementShmSink;
+}
+}  // namespace elements
+namespace streams {
+class IngestStream;
+namespace builders {
+
+// queue in front of shmsink, leaky and bounded, so source thread never waits for stalled shared memory
+elements::ElementQueue* make_ingest_queue();
+
+// src => queue => shmsink, nothing demuxed or parsed
+class IngestStreamBuilder : public GstBaseBuilder {
+ public:
+  IngestStreamBuilder(const Config* config, IngestStream* observer);
+
+  Connector BuildInput() override;
+  Connector BuildUdbConnections(Connector conn) override;
+  Connector BuildPostProc(Connector conn) override;
+  Connector BuildConverter(Connector conn) override;
+  Connector BuildOutput(Connector conn) override;
+
+ protected:
+  void HandleShmSinkCreated(elements::sink::ElementShmSink* sink);
+};
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace iptv_cloud
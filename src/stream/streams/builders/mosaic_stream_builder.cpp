@@ -110,7 +110,7 @@ bool MosaicStreamBuilder::InitPipeline() {
       SoundInfo sound;
       InputUri uri = prepared[i];
       const common::uri::Url iuri = uri.GetInput();
-      elements::Element* src = elements::sources::make_src(iuri, i, IBaseStream::src_timeout_sec);
+      elements::Element* src = CreateSrc(iuri, i, IBaseStream::src_timeout_sec);
       pad::Pad* src_pad = src->StaticPad("src");
       if (src_pad->IsValid()) {
         HandleInputSrcPadCreated(iuri.GetScheme(), src_pad, i);
@@ -274,9 +274,9 @@ void MosaicStreamBuilder::BuildOutput(elements::Element* video, elements::Elemen
 
     common::uri::Url uri = output.GetOutput();
     common::uri::Url::scheme scheme = uri.GetScheme();
-    bool is_rtp_out = scheme == common::uri::Url::udp;
+    bool is_rtp_out = scheme == common::uri::Url::udp && !config->IsUdpBatch();
     const std::string vcodec = config->GetVideoEncoder();
-    elements::Element* mux = elements::muxer::make_muxer(scheme, i);
+    elements::Element* mux = elements::muxer::make_muxer(scheme, i, config->IsUdpBatch());
     ElementAdd(mux);
 
     if (config->HaveVideo()) {
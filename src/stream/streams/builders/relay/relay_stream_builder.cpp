@@ -21,14 +21,101 @@
 #include "stream/elements/parser/audio_parsers.h"
 #include "stream/elements/parser/video_parsers.h"
 
+#include "stream/streams/relay/relay_stream.h"
+
 namespace iptv_cloud {
 namespace stream {
+namespace {
+bool EndsWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// container which input delivers, known from url without typefind
+bool GetDemuxerFromUrl(const common::uri::Url& uri, SupportedDemuxer* demuxer) {
+  const common::uri::Url::scheme scheme = uri.GetScheme();
+  if (scheme == common::uri::Url::udp || scheme == common::uri::Url::tcp) {
+    *demuxer = VIDEO_MPEGTS_DEMUXER;
+    return true;
+  } else if (scheme == common::uri::Url::rtmp) {
+    *demuxer = VIDEO_FLV_DEMUXER;
+    return true;
+  } else if (scheme == common::uri::Url::http || scheme == common::uri::Url::https ||
+             scheme == common::uri::Url::file) {
+    const common::uri::Upath upath = uri.GetPath();
+    const std::string path = upath.GetPath();
+    if (EndsWith(path, "." TS_EXTENSION)) {
+      *demuxer = VIDEO_MPEGTS_DEMUXER;
+      return true;
+    } else if (EndsWith(path, ".flv")) {
+      *demuxer = VIDEO_FLV_DEMUXER;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+elements::Element* make_demuxer(SupportedDemuxer demuxer, element_id_t demuxer_id) {
+  const std::string name = common::MemSPrintf(DEMUXER_NAME_1U, demuxer_id);
+  if (demuxer == VIDEO_MPEGTS_DEMUXER) {
+    return new elements::ElementTsDemux(name);
+  } else if (demuxer == VIDEO_FLV_DEMUXER) {
+    return new elements::ElementFlvDemux(name);
+  }
+
+  NOTREACHED() << "Please add demuxer for type: " << demuxer;
+  return nullptr;
+}
+}  // namespace
 namespace streams {
 namespace builders {
 
 RelayStreamBuilder::RelayStreamBuilder(const RelayConfig* config, SrcDecodeBinStream* observer)
     : SrcDecodeStreamBuilder(config, observer) {}
 
+Connector RelayStreamBuilder::BuildInput() {
+  SupportedDemuxer demuxer_type;
+  if (!GetInputDemuxer(&demuxer_type)) {
+    return SrcDecodeStreamBuilder::BuildInput();
+  }
+
+  elements::Element* src = BuildInputSrc();
+  elements::Element* demuxer = make_demuxer(demuxer_type, 0);
+  ElementAdd(demuxer);
+  ElementLink(src, demuxer);
+  HandleDemuxerCreated(demuxer, demuxer_type);
+
+  return {nullptr, nullptr};
+}
+
+bool RelayStreamBuilder::GetInputDemuxer(SupportedDemuxer* demuxer) const {
+  const RelayConfig* config = static_cast<const RelayConfig*>(GetConfig());
+  if (!config->IsFastPath() || config->GetType() != RELAY) {
+    return false;
+  }
+
+  // tsparse takes whole transport stream, there is nothing to demux
+  if (config->GetVideoParser() == elements::parser::ElementTsParse::GetPluginName()) {
+    return false;
+  }
+
+  // container detected by autoplugging on previous runs takes precedence over url guess
+  RelayStream* stream = static_cast<RelayStream*>(GetObserver());
+  if (stream && stream->FindCachedDemuxer(demuxer)) {
+    return true;
+  }
+
+  const input_t input = config->GetInput();
+  return GetDemuxerFromUrl(input[0].GetInput(), demuxer);
+}
+
+void RelayStreamBuilder::HandleDemuxerCreated(elements::Element* demuxer, SupportedDemuxer type) {
+  RelayStream* stream = static_cast<RelayStream*>(GetObserver());
+  if (stream) {
+    stream->OnDemuxerCreated(demuxer, type);
+  }
+}
+
 Connector RelayStreamBuilder::BuildPostProc(Connector conn) {
   return conn;
 }
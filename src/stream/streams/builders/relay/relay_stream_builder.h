@@ -27,6 +27,8 @@ class RelayStreamBuilder : public SrcDecodeStreamBuilder {
  public:
   RelayStreamBuilder(const RelayConfig* config, SrcDecodeBinStream* observer);
 
+  Connector BuildInput() override;
+
   elements::Element* BuildVideoUdbConnection() override;
   elements::Element* BuildAudioUdbConnection() override;
 
@@ -35,6 +37,12 @@ class RelayStreamBuilder : public SrcDecodeStreamBuilder {
 
   Connector BuildPostProc(Connector conn) override;
   Connector BuildConverter(Connector conn) override;
+
+ protected:
+  // fast path: container of input known without typefind, parsers are linked to demuxer pads directly
+  virtual bool GetInputDemuxer(SupportedDemuxer* demuxer) const;
+
+  void HandleDemuxerCreated(elements::Element* demuxer, SupportedDemuxer type);
 };
 
 }  // namespace builders
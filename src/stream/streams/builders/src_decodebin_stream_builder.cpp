@@ -14,6 +14,9 @@
 
 #include "stream/streams/builders/src_decodebin_stream_builder.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <common/sprintf.h>
 
 #include "stream/ibase_stream.h"
@@ -58,12 +61,35 @@ elements::Element* make_audio_pay(SupportedAudioCodec acodec, element_id_t pay_i
   NOTREACHED() << "Please add rtp pay for audio codec type: " << acodec;
   return nullptr;
 }
+
+// network outputs where server can go away and come back
+// tcp clients server keeps listening by itself, only tcpserversink needs reconnect
+bool is_reconnectable_output(const OutputUri& output, bool tcp_clients) {
+  common::uri::Url::scheme scheme = output.GetOutput().GetScheme();
+  return scheme == common::uri::Url::rtmp || (scheme == common::uri::Url::tcp && !tcp_clients);
+}
 }  // namespace
 namespace streams {
 namespace builders {
 
+element_id_t GroupOutput(elements::SupportedElements muxer,
+                         elements::Element* video,
+                         size_t output_index,
+                         output_groups_t* groups) {
+  auto it = std::find_if(groups->begin(), groups->end(), [muxer, video](const OutputGroup& group) {
+    return group.muxer == muxer && group.video == video;
+  });
+  if (it == groups->end()) {
+    groups->push_back({muxer, video, {output_index}});
+    return output_index;
+  }
+
+  it->outputs.push_back(output_index);
+  return it->outputs.front();
+}
+
 SrcDecodeStreamBuilder::SrcDecodeStreamBuilder(const AudioVideoConfig* config, SrcDecodeBinStream* observer)
-    : GstBaseBuilder(config, observer) {}
+    : GstBaseBuilder(config, observer), output_muxers_() {}
 
 Connector SrcDecodeStreamBuilder::BuildInput() {
   elements::Element* src = BuildInputSrc();
@@ -86,7 +112,7 @@ elements::Element* SrcDecodeStreamBuilder::BuildInputSrc() {
   const Config* config = GetConfig();
   input_t prepared = config->GetInput();
   const common::uri::Url uri = prepared[0].GetInput();
-  elements::Element* src = elements::sources::make_src(uri, 0, IBaseStream::src_timeout_sec);
+  elements::Element* src = CreateSrc(uri, 0, IBaseStream::src_timeout_sec);
   pad::Pad* src_pad = src->StaticPad("src");
   if (src_pad->IsValid()) {
     HandleInputSrcPadCreated(uri.GetScheme(), src_pad, 0);
@@ -128,29 +154,42 @@ Connector SrcDecodeStreamBuilder::BuildUdbConnections(Connector conn) {
 Connector SrcDecodeStreamBuilder::BuildOutput(Connector conn) {
   const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
   output_t out = config->GetOutput();
+  output_muxers_.resize(out.size());
+
+  // one muxer per container and video source, its stream teed to every sink, sinks keep own stats
+  output_groups_t groups;
   for (size_t i = 0; i < out.size(); ++i) {
     const OutputUri output = out[i];
+    output_muxers_[i] = i;
     SinkDeviceType dt;
     if (IsDeviceOutUrl(output.GetOutput(), &dt)) {  // monitor
       CRITICAL_LOG() << "Decklink not supported for encoding based streams!";
       continue;
     }
 
-    common::uri::Url uri = output.GetOutput();
+    const elements::SupportedElements muxer =
+        elements::muxer::get_muxer_type(output.GetOutput().GetScheme(), config->IsUdpBatch());
+    elements::Element* video = config->HaveVideo() ? SelectOutputVideoSource(output, conn.video) : nullptr;
+    output_muxers_[i] = GroupOutput(muxer, video, i, &groups);
+  }
+
+  for (const OutputGroup& group : groups) {
+    const element_id_t mux_id = group.outputs.front();
+    common::uri::Url uri = out[mux_id].GetOutput();
     common::uri::Url::scheme scheme = uri.GetScheme();
-    bool is_rtp_out = scheme == common::uri::Url::udp;
-    elements::Element* mux = elements::muxer::make_muxer(scheme, i);
+    bool is_rtp_out = scheme == common::uri::Url::udp && !config->IsUdpBatch();
+    elements::Element* mux = elements::muxer::make_muxer(scheme, mux_id, config->IsUdpBatch());
     ElementAdd(mux);
 
     if (config->HaveVideo()) {
       elements::ElementQueue* video_tee_queue =
-          new elements::ElementQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, i));
+          new elements::ElementQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, mux_id));
       ElementAdd(video_tee_queue);
       elements::Element* next = video_tee_queue;
-      ElementLink(conn.video, next);
+      ElementLink(group.video, next);
 
       if (is_rtp_out) {
-        elements::Element* rtp_pay = make_video_pay(GetVideoCodecType(), i);
+        elements::Element* rtp_pay = make_video_pay(GetVideoCodecType(), mux_id);
         ElementAdd(rtp_pay);
         ElementLink(next, rtp_pay);
         next = rtp_pay;
@@ -161,13 +200,13 @@ Connector SrcDecodeStreamBuilder::BuildOutput(Connector conn) {
 
     if (config->HaveAudio()) {
       elements::ElementQueue* audio_tee_queue =
-          new elements::ElementQueue(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, i));
+          new elements::ElementQueue(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, mux_id));
       ElementAdd(audio_tee_queue);
       elements::Element* next = audio_tee_queue;
       ElementLink(conn.audio, next);
 
       if (is_rtp_out) {
-        elements::Element* rtp_pay = make_audio_pay(GetAudioCodecType(), i);
+        elements::Element* rtp_pay = make_audio_pay(GetAudioCodecType(), mux_id);
         ElementAdd(rtp_pay);
         ElementLink(next, rtp_pay);
         next = rtp_pay;
@@ -176,13 +215,81 @@ Connector SrcDecodeStreamBuilder::BuildOutput(Connector conn) {
       ElementLink(next, mux);
     }
 
-    elements::Element* sink = BuildGenericOutput(output, i);
-    ElementAdd(sink);
-    ElementLink(mux, sink);
+    // reconnected branch is unlinked from tee for a while, so even single output gets tee which allows it,
+    // batched udp output gets queue, its pacing doesn't hold muxer thread
+    const bool is_isolated = config->IsOutputIsolated();
+    const bool tcp_clients = config->IsTcpClients();
+    const bool is_reconnect =
+        config->IsOutputReconnect() &&
+        std::any_of(group.outputs.begin(), group.outputs.end(), [&out, tcp_clients](size_t output_index) {
+          return is_reconnectable_output(out[output_index], tcp_clients);
+        });
+    const bool is_paced = config->IsUdpBatch() && scheme == common::uri::Url::udp;
+    if (group.outputs.size() == 1 && !is_isolated && !is_reconnect && !is_paced) {
+      elements::Element* sink = BuildGenericOutput(out[mux_id], mux_id);
+      ElementAdd(sink);
+      ElementLink(mux, sink);
+      continue;
+    }
+
+    elements::Element* branch = mux;
+    if (group.outputs.size() > 1 || is_reconnect) {
+      elements::ElementTee* mux_tee = new elements::ElementTee(common::MemSPrintf(MUXER_TEE_NAME_1U, mux_id));
+      mux_tee->SetAllowNotLinked(is_reconnect);
+      ElementAdd(mux_tee);
+      ElementLink(mux, mux_tee);
+      branch = mux_tee;
+    }
+
+    for (size_t output_index : group.outputs) {
+      // queue of reconnected output never blocks tee, it is bounded and leaky as isolated one
+      const bool is_reconnectable =
+          config->IsOutputReconnect() && is_reconnectable_output(out[output_index], tcp_clients);
+      elements::ElementQueue* output_queue = BuildOutputQueue(output_index, is_isolated || is_reconnectable);
+      ElementLink(branch, output_queue);
+
+      elements::Element* sink = BuildGenericOutput(out[output_index], output_index, true);
+      ElementAdd(sink);
+      ElementLink(output_queue, sink);
+      if (is_reconnectable) {
+        HandleOutputBranchCreated(output_queue, sink, output_index);
+      }
+    }
   }
   return conn;
 }
 
+elements::ElementQueue* SrcDecodeStreamBuilder::BuildOutputQueue(size_t output_index, bool is_isolated) {
+  elements::ElementQueue* output_queue =
+      new elements::ElementQueue(common::MemSPrintf(OUTPUT_QUEUE_NAME_1U, output_index));
+  ElementAdd(output_queue);
+  if (!is_isolated) {
+    return output_queue;
+  }
+
+  // bounded by time and bytes only, when full new data of this output dropped and upstream never blocks
+  const Config* config = GetConfig();
+  output_queue->SetMaxSizeBuffers(0);
+  output_queue->SetMaxSizeTime(config->GetOutputQueueMaxTime() * GST_MSECOND);
+  output_queue->SetMaxSizeBytes(config->GetOutputQueueMaxBytes());
+  output_queue->SetLeaky(elements::ElementQueue::LEAKY_UPSTREAM);
+  HandleOutputQueueCreated(output_queue, output_index);
+  return output_queue;
+}
+
+element_id_t SrcDecodeStreamBuilder::GetOutputMuxerId(size_t output_index) const {
+  if (output_index < output_muxers_.size()) {
+    return output_muxers_[output_index];
+  }
+
+  return output_index;
+}
+
+elements::Element* SrcDecodeStreamBuilder::SelectOutputVideoSource(const OutputUri& output, elements::Element* video) {
+  UNUSED(output);
+  return video;
+}
+
 }  // namespace builders
 }  // namespace streams
 }  // namespace stream
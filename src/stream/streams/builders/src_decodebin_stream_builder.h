@@ -14,18 +14,37 @@
 
 #pragma once
 
+#include <vector>
+
+#include "stream/elements/element.h"  // for SupportedElements
+
 #include "stream/streams/builders/gst_base_builder.h"
 
 namespace iptv_cloud {
 namespace stream {
 namespace elements {
 class ElementDecodebin;
+class ElementQueue;
 }
 namespace streams {
 class SrcDecodeBinStream;
 class AudioVideoConfig;
 namespace builders {
 
+// outputs with the same muxer type and video source share one muxer
+struct OutputGroup {
+  elements::SupportedElements muxer;
+  elements::Element* video;
+  std::vector<size_t> outputs;  // indexes in config output, first one gives ids of shared elements
+};
+typedef std::vector<OutputGroup> output_groups_t;
+
+// adds output into its group, returns id of group muxer
+element_id_t GroupOutput(elements::SupportedElements muxer,
+                         elements::Element* video,
+                         size_t output_index,
+                         output_groups_t* groups);
+
 class SrcDecodeStreamBuilder : public GstBaseBuilder {
  public:
   SrcDecodeStreamBuilder(const AudioVideoConfig* config, SrcDecodeBinStream* observer);
@@ -40,12 +59,21 @@ class SrcDecodeStreamBuilder : public GstBaseBuilder {
   Connector BuildPostProc(Connector conn) override = 0;
   Connector BuildConverter(Connector conn) override = 0;
   Connector BuildOutput(Connector conn) override;
+  virtual elements::Element* SelectOutputVideoSource(const OutputUri& output, elements::Element* video);
 
   virtual SupportedVideoCodec GetVideoCodecType() const = 0;
   virtual SupportedAudioCodec GetAudioCodecType() const = 0;
 
  protected:
   void HandleDecodebinCreated(elements::ElementDecodebin* decodebin);
+
+  // id of muxer and tee queues built for output, outputs of one container and video share them
+  element_id_t GetOutputMuxerId(size_t output_index) const;
+
+ private:
+  elements::ElementQueue* BuildOutputQueue(size_t output_index, bool is_isolated);
+
+  std::vector<element_id_t> output_muxers_;
 };
 
 }  // namespace builders
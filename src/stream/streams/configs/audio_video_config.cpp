@@ -21,7 +21,12 @@ namespace stream {
 namespace streams {
 
 AudioVideoConfig::AudioVideoConfig(const base_class& config)
-    : base_class(config), have_video_(), have_audio_(), audio_select_(), loop_() {}
+    : base_class(config),
+      have_video_(),
+      have_audio_(),
+      audio_select_(),
+      loop_(),
+      playlist_block_size_(DEFAULT_PLAYLIST_BLOCK_SIZE) {}
 
 AudioVideoConfig::have_stream_t AudioVideoConfig::HaveVideo() const {
   return have_video_;
@@ -55,6 +60,14 @@ void AudioVideoConfig::SetLoop(loop_t loop) {
   loop_ = loop;
 }
 
+size_t AudioVideoConfig::GetPlaylistBlockSize() const {
+  return playlist_block_size_;
+}
+
+void AudioVideoConfig::SetPlaylistBlockSize(size_t size) {
+  playlist_block_size_ = size;
+}
+
 }  // namespace streams
 }  // namespace stream
 }  // namespace iptv_cloud
@@ -40,11 +40,15 @@ class AudioVideoConfig : public Config {
   loop_t GetLoop() const;
   void SetLoop(loop_t loop);
 
+  size_t GetPlaylistBlockSize() const;  // playlist streams
+  void SetPlaylistBlockSize(size_t size);
+
  private:
   have_stream_t have_video_;
   have_stream_t have_audio_;
   audio_select_t audio_select_;
   loop_t loop_;
+  size_t playlist_block_size_;
 };
 
 }  // namespace streams
@@ -28,6 +28,8 @@ namespace iptv_cloud {
 namespace stream {
 namespace streams {
 
+VideoRendition::VideoRendition() : size(), video_bitrate(), video_encoder_args(), video_encoder_str_args(), outputs() {}
+
 EncodingConfig::EncodingConfig(const base_class& config)
     : base_class(config),
       deinterlace_(),
@@ -44,6 +46,9 @@ EncodingConfig::EncodingConfig(const base_class& config)
       logo_(),
       decklink_video_mode_(DEFAULT_DECKLINK_VIDEO_MODE),
       aspect_ratio_(),
+      video_renditions_(),
+      key_frame_interval_(DEFAULT_KEY_FRAME_INTERVAL),
+      hls_master_playlist_(),
       relay_video_(false),
       relay_audio_(false) {}
 
@@ -187,6 +192,30 @@ void EncodingConfig::SetAspectRatio(rational_t rat) {
   aspect_ratio_ = rat;
 }
 
+video_renditions_t EncodingConfig::GetVideoRenditions() const {
+  return video_renditions_;
+}
+
+void EncodingConfig::SetVideoRenditions(const video_renditions_t& renditions) {
+  video_renditions_ = renditions;
+}
+
+int EncodingConfig::GetKeyFrameInterval() const {
+  return key_frame_interval_;
+}
+
+void EncodingConfig::SetKeyFrameInterval(int interval) {
+  key_frame_interval_ = interval;
+}
+
+std::string EncodingConfig::GetHlsMasterPlaylist() const {
+  return hls_master_playlist_;
+}
+
+void EncodingConfig::SetHlsMasterPlaylist(const std::string& name) {
+  hls_master_playlist_ = name;
+}
+
 decklink_video_mode_t EncodingConfig::GetDecklinkMode() const {
   return decklink_video_mode_;
 }
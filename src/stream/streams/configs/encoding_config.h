@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/draw/types.h>
 
@@ -28,6 +29,19 @@ namespace iptv_cloud {
 namespace stream {
 namespace streams {
 
+// rendition with resolved encoder args
+struct VideoRendition {
+  VideoRendition();
+
+  common::draw::Size size;
+  bit_rate_t video_bitrate;
+  video_encoders_args_t video_encoder_args;
+  video_encoders_str_args_t video_encoder_str_args;
+  std::vector<channel_id_t> outputs;
+};
+
+typedef std::vector<VideoRendition> video_renditions_t;
+
 class EncodingConfig : public AudioVideoConfig {
  public:
   typedef AudioVideoConfig base_class;
@@ -81,6 +95,15 @@ class EncodingConfig : public AudioVideoConfig {
   rational_t GetAspectRatio() const;  // encoding
   void SetAspectRatio(rational_t rat);
 
+  video_renditions_t GetVideoRenditions() const;  // encoding, empty means single rendition of size and bitrate
+  void SetVideoRenditions(const video_renditions_t& renditions);
+
+  int GetKeyFrameInterval() const;  // encoding, msec
+  void SetKeyFrameInterval(int interval);
+
+  std::string GetHlsMasterPlaylist() const;  // encoding, file name in http root of first hls rendition output
+  void SetHlsMasterPlaylist(const std::string& name);
+
   decklink_video_mode_t GetDecklinkMode() const;  // mosaic
   void SetDecklinkMode(decklink_video_mode_t decl);
 
@@ -107,6 +130,10 @@ class EncodingConfig : public AudioVideoConfig {
   decklink_video_mode_t decklink_video_mode_;
   rational_t aspect_ratio_;
 
+  video_renditions_t video_renditions_;
+  int key_frame_interval_;
+  std::string hls_master_playlist_;
+
   bool relay_video_;
   bool relay_audio_;
 };
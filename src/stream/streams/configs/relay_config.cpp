@@ -27,7 +27,7 @@ namespace stream {
 namespace streams {
 
 RelayConfig::RelayConfig(const base_class& config)
-    : base_class(config), video_parser_(DEFAULT_VIDEO_PARSER), audio_parser_(DEFAULT_AUDIO_PARSER) {}
+    : base_class(config), video_parser_(DEFAULT_VIDEO_PARSER), audio_parser_(DEFAULT_AUDIO_PARSER), fast_path_(false) {}
 
 std::string RelayConfig::GetVideoParser() const {
   return video_parser_;
@@ -45,6 +45,14 @@ void RelayConfig::SetAudioParser(const std::string& parser) {
   audio_parser_ = parser;
 }
 
+bool RelayConfig::IsFastPath() const {
+  return fast_path_;
+}
+
+void RelayConfig::SetFastPath(bool fast_path) {
+  fast_path_ = fast_path;
+}
+
 TimeshiftConfig::TimeshiftConfig(const base_class& config)
     : base_class(config), timeshift_chunk_duration_(DEFAULT_TIMESHIFT_CHUNK_DURATION) {}
 
@@ -33,9 +33,14 @@ class RelayConfig : public AudioVideoConfig {
   std::string GetAudioParser() const;  // relay
   void SetAudioParser(const std::string& parser);
 
+  // relay links demuxer of known input container straight to parsers, decodebin only for unknown containers
+  bool IsFastPath() const;
+  void SetFastPath(bool fast_path);
+
  private:
   std::string video_parser_;
   std::string audio_parser_;
+  bool fast_path_;
 };
 
 class TimeshiftConfig : public RelayConfig {
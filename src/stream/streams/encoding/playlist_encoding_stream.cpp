@@ -22,21 +22,14 @@
 
 #include "stream/streams/builders/encoding/playlist_encoding_stream_builder.h"
 
-#define BUFFER_SIZE 4096
-
 namespace iptv_cloud {
 namespace stream {
 namespace streams {
 
 PlaylistEncodingStream::PlaylistEncodingStream(const EncodingConfig* config, IStreamClient* client, StreamStruct* stats)
-    : EncodingStream(config, client, stats), app_src_(nullptr), current_file_(nullptr), curent_pos_(0) {}
+    : EncodingStream(config, client, stats), app_src_(nullptr), engine_(config, stats, this) {}
 
-PlaylistEncodingStream::~PlaylistEncodingStream() {
-  if (current_file_) {
-    fclose(current_file_);
-    current_file_ = nullptr;
-  }
-}
+PlaylistEncodingStream::~PlaylistEncodingStream() {}
 
 const char* PlaylistEncodingStream::ClassName() const {
   return "PlaylistEncodingStream";
@@ -53,38 +46,32 @@ IBaseBuilder* PlaylistEncodingStream::CreateBuilder() {
   return new builders::PlaylistEncodingStreamBuilder(econf, this);
 }
 
-void PlaylistEncodingStream::PreLoop() {}
+void PlaylistEncodingStream::PreLoop() {
+  engine_.Reset();
+}
+
+void PlaylistEncodingStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
+  EncodingStream::HandleDecodeBinPadAdded(src, new_pad);
+  if (gst_pad_is_linked(new_pad)) {
+    engine_.LinkPad(new_pad);
+  }
+}
 
 void PlaylistEncodingStream::HandleNeedData(GstElement* pipeline, guint rsize) {
   UNUSED(pipeline);
   UNUSED(rsize);
 
-  size_t size = 0;
-  char* ptr = static_cast<char*>(calloc(BUFFER_SIZE, sizeof(char)));
-  if (!ptr) {
-    app_src_->SendEOS();
-    return;
+  GstBuffer* buffer = nullptr;
+  common::ErrnoError err = engine_.ReadBlock(&buffer);
+  if (err) {
+    WARNING_LOG() << err->GetDescription();
   }
 
-  while (size == 0) {
-    if (!current_file_) {
-      current_file_ = OpenNextFile();
-    }
-
-    if (!current_file_) {
-      app_src_->SendEOS();
-      free(ptr);
-      return;
-    }
-
-    size = fread(ptr, sizeof(char), BUFFER_SIZE, current_file_);
-    if (size == 0) {
-      fclose(current_file_);
-      current_file_ = nullptr;
-    }
+  if (!buffer) {
+    app_src_->SendEOS();  // send  eos
+    return;
   }
 
-  GstBuffer* buffer = gst_buffer_new_wrapped(ptr, size);
   GstFlowReturn ret = app_src_->PushBuffer(buffer);
   if (ret != GST_FLOW_OK) {
     WARNING_LOG() << "gst_app_src_push_buffer failed: " << gst_flow_get_name(ret);
@@ -97,39 +84,10 @@ void PlaylistEncodingStream::need_data_callback(GstElement* pipeline, guint size
   return stream->HandleNeedData(pipeline, size);
 }
 
-FILE* PlaylistEncodingStream::OpenNextFile() {
-  const PlaylistEncodingConfig* econf = static_cast<const PlaylistEncodingConfig*>(GetConfig());
-  const auto loop = econf->GetLoop();
-  if (loop) {
-    if (!*loop) {
-      input_t input = econf->GetInput();
-      if (curent_pos_ >= input.size()) {
-        INFO_LOG() << "No more files for playing";
-        return nullptr;  // EOS
-      }
-    }
-  }
-
-  input_t input = econf->GetInput();
-  if (curent_pos_ >= input.size()) {
-    curent_pos_ = 0;
-  }
-
-  InputUri iuri = input[curent_pos_];
-  common::uri::Url uri = iuri.GetInput();
-  curent_pos_++;
-  common::uri::Upath path = uri.GetPath();
-  std::string cur_path = path.GetPath();
-  FILE* file = fopen(cur_path.c_str(), "rb");
-  if (file) {
-    INFO_LOG() << "File " << cur_path << " open for playing";
-    if (client_) {
-      client_->OnInputChanged(iuri);
-    }
-  } else {
-    WARNING_LOG() << "File " << cur_path << " can't open for playing";
+void PlaylistEncodingStream::OnPlaylistFileChanged(const InputUri& uri) {
+  if (client_) {
+    client_->OnInputChanged(uri);
   }
-  return file;
 }
 
 }  // namespace streams
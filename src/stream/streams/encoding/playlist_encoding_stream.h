@@ -16,6 +16,8 @@
 
 #include "stream/streams/encoding/encoding_stream.h"
 
+#include "stream/playlist_engine.h"
+
 namespace iptv_cloud {
 namespace stream {
 
@@ -31,7 +33,7 @@ namespace builders {
 class PlaylistEncodingStreamBuilder;
 }
 
-class PlaylistEncodingStream : public EncodingStream {
+class PlaylistEncodingStream : public EncodingStream, public PlaylistEngine::IPlaylistObserver {
   friend class builders::PlaylistEncodingStreamBuilder;
 
  public:
@@ -46,16 +48,17 @@ class PlaylistEncodingStream : public EncodingStream {
   virtual void OnAppSrcCreatedCreated(elements::sources::ElementAppSrc* src);
   IBaseBuilder* CreateBuilder() override;
 
+  void HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) override;
+
   virtual void HandleNeedData(GstElement* pipeline, guint rsize);
 
+  void OnPlaylistFileChanged(const InputUri& uri) override;
+
  private:
   static void need_data_callback(GstElement* pipeline, guint size, gpointer user_data);
 
-  FILE* OpenNextFile();
-
   elements::sources::ElementAppSrc* app_src_;
-  FILE* current_file_;
-  size_t curent_pos_;
+  PlaylistEngine engine_;
 };
 
 }  // namespace streams
@@ -0,0 +1,98 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streams/ingest_stream.h"
+
+#include "base/channel_stats.h"
+#include "base/stream_struct.h"
+
+#include "stream/elements/sink/shm.h"
+#include "stream/streams/builders/ingest_stream_builder.h"
+
+#include "stream/pad/pad.h"
+
+namespace iptv_cloud {
+namespace stream {
+namespace streams {
+
+IngestStream::IngestStream(const Config* config, IStreamClient* client, StreamStruct* stats)
+    : IBaseStream(config, client, stats), clients_(0) {}
+
+const char* IngestStream::ClassName() const {
+  return "IngestStream";
+}
+
+void IngestStream::OnInpudSrcPadCreated(common::uri::Url::scheme scheme, pad::Pad* src_pad, element_id_t id) {
+  UNUSED(scheme);
+  LinkInputPad(src_pad->GetGstPad(), id);
+}
+
+void IngestStream::OnOutputSinkPadCreated(common::uri::Url::scheme scheme, pad::Pad* sink_pad, element_id_t id) {
+  UNUSED(scheme);
+  LinkOutputPad(sink_pad->GetGstPad(), id);
+}
+
+void IngestStream::OnShmSinkCreated(elements::sink::ElementShmSink* sink) {
+  clients_ = 0;
+  StreamStruct* stats = GetStats();
+  if (!stats->output.empty()) {
+    stats->output[0]->SetClients(clients_);
+  }
+
+  gboolean connected = sink->RegisterClientConnectedCallback(shmsink_client_connected_callback, this);
+  DCHECK(connected);
+
+  gboolean disconnected = sink->RegisterClientDisconnectedCallback(shmsink_client_disconnected_callback, this);
+  DCHECK(disconnected);
+}
+
+IBaseBuilder* IngestStream::CreateBuilder() {
+  return new builders::IngestStreamBuilder(GetConfig(), this);
+}
+
+void IngestStream::PreLoop() {}
+
+void IngestStream::PostLoop(ExitStatus status) {
+  UNUSED(status);
+}
+
+void IngestStream::HandleClientsChanged() {
+  INFO_LOG() << "Streams attached to ingest: " << clients_;
+  StreamStruct* stats = GetStats();
+  if (!stats->output.empty()) {
+    stats->output[0]->SetClients(clients_);
+  }
+}
+
+void IngestStream::shmsink_client_connected_callback(GstElement* shmsink, gint fd, gpointer user_data) {
+  UNUSED(shmsink);
+  UNUSED(fd);
+  IngestStream* stream = reinterpret_cast<IngestStream*>(user_data);
+  stream->clients_++;
+  stream->HandleClientsChanged();
+}
+
+void IngestStream::shmsink_client_disconnected_callback(GstElement* shmsink, gint fd, gpointer user_data) {
+  UNUSED(shmsink);
+  UNUSED(fd);
+  IngestStream* stream = reinterpret_cast<IngestStream*>(user_data);
+  if (stream->clients_) {
+    stream->clients_--;
+  }
+  stream->HandleClientsChanged();
+}
+
+}  // namespace streams
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -23,21 +23,14 @@
 
 #include "stream/streams/builders/relay/playlist_relay_stream_builder.h"
 
-#define BUFFER_SIZE 4096
-
 namespace iptv_cloud {
 namespace stream {
 namespace streams {
 
 PlaylistRelayStream::PlaylistRelayStream(const PlaylistRelayConfig* config, IStreamClient* client, StreamStruct* stats)
-    : RelayStream(config, client, stats), app_src_(nullptr), current_file_(nullptr), curent_pos_(0) {}
+    : RelayStream(config, client, stats), app_src_(nullptr), engine_(config, stats, this) {}
 
-PlaylistRelayStream::~PlaylistRelayStream() {
-  if (current_file_) {
-    fclose(current_file_);
-    current_file_ = nullptr;
-  }
-}
+PlaylistRelayStream::~PlaylistRelayStream() {}
 
 const char* PlaylistRelayStream::ClassName() const {
   return "PlaylistRelayStream";
@@ -54,42 +47,36 @@ IBaseBuilder* PlaylistRelayStream::CreateBuilder() {
   return new builders::PlaylistRelayStreamBuilder(rconf, this);
 }
 
-void PlaylistRelayStream::PreLoop() {}
+void PlaylistRelayStream::PreLoop() {
+  engine_.Reset();
+}
 
 void PlaylistRelayStream::PostLoop(ExitStatus status) {
   RelayStream::PostLoop(status);
 }
 
+void PlaylistRelayStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
+  RelayStream::HandleDecodeBinPadAdded(src, new_pad);
+  if (gst_pad_is_linked(new_pad)) {
+    engine_.LinkPad(new_pad);
+  }
+}
+
 void PlaylistRelayStream::HandleNeedData(GstElement* pipeline, guint rsize) {
   UNUSED(pipeline);
   UNUSED(rsize);
 
-  char* ptr = static_cast<char*>(calloc(BUFFER_SIZE, sizeof(char)));
-  if (!ptr) {
-    app_src_->SendEOS();  // send  eos
-    return;
+  GstBuffer* buffer = nullptr;
+  common::ErrnoError err = engine_.ReadBlock(&buffer);
+  if (err) {
+    WARNING_LOG() << err->GetDescription();
   }
 
-  size_t size = 0;
-  while (size == 0) {
-    if (!current_file_) {
-      current_file_ = OpenNextFile();
-    }
-
-    if (!current_file_) {
-      app_src_->SendEOS();  // send  eos
-      free(ptr);
-      return;
-    }
-
-    size = fread(ptr, sizeof(char), BUFFER_SIZE, current_file_);
-    if (size == 0) {
-      fclose(current_file_);
-      current_file_ = nullptr;
-    }
+  if (!buffer) {
+    app_src_->SendEOS();  // send  eos
+    return;
   }
 
-  GstBuffer* buffer = gst_buffer_new_wrapped(ptr, size);
   GstFlowReturn ret = app_src_->PushBuffer(buffer);
   if (ret != GST_FLOW_OK) {
     WARNING_LOG() << "gst_app_src_push_buffer failed: " << gst_flow_get_name(ret);
@@ -102,38 +89,10 @@ void PlaylistRelayStream::need_data_callback(GstElement* pipeline, guint size, g
   return stream->HandleNeedData(pipeline, size);
 }
 
-FILE* PlaylistRelayStream::OpenNextFile() {
-  const PlaylistRelayConfig* rconf = static_cast<const PlaylistRelayConfig*>(GetConfig());
-  const auto loop = rconf->GetLoop();
-  if (loop) {
-    if (!*loop) {
-      input_t input = rconf->GetInput();
-      if (curent_pos_ >= input.size()) {
-        INFO_LOG() << "No more files for playing";
-        return nullptr;  // EOS
-      }
-    }
-  }
-
-  input_t input = rconf->GetInput();
-  if (curent_pos_ >= input.size()) {
-    curent_pos_ = 0;
-  }
-
-  InputUri iuri = input[curent_pos_++];
-  common::uri::Url uri = iuri.GetInput();
-  common::uri::Upath path = uri.GetPath();
-  std::string cur_path = path.GetPath();
-  FILE* file = fopen(cur_path.c_str(), "rb");
-  if (file) {
-    INFO_LOG() << "File " << cur_path << " open for playing";
-    if (client_) {
-      client_->OnInputChanged(iuri);
-    }
-  } else {
-    WARNING_LOG() << "File " << cur_path << "can't open for playing";
+void PlaylistRelayStream::OnPlaylistFileChanged(const InputUri& uri) {
+  if (client_) {
+    client_->OnInputChanged(uri);
   }
-  return file;
 }
 
 }  // namespace streams
@@ -16,6 +16,8 @@
 
 #include "stream/streams/relay/relay_stream.h"
 
+#include "stream/playlist_engine.h"
+
 namespace iptv_cloud {
 namespace stream {
 namespace elements {
@@ -30,7 +32,7 @@ namespace builders {
 class PlaylistRelayStreamBuilder;
 }
 
-class PlaylistRelayStream : public RelayStream {
+class PlaylistRelayStream : public RelayStream, public PlaylistEngine::IPlaylistObserver {
   friend class builders::PlaylistRelayStreamBuilder;
 
  public:
@@ -47,16 +49,17 @@ class PlaylistRelayStream : public RelayStream {
   void PreLoop() override;
   void PostLoop(ExitStatus status) override;
 
+  void HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) override;
+
   virtual void HandleNeedData(GstElement* pipeline, guint rsize);
 
+  void OnPlaylistFileChanged(const InputUri& uri) override;
+
  private:
   static void need_data_callback(GstElement* pipeline, guint size, gpointer user_data);
 
-  FILE* OpenNextFile();
-
   elements::sources::ElementAppSrc* app_src_;
-  FILE* current_file_;
-  size_t curent_pos_;
+  PlaylistEngine engine_;
 };
 
 }  // namespace streams
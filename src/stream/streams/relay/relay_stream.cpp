@@ -34,7 +34,12 @@ namespace stream {
 namespace streams {
 
 RelayStream::RelayStream(const RelayConfig* config, IStreamClient* client, StreamStruct* stats)
-    : SrcDecodeBinStream(config, client, stats) {}
+    : SrcDecodeBinStream(config, client, stats),
+      detected_caps_(),
+      input_caps_checked_(false),
+      cached_caps_(),
+      use_cached_caps_(false),
+      demuxer_(nullptr) {}
 
 const char* RelayStream::ClassName() const {
   return "RelayStream";
@@ -45,6 +50,95 @@ IBaseBuilder* RelayStream::CreateBuilder() {
   return new builders::RelayStreamBuilder(rconf, this);
 }
 
+bool RelayStream::IsCapsCacheEnabled() const {
+  const RelayConfig* config = static_cast<const RelayConfig*>(GetConfig());
+  return client_ && config->IsFastPath() && config->GetType() == RELAY;
+}
+
+bool RelayStream::FindCachedDemuxer(SupportedDemuxer* demuxer) {
+  if (!IsCapsCacheEnabled()) {
+    return false;
+  }
+
+  const input_t input = GetConfig()->GetInput();
+  InputCaps caps;
+  if (!client_->OnFindInputCaps(input[0], &caps) || !IsDemuxerFromType(caps.demuxer, demuxer)) {
+    return false;
+  }
+
+  INFO_LOG() << "Cached caps, demuxer: " << caps.demuxer << ", video: " << caps.video << ", audio: " << caps.audio;
+  cached_caps_ = caps;
+  use_cached_caps_ = true;
+  return true;
+}
+
+void RelayStream::StoreDetectedCaps() {
+  if (use_cached_caps_ || !detected_caps_.IsValid() || !IsCapsCacheEnabled()) {
+    return;
+  }
+
+  const input_t input = GetConfig()->GetInput();
+  client_->OnInputCapsDetected(input[0], detected_caps_);
+}
+
+void RelayStream::InvalidateCachedCaps(const std::string& reason) {
+  if (!use_cached_caps_.exchange(false)) {
+    return;
+  }
+
+  WARNING_LOG() << "Cached caps of input are invalidated: " << reason << ", autoplugging on next start";
+  const input_t input = GetConfig()->GetInput();
+  client_->OnInputCapsMismatch(input[0]);
+}
+
+void RelayStream::OnDemuxerCreated(elements::Element* demuxer, SupportedDemuxer type) {
+  gboolean pad_added = FALSE;
+  if (type == VIDEO_MPEGTS_DEMUXER) {
+    elements::ElementTsDemux* tsdemux = static_cast<elements::ElementTsDemux*>(demuxer);
+    pad_added = tsdemux->RegisterPadAddedCallback(demuxer_pad_added_callback, this);
+  } else if (type == VIDEO_FLV_DEMUXER) {
+    elements::ElementFlvDemux* flvdemux = static_cast<elements::ElementFlvDemux*>(demuxer);
+    pad_added = flvdemux->RegisterPadAddedCallback(demuxer_pad_added_callback, this);
+  }
+  DCHECK(pad_added);
+  demuxer_ = demuxer->GetGstElement();
+  INFO_LOG() << "Relay fast path, demuxer: " << demuxer->GetPluginName();
+}
+
+void RelayStream::HandleDemuxerPadAdded(GstElement* src, GstPad* new_pad) {
+  GstCaps* caps = gst_pad_query_caps(new_pad, nullptr);
+  if (caps) {
+    std::string type_title;
+    std::string type_full;
+    if (get_type_from_caps(caps, &type_title, &type_full)) {
+      INFO_LOG() << "Demuxer caps: " << type_full;
+      SupportedAudioCodec saudio;
+      SupportedVideoCodec svideo;
+      if (IsVideoCodecFromType(type_title, &svideo)) {
+        if (!IsVideoInited() && !cached_caps_.video.empty() && cached_caps_.video != type_title) {
+          InvalidateCachedCaps("video " + type_title + " instead of " + cached_caps_.video);
+        }
+        RegisterVideoCaps(svideo, caps, 0);
+      } else if (IsAudioCodecFromType(type_title, &saudio)) {
+        if (!IsAudioInited() && !cached_caps_.audio.empty() && cached_caps_.audio != type_title) {
+          InvalidateCachedCaps("audio " + type_title + " instead of " + cached_caps_.audio);
+        }
+        RegisterAudioCaps(saudio, caps, 0);
+      }
+    }
+    gst_caps_unref(caps);
+  }
+
+  // same linking as for decodebin, parsers are sinks of elementary streams
+  const bool video_inited = IsVideoInited();
+  const bool audio_inited = IsAudioInited();
+  HandleDecodeBinPadAdded(src, new_pad);
+  const bool selected = video_inited != IsVideoInited() || audio_inited != IsAudioInited();
+  if (selected && !gst_pad_is_linked(new_pad)) {
+    InvalidateCachedCaps(std::string("parser not linked to ") + GST_PAD_NAME(new_pad));
+  }
+}
+
 gboolean RelayStream::HandleDecodeBinAutoplugger(GstElement* elem,
                                                  GstPad* pad,
                                                  GstCaps* caps) {  // FALSE => stop autoplug
@@ -64,6 +158,18 @@ gboolean RelayStream::HandleDecodeBinAutoplugger(GstElement* elem,
   bool is_audio = IsAudioCodecFromType(type_title, &saudio);
   bool is_video = IsVideoCodecFromType(type_title, &svideo);
   bool is_demuxer = IsDemuxerFromType(type_title, &sdemuxer);
+  if (!input_caps_checked_) {  // first caps are of input itself, cached only if it is container we can demux
+    input_caps_checked_ = true;
+    if (is_demuxer) {
+      detected_caps_.demuxer = type_title;
+    }
+  }
+  if (is_video && detected_caps_.video.empty()) {
+    detected_caps_.video = type_title;
+  } else if (is_audio && detected_caps_.audio.empty()) {
+    detected_caps_.audio = type_title;
+  }
+
   if (is_demuxer) {
     if (sdemuxer == VIDEO_MPEGTS_DEMUXER) {
       return TRUE;
@@ -152,8 +258,11 @@ void RelayStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
   if (!gst_pad_is_linked(sink_pad->GetGstPad())) {
     GstPadLinkReturn ret = gst_pad_link(new_pad, sink_pad->GetGstPad());
     if (GST_PAD_LINK_FAILED(ret)) {
+      WARNING_LOG() << "Failed to link pad: " << GST_PAD_NAME(new_pad) << " " << new_pad_type
+                    << ", please check parsers of stream";
     } else {
       DEBUG_LOG() << "Pad emitted: " << GST_ELEMENT_NAME(src) << " " << GST_PAD_NAME(new_pad) << " " << new_pad_type;
+      StoreDetectedCaps();
     }
   } else {
     DEBUG_LOG() << "pad-emitter: pad is linked";
@@ -167,6 +276,20 @@ void RelayStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
   delete sink_pad;
 }
 
+gboolean RelayStream::HandleAsyncBusMessageReceived(GstBus* bus, GstMessage* message) {
+  if (use_cached_caps_ && demuxer_ && GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR &&
+      GST_MESSAGE_SRC(message) == GST_OBJECT(demuxer_)) {
+    GError* err = nullptr;
+    gst_message_parse_error(message, &err, nullptr);
+    // not-negotiated and other flow errors of demuxer are stream errors too
+    if (err && err->domain == GST_STREAM_ERROR) {
+      InvalidateCachedCaps(std::string("demuxer error: ") + err->message);
+    }
+    g_clear_error(&err);
+  }
+  return SrcDecodeBinStream::HandleAsyncBusMessageReceived(bus, message);
+}
+
 GValueArray* RelayStream::HandleAutoplugSort(GstElement* bin, GstPad* pad, GstCaps* caps, GValueArray* factories) {
   UNUSED(bin);
   UNUSED(pad);
@@ -203,6 +326,11 @@ void RelayStream::HandleDecodeBinElementRemoved(GstBin* bin, GstElement* element
   DEBUG_LOG() << "decodebin removed element: " << element_plugin_name;
 }
 
+void RelayStream::demuxer_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data) {
+  RelayStream* stream = reinterpret_cast<RelayStream*>(user_data);
+  stream->HandleDemuxerPadAdded(src, new_pad);
+}
+
 }  // namespace streams
 }  // namespace stream
 }  // namespace iptv_cloud
@@ -14,15 +14,26 @@
 
 #pragma once
 
+#include <atomic>
+#include <string>
+
 #include "stream/streams/src_decodebin_stream.h"
 
+#include "stream/input_caps_cache.h"
+
 #include "stream/streams/configs/relay_config.h"
 
 namespace iptv_cloud {
 namespace stream {
 namespace streams {
 
+namespace builders {
+class RelayStreamBuilder;
+}
+
 class RelayStream : public SrcDecodeBinStream {
+  friend class builders::RelayStreamBuilder;
+
  public:
   RelayStream(const RelayConfig* config, IStreamClient* client, StreamStruct* stats);
 
@@ -31,6 +42,12 @@ class RelayStream : public SrcDecodeBinStream {
  protected:
   IBaseBuilder* CreateBuilder() override;
 
+  // demuxer of input from caps cache, chain of previous run is built again
+  bool FindCachedDemuxer(SupportedDemuxer* demuxer);
+
+  virtual void OnDemuxerCreated(elements::Element* demuxer, SupportedDemuxer type);
+  virtual void HandleDemuxerPadAdded(GstElement* src, GstPad* new_pad);
+
   gboolean HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pad, GstCaps* caps) override;
   void HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) override;
 
@@ -42,6 +59,23 @@ class RelayStream : public SrcDecodeBinStream {
 
   void HandleDecodeBinElementAdded(GstBin* bin, GstElement* element) override;
   void HandleDecodeBinElementRemoved(GstBin* bin, GstElement* element) override;
+
+  // stream error of demuxer built from cached caps means container of input changed,
+  // source errors (down, 404, timeout) keep cached caps
+  gboolean HandleAsyncBusMessageReceived(GstBus* bus, GstMessage* message) override;
+
+ private:
+  bool IsCapsCacheEnabled() const;
+  void StoreDetectedCaps();
+  void InvalidateCachedCaps(const std::string& reason);
+
+  static void demuxer_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data);
+
+  InputCaps detected_caps_;  // autoplugging decisions of this run
+  bool input_caps_checked_;
+  InputCaps cached_caps_;              // chain of this run is built from them
+  std::atomic<bool> use_cached_caps_;  // streaming threads invalidate too
+  GstElement* demuxer_;
 };
 
 }  // namespace streams
@@ -22,6 +22,7 @@
 #include "stream/streams/encoding/encoding_only_audio_stream.h"
 #include "stream/streams/encoding/encoding_only_video_stream.h"
 #include "stream/streams/encoding/playlist_encoding_stream.h"
+#include "stream/streams/ingest_stream.h"
 #include "stream/streams/mosaic_stream.h"
 #include "stream/streams/relay/playlist_relay_stream.h"
 #include "stream/streams/test/test_life_stream.h"
@@ -43,6 +44,10 @@ IBaseStream* StreamsFactory::CreateStream(const Config* config,
   input_t input = config->GetInput();
   StreamType type = config->GetType();
   if (type == RELAY) {
+    if (!config->GetIngestPublish().empty()) {  // started by daemon for shared ingest
+      return new streams::IngestStream(config, client, stats);
+    }
+
     const streams::RelayConfig* rconfig = static_cast<const streams::RelayConfig*>(config);
     InputUri iuri = input[0];
     common::uri::Url input_uri = iuri.GetInput();
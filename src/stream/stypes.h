@@ -30,11 +30,13 @@
 
 #define VIDEO_TEE_NAME_1U "video_tee_%lu"
 #define AUDIO_TEE_NAME_1U "audio_tee_%lu"
+#define RENDITIONS_TEE_NAME_1U "renditions_tee_%lu"
 
 #define UDB_VIDEO_NAME_1U "udb_conn_video_%lu"
 #define UDB_AUDIO_NAME_1U "udb_conn_audio_%lu"
 
 #define POST_PROC_NAME_1U "post_proc_%lu"
+#define RENDITION_POST_PROC_NAME_1U "rendition_post_proc_%lu"
 #define VIDEO_LOGO_NAME_1U "videologo_%lu"
 #define DEINTERLACE_NAME_1U "deinterlace_%lu"
 #define ASPECT_RATIO_NAME_1U "aspect_ratio_%lu"
@@ -69,6 +71,7 @@
 #define MPEG_AUDIO_PARSE_NAME_1U "mpegaudioparse_%lu"
 
 #define DECODEBIN_NAME_1U "decodebin_%lu"
+#define DEMUXER_NAME_1U "demuxer_%lu"
 #define VIDEOBOX_NAME_1U "videobox_%lu"
 
 #define VIDEO_DECODEBIN_NAME_1U "video_decodebin_%lu"
@@ -81,12 +84,15 @@
 #define AUDIO_PARSER_NAME_1U "audio_parser_%lu"
 #define VIDEO_PARSER_NAME_1U "video_parser_%lu"
 #define MUXER_NAME_1U "muxer_%lu"
+#define MUXER_TEE_NAME_1U "muxer_tee_%lu"
+#define OUTPUT_QUEUE_NAME_1U "output_queue_%lu"
 
 #define AUDIO_PAY_NAME_1U "audio_pay_%lu"
 #define VIDEO_PAY_NAME_1U "video_pay_%lu"
 
 #define VIDEO_TEE_QUEUE_NAME_1U "video_tee_queue_%lu"
 #define AUDIO_TEE_QUEUE_NAME_1U "audio_tee_queue_%lu"
+#define RENDITION_QUEUE_NAME_1U "rendition_queue_%lu"
 
 #define AUDIO_LEVEL_NAME_1U "level_%lu"
 
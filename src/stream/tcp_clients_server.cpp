@@ -0,0 +1,613 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/tcp_clients_server.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+#include <common/convert2string.h>
+#include <common/logger.h>
+
+#include "base/channel_stats.h"
+
+namespace {
+
+const uint64_t kNsecInSec = 1000000000;
+const uint64_t kNsecInMsec = 1000000;
+const int kPollTimeoutMsec = 100;  // eviction deadlines and stats checked at least that often
+
+const size_t kTsPacketSize = 188;
+const uint8_t kTsSyncByte = 0x47;
+const uint16_t kPatPid = 0x0000;
+const uint8_t kPatTableId = 0x00;
+const uint8_t kPmtTableId = 0x02;
+
+uint64_t monotonic_nsec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * kNsecInSec + ts.tv_nsec;
+}
+
+std::string peer_to_string(const struct sockaddr_storage& addr) {
+  char host[INET6_ADDRSTRLEN] = {0};
+  uint16_t port = 0;
+  if (addr.ss_family == AF_INET) {
+    const struct sockaddr_in* sin = reinterpret_cast<const struct sockaddr_in*>(&addr);
+    inet_ntop(AF_INET, &sin->sin_addr, host, sizeof(host));
+    port = ntohs(sin->sin_port);
+  } else if (addr.ss_family == AF_INET6) {
+    const struct sockaddr_in6* sin6 = reinterpret_cast<const struct sockaddr_in6*>(&addr);
+    inet_ntop(AF_INET6, &sin6->sin6_addr, host, sizeof(host));
+    port = ntohs(sin6->sin6_port);
+  }
+  return std::string(host) + ":" + common::ConvertToString(port);
+}
+
+uint16_t ts_packet_pid(const uint8_t* packet) {
+  return ((packet[1] & 0x1f) << 8) | packet[2];
+}
+
+// psi section which starts in packet, nullptr if there is none
+const uint8_t* ts_section_start(const uint8_t* packet) {
+  const uint8_t adaptation_field_control = (packet[3] >> 4) & 0x3;
+  if (!(packet[1] & 0x40) || !(adaptation_field_control & 0x1)) {  // no payload unit start or no payload
+    return nullptr;
+  }
+
+  size_t offset = 4;
+  if (adaptation_field_control & 0x2) {
+    offset += 1 + packet[offset];
+  }
+  if (offset >= kTsPacketSize) {
+    return nullptr;
+  }
+  offset += 1 + packet[offset];  // pointer field
+  if (offset + 3 > kTsPacketSize) {
+    return nullptr;
+  }
+  return packet + offset;
+}
+
+// pmt pid of first program of PAT, 0 if packet isn't PAT
+uint16_t pat_pmt_pid(const uint8_t* packet) {
+  const uint8_t* section = ts_section_start(packet);
+  if (!section || section[0] != kPatTableId) {
+    return 0;
+  }
+
+  const size_t section_length = ((section[1] & 0x0f) << 8) | section[2];
+  if (section_length < 9 || section + 3 + section_length > packet + kTsPacketSize) {
+    return 0;
+  }
+  const uint8_t* end = section + 3 + section_length - 4;  // without crc
+  for (const uint8_t* program = section + 8; program + 4 <= end; program += 4) {
+    const uint16_t number = (program[0] << 8) | program[1];
+    if (number != 0) {  // 0 is network pid
+      return ((program[2] & 0x1f) << 8) | program[3];
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace stream {
+
+TcpClientsServer::ClientStats::ClientStats()
+    : peer(), duration(0), bytes_sent(0), bytes_dropped(0), queued_bytes(0), bitrate(0) {}
+
+TcpClientsServer::Stats::Stats() : clients(0), accepted(0), rejected(0), evicted(0) {}
+
+TcpClientsServer::Client::Client(int fd, const std::string& peer, uint64_t now)
+    : fd(fd),
+      peer(peer),
+      connected_ns(now),
+      queue(),
+      queued_bytes(0),
+      offset(0),
+      wait_keyframe(true),
+      need_tables(true),
+      overflow_ns(0),
+      closing(false),
+      evicted(false),
+      bytes_sent(0),
+      bytes_dropped(0) {}
+
+TcpClientsServer::ClientIo::ClientIo(Client* client)
+    : client(client),
+      fd(client->fd),
+      closing(client->closing),
+      revents(0),
+      chunks(),
+      offset(0),
+      sent(0),
+      broken(false) {}
+
+TcpClientsServer::TcpClientsServer(size_t max_queue_bytes, time_t evict_time)
+    : max_queue_bytes_(max_queue_bytes),
+      evict_time_(evict_time),
+      listen_fd_(INVALID_DESCRIPTOR),
+      wake_fd_(INVALID_DESCRIPTOR),
+      port_(0),
+      stop_(false),
+      thread_(),
+      pmt_pid_(0),
+      pat_(),
+      pmt_(),
+      tables_(),
+      mutex_(),
+      clients_(),
+      stats_(nullptr),
+      accepted_(0),
+      rejected_(0),
+      evicted_(0) {}
+
+TcpClientsServer::~TcpClientsServer() {
+  Close();
+}
+
+common::ErrnoError TcpClientsServer::Open(const common::net::HostAndPort& host) {
+  if (IsOpen()) {
+    return common::make_errno_error("Already opened.", EINVAL);
+  }
+
+  const std::string host_str = host.GetHost();
+  const std::string port_str = common::ConvertToString(host.GetPort());
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  struct addrinfo* addrs = nullptr;
+  int res = getaddrinfo(host_str.empty() ? nullptr : host_str.c_str(), port_str.c_str(), &hints, &addrs);
+  if (res != 0) {
+    return common::make_errno_error(gai_strerror(res), EINVAL);
+  }
+
+  common::ErrnoError err = common::make_errno_error("Can't listen tcp host: " + host_str + ":" + port_str, EINVAL);
+  for (struct addrinfo* rp = addrs; rp != nullptr; rp = rp->ai_next) {
+    int fd = socket(rp->ai_family, rp->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, rp->ai_protocol);
+    if (fd == INVALID_DESCRIPTOR) {
+      err = common::make_errno_error(errno);
+      continue;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, rp->ai_addr, rp->ai_addrlen) == ERROR_RESULT_VALUE ||
+        listen(fd, listen_backlog) == ERROR_RESULT_VALUE) {
+      err = common::make_errno_error(errno);
+      ::close(fd);
+      continue;
+    }
+
+    listen_fd_ = fd;
+    err = common::ErrnoError();
+    break;
+  }
+  freeaddrinfo(addrs);
+  if (err) {
+    return err;
+  }
+
+  struct sockaddr_storage addr;
+  socklen_t addr_len = sizeof(addr);
+  if (getsockname(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) == 0) {
+    port_ = addr.ss_family == AF_INET6 ? ntohs(reinterpret_cast<struct sockaddr_in6*>(&addr)->sin6_port)
+                                       : ntohs(reinterpret_cast<struct sockaddr_in*>(&addr)->sin_port);
+  }
+
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ == INVALID_DESCRIPTOR) {
+    err = common::make_errno_error(errno);
+    ::close(listen_fd_);
+    listen_fd_ = INVALID_DESCRIPTOR;
+    return err;
+  }
+
+  stop_ = false;
+  thread_ = std::thread([this] { Routine(); });
+  return common::ErrnoError();
+}
+
+bool TcpClientsServer::IsOpen() const {
+  return listen_fd_ != INVALID_DESCRIPTOR;
+}
+
+void TcpClientsServer::Close() {
+  if (!IsOpen()) {
+    return;
+  }
+
+  stop_ = true;
+  Wakeup();
+  thread_.join();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (Client& client : clients_) {
+    ::close(client.fd);
+  }
+  clients_.clear();
+  ::close(wake_fd_);
+  wake_fd_ = INVALID_DESCRIPTOR;
+  ::close(listen_fd_);
+  listen_fd_ = INVALID_DESCRIPTOR;
+}
+
+uint16_t TcpClientsServer::GetPort() const {
+  return port_;
+}
+
+void TcpClientsServer::SetStats(ChannelStats* stats) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stats_ = stats;
+}
+
+void TcpClientsServer::Write(const void* data, size_t size, bool keyframe) {
+  if (!size) {
+    return;
+  }
+
+  const uint8_t* ptr = static_cast<const uint8_t*>(data);
+  if (size % kTsPacketSize == 0) {
+    UpdateTables(ptr, size);
+  }
+
+  const uint64_t now = monotonic_nsec();
+  chunk_t chunk;
+  bool wake = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (Client& client : clients_) {
+      if (client.closing) {
+        continue;
+      }
+
+      if (client.wait_keyframe) {
+        if (!keyframe) {
+          if (client.overflow_ns) {
+            client.bytes_dropped += size;
+          }
+          continue;
+        }
+        client.wait_keyframe = false;
+      }
+
+      const chunk_t tables = client.need_tables ? GetTables() : chunk_t();
+      const size_t need = size + (tables ? tables->size() : 0);
+      // empty queue takes chunk of any size, so limit below keyframe size doesn't evict everybody
+      if (!client.queue.empty() && client.queued_bytes + need > max_queue_bytes_) {
+        // queue ends on whole chunk, so client can continue cleanly from next keyframe
+        client.bytes_dropped += size;
+        client.wait_keyframe = true;
+        if (!client.overflow_ns) {
+          client.overflow_ns = now;
+          wake = true;  // eviction deadline is checked by poll thread
+        }
+        continue;
+      }
+
+      if (!chunk) {
+        chunk = std::make_shared<const std::vector<uint8_t>>(ptr, ptr + size);
+      }
+      if (client.queue.empty()) {
+        wake = true;
+      }
+      if (tables) {
+        client.queue.push_back(tables);
+      }
+      client.need_tables = false;
+      client.queue.push_back(chunk);
+      client.queued_bytes += need;
+    }
+  }
+
+  if (wake) {
+    Wakeup();
+  }
+}
+
+TcpClientsServer::Stats TcpClientsServer::GetStats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  Stats stats;
+  stats.clients = clients_.size();
+  stats.accepted = accepted_;
+  stats.rejected = rejected_;
+  stats.evicted = evicted_;
+  return stats;
+}
+
+std::vector<TcpClientsServer::ClientStats> TcpClientsServer::GetClientsStats() const {
+  const uint64_t now = monotonic_nsec();
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::vector<ClientStats> stats;
+  stats.reserve(clients_.size());
+  for (const Client& client : clients_) {
+    stats.push_back(MakeClientStats(client, now));
+  }
+  return stats;
+}
+
+void TcpClientsServer::Routine() {
+  const uint64_t evict_ns = evict_time_ * kNsecInMsec;
+  uint64_t stats_ns = 0;
+  std::vector<struct pollfd> fds;
+  std::vector<ClientIo> polled;
+  while (!stop_) {
+    fds.clear();
+    polled.clear();
+    struct pollfd wake_pfd = {wake_fd_, POLLIN, 0};
+    struct pollfd listen_pfd = {listen_fd_, POLLIN, 0};
+    fds.push_back(wake_pfd);
+    fds.push_back(listen_pfd);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      for (Client& client : clients_) {
+        struct pollfd pfd = {client.fd, static_cast<short>(client.queue.empty() ? POLLIN : POLLIN | POLLOUT), 0};
+        fds.push_back(pfd);
+        polled.push_back(ClientIo(&client));
+      }
+    }
+
+    if (poll(fds.data(), fds.size(), kPollTimeoutMsec) == ERROR_RESULT_VALUE && errno != EINTR) {
+      WARNING_LOG() << "Tcp clients poll failed: " << strerror(errno);
+      break;
+    }
+
+    if (fds[0].revents & POLLIN) {
+      uint64_t val;
+      while (read(wake_fd_, &val, sizeof(val)) == sizeof(val)) {
+      }
+    }
+
+    // only this thread removes clients and pops their queues, so polled pointers and queue fronts stay valid
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < polled.size(); ++i) {
+        ClientIo* io = &polled[i];
+        io->revents = fds[i + 2].revents;
+        if (io->closing || !(io->revents & POLLOUT)) {
+          continue;
+        }
+
+        const Client* client = io->client;
+        io->offset = client->offset;
+        for (auto it = client->queue.begin(); it != client->queue.end() && io->chunks.size() < max_send_chunks;
+             ++it) {
+          io->chunks.push_back(*it);
+        }
+      }
+    }
+
+    // socket calls don't hold streaming thread
+    for (ClientIo& io : polled) {
+      if (io.closing) {
+        continue;
+      }
+
+      io.broken = (io.revents & (POLLERR | POLLNVAL)) || ((io.revents & (POLLIN | POLLHUP)) && !Drain(io.fd)) ||
+                  !Send(&io);
+    }
+
+    const uint64_t now = monotonic_nsec();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      for (const ClientIo& io : polled) {
+        Client* client = io.client;
+        if (io.closing) {
+          continue;
+        }
+
+        CommitSent(client, io.sent);
+        if (io.broken) {
+          client->closing = true;
+        } else if (client->overflow_ns && now - client->overflow_ns >= evict_ns) {
+          client->closing = true;
+          client->evicted = true;
+        }
+      }
+    }
+
+    if (fds[1].revents & POLLIN) {
+      Accept(now);
+    }
+    RemoveClosed(now);
+
+    if (now - stats_ns >= stats_interval_msec * kNsecInMsec) {
+      PublishStats();
+      stats_ns = now;
+    }
+  }
+}
+
+void TcpClientsServer::Accept(uint64_t now) {
+  while (true) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    int fd = accept4(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), &addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == INVALID_DESCRIPTOR) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        WARNING_LOG() << "Tcp clients accept failed: " << strerror(errno);
+      }
+      return;
+    }
+
+    const std::string peer = peer_to_string(addr);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (clients_.size() >= max_clients) {
+      rejected_++;
+      ::close(fd);
+      WARNING_LOG() << "Tcp client " << peer << " rejected, clients limit reached: " << max_clients;
+      continue;
+    }
+
+    clients_.emplace_back(fd, peer, now);
+    accepted_++;
+    INFO_LOG() << "Tcp client " << peer << " connected, clients: " << clients_.size();
+  }
+}
+
+bool TcpClientsServer::Send(ClientIo* io) {
+  struct iovec iov[max_send_chunks];
+  size_t count = 0;
+  for (const chunk_t& chunk : io->chunks) {
+    const size_t offset = count == 0 ? io->offset : 0;
+    iov[count].iov_base = const_cast<uint8_t*>(chunk->data()) + offset;
+    iov[count].iov_len = chunk->size() - offset;
+    count++;
+  }
+  if (!count) {
+    return true;
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = count;
+  ssize_t res = sendmsg(io->fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+  if (res == ERROR_RESULT_VALUE) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+
+  io->sent = res;
+  return true;
+}
+
+bool TcpClientsServer::Drain(int fd) {
+  char buff[4096];
+  ssize_t res = ::read(fd, buff, sizeof(buff));
+  if (res == ERROR_RESULT_VALUE) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  return res != 0;
+}
+
+void TcpClientsServer::CommitSent(Client* client, size_t sent) {
+  client->bytes_sent += sent;
+  client->queued_bytes -= sent;
+  while (sent) {
+    const size_t left = client->queue.front()->size() - client->offset;
+    if (sent < left) {
+      client->offset += sent;
+      break;
+    }
+    sent -= left;
+    client->offset = 0;
+    client->queue.pop_front();
+  }
+
+  // client caught up, slow period is over
+  if (client->overflow_ns && client->queued_bytes <= max_queue_bytes_ / 2) {
+    client->overflow_ns = 0;
+  }
+}
+
+void TcpClientsServer::UpdateTables(const uint8_t* data, size_t size) {
+  for (const uint8_t* packet = data; packet + kTsPacketSize <= data + size; packet += kTsPacketSize) {
+    if (packet[0] != kTsSyncByte) {  // not aligned mpeg-ts
+      return;
+    }
+
+    const uint16_t pid = ts_packet_pid(packet);
+    if (pid == kPatPid) {
+      const uint16_t pmt_pid = pat_pmt_pid(packet);
+      if (!pmt_pid) {
+        continue;
+      }
+      if (pmt_pid != pmt_pid_) {
+        pmt_pid_ = pmt_pid;
+        pmt_.clear();
+      }
+      pat_.assign(packet, packet + kTsPacketSize);
+      tables_.reset();
+    } else if (pmt_pid_ && pid == pmt_pid_) {
+      const uint8_t* section = ts_section_start(packet);
+      if (section && section[0] == kPmtTableId) {
+        pmt_.assign(packet, packet + kTsPacketSize);
+        tables_.reset();
+      }
+    }
+  }
+}
+
+TcpClientsServer::chunk_t TcpClientsServer::GetTables() {
+  if (!tables_ && !pat_.empty() && !pmt_.empty()) {
+    std::vector<uint8_t> tables(pat_);
+    tables.insert(tables.end(), pmt_.begin(), pmt_.end());
+    tables_ = std::make_shared<const std::vector<uint8_t>>(std::move(tables));
+  }
+  return tables_;
+}
+
+void TcpClientsServer::RemoveClosed(uint64_t now) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    if (!it->closing) {
+      ++it;
+      continue;
+    }
+
+    const ClientStats stats = MakeClientStats(*it, now);
+    if (it->evicted) {
+      evicted_++;
+      WARNING_LOG() << "Tcp client " << stats.peer << " evicted, queued bytes: " << stats.queued_bytes
+                    << ", dropped bytes: " << stats.bytes_dropped;
+    }
+    INFO_LOG() << "Tcp client " << stats.peer << " disconnected after " << stats.duration
+               << " msec, sent bytes: " << stats.bytes_sent << ", bitrate: " << stats.bitrate;
+    ::close(it->fd);
+    it = clients_.erase(it);
+  }
+}
+
+void TcpClientsServer::Wakeup() {
+  const uint64_t val = 1;
+  ssize_t res = write(wake_fd_, &val, sizeof(val));
+  UNUSED(res);
+}
+
+TcpClientsServer::ClientStats TcpClientsServer::MakeClientStats(const Client& client, uint64_t now) const {
+  ClientStats stats;
+  stats.peer = client.peer;
+  stats.duration = (now - client.connected_ns) / kNsecInMsec;
+  stats.bytes_sent = client.bytes_sent;
+  stats.bytes_dropped = client.bytes_dropped;
+  stats.queued_bytes = client.queued_bytes;
+  stats.bitrate = stats.duration ? client.bytes_sent * 8 * 1000 / stats.duration : 0;
+  return stats;
+}
+
+void TcpClientsServer::PublishStats() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (stats_) {
+    stats_->SetClients(clients_.size());
+    stats_->SetEvictedClients(evicted_);
+  }
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
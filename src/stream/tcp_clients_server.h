@@ -0,0 +1,164 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+namespace iptv_cloud {
+
+class ChannelStats;
+
+namespace stream {
+
+// Serves one mpeg-ts output to many tcp clients. Every client has own bounded queue of shared chunks,
+// so one stalled client never blocks streaming thread nor grows memory of others. New clients (and clients
+// which lost data on full queue) start from keyframe, new ones get last PAT and PMT before it. Client which
+// stays behind longer than evict time is disconnected. Sockets are served by own poll thread without lock
+// held, Write only queues.
+class TcpClientsServer {
+ public:
+  enum {
+    max_clients = 1024,
+    listen_backlog = 128,
+    max_send_chunks = 64,     // iovecs per send call
+    stats_interval_msec = 1000
+  };
+
+  struct ClientStats {
+    ClientStats();
+
+    std::string peer;
+    time_t duration;        // msec connected
+    uint64_t bytes_sent;
+    uint64_t bytes_dropped;  // not queued because queue was full
+    size_t queued_bytes;
+    uint64_t bitrate;  // average of connection, bits per sec
+  };
+
+  struct Stats {
+    Stats();
+
+    size_t clients;     // connected
+    uint64_t accepted;
+    uint64_t rejected;  // over max clients
+    uint64_t evicted;   // slow clients
+  };
+
+  // evict_time in msec, 0 disconnects client on first overflow of its queue,
+  // empty queue takes one chunk even if it is bigger than max_queue_bytes
+  TcpClientsServer(size_t max_queue_bytes, time_t evict_time);
+  ~TcpClientsServer();
+
+  // listens and starts poll thread
+  common::ErrnoError Open(const common::net::HostAndPort& host) WARN_UNUSED_RESULT;
+  bool IsOpen() const;
+  void Close();
+
+  uint16_t GetPort() const;  // bound one, useful for port 0
+  void SetStats(ChannelStats* stats);
+
+  // streaming thread, chunk is copied once and shared by queues of all clients
+  void Write(const void* data, size_t size, bool keyframe);
+
+  Stats GetStats() const;
+  std::vector<ClientStats> GetClientsStats() const;
+
+ private:
+  typedef std::shared_ptr<const std::vector<uint8_t>> chunk_t;
+
+  struct Client {
+    Client(int fd, const std::string& peer, uint64_t now);
+
+    int fd;
+    std::string peer;
+    uint64_t connected_ns;
+    std::deque<chunk_t> queue;
+    size_t queued_bytes;
+    size_t offset;           // sent bytes of front chunk
+    bool wait_keyframe;
+    bool need_tables;        // PAT and PMT not sent yet
+    uint64_t overflow_ns;    // first overflow since queue was drained, 0 if none
+    bool closing;
+    bool evicted;
+    uint64_t bytes_sent;
+    uint64_t bytes_dropped;
+  };
+
+  // socket work of one client in poll iteration, collected and committed under lock, done without it
+  struct ClientIo {
+    explicit ClientIo(Client* client);
+
+    Client* client;
+    int fd;
+    bool closing;
+    short revents;
+    std::vector<chunk_t> chunks;  // front of queue
+    size_t offset;                // sent bytes of first chunk
+    size_t sent;
+    bool broken;
+  };
+
+  void Routine();
+  void Accept(uint64_t now);
+  static bool Send(ClientIo* io);  // false if connection broken
+  static bool Drain(int fd);       // reads and drops client input, false if connection closed
+  void CommitSent(Client* client, size_t sent);
+  void UpdateTables(const uint8_t* data, size_t size);
+  chunk_t GetTables();
+  void RemoveClosed(uint64_t now);
+  void Wakeup();
+  ClientStats MakeClientStats(const Client& client, uint64_t now) const;
+  void PublishStats();
+
+  const size_t max_queue_bytes_;
+  const time_t evict_time_;
+
+  int listen_fd_;
+  int wake_fd_;
+  uint16_t port_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+
+  // streaming thread only
+  uint16_t pmt_pid_;
+  std::vector<uint8_t> pat_;  // last PAT packet
+  std::vector<uint8_t> pmt_;  // last PMT packet
+  chunk_t tables_;            // both of them, shared by new clients
+
+  mutable std::mutex mutex_;
+  std::list<Client> clients_;
+  ChannelStats* stats_;
+  uint64_t accepted_;
+  uint64_t rejected_;
+  uint64_t evicted_;
+
+  DISALLOW_COPY_AND_ASSIGN(TcpClientsServer);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
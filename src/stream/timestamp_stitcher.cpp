@@ -0,0 +1,109 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/timestamp_stitcher.h"
+
+#include <algorithm>
+
+namespace {
+
+uint64_t ApplyOffset(uint64_t timestamp, int64_t offset) {
+  if (timestamp == iptv_cloud::stream::TimestampStitcher::invalid_timestamp) {
+    return timestamp;
+  }
+
+  const int64_t result = static_cast<int64_t>(timestamp) + offset;
+  return result < 0 ? 0 : result;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace stream {
+
+const uint64_t TimestampStitcher::invalid_timestamp;
+const uint64_t TimestampStitcher::max_jump;
+
+TimestampStitcher::Track::Track() : last_raw(invalid_timestamp), last_delta(0), out_end(0), offset(0), epoch(0) {}
+
+TimestampStitcher::TimestampStitcher() : mutex_(), tracks_(), epoch_(0), stitched_epoch_(0), epoch_offset_(0) {}
+
+void TimestampStitcher::Reset() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < max_tracks; ++i) {
+    tracks_[i] = Track();
+  }
+  epoch_ = 0;
+  stitched_epoch_ = 0;
+  epoch_offset_ = 0;
+}
+
+void TimestampStitcher::MarkTransition() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  epoch_++;
+}
+
+bool TimestampStitcher::Stitch(size_t track, uint64_t* pts, uint64_t* dts, uint64_t duration, uint64_t* jump) {
+  if (track >= max_tracks || !pts || !dts || !jump) {
+    return false;
+  }
+
+  const uint64_t raw = *dts != invalid_timestamp ? *dts : *pts;
+  if (raw == invalid_timestamp) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  Track* tr = &tracks_[track];
+  bool rebased = false;
+  if (tr->last_raw == invalid_timestamp) {  // track appeared, joins current file
+    if (stitched_epoch_ == epoch_) {
+      tr->offset = epoch_offset_;
+    }
+    tr->epoch = epoch_;
+  } else if (tr->epoch != epoch_) {
+    const uint64_t expected = tr->last_raw + tr->last_delta;
+    const uint64_t diff = raw > expected ? raw - expected : expected - raw;
+    if (raw < tr->last_raw || diff > max_jump) {  // next file may start just before end of short previous one
+      if (stitched_epoch_ != epoch_) {  // first track of new file, continue after everything already sent
+        uint64_t end = 0;
+        for (size_t i = 0; i < max_tracks; ++i) {
+          end = std::max(end, tracks_[i].out_end);
+        }
+        epoch_offset_ = static_cast<int64_t>(end) - static_cast<int64_t>(raw);
+        stitched_epoch_ = epoch_;
+      }
+      tr->offset = epoch_offset_;
+      tr->epoch = epoch_;
+      tr->last_delta = 0;
+      *jump = diff / 1000;
+      rebased = true;
+    }
+  }
+
+  if (!rebased && raw > tr->last_raw && raw - tr->last_raw <= max_jump) {
+    tr->last_delta = raw - tr->last_raw;
+  }
+  tr->last_raw = raw;
+
+  *pts = ApplyOffset(*pts, tr->offset);
+  *dts = ApplyOffset(*dts, tr->offset);
+  const uint64_t out = *dts != invalid_timestamp ? *dts : *pts;
+  const uint64_t out_end = out + (duration != invalid_timestamp ? duration : tr->last_delta);
+  tr->out_end = std::max(tr->out_end, out_end);
+  return rebased;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
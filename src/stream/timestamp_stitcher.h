@@ -0,0 +1,66 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+
+#include <common/macros.h>
+
+namespace iptv_cloud {
+namespace stream {
+
+// Keeps timestamps of playlist continuous when it switches files, every file has own timeline.
+// Demuxer still outputs buffers of previous file after transition, so track is rebased only when its own timestamps
+// go back or jump forward after transition; all tracks of one file get same offset, audio and video stay in sync.
+class TimestampStitcher {
+ public:
+  static const uint64_t invalid_timestamp = UINT64_MAX;  // same as GST_CLOCK_TIME_NONE
+  static const uint64_t max_jump = 1000000000;           // nsec, bigger differences are discontinuities
+  enum { max_tracks = 2 };
+
+  TimestampStitcher();
+
+  void Reset();           // new pipeline, timestamps start over
+  void MarkTransition();  // first block of next file pushed
+
+  // streaming threads, timestamps in nsec rewritten in place,
+  // true if track was rebased by this buffer, jump (usec) is discontinuity stitched over
+  bool Stitch(size_t track, uint64_t* pts, uint64_t* dts, uint64_t duration, uint64_t* jump);
+
+ private:
+  struct Track {
+    Track();
+
+    uint64_t last_raw;    // nsec, dts (pts) before rewrite
+    uint64_t last_delta;  // nsec, distance between last two buffers
+    uint64_t out_end;     // nsec, end of last rewritten buffer
+    int64_t offset;
+    uint64_t epoch;
+  };
+
+  std::mutex mutex_;
+  Track tracks_[max_tracks];
+  uint64_t epoch_;  // transitions count
+  uint64_t stitched_epoch_;
+  int64_t epoch_offset_;  // offset of tracks rebased in stitched_epoch_
+
+  DISALLOW_COPY_AND_ASSIGN(TimestampStitcher);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
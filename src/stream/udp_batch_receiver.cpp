@@ -0,0 +1,268 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/udp_batch_receiver.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include <common/convert2string.h>
+
+#include "base/channel_stats.h"
+
+namespace {
+
+const uint64_t kNsecInSec = 1000000000;
+const uint64_t kNsecInMsec = 1000000;
+const uint8_t kTsSyncByte = 0x47;
+const size_t kRtpHeaderSize = 12;
+const uint8_t kRtpVersion = 2;
+
+uint64_t monotonic_nsec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * kNsecInSec + ts.tv_nsec;
+}
+
+bool is_multicast(const struct addrinfo* addr) {
+  if (addr->ai_family == AF_INET) {
+    const struct sockaddr_in* sin = reinterpret_cast<const struct sockaddr_in*>(addr->ai_addr);
+    return IN_MULTICAST(ntohl(sin->sin_addr.s_addr));
+  } else if (addr->ai_family == AF_INET6) {
+    const struct sockaddr_in6* sin6 = reinterpret_cast<const struct sockaddr_in6*>(addr->ai_addr);
+    return IN6_IS_ADDR_MULTICAST(&sin6->sin6_addr);
+  }
+  return false;
+}
+
+int join_group(int fd, const struct addrinfo* addr) {
+  if (addr->ai_family == AF_INET) {
+    struct ip_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_multiaddr = reinterpret_cast<const struct sockaddr_in*>(addr->ai_addr)->sin_addr;
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    return setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+  }
+
+  struct ipv6_mreq mreq;
+  memset(&mreq, 0, sizeof(mreq));
+  mreq.ipv6mr_multiaddr = reinterpret_cast<const struct sockaddr_in6*>(addr->ai_addr)->sin6_addr;
+  return setsockopt(fd, IPPROTO_IPV6, IPV6_JOIN_GROUP, &mreq, sizeof(mreq));
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace stream {
+
+UdpBatchReceiver::UdpBatchReceiver(uint64_t latency)
+    : fd_(INVALID_DESCRIPTOR),
+      jitter_(latency),
+      stats_(nullptr),
+      buffer_(max_batch_datagrams * max_datagram_size),
+      msgs_(),
+      iovecs_(),
+      datagrams_(0),
+      reported_lost_(0),
+      reported_reordered_(0),
+      reported_duplicates_(0) {
+  for (size_t i = 0; i < max_batch_datagrams; ++i) {
+    iovecs_[i].iov_base = &buffer_[i * max_datagram_size];
+    iovecs_[i].iov_len = max_datagram_size;
+    msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+    msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
+}
+
+UdpBatchReceiver::~UdpBatchReceiver() {
+  Close();
+}
+
+common::ErrnoError UdpBatchReceiver::Open(const common::net::HostAndPort& host, int rcvbuf) {
+  if (IsOpen()) {
+    return common::make_errno_error("Already opened.", EINVAL);
+  }
+
+  const std::string host_str = host.GetHost();
+  const std::string port_str = common::ConvertToString(host.GetPort());
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  hints.ai_flags = AI_PASSIVE;
+  struct addrinfo* addrs = nullptr;
+  int res = getaddrinfo(host_str.c_str(), port_str.c_str(), &hints, &addrs);
+  if (res != 0) {
+    return common::make_errno_error(gai_strerror(res), EINVAL);
+  }
+
+  common::ErrnoError err = common::make_errno_error("Can't bind udp host: " + host_str + ":" + port_str, EINVAL);
+  for (struct addrinfo* rp = addrs; rp != nullptr; rp = rp->ai_next) {
+    int fd = socket(rp->ai_family, rp->ai_socktype | SOCK_CLOEXEC, rp->ai_protocol);
+    if (fd == INVALID_DESCRIPTOR) {
+      err = common::make_errno_error(errno);
+      continue;
+    }
+
+    // forced size ignores net.core.rmem_max, but needs CAP_NET_ADMIN
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) == ERROR_RESULT_VALUE) {
+      setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+
+    int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) == ERROR_RESULT_VALUE ||
+        ::bind(fd, rp->ai_addr, rp->ai_addrlen) == ERROR_RESULT_VALUE ||
+        (is_multicast(rp) && join_group(fd, rp) == ERROR_RESULT_VALUE)) {
+      err = common::make_errno_error(errno);
+      ::close(fd);
+      continue;
+    }
+
+    fd_ = fd;
+    err = common::ErrnoError();
+    break;
+  }
+
+  freeaddrinfo(addrs);
+  return err;
+}
+
+bool UdpBatchReceiver::IsOpen() const {
+  return fd_ != INVALID_DESCRIPTOR;
+}
+
+void UdpBatchReceiver::Close() {
+  if (!IsOpen()) {
+    return;
+  }
+
+  ::close(fd_);
+  fd_ = INVALID_DESCRIPTOR;
+}
+
+int UdpBatchReceiver::GetReceiveBufferSize() const {
+  int size = 0;
+  socklen_t len = sizeof(size);
+  if (getsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &size, &len) == ERROR_RESULT_VALUE) {
+    return 0;
+  }
+
+  return size / 2;  // kernel doubles asked size for bookkeeping overhead
+}
+
+void UdpBatchReceiver::SetStats(ChannelStats* stats) {
+  stats_ = stats;
+}
+
+common::ErrnoError UdpBatchReceiver::Read(int timeout_msec, std::vector<uint8_t>* out) {
+  if (!IsOpen() || !out) {
+    return common::make_errno_error_inval();
+  }
+
+  // held rtp packet expires earlier than timeout
+  const uint64_t deadline = jitter_.GetDeadline();
+  if (deadline != RtpJitterBuffer::invalid_deadline) {
+    const uint64_t now = monotonic_nsec();
+    const uint64_t wait_msec = deadline > now ? (deadline - now + kNsecInMsec - 1) / kNsecInMsec : 0;
+    timeout_msec = std::min<uint64_t>(timeout_msec, wait_msec);
+  }
+
+  struct pollfd pfd;
+  pfd.fd = fd_;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  int res = poll(&pfd, 1, timeout_msec);
+  if (res == ERROR_RESULT_VALUE && errno != EINTR) {
+    return common::make_errno_error(errno);
+  }
+
+  if (res > 0) {
+    int count = recvmmsg(fd_, msgs_, max_batch_datagrams, MSG_DONTWAIT, nullptr);
+    if (count == ERROR_RESULT_VALUE) {
+      if (errno != EAGAIN && errno != EINTR) {
+        return common::make_errno_error(errno);
+      }
+    } else {
+      const uint64_t now = monotonic_nsec();
+      for (int i = 0; i < count; ++i) {
+        if (msgs_[i].msg_hdr.msg_flags & MSG_TRUNC) {
+          continue;
+        }
+        HandleDatagram(&buffer_[i * max_datagram_size], msgs_[i].msg_len, now, out);
+      }
+      datagrams_ += count;
+    }
+  }
+
+  jitter_.Pop(monotonic_nsec(), out);
+  UpdateStats();
+  return common::ErrnoError();
+}
+
+uint64_t UdpBatchReceiver::GetDatagrams() const {
+  return datagrams_;
+}
+
+const RtpJitterBuffer* UdpBatchReceiver::GetJitterBuffer() const {
+  return &jitter_;
+}
+
+void UdpBatchReceiver::HandleDatagram(const uint8_t* data, size_t size, uint64_t now, std::vector<uint8_t>* out) {
+  if (size && data[0] == kTsSyncByte) {  // plain mpeg-ts
+    out->insert(out->end(), data, data + size);
+    return;
+  }
+
+  if (size < kRtpHeaderSize || (data[0] >> 6) != kRtpVersion) {
+    return;
+  }
+
+  size_t header = kRtpHeaderSize + (data[0] & 0x0f) * 4;  // csrc
+  if (data[0] & 0x10) {                                   // extension
+    if (size < header + 4) {
+      return;
+    }
+    header += 4 + ((data[header + 2] << 8) | data[header + 3]) * 4;
+  }
+  const size_t padding = (data[0] & 0x20) ? data[size - 1] : 0;
+  if (header + padding > size) {
+    return;
+  }
+
+  const uint16_t seq = (data[2] << 8) | data[3];
+  jitter_.Push(seq, data + header, size - header - padding, now, out);
+}
+
+void UdpBatchReceiver::UpdateStats() {
+  const uint64_t lost = jitter_.GetLost();
+  const uint64_t reordered = jitter_.GetReordered();
+  const uint64_t duplicates = jitter_.GetDuplicates();
+  if (stats_ && (lost != reported_lost_ || reordered != reported_reordered_ || duplicates != reported_duplicates_)) {
+    stats_->RecordRtpCounters(lost - reported_lost_, reordered - reported_reordered_,
+                              duplicates - reported_duplicates_);
+  }
+  reported_lost_ = lost;
+  reported_reordered_ = reordered;
+  reported_duplicates_ = duplicates;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
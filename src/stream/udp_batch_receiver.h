@@ -0,0 +1,79 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+#include "stream/rtp_jitter_buffer.h"
+
+namespace iptv_cloud {
+class ChannelStats;
+namespace stream {
+
+// Reads udp (multicast) input by recvmmsg batches from socket with big receive buffer.
+// Datagrams of mpeg-ts pass as they are, rtp ones go through reorder buffer and leave without rtp headers.
+class UdpBatchReceiver {
+ public:
+  enum {
+    max_batch_datagrams = 64,
+    max_datagram_size = 2048  // mpeg-ts over udp/rtp doesn't exceed mtu
+  };
+
+  explicit UdpBatchReceiver(uint64_t latency);  // nsec, reorder buffer
+  ~UdpBatchReceiver();
+
+  // multicast group joined on default interface, rcvbuf in bytes
+  common::ErrnoError Open(const common::net::HostAndPort& host, int rcvbuf) WARN_UNUSED_RESULT;
+  bool IsOpen() const;
+  void Close();
+
+  int GetReceiveBufferSize() const;  // real one, kernel limits what is asked without CAP_NET_ADMIN
+
+  // input stats get rtp losses, reorders and duplicates
+  void SetStats(ChannelStats* stats);
+
+  // waits for datagrams not longer than timeout, released mpeg-ts appended to out
+  common::ErrnoError Read(int timeout_msec, std::vector<uint8_t>* out) WARN_UNUSED_RESULT;
+  uint64_t GetDatagrams() const;
+  const RtpJitterBuffer* GetJitterBuffer() const;
+
+ private:
+  void HandleDatagram(const uint8_t* data, size_t size, uint64_t now, std::vector<uint8_t>* out);
+  void UpdateStats();
+
+  int fd_;
+  RtpJitterBuffer jitter_;
+  ChannelStats* stats_;
+
+  std::vector<uint8_t> buffer_;  // max_batch_datagrams datagrams
+  struct mmsghdr msgs_[max_batch_datagrams];
+  struct iovec iovecs_[max_batch_datagrams];
+  uint64_t datagrams_;
+
+  uint64_t reported_lost_;
+  uint64_t reported_reordered_;
+  uint64_t reported_duplicates_;
+
+  DISALLOW_COPY_AND_ASSIGN(UdpBatchReceiver);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
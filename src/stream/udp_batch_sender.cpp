@@ -0,0 +1,330 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/udp_batch_sender.h"
+
+#include <netdb.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include <common/convert2string.h>
+
+namespace {
+
+const uint64_t kNsecInSec = 1000000000;
+const uint64_t kNsecInMsec = 1000000;
+
+class MonotonicClock : public iptv_cloud::stream::UdpBatchSender::Clock {
+ public:
+  uint64_t GetNsec() override {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * kNsecInSec + ts.tv_nsec;
+  }
+
+  void SleepNsec(uint64_t nsec) override {
+    struct timespec ts;
+    ts.tv_sec = nsec / kNsecInSec;
+    ts.tv_nsec = nsec % kNsecInSec;
+    while (nanosleep(&ts, &ts) == ERROR_RESULT_VALUE && errno == EINTR) {
+    }
+  }
+};
+
+MonotonicClock monotonic_clock;
+
+// receiver is away or host queue is full, output just loses datagram as udpsink does
+bool is_transient_send_error(int err) {
+  return err == ECONNREFUSED || err == ENOBUFS || err == EAGAIN || err == EHOSTUNREACH || err == ENETUNREACH;
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace stream {
+
+UdpBatchSender::Stats::Stats() : bytes(0), ts_packets(0), datagrams(0), bursts(0), paced_waits(0), send_errors(0) {}
+
+UdpBatchSender::Clock::~Clock() {}
+
+UdpBatchSender::UdpBatchSender() : UdpBatchSender(&monotonic_clock) {}
+
+UdpBatchSender::UdpBatchSender(Clock* clock)
+    : clock_(clock),
+      fd_(INVALID_DESCRIPTOR),
+      pacing_(true),
+      fixed_bitrate_(0),
+      measured_bitrate_(0),
+      buffer_(max_burst_datagrams * datagram_size),
+      buffer_datagrams_(0),
+      tail_size_(0),
+      msgs_(),
+      iovecs_(),
+      first_datagram_ns_(0),
+      next_burst_ns_(0),
+      window_start_ns_(0),
+      window_bytes_(0),
+      bytes_(0),
+      datagrams_(0),
+      bursts_(0),
+      paced_waits_(0),
+      send_errors_(0) {
+  for (size_t i = 0; i < max_burst_datagrams; ++i) {
+    iovecs_[i].iov_base = &buffer_[i * datagram_size];
+    iovecs_[i].iov_len = datagram_size;
+    msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+    msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
+}
+
+UdpBatchSender::~UdpBatchSender() {
+  Close();
+}
+
+common::ErrnoError UdpBatchSender::Open(const common::net::HostAndPort& host) {
+  if (IsOpen()) {
+    return common::make_errno_error("Already opened.", EINVAL);
+  }
+
+  const std::string host_str = host.GetHost();
+  const std::string port_str = common::ConvertToString(host.GetPort());
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  struct addrinfo* addrs = nullptr;
+  int res = getaddrinfo(host_str.c_str(), port_str.c_str(), &hints, &addrs);
+  if (res != 0) {
+    return common::make_errno_error(gai_strerror(res), EINVAL);
+  }
+
+  // connected socket, so datagrams of burst don't need own addresses
+  common::ErrnoError err = common::make_errno_error("Can't connect udp host: " + host_str + ":" + port_str, EINVAL);
+  for (struct addrinfo* rp = addrs; rp != nullptr; rp = rp->ai_next) {
+    int fd = socket(rp->ai_family, rp->ai_socktype | SOCK_CLOEXEC, rp->ai_protocol);
+    if (fd == INVALID_DESCRIPTOR) {
+      err = common::make_errno_error(errno);
+      continue;
+    }
+
+    if (connect(fd, rp->ai_addr, rp->ai_addrlen) == ERROR_RESULT_VALUE) {
+      err = common::make_errno_error(errno);
+      ::close(fd);
+      continue;
+    }
+
+    fd_ = fd;
+    err = common::ErrnoError();
+    break;
+  }
+
+  freeaddrinfo(addrs);
+  return err;
+}
+
+bool UdpBatchSender::IsOpen() const {
+  return fd_ != INVALID_DESCRIPTOR;
+}
+
+void UdpBatchSender::Close() {
+  if (!IsOpen()) {
+    return;
+  }
+
+  ::close(fd_);
+  fd_ = INVALID_DESCRIPTOR;
+  buffer_datagrams_ = 0;
+  tail_size_ = 0;
+}
+
+void UdpBatchSender::SetFixedBitrate(uint64_t bitrate) {
+  fixed_bitrate_ = bitrate;
+}
+
+void UdpBatchSender::SetPacing(bool pacing) {
+  pacing_ = pacing;
+}
+
+common::ErrnoError UdpBatchSender::Write(const void* data, size_t size) {
+  if (!IsOpen()) {
+    return common::make_errno_error("Not opened.", EINVAL);
+  }
+
+  const uint64_t now = clock_->GetNsec();
+  UpdateBitrate(now, size);
+  const size_t burst_size = GetBurstSize();
+  const uint8_t* ptr = static_cast<const uint8_t*>(data);
+  while (size) {
+    const size_t chunk = std::min(size, static_cast<size_t>(datagram_size) - tail_size_);
+    memcpy(&buffer_[buffer_datagrams_ * datagram_size + tail_size_], ptr, chunk);
+    ptr += chunk;
+    size -= chunk;
+    tail_size_ += chunk;
+    if (tail_size_ != datagram_size) {
+      continue;
+    }
+
+    tail_size_ = 0;
+    if (buffer_datagrams_++ == 0) {
+      first_datagram_ns_ = now;
+    }
+    if (buffer_datagrams_ >= burst_size) {
+      common::ErrnoError err = SendBurst(false);
+      if (err) {
+        return err;
+      }
+    }
+  }
+
+  // low bitrate stream doesn't collect burst in time, datagrams wait not longer than one interval
+  if (buffer_datagrams_ && now - first_datagram_ns_ >= burst_interval_msec * kNsecInMsec) {
+    return SendBurst(false);
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError UdpBatchSender::Flush() {
+  if (!IsOpen()) {
+    return common::make_errno_error("Not opened.", EINVAL);
+  }
+
+  return SendBurst(true);
+}
+
+uint64_t UdpBatchSender::GetBitrate() const {
+  return fixed_bitrate_ ? fixed_bitrate_ : measured_bitrate_.load();
+}
+
+UdpBatchSender::Stats UdpBatchSender::GetStats() const {
+  Stats stats;
+  stats.bytes = bytes_;
+  stats.ts_packets = stats.bytes / ts_packet_size;
+  stats.datagrams = datagrams_;
+  stats.bursts = bursts_;
+  stats.paced_waits = paced_waits_;
+  stats.send_errors = send_errors_;
+  return stats;
+}
+
+uint64_t UdpBatchSender::GetPacingBitrate() const {
+  if (!pacing_) {
+    return 0;
+  }
+
+  return GetBitrate() * pacing_headroom_percent / 100;
+}
+
+size_t UdpBatchSender::GetBurstSize() const {
+  const uint64_t bitrate = GetPacingBitrate();
+  if (!bitrate) {
+    return max_burst_datagrams;
+  }
+
+  const uint64_t interval_datagrams = bitrate * burst_interval_msec / 1000 / 8 / datagram_size;
+  return std::max<size_t>(1, std::min<uint64_t>(interval_datagrams, max_burst_datagrams));
+}
+
+void UdpBatchSender::UpdateBitrate(uint64_t now, size_t size) {
+  if (fixed_bitrate_) {
+    return;
+  }
+
+  if (!window_start_ns_) {
+    window_start_ns_ = now;
+  }
+  window_bytes_ += size;
+  const uint64_t elapsed_msec = (now - window_start_ns_) / kNsecInMsec;
+  if (elapsed_msec < bitrate_window_msec) {
+    return;
+  }
+
+  const uint64_t bitrate = window_bytes_ * 8 * 1000 / elapsed_msec;
+  const uint64_t prev = measured_bitrate_;
+  measured_bitrate_ = prev ? (prev * 3 + bitrate) / 4 : bitrate;
+  window_start_ns_ = now;
+  window_bytes_ = 0;
+}
+
+void UdpBatchSender::Pace(size_t burst_bytes) {
+  const uint64_t bitrate = GetPacingBitrate();
+  if (!bitrate) {
+    return;
+  }
+
+  const uint64_t interval_ns = burst_interval_msec * kNsecInMsec;
+  const uint64_t now = clock_->GetNsec();
+  if (next_burst_ns_ > now) {
+    clock_->SleepNsec(next_burst_ns_ - now);
+    paced_waits_++;
+  } else if (now - next_burst_ns_ > interval_ns) {
+    next_burst_ns_ = now - interval_ns;  // idle time doesn't turn into long burst, credit is one interval
+  }
+  next_burst_ns_ += burst_bytes * 8 * kNsecInSec / bitrate;
+}
+
+common::ErrnoError UdpBatchSender::SendBurst(bool with_tail) {
+  const bool send_tail = with_tail && tail_size_;
+  const size_t count = buffer_datagrams_ + (send_tail ? 1 : 0);
+  if (!count) {
+    return common::ErrnoError();
+  }
+
+  if (send_tail) {
+    iovecs_[count - 1].iov_len = tail_size_;
+  }
+  Pace(buffer_datagrams_ * datagram_size + (send_tail ? tail_size_ : 0));
+
+  common::ErrnoError err;
+  size_t sent = 0;
+  while (sent < count) {
+    int res = sendmmsg(fd_, msgs_ + sent, count - sent, 0);
+    if (res == ERROR_RESULT_VALUE) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (is_transient_send_error(errno)) {  // first datagram failed, rest of burst can pass
+        send_errors_++;
+        sent++;
+        continue;
+      }
+
+      err = common::make_errno_error(errno);
+      send_errors_ += count - sent;
+      break;
+    }
+
+    bursts_++;
+    for (int i = 0; i < res; ++i) {
+      bytes_ += msgs_[sent + i].msg_len;
+    }
+    datagrams_ += res;
+    sent += res;
+  }
+
+  if (send_tail) {
+    iovecs_[count - 1].iov_len = datagram_size;
+    tail_size_ = 0;
+  } else if (tail_size_) {
+    memmove(&buffer_[0], &buffer_[buffer_datagrams_ * datagram_size], tail_size_);
+  }
+  buffer_datagrams_ = 0;
+  return err;
+}
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -0,0 +1,117 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <vector>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+namespace iptv_cloud {
+namespace stream {
+
+// Sends mpeg-ts stream as udp datagrams of 7 ts packets, several datagrams per sendmmsg call.
+// Bursts are paced to measured bitrate of stream (or fixed one), so output doesn't leave host in microbursts
+// when muxer pushes whole frames at once. Write blocks caller for pacing, it should be called from own
+// streaming thread (behind output queue), otherwise pacing should be off.
+class UdpBatchSender {
+ public:
+  // time source of pacing, monotonic
+  class Clock {
+   public:
+    virtual ~Clock();
+    virtual uint64_t GetNsec() = 0;
+    virtual void SleepNsec(uint64_t nsec) = 0;
+  };
+  enum {
+    ts_packet_size = 188,
+    ts_packets_per_datagram = 7,
+    datagram_size = ts_packet_size * ts_packets_per_datagram,  // 1316, fits ethernet mtu
+    max_burst_datagrams = 32,
+    burst_interval_msec = 5,          // datagrams of this time at stream bitrate go in one burst
+    bitrate_window_msec = 1000,       // bitrate measured by windows of input
+    pacing_headroom_percent = 110     // pacing rate above measured bitrate, so sender keeps up with input
+  };
+
+  struct Stats {
+    Stats();
+
+    uint64_t bytes;         // sent
+    uint64_t ts_packets;    // sent
+    uint64_t datagrams;     // sent
+    uint64_t bursts;        // sendmmsg calls
+    uint64_t paced_waits;   // bursts delayed by pacing
+    uint64_t send_errors;   // datagrams not sent
+  };
+
+  UdpBatchSender();
+  explicit UdpBatchSender(Clock* clock);  // not owned, should outlive sender
+  ~UdpBatchSender();
+
+  common::ErrnoError Open(const common::net::HostAndPort& host) WARN_UNUSED_RESULT;
+  bool IsOpen() const;
+  void Close();
+
+  // 0 means measured bitrate is used, pacing starts after first window of input
+  void SetFixedBitrate(uint64_t bitrate);  // bits per sec
+  void SetPacing(bool pacing);
+
+  // datagrams go out by bursts, complete datagrams wait for next write not longer than burst interval
+  common::ErrnoError Write(const void* data, size_t size) WARN_UNUSED_RESULT;
+  // sends tail datagram even if it is shorter than 7 ts packets, on eos
+  common::ErrnoError Flush() WARN_UNUSED_RESULT;
+
+  uint64_t GetBitrate() const;  // pacing bitrate without headroom, bits per sec
+  Stats GetStats() const;
+
+ private:
+  uint64_t GetPacingBitrate() const;
+  size_t GetBurstSize() const;
+  void UpdateBitrate(uint64_t now, size_t size);
+  void Pace(size_t burst_bytes);
+  common::ErrnoError SendBurst(bool with_tail) WARN_UNUSED_RESULT;
+
+  Clock* const clock_;
+  int fd_;
+  bool pacing_;
+  uint64_t fixed_bitrate_;
+  std::atomic<uint64_t> measured_bitrate_;
+
+  std::vector<uint8_t> buffer_;  // max_burst_datagrams datagrams
+  size_t buffer_datagrams_;      // complete datagrams in buffer
+  size_t tail_size_;             // bytes of incomplete datagram after them
+  struct mmsghdr msgs_[max_burst_datagrams];
+  struct iovec iovecs_[max_burst_datagrams];
+
+  uint64_t first_datagram_ns_;  // when oldest complete datagram in buffer was completed
+  uint64_t next_burst_ns_;
+  uint64_t window_start_ns_;
+  uint64_t window_bytes_;
+
+  std::atomic<uint64_t> bytes_;
+  std::atomic<uint64_t> datagrams_;
+  std::atomic<uint64_t> bursts_;
+  std::atomic<uint64_t> paced_waits_;
+  std::atomic<uint64_t> send_errors_;
+
+  DISALLOW_COPY_AND_ASSIGN(UdpBatchSender);
+};
+
+}  // namespace stream
+}  // namespace iptv_cloud
@@ -22,6 +22,76 @@
 #define FIELD_STATS_TOTAL_BYTES "total_bytes"
 #define FIELD_STATS_BYTES_PER_SECOND "bps"
 #define FIELD_STATS_DESIRE_BYTES_PER_SECOND "dbps"
+#define FIELD_STATS_BUFFER_SIZE_HISTOGRAM "buffer_size_hist"
+#define FIELD_STATS_ARRIVAL_HISTOGRAM "arrival_hist"
+#define FIELD_STATS_TIMESTAMP_GAP_HISTOGRAM "timestamp_gap_hist"
+#define FIELD_STATS_MAX_GAP "max_gap"
+#define FIELD_STATS_TRANSITION_STALL_HISTOGRAM "transition_stall_hist"
+#define FIELD_STATS_TRANSITION_JUMP_HISTOGRAM "transition_jump_hist"
+#define FIELD_STATS_DROPPED_BYTES "dropped_bytes"
+#define FIELD_STATS_DROPPED_PACKETS "dropped_packets"
+#define FIELD_STATS_DEGRADED "degraded"
+#define FIELD_STATS_RECONNECTS "reconnects"
+#define FIELD_STATS_DOWNTIME "downtime"
+#define FIELD_STATS_LOST_PACKETS "lost_packets"
+#define FIELD_STATS_REORDERED_PACKETS "reordered_packets"
+#define FIELD_STATS_DUPLICATE_PACKETS "duplicate_packets"
+#define FIELD_STATS_CLIENTS "clients"
+#define FIELD_STATS_EVICTED_CLIENTS "evicted_clients"
+
+#define FIELD_HISTOGRAM_BOUND "bound"
+#define FIELD_HISTOGRAM_BUCKETS "buckets"
+#define FIELD_HISTOGRAM_COUNT "count"
+#define FIELD_HISTOGRAM_SUM "sum"
+
+namespace {
+
+json_object* MakeHistogramJson(const iptv_cloud::HistogramSnapshot& hist) {
+  json_object* jhist = json_object_new_object();
+  json_object_object_add(jhist, FIELD_HISTOGRAM_BOUND, json_object_new_int64(hist.first_bound));
+  json_object* jbuckets = json_object_new_array();
+  for (size_t i = 0; i < iptv_cloud::HistogramSnapshot::buckets_count; ++i) {
+    json_object_array_add(jbuckets, json_object_new_int64(hist.buckets[i]));
+  }
+  json_object_object_add(jhist, FIELD_HISTOGRAM_BUCKETS, jbuckets);
+  json_object_object_add(jhist, FIELD_HISTOGRAM_COUNT, json_object_new_int64(hist.count));
+  json_object_object_add(jhist, FIELD_HISTOGRAM_SUM, json_object_new_int64(hist.sum));
+  return jhist;
+}
+
+bool ParseHistogramJson(json_object* jhist, iptv_cloud::HistogramSnapshot* hist) {
+  iptv_cloud::HistogramSnapshot lhist;
+  json_object* jbound = nullptr;
+  if (json_object_object_get_ex(jhist, FIELD_HISTOGRAM_BOUND, &jbound)) {
+    lhist.first_bound = json_object_get_int64(jbound);
+  }
+
+  json_object* jbuckets = nullptr;
+  if (!json_object_object_get_ex(jhist, FIELD_HISTOGRAM_BUCKETS, &jbuckets) ||
+      !json_object_is_type(jbuckets, json_type_array) ||
+      json_object_array_length(jbuckets) != iptv_cloud::HistogramSnapshot::buckets_count) {
+    return false;
+  }
+
+  for (size_t i = 0; i < iptv_cloud::HistogramSnapshot::buckets_count; ++i) {
+    lhist.buckets[i] = json_object_get_int64(json_object_array_get_idx(jbuckets, i));
+  }
+
+  json_object* jcount = nullptr;
+  if (json_object_object_get_ex(jhist, FIELD_HISTOGRAM_COUNT, &jcount)) {
+    lhist.count = json_object_get_int64(jcount);
+  }
+
+  json_object* jsum = nullptr;
+  if (json_object_object_get_ex(jhist, FIELD_HISTOGRAM_SUM, &jsum)) {
+    lhist.sum = json_object_get_int64(jsum);
+  }
+
+  *hist = lhist;
+  return true;
+}
+
+}  // namespace
 
 namespace iptv_cloud {
 namespace details {
@@ -54,6 +124,26 @@ common::Error ChannelStatsInfo::SerializeFields(json_object* out) const {
   std::string dbps_str = common::ConvertToString(dbps);
   json_object_object_add(out, FIELD_STATS_DESIRE_BYTES_PER_SECOND, json_object_new_string(dbps_str.c_str()));
 
+  json_object_object_add(out, FIELD_STATS_BUFFER_SIZE_HISTOGRAM, MakeHistogramJson(stats_.GetBufferSizeHistogram()));
+  json_object_object_add(out, FIELD_STATS_ARRIVAL_HISTOGRAM, MakeHistogramJson(stats_.GetArrivalHistogram()));
+  json_object_object_add(out, FIELD_STATS_TIMESTAMP_GAP_HISTOGRAM,
+                         MakeHistogramJson(stats_.GetTimestampGapHistogram()));
+  json_object_object_add(out, FIELD_STATS_MAX_GAP, json_object_new_int64(stats_.GetMaxGap()));
+  json_object_object_add(out, FIELD_STATS_TRANSITION_STALL_HISTOGRAM,
+                         MakeHistogramJson(stats_.GetTransitionStallHistogram()));
+  json_object_object_add(out, FIELD_STATS_TRANSITION_JUMP_HISTOGRAM,
+                         MakeHistogramJson(stats_.GetTransitionJumpHistogram()));
+  json_object_object_add(out, FIELD_STATS_DROPPED_BYTES, json_object_new_int64(stats_.GetDroppedBytes()));
+  json_object_object_add(out, FIELD_STATS_DROPPED_PACKETS, json_object_new_int64(stats_.GetDroppedPackets()));
+  json_object_object_add(out, FIELD_STATS_DEGRADED, json_object_new_boolean(stats_.IsDegraded()));
+  json_object_object_add(out, FIELD_STATS_RECONNECTS, json_object_new_int64(stats_.GetReconnects()));
+  json_object_object_add(out, FIELD_STATS_DOWNTIME, json_object_new_int64(stats_.GetDowntime()));
+  json_object_object_add(out, FIELD_STATS_LOST_PACKETS, json_object_new_int64(stats_.GetLostPackets()));
+  json_object_object_add(out, FIELD_STATS_REORDERED_PACKETS, json_object_new_int64(stats_.GetReorderedPackets()));
+  json_object_object_add(out, FIELD_STATS_DUPLICATE_PACKETS, json_object_new_int64(stats_.GetDuplicatePackets()));
+  json_object_object_add(out, FIELD_STATS_CLIENTS, json_object_new_int64(stats_.GetClients()));
+  json_object_object_add(out, FIELD_STATS_EVICTED_CLIENTS, json_object_new_int64(stats_.GetEvictedClients()));
+
   return common::Error();
 }
 
@@ -96,6 +186,103 @@ common::Error ChannelStatsInfo::DoDeSerialize(json_object* serialized) {
     stats.SetDesireBytesPerSecond(dbps);
   }
 
+  json_object* jhist = nullptr;
+  HistogramSnapshot hist;
+  if (json_object_object_get_ex(serialized, FIELD_STATS_BUFFER_SIZE_HISTOGRAM, &jhist) &&
+      ParseHistogramJson(jhist, &hist)) {
+    stats.SetBufferSizeHistogram(hist);
+  }
+
+  if (json_object_object_get_ex(serialized, FIELD_STATS_ARRIVAL_HISTOGRAM, &jhist) &&
+      ParseHistogramJson(jhist, &hist)) {
+    stats.SetArrivalHistogram(hist);
+  }
+
+  if (json_object_object_get_ex(serialized, FIELD_STATS_TIMESTAMP_GAP_HISTOGRAM, &jhist) &&
+      ParseHistogramJson(jhist, &hist)) {
+    stats.SetTimestampGapHistogram(hist);
+  }
+
+  json_object* jmax_gap = nullptr;
+  json_bool jmax_gap_exists = json_object_object_get_ex(serialized, FIELD_STATS_MAX_GAP, &jmax_gap);
+  if (jmax_gap_exists) {
+    stats.SetMaxGap(json_object_get_int64(jmax_gap));
+  }
+
+  if (json_object_object_get_ex(serialized, FIELD_STATS_TRANSITION_STALL_HISTOGRAM, &jhist) &&
+      ParseHistogramJson(jhist, &hist)) {
+    stats.SetTransitionStallHistogram(hist);
+  }
+
+  if (json_object_object_get_ex(serialized, FIELD_STATS_TRANSITION_JUMP_HISTOGRAM, &jhist) &&
+      ParseHistogramJson(jhist, &hist)) {
+    stats.SetTransitionJumpHistogram(hist);
+  }
+
+  json_object* jdropped_bytes = nullptr;
+  json_bool jdropped_bytes_exists = json_object_object_get_ex(serialized, FIELD_STATS_DROPPED_BYTES, &jdropped_bytes);
+  if (jdropped_bytes_exists) {
+    stats.SetDroppedBytes(json_object_get_int64(jdropped_bytes));
+  }
+
+  json_object* jdropped_packets = nullptr;
+  json_bool jdropped_packets_exists =
+      json_object_object_get_ex(serialized, FIELD_STATS_DROPPED_PACKETS, &jdropped_packets);
+  if (jdropped_packets_exists) {
+    stats.SetDroppedPackets(json_object_get_int64(jdropped_packets));
+  }
+
+  json_object* jdegraded = nullptr;
+  json_bool jdegraded_exists = json_object_object_get_ex(serialized, FIELD_STATS_DEGRADED, &jdegraded);
+  if (jdegraded_exists) {
+    stats.SetDegraded(json_object_get_boolean(jdegraded));
+  }
+
+  json_object* jreconnects = nullptr;
+  json_bool jreconnects_exists = json_object_object_get_ex(serialized, FIELD_STATS_RECONNECTS, &jreconnects);
+  if (jreconnects_exists) {
+    stats.SetReconnects(json_object_get_int64(jreconnects));
+  }
+
+  json_object* jdowntime = nullptr;
+  json_bool jdowntime_exists = json_object_object_get_ex(serialized, FIELD_STATS_DOWNTIME, &jdowntime);
+  if (jdowntime_exists) {
+    stats.SetDowntime(json_object_get_int64(jdowntime));
+  }
+
+  json_object* jlost_packets = nullptr;
+  json_bool jlost_packets_exists = json_object_object_get_ex(serialized, FIELD_STATS_LOST_PACKETS, &jlost_packets);
+  if (jlost_packets_exists) {
+    stats.SetLostPackets(json_object_get_int64(jlost_packets));
+  }
+
+  json_object* jreordered_packets = nullptr;
+  json_bool jreordered_packets_exists =
+      json_object_object_get_ex(serialized, FIELD_STATS_REORDERED_PACKETS, &jreordered_packets);
+  if (jreordered_packets_exists) {
+    stats.SetReorderedPackets(json_object_get_int64(jreordered_packets));
+  }
+
+  json_object* jduplicate_packets = nullptr;
+  json_bool jduplicate_packets_exists =
+      json_object_object_get_ex(serialized, FIELD_STATS_DUPLICATE_PACKETS, &jduplicate_packets);
+  if (jduplicate_packets_exists) {
+    stats.SetDuplicatePackets(json_object_get_int64(jduplicate_packets));
+  }
+
+  json_object* jclients = nullptr;
+  json_bool jclients_exists = json_object_object_get_ex(serialized, FIELD_STATS_CLIENTS, &jclients);
+  if (jclients_exists) {
+    stats.SetClients(json_object_get_int64(jclients));
+  }
+
+  json_object* jevicted_clients = nullptr;
+  json_bool jevicted_clients_exists =
+      json_object_object_get_ex(serialized, FIELD_STATS_EVICTED_CLIENTS, &jevicted_clients);
+  if (jevicted_clients_exists) {
+    stats.SetEvictedClients(json_object_get_int64(jevicted_clients));
+  }
+
   *this = ChannelStatsInfo(stats);
   return common::Error();
 }
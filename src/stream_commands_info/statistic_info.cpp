@@ -27,16 +27,17 @@
 #define FIELD_STREAM_RESTARTS "restarts"
 #define FIELD_STREAM_START_TIME "start_time"
 #define FIELD_STREAM_TIMESTAMP "timestamp"
+#define FIELD_STREAM_FIRST_OUTPUT "first_output"
 
 #define FIELD_STREAM_INPUT_STREAMS "input_streams"
 #define FIELD_STREAM_OUTPUT_STREAMS "output_streams"
 
 namespace iptv_cloud {
 
-StatisticInfo::StatisticInfo() : stream_struct_(), cpu_load_(), rss_(), timestamp_() {}
+StatisticInfo::StatisticInfo() : stream_struct_(), cpu_load_(), rss_(), timestamp_(), first_output_() {}
 
-StatisticInfo::StatisticInfo(const StreamStruct& str, cpu_load_t cpu_load, rss_t rss, time_t time)
-    : stream_struct_(), cpu_load_(cpu_load), rss_(rss), timestamp_(time) {
+StatisticInfo::StatisticInfo(const StreamStruct& str, cpu_load_t cpu_load, rss_t rss, time_t time, time_t first_output)
+    : stream_struct_(), cpu_load_(cpu_load), rss_(rss), timestamp_(time), first_output_(first_output) {
   input_channels_info_t input;
   for (auto it = str.input.rbegin(); it != str.input.rend(); ++it) {
     ChannelStats copy = *(*it);
@@ -73,6 +74,10 @@ time_t StatisticInfo::GetTimestamp() const {
   return timestamp_;
 }
 
+time_t StatisticInfo::GetFirstOutput() const {
+  return first_output_;
+}
+
 common::Error StatisticInfo::SerializeFields(json_object* out) const {
   if (!stream_struct_ || !stream_struct_->IsValid()) {
     return common::make_error_inval();
@@ -115,6 +120,7 @@ common::Error StatisticInfo::SerializeFields(json_object* out) const {
   json_object_object_add(out, FIELD_STREAM_RESTARTS, json_object_new_int64(stream_struct_->restarts));
   json_object_object_add(out, FIELD_STREAM_START_TIME, json_object_new_int(stream_struct_->start_time));
   json_object_object_add(out, FIELD_STREAM_TIMESTAMP, json_object_new_int64(timestamp_));
+  json_object_object_add(out, FIELD_STREAM_FIRST_OUTPUT, json_object_new_int64(first_output_));
   return common::Error();
 }
 
@@ -217,8 +223,15 @@ common::Error StatisticInfo::DoDeSerialize(json_object* serialized) {
     loop_start_time = json_object_get_int64(jloop_start_time);
   }
 
+  time_t first_output = 0;
+  json_object* jfirst_output = nullptr;
+  json_bool jfirst_output_exists = json_object_object_get_ex(serialized, FIELD_STREAM_FIRST_OUTPUT, &jfirst_output);
+  if (jfirst_output_exists) {
+    first_output = json_object_get_int64(jfirst_output);
+  }
+
   StreamStruct strct(cid, type, st, input, output, start_time, loop_start_time, restarts);
-  *this = StatisticInfo(strct, cpu_load, rss, time);
+  *this = StatisticInfo(strct, cpu_load, rss, time, first_output);
   return common::Error();
 }
 
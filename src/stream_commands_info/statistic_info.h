@@ -30,12 +30,13 @@ class StatisticInfo : public common::serializer::JsonSerializer<StatisticInfo> {
   typedef std::shared_ptr<StreamStruct> stream_struct_t;
 
   StatisticInfo();
-  StatisticInfo(const StreamStruct& str, cpu_load_t cpu_load, rss_t rss, time_t time);
+  StatisticInfo(const StreamStruct& str, cpu_load_t cpu_load, rss_t rss, time_t time, time_t first_output);
 
   stream_struct_t GetStreamStruct() const;
   cpu_load_t GetCpuLoad() const;
   rss_t GetRss() const;
   time_t GetTimestamp() const;
+  time_t GetFirstOutput() const;  // msec, 0 if nothing was sent yet
 
  protected:
   common::Error SerializeFields(json_object* out) const override;
@@ -46,6 +47,7 @@ class StatisticInfo : public common::serializer::JsonSerializer<StatisticInfo> {
   cpu_load_t cpu_load_;
   rss_t rss_;
   time_t timestamp_;
+  time_t first_output_;
 };
 
 }  // namespace iptv_cloud
@@ -14,7 +14,10 @@
 
 #include "utils/m3u8_writer.h"
 
+#include <string>
+
 #include "utils/chunk_info.h"
+#include "utils/variant_info.h"
 
 namespace iptv_cloud {
 namespace utils {
@@ -45,6 +48,25 @@ common::ErrnoError M3u8Writer::WriteFooter() {
   return file_.WriteBuffer("#EXT-X-ENDLIST", &writed);
 }
 
+common::ErrnoError M3u8Writer::WriteMasterHeader() {
+  size_t writed;
+  // all variants are cut on the same keyframes
+  return file_.WriteBuffer("#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-INDEPENDENT-SEGMENTS\n", &writed);
+}
+
+common::ErrnoError M3u8Writer::WriteVariant(const VariantInfo& variant) {
+  std::string attrs = common::MemSPrintf("BANDWIDTH=%llu", variant.bandwidth);
+  if (variant.width && variant.height) {
+    attrs += common::MemSPrintf(",RESOLUTION=%dx%d", variant.width, variant.height);
+  }
+  if (!variant.codecs.empty()) {
+    attrs += common::MemSPrintf(",CODECS=\"%s\"", variant.codecs);
+  }
+
+  size_t writed;
+  return file_.WriteBuffer(common::MemSPrintf("#EXT-X-STREAM-INF:%s\n%s\n", attrs, variant.uri), &writed);
+}
+
 common::ErrnoError M3u8Writer::Close() {
   return file_.Close();
 }
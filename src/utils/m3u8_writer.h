@@ -20,6 +20,7 @@ namespace iptv_cloud {
 namespace utils {
 
 struct ChunkInfo;
+struct VariantInfo;
 
 class M3u8Writer {
  public:
@@ -31,6 +32,9 @@ class M3u8Writer {
   common::ErrnoError WriteHeader(uint64_t first_index, size_t target_duration) WARN_UNUSED_RESULT;
   common::ErrnoError WriteLine(const ChunkInfo& chunks) WARN_UNUSED_RESULT;
   common::ErrnoError WriteFooter() WARN_UNUSED_RESULT;
+
+  common::ErrnoError WriteMasterHeader() WARN_UNUSED_RESULT;
+  common::ErrnoError WriteVariant(const VariantInfo& variant) WARN_UNUSED_RESULT;
   common::ErrnoError Close() WARN_UNUSED_RESULT;
 
  private:
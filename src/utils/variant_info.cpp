@@ -0,0 +1,114 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "utils/variant_info.h"
+
+#include <stdlib.h>
+
+#include <common/sprintf.h>
+
+namespace {
+
+// "3.1" => 31, "4" => 40
+int ParseLevel(const std::string& level) {
+  if (level == "1b") {
+    return 11;
+  }
+
+  char* end = nullptr;
+  const double lvl = strtod(level.c_str(), &end);
+  if (end == level.c_str() || lvl <= 0) {
+    return 0;
+  }
+
+  return static_cast<int>(lvl * 10 + 0.5);
+}
+
+}  // namespace
+
+namespace iptv_cloud {
+namespace utils {
+
+VariantInfo::VariantInfo() : bandwidth(0), width(0), height(0), codecs(), uri() {}
+
+bool VariantInfo::IsValid() const {
+  return bandwidth != 0 && !uri.empty();
+}
+
+std::string MakeH264CodecTag(const std::string& profile, const std::string& level) {
+  int profile_idc = 0;
+  int constraints = 0;
+  if (profile == "constrained-baseline") {
+    profile_idc = 0x42;
+    constraints = 0xE0;
+  } else if (profile == "baseline") {
+    profile_idc = 0x42;
+  } else if (profile == "main") {
+    profile_idc = 0x4D;
+    constraints = 0x40;
+  } else if (profile == "extended") {
+    profile_idc = 0x58;
+  } else if (profile == "high") {
+    profile_idc = 0x64;
+  } else if (profile == "high-10") {
+    profile_idc = 0x6E;
+  } else if (profile == "high-4:2:2") {
+    profile_idc = 0x7A;
+  } else if (profile == "high-4:4:4") {
+    profile_idc = 0xF4;
+  } else {
+    return std::string();
+  }
+
+  const int level_idc = ParseLevel(level);
+  if (!level_idc) {
+    return std::string();
+  }
+
+  return common::MemSPrintf("avc1.%02X%02X%02X", profile_idc, constraints, level_idc);
+}
+
+std::string MakeH265CodecTag(const std::string& profile, const std::string& level) {
+  int profile_idc = 0;
+  int compatibility = 0;
+  if (profile == "main") {
+    profile_idc = 1;
+    compatibility = 6;
+  } else if (profile == "main-10") {
+    profile_idc = 2;
+    compatibility = 4;
+  } else {
+    return std::string();
+  }
+
+  const int level_idc = ParseLevel(level) * 3;  // general_level_idc is level * 30
+  if (!level_idc) {
+    return std::string();
+  }
+
+  return common::MemSPrintf("hvc1.%d.%d.L%d.B0", profile_idc, compatibility, level_idc);
+}
+
+std::string MakeMpegAudioCodecTag(int mpegversion) {
+  if (mpegversion == 2 || mpegversion == 4) {
+    return "mp4a.40.2";  // aac lc
+  } else if (mpegversion == 1) {
+    return "mp4a.40.34";  // mp3
+  }
+
+  return std::string();
+}
+
+}  // namespace utils
+}  // namespace iptv_cloud
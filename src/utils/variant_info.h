@@ -0,0 +1,43 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+namespace iptv_cloud {
+namespace utils {
+
+// one EXT-X-STREAM-INF entry of hls master playlist
+struct VariantInfo {
+  VariantInfo();
+
+  bool IsValid() const;
+
+  uint64_t bandwidth;  // bits per second, peak
+  int width;           // 0 if unknown
+  int height;          // 0 if unknown
+  std::string codecs;  // rfc 6381 tags, comma separated
+  std::string uri;     // media playlist
+};
+
+// rfc 6381 codec tags from caps fields, empty string if profile not known
+std::string MakeH264CodecTag(const std::string& profile, const std::string& level);  // avc1.PPCCLL
+std::string MakeH265CodecTag(const std::string& profile, const std::string& level);  // hvc1.P.C.LXX.B0
+std::string MakeMpegAudioCodecTag(int mpegversion);                                  // mp4a.40.X
+
+}  // namespace utils
+}  // namespace iptv_cloud
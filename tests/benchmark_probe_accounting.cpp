@@ -0,0 +1,72 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "base/channel_stats.h"
+#include "base/stream_struct.h"
+
+namespace {
+// per buffer accounting of probes before channel slots were bound at probe creation
+void LegacyUpdateStats(const iptv_cloud::StreamStruct& str, const std::string& name, size_t id, size_t size) {
+  if (name == "in") {
+    iptv_cloud::input_channels_info_t ins = str.input;
+    if (id < ins.size()) {
+      iptv_cloud::ChannelStats* cahnnel_info = ins[id];
+      cahnnel_info->SetTotalBytes(cahnnel_info->GetTotalBytes() + size);
+    }
+  } else if (name == "out") {
+    iptv_cloud::output_channels_info_t outs = str.output;
+    if (id < outs.size()) {
+      iptv_cloud::ChannelStats* cahnnel_info = outs[id];
+      cahnnel_info->SetTotalBytes(cahnnel_info->GetTotalBytes() + size);
+    }
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t buffers = 1000000;
+  if (argc > 1) {
+    buffers = std::stoul(argv[1]);
+  }
+
+  iptv_cloud::StreamInfo sha;
+  sha.id = "test";
+  sha.input = {0, 1};
+  sha.output = {2, 3, 4, 5};
+  iptv_cloud::StreamStruct str(sha);
+  const std::string probe_name = "out";
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < buffers; ++i) {
+    LegacyUpdateStats(str, probe_name, 3, 1316);
+  }
+  const auto legacy = std::chrono::steady_clock::now() - start;
+
+  iptv_cloud::ChannelStats* slot = str.output[3];  // what probe keeps
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < buffers; ++i) {
+    slot->UpdateData(1316, 1);
+  }
+  const auto bound = std::chrono::steady_clock::now() - start;
+
+  const auto legacy_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(legacy).count();
+  const auto bound_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(bound).count();
+  std::cout << buffers << " buffers, legacy: " << legacy_ns / buffers << " ns/buffer, bound slot: "
+            << bound_ns / buffers << " ns/buffer, total bytes: " << slot->GetTotalBytes() << std::endl;
+  return 0;
+}
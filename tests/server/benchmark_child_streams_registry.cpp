@@ -0,0 +1,101 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "base/stream_struct.h"
+
+#include "server/child_streams_registry.h"
+#include "server/pipe/pipe_client.h"
+
+namespace {
+struct StreamHolder {
+  explicit StreamHolder(const iptv_cloud::stream_id_t& sid)
+      : mem(iptv_cloud::StreamInfo{sid, iptv_cloud::RELAY, {}, {}}),
+        client(nullptr, INVALID_DESCRIPTOR, INVALID_DESCRIPTOR),
+        stream(nullptr, &mem, 0, false) {
+    stream.SetClient(&client);
+  }
+
+  iptv_cloud::StreamStruct mem;
+  iptv_cloud::server::pipe::ProtocoledPipeClient client;
+  iptv_cloud::server::ChildStream stream;
+};
+
+typedef std::vector<std::unique_ptr<StreamHolder>> holders_t;
+
+holders_t MakeStreams(size_t count) {
+  holders_t streams;
+  for (size_t i = 0; i < count; ++i) {
+    streams.emplace_back(new StreamHolder("stream_" + std::to_string(i)));
+  }
+  return streams;
+}
+
+// how daemon searched streams before registry
+iptv_cloud::server::ChildStream* LinearFind(const holders_t& streams, const iptv_cloud::stream_id_t& sid) {
+  for (const auto& holder : streams) {
+    if (holder->stream.GetStreamID() == sid) {
+      return &holder->stream;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t count = 10000;
+  if (argc > 1) {
+    count = std::stoul(argv[1]);
+  }
+
+  holders_t streams = MakeStreams(count);
+  iptv_cloud::server::ChildStreamsRegistry registry;
+  for (const auto& holder : streams) {
+    registry.Add(&holder->stream);
+    registry.BindClient(&holder->client, &holder->stream);
+  }
+
+  std::vector<iptv_cloud::stream_id_t> ids;
+  for (size_t i = 0; i < count; i += 10) {
+    ids.push_back(streams[(i * 7919) % count]->stream.GetStreamID());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  size_t linear_found = 0;
+  for (const auto& sid : ids) {
+    linear_found += LinearFind(streams, sid) != nullptr;
+  }
+  const auto linear = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  size_t registry_found = 0;
+  for (const auto& sid : ids) {
+    registry_found += registry.FindByID(sid) != nullptr;
+  }
+  for (const auto& holder : streams) {
+    registry_found += registry.FindByClient(&holder->client) != nullptr;
+  }
+  const auto hashed = std::chrono::steady_clock::now() - start;
+
+  const auto linear_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(linear).count();
+  const auto hashed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(hashed).count();
+  std::cout << count << " streams, linear: " << linear_ns / ids.size() << " ns/lookup (" << linear_found
+            << " found), registry: " << hashed_ns / (ids.size() + count) << " ns/lookup (" << registry_found
+            << " found)" << std::endl;
+  return 0;
+}
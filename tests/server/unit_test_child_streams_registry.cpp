@@ -0,0 +1,89 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/stream_struct.h"
+
+#include "server/child_streams_registry.h"
+#include "server/pipe/pipe_client.h"
+
+namespace {
+struct StreamHolder {
+  explicit StreamHolder(const iptv_cloud::stream_id_t& sid)
+      : mem(iptv_cloud::StreamInfo{sid, iptv_cloud::RELAY, {}, {}}),
+        client(nullptr, INVALID_DESCRIPTOR, INVALID_DESCRIPTOR),
+        stream(nullptr, &mem, 0, false) {
+    stream.SetClient(&client);
+  }
+
+  iptv_cloud::StreamStruct mem;
+  iptv_cloud::server::pipe::ProtocoledPipeClient client;
+  iptv_cloud::server::ChildStream stream;
+};
+
+typedef std::vector<std::unique_ptr<StreamHolder>> holders_t;
+
+holders_t MakeStreams(size_t count) {
+  holders_t streams;
+  for (size_t i = 0; i < count; ++i) {
+    streams.emplace_back(new StreamHolder("stream_" + std::to_string(i)));
+  }
+  return streams;
+}
+}  // namespace
+
+TEST(ChildStreamsRegistry, add_find_remove) {
+  holders_t streams = MakeStreams(3);
+  iptv_cloud::server::ChildStreamsRegistry registry;
+  for (const auto& holder : streams) {
+    ASSERT_TRUE(registry.Add(&holder->stream));
+    ASSERT_TRUE(registry.BindClient(&holder->client, &holder->stream));
+  }
+  ASSERT_EQ(registry.Size(), 3);
+  ASSERT_FALSE(registry.Add(&streams[0]->stream));
+  ASSERT_FALSE(registry.Add(nullptr));
+
+  ASSERT_EQ(registry.FindByID("stream_1"), &streams[1]->stream);
+  ASSERT_EQ(registry.FindByClient(&streams[2]->client), &streams[2]->stream);
+  ASSERT_EQ(registry.FindByID("unknown"), nullptr);
+
+  // pipe closed, stream still running
+  ASSERT_EQ(registry.UnBindClient(&streams[1]->client), &streams[1]->stream);
+  ASSERT_EQ(registry.FindByClient(&streams[1]->client), nullptr);
+  ASSERT_EQ(registry.FindByID("stream_1"), &streams[1]->stream);
+  ASSERT_EQ(registry.UnBindClient(&streams[1]->client), nullptr);
+
+  // process exited
+  ASSERT_EQ(registry.Remove("stream_2"), &streams[2]->stream);
+  ASSERT_EQ(registry.FindByID("stream_2"), nullptr);
+  ASSERT_EQ(registry.FindByClient(&streams[2]->client), nullptr);
+  ASSERT_EQ(registry.Remove("stream_2"), nullptr);
+  ASSERT_EQ(registry.Size(), 2);
+
+  // started again with same id
+  StreamHolder restarted("stream_2");
+  ASSERT_TRUE(registry.Add(&restarted.stream));
+  ASSERT_TRUE(registry.BindClient(&restarted.client, &restarted.stream));
+  ASSERT_EQ(registry.FindByID("stream_2"), &restarted.stream);
+  ASSERT_EQ(registry.FindByClient(&restarted.client), &restarted.stream);
+
+  // not registered stream can't take client
+  StreamHolder unknown("stream_3");
+  ASSERT_FALSE(registry.BindClient(&unknown.client, &unknown.stream));
+  ASSERT_EQ(registry.GetStreams().size(), 3);
+}
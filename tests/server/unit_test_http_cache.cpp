@@ -0,0 +1,92 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "server/http/http_cache.h"
+
+namespace {
+iptv_cloud::server::HttpCache::CachedFile MakeFile(size_t size) {
+  return iptv_cloud::server::HttpCache::CachedFile(
+      iptv_cloud::server::HttpCache::content_t(new std::string(size, 'x')), 0);
+}
+}  // namespace
+
+TEST(HttpCache, cacheable) {
+  ASSERT_TRUE(iptv_cloud::server::HttpCache::IsCacheableFile("/var/www/1/master.m3u8"));
+  ASSERT_TRUE(iptv_cloud::server::HttpCache::IsCacheableFile("/var/www/1/1.ts"));
+  ASSERT_FALSE(iptv_cloud::server::HttpCache::IsCacheableFile("/var/www/1/1.mp4"));
+  ASSERT_FALSE(iptv_cloud::server::HttpCache::IsCacheableFile("ts"));
+}
+
+TEST(HttpCache, hit_miss) {
+  iptv_cloud::server::HttpCache cache(1024);
+  iptv_cloud::server::HttpCache::CachedFile file;
+  ASSERT_FALSE(cache.Find("/1/1.ts", &file));
+  ASSERT_TRUE(cache.Insert("/1/1.ts", MakeFile(100)));
+  ASSERT_TRUE(cache.Find("/1/1.ts", &file));
+  ASSERT_EQ(file.content->size(), 100);
+
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.hits, 1);
+  ASSERT_EQ(stats.misses, 1);
+  ASSERT_EQ(stats.size, 100);
+  ASSERT_EQ(stats.entries, 1);
+
+  // too big for one entry
+  ASSERT_FALSE(cache.Insert("/1/2.ts", MakeFile(cache.GetMaxEntrySize() + 1)));
+
+  iptv_cloud::server::HttpCache disabled(0);
+  ASSERT_FALSE(disabled.IsEnabled());
+  ASSERT_FALSE(disabled.Insert("/1/1.ts", MakeFile(1)));
+}
+
+TEST(HttpCache, lru_eviction) {
+  iptv_cloud::server::HttpCache cache(800);
+  ASSERT_TRUE(cache.Insert("/1/1.ts", MakeFile(100)));
+  ASSERT_TRUE(cache.Insert("/1/2.ts", MakeFile(100)));
+  for (size_t i = 3; i <= 8; ++i) {
+    ASSERT_TRUE(cache.Insert("/1/" + std::to_string(i) + ".ts", MakeFile(100)));
+  }
+
+  iptv_cloud::server::HttpCache::CachedFile file;
+  ASSERT_TRUE(cache.Find("/1/1.ts", &file));  // 2.ts least recently used now
+  ASSERT_TRUE(cache.Insert("/1/9.ts", MakeFile(100)));
+  ASSERT_FALSE(cache.Find("/1/2.ts", &file));
+  ASSERT_TRUE(cache.Find("/1/1.ts", &file));
+
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.evictions, 1);
+  ASSERT_EQ(stats.size, 800);
+  ASSERT_EQ(stats.entries, 8);
+}
+
+TEST(HttpCache, invalidation) {
+  iptv_cloud::server::HttpCache cache(1024);
+  ASSERT_TRUE(cache.Insert("/1/master.m3u8", MakeFile(10)));
+  ASSERT_TRUE(cache.Insert("/1/1.ts", MakeFile(10)));
+  ASSERT_TRUE(cache.Insert("/2/1.ts", MakeFile(10)));
+
+  cache.Invalidate("/1/master.m3u8");
+  iptv_cloud::server::HttpCache::CachedFile file;
+  ASSERT_FALSE(cache.Find("/1/master.m3u8", &file));
+
+  cache.InvalidateDirectory("/1/");
+  ASSERT_FALSE(cache.Find("/1/1.ts", &file));
+  ASSERT_TRUE(cache.Find("/2/1.ts", &file));
+
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.invalidations, 2);
+  ASSERT_EQ(stats.entries, 1);
+}
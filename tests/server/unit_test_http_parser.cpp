@@ -0,0 +1,81 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "server/http/http_request_parser.h"
+
+#define FIRST_REQUEST "GET /1/master.m3u8 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+#define SECOND_REQUEST "GET /1/1.ts HTTP/1.1\r\nHost: localhost\r\n\r\n"
+#define POST_REQUEST "POST /1 HTTP/1.1\r\ncontent-length: 4\r\n\r\ntest"
+
+TEST(HttpRequestParser, splitted) {
+  iptv_cloud::server::HttpRequestParser parser;
+  const std::string request = FIRST_REQUEST;
+  std::string out;
+  for (size_t i = 0; i < request.size() - 1; ++i) {
+    parser.Append(&request[i], 1);
+    ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::NEED_MORE_DATA);
+  }
+
+  parser.Append(&request[request.size() - 1], 1);
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::REQUEST_READY);
+  ASSERT_EQ(out, request);
+  ASSERT_EQ(parser.GetBufferedSize(), 0);
+}
+
+TEST(HttpRequestParser, pipelined) {
+  iptv_cloud::server::HttpRequestParser parser;
+  const std::string data = FIRST_REQUEST SECOND_REQUEST "\r\n" POST_REQUEST "GET /1/2";
+  parser.Append(data.c_str(), data.size());
+
+  std::string out;
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::REQUEST_READY);
+  ASSERT_EQ(out, FIRST_REQUEST);
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::REQUEST_READY);
+  ASSERT_EQ(out, SECOND_REQUEST);
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::REQUEST_READY);
+  ASSERT_EQ(out, POST_REQUEST);
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::NEED_MORE_DATA);
+
+  const std::string tail = ".ts HTTP/1.1\r\n\r\n";
+  parser.Append(tail.c_str(), tail.size());
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::REQUEST_READY);
+  ASSERT_EQ(out, "GET /1/2.ts HTTP/1.1\r\n\r\n");
+}
+
+TEST(HttpRequestParser, invalid) {
+  iptv_cloud::server::HttpRequestParser parser;
+  const std::string chunked = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+  parser.Append(chunked.c_str(), chunked.size());
+  std::string out;
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::BAD_REQUEST);
+
+  parser.Reset();
+  const std::string huge(iptv_cloud::server::HttpRequestParser::max_request_size + 1, 'a');
+  parser.Append(huge.c_str(), huge.size());
+  ASSERT_EQ(parser.Next(&out), iptv_cloud::server::HttpRequestParser::REQUEST_TOO_LARGE);
+}
+
+TEST(HttpRequestParser, keep_alive) {
+  ASSERT_TRUE(iptv_cloud::server::HttpRequestParser::IsKeepAlive(nullptr, true));
+  ASSERT_FALSE(iptv_cloud::server::HttpRequestParser::IsKeepAlive(nullptr, false));
+
+  const std::string keep_alive = "keep-alive";
+  ASSERT_TRUE(iptv_cloud::server::HttpRequestParser::IsKeepAlive(&keep_alive, false));
+  const std::string close = "Upgrade, Close";
+  ASSERT_FALSE(iptv_cloud::server::HttpRequestParser::IsKeepAlive(&close, true));
+  const std::string other = "TE";
+  ASSERT_TRUE(iptv_cloud::server::HttpRequestParser::IsKeepAlive(&other, true));
+}
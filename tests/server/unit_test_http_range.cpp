@@ -0,0 +1,73 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "server/http/http_range.h"
+
+TEST(HttpRange, parse) {
+  iptv_cloud::server::HttpRange range;
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=0-99", 1000, &range), iptv_cloud::server::RANGE_SATISFIABLE);
+  ASSERT_EQ(range.first, 0);
+  ASSERT_EQ(range.last, 99);
+  ASSERT_EQ(range.GetLength(), 100);
+  ASSERT_EQ(iptv_cloud::server::MakeContentRange(range, 1000), "bytes 0-99/1000");
+
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=900-", 1000, &range), iptv_cloud::server::RANGE_SATISFIABLE);
+  ASSERT_EQ(range.first, 900);
+  ASSERT_EQ(range.last, 999);
+
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=-100", 1000, &range), iptv_cloud::server::RANGE_SATISFIABLE);
+  ASSERT_EQ(range.first, 900);
+  ASSERT_EQ(range.last, 999);
+
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=-5000", 1000, &range),
+            iptv_cloud::server::RANGE_SATISFIABLE);
+  ASSERT_EQ(range.first, 0);
+
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=500-5000", 1000, &range),
+            iptv_cloud::server::RANGE_SATISFIABLE);
+  ASSERT_EQ(range.last, 999);
+}
+
+TEST(HttpRange, rejected) {
+  iptv_cloud::server::HttpRange range;
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=1000-", 1000, &range),
+            iptv_cloud::server::RANGE_NOT_SATISFIABLE);
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=-0", 1000, &range),
+            iptv_cloud::server::RANGE_NOT_SATISFIABLE);
+  ASSERT_EQ(iptv_cloud::server::MakeUnsatisfiedContentRange(1000), "bytes */1000");
+
+  // ignored, whole file
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=0-1,5-10", 1000, &range), iptv_cloud::server::RANGE_NONE);
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("items=0-1", 1000, &range), iptv_cloud::server::RANGE_NONE);
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=10-1", 1000, &range), iptv_cloud::server::RANGE_NONE);
+  ASSERT_EQ(iptv_cloud::server::ParseRangeHeader("bytes=a-1", 1000, &range), iptv_cloud::server::RANGE_NONE);
+}
+
+TEST(HttpRange, conditional) {
+  const std::string etag = iptv_cloud::server::MakeETag(1000, 0x5c000000);
+  ASSERT_EQ(etag, "\"5c000000-3e8\"");
+  ASSERT_TRUE(iptv_cloud::server::IsETagMatched(etag, etag));
+  ASSERT_TRUE(iptv_cloud::server::IsETagMatched("\"1-1\", W/" + etag, etag));
+  ASSERT_TRUE(iptv_cloud::server::IsETagMatched("*", etag));
+  ASSERT_FALSE(iptv_cloud::server::IsETagMatched("\"1-1\"", etag));
+  ASSERT_TRUE(iptv_cloud::server::IsETagStrongMatched(etag, etag));
+  ASSERT_FALSE(iptv_cloud::server::IsETagStrongMatched("W/" + etag, etag));
+
+  time_t date = 0;
+  ASSERT_TRUE(iptv_cloud::server::ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT", &date));
+  ASSERT_EQ(date, 784111777);
+  ASSERT_FALSE(iptv_cloud::server::ParseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT", &date));
+}
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "server/ingest_registry.h"
+
+TEST(IngestRegistry, first_consumer_spawns_last_stops) {
+  iptv_cloud::server::IngestRegistry registry("/tmp/ingest");
+  const std::string input = "udp://239.0.0.1:1234";
+
+  bool spawn = false;
+  iptv_cloud::server::IngestRegistry::Ingest* ingest = registry.Acquire(input, "relay_1", &spawn);
+  ASSERT_TRUE(ingest);
+  ASSERT_TRUE(spawn);
+  ASSERT_EQ(ingest->id, iptv_cloud::server::IngestRegistry::MakeIngestID(input));
+  ASSERT_EQ(ingest->socket_path, "/tmp/ingest/" + ingest->id + ".sock");
+
+  ASSERT_EQ(registry.Acquire(input, "encode_1", &spawn), ingest);
+  ASSERT_FALSE(spawn);
+  ASSERT_EQ(registry.Acquire(input, "encode_2", &spawn), ingest);
+  ASSERT_EQ(ingest->consumers.size(), 3);
+
+  bool other_spawn = false;
+  iptv_cloud::server::IngestRegistry::Ingest* other = registry.Acquire("udp://239.0.0.2:1234", "relay_2", &other_spawn);
+  ASSERT_TRUE(other_spawn);
+  ASSERT_NE(other->id, ingest->id);
+  ASSERT_EQ(registry.Size(), 2);
+
+  ASSERT_FALSE(registry.Release("encode_1"));
+  ASSERT_FALSE(registry.Release("relay_1"));
+  ASSERT_FALSE(registry.Release("unknown"));
+  ASSERT_EQ(registry.Release("encode_2"), ingest);  // stop it
+  ASSERT_FALSE(registry.SetStopped(ingest->id));
+  ASSERT_FALSE(registry.FindByID(iptv_cloud::server::IngestRegistry::MakeIngestID(input)));
+  ASSERT_EQ(registry.Size(), 1);
+}
+
+TEST(IngestRegistry, crashed_ingest_restarted_for_consumers) {
+  iptv_cloud::server::IngestRegistry registry("/tmp/ingest");
+  const std::string input = "rtmp://127.0.0.1/live/feed";
+
+  bool spawn = false;
+  iptv_cloud::server::IngestRegistry::Ingest* ingest = registry.Acquire(input, "relay_1", &spawn);
+  ASSERT_TRUE(spawn);
+  ASSERT_EQ(registry.SetStopped(ingest->id), ingest);
+  ASSERT_TRUE(ingest->running);
+
+  // stop requested, new consumer came before ingest exited
+  ASSERT_EQ(registry.Release("relay_1"), ingest);
+  ASSERT_EQ(registry.Acquire(input, "relay_2", &spawn), ingest);
+  ASSERT_FALSE(spawn);
+  ASSERT_EQ(registry.SetStopped(ingest->id), ingest);
+
+  ASSERT_EQ(registry.Release("relay_2"), ingest);
+  ASSERT_FALSE(registry.SetStopped(ingest->id));
+  ASSERT_EQ(registry.Size(), 0);
+}
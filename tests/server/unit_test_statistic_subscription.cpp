@@ -0,0 +1,112 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include "server/commands_info/service/subscribe_info.h"
+#include "server/statistic_subscription.h"
+
+TEST(StatisticSubscription, everything_by_default) {
+  iptv_cloud::server::StatisticSubscription sub;
+  ASSERT_TRUE(sub.WantsStreamStatistic("first", 1000));
+  ASSERT_TRUE(sub.WantsServiceStatistic(1000));
+  ASSERT_FALSE(sub.HasPending());
+
+  sub.AddStreamStatistic("first", "msg", 1000);
+  ASSERT_TRUE(sub.WantsStreamStatistic("first", 1000));  // no interval
+}
+
+TEST(StatisticSubscription, filters) {
+  iptv_cloud::server::StatisticSubscription sub;
+  iptv_cloud::server::service::SubscribeInfo info({"first"}, true, 0, false, 0);
+  sub.Subscribe(info);
+  ASSERT_TRUE(sub.WantsStreamStatistic("first", 1000));
+  ASSERT_FALSE(sub.WantsStreamStatistic("second", 1000));
+  ASSERT_FALSE(sub.WantsServiceStatistic(1000));
+
+  sub.Unsubscribe();
+  ASSERT_FALSE(sub.WantsStreamStatistic("first", 1000));
+  ASSERT_FALSE(sub.WantsServiceStatistic(1000));
+}
+
+TEST(StatisticSubscription, intervals) {
+  iptv_cloud::server::StatisticSubscription sub;
+  iptv_cloud::server::service::SubscribeInfo info({}, true, 5, true, 10);
+  sub.Subscribe(info);
+
+  sub.AddStreamStatistic("first", "msg", 1000);
+  ASSERT_FALSE(sub.WantsStreamStatistic("first", 3000));
+  ASSERT_TRUE(sub.WantsStreamStatistic("second", 3000));
+  ASSERT_TRUE(sub.WantsStreamStatistic("first", 6000));
+
+  sub.AddServiceStatistic("service", 1000);
+  ASSERT_FALSE(sub.WantsServiceStatistic(6000));
+  ASSERT_TRUE(sub.WantsServiceStatistic(11000));
+}
+
+TEST(StatisticSubscription, coalescing) {
+  iptv_cloud::server::StatisticSubscription sub;
+  sub.AddStreamStatistic("first", "first_1", 1000);
+  sub.AddServiceStatistic("service_1", 1000);
+  sub.AddStreamStatistic("second", "second_1", 1000);
+  sub.AddStreamStatistic("first", "first_2", 2000);
+  sub.AddServiceStatistic("service_2", 2000);
+  ASSERT_EQ(sub.GetPendingCount(), 3);
+
+  ASSERT_EQ(sub.FrontPending().sid, "first");
+  ASSERT_EQ(sub.FrontPending().message, "first_2");
+  sub.PopPending();
+  ASSERT_EQ(sub.FrontPending().message, "service_2");
+  sub.PopPending();
+
+  sub.RemoveStream("second");
+  ASSERT_FALSE(sub.HasPending());
+
+  sub.AddStreamStatistic("first", "first_3", 3000);
+  ASSERT_EQ(sub.GetPendingCount(), 1);
+  ASSERT_EQ(sub.FrontPending().message, "first_3");
+}
+
+TEST(StatisticSubscription, events_inside_interval) {
+  iptv_cloud::server::StatisticSubscription sub;
+  iptv_cloud::server::service::SubscribeInfo info({"first"}, true, 5, false, 0);
+  sub.Subscribe(info);
+  ASSERT_TRUE(sub.WantsStreamEvent("first"));
+  ASSERT_FALSE(sub.WantsStreamEvent("second"));
+
+  sub.AddStreamStatistic("first", "stats_1", 1000);
+  ASSERT_FALSE(sub.WantsStreamStatistic("first", 2000));
+  ASSERT_TRUE(sub.WantsStreamEvent("first"));  // status changed inside interval
+  sub.AddStreamEvent("first", "started");
+  sub.AddStreamEvent("first", "failed");
+  sub.AddStreamStatistic("first", "stats_2", 7000);
+  ASSERT_EQ(sub.GetPendingCount(), 3);
+
+  ASSERT_EQ(sub.FrontPending().message, "stats_2");
+  sub.PopPending();
+  ASSERT_EQ(sub.FrontPending().message, "started");
+  ASSERT_TRUE(sub.FrontPending().event);
+  sub.PopPending();
+  ASSERT_EQ(sub.FrontPending().message, "failed");
+  sub.PopPending();
+  ASSERT_FALSE(sub.HasPending());
+
+  // stream finished, its last status still goes out
+  sub.AddStreamEvent("first", "stopped");
+  sub.RemoveStream("first");
+  ASSERT_EQ(sub.GetPendingCount(), 1);
+
+  sub.Unsubscribe();
+  ASSERT_FALSE(sub.WantsStreamEvent("first"));
+}
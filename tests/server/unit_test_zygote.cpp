@@ -0,0 +1,76 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "server/zygote.h"
+
+namespace {
+int Preload() {
+  return EXIT_SUCCESS;
+}
+
+// echo config into responce pipe, stats fd is checked to be passed
+int ChildMain(const std::string& config, int read_command_fd, int write_responce_fd, int stats_fd) {
+  if (read_command_fd == INVALID_DESCRIPTOR || stats_fd == INVALID_DESCRIPTOR) {
+    return EXIT_FAILURE;
+  }
+
+  ssize_t res = write(write_responce_fd, config.data(), config.size());
+  return res == static_cast<ssize_t>(config.size()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}  // namespace
+
+TEST(Zygote, spawn) {
+  iptv_cloud::server::Zygote zygote(Preload, ChildMain);
+  ASSERT_FALSE(zygote.IsRunning());
+  common::ErrnoError err = zygote.Start();
+  ASSERT_FALSE(err);
+  ASSERT_TRUE(zygote.IsRunning());
+
+  for (size_t i = 0; i < 3; ++i) {
+    int command[2];
+    int responce[2];
+    ASSERT_EQ(pipe(command), 0);
+    ASSERT_EQ(pipe(responce), 0);
+
+    const std::string config = "{\"id\": \"" + std::to_string(i) + "\"}";
+    pid_t pid = 0;
+    err = zygote.Spawn(config, command[0], responce[1], command[1], &pid);
+    ASSERT_FALSE(err);
+    ASSERT_GT(pid, 0);
+    close(command[0]);
+    close(command[1]);
+    close(responce[1]);
+
+    char buff[256] = {0};
+    ssize_t nread = read(responce[0], buff, sizeof(buff));
+    close(responce[0]);
+    ASSERT_EQ(std::string(buff, nread), config);
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);  // reparented to us
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), EXIT_SUCCESS);
+  }
+
+  zygote.Stop();
+  ASSERT_FALSE(zygote.IsRunning());
+  pid_t pid = 0;
+  err = zygote.Spawn("{}", 0, 1, 2, &pid);
+  ASSERT_TRUE(err);
+}
@@ -0,0 +1,135 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gst/gst.h>
+
+#include "base/constants.h"
+#include "stream/file_block_reader.h"
+
+namespace {
+
+const size_t kLegacyBufferSize = 4096;  // what playlist streams read before
+
+std::string MakeTempFile(size_t size) {
+  char path[] = "/tmp/iptv_cloud_playlist_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd == -1) {
+    return std::string();
+  }
+
+  std::vector<char> chunk(1024 * 1024);
+  for (size_t i = 0; i < chunk.size(); ++i) {
+    chunk[i] = static_cast<char>(i * 7);
+  }
+  for (size_t written = 0; written < size; written += chunk.size()) {
+    if (write(fd, chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size())) {
+      close(fd);
+      unlink(path);
+      return std::string();
+    }
+  }
+  close(fd);
+  return path;
+}
+
+uint64_t CpuTimeUsec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+size_t LegacyRead(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return 0;
+  }
+
+  size_t total = 0;
+  while (true) {
+    char* ptr = static_cast<char*>(calloc(kLegacyBufferSize, sizeof(char)));
+    size_t size = fread(ptr, sizeof(char), kLegacyBufferSize, file);
+    if (size == 0) {
+      free(ptr);
+      break;
+    }
+    GstBuffer* buffer = gst_buffer_new_wrapped(ptr, size);
+    total += gst_buffer_get_size(buffer);
+    gst_buffer_unref(buffer);
+  }
+  fclose(file);
+  return total;
+}
+
+size_t BlockRead(const std::string& path, size_t block_size, bool* mapped) {
+  iptv_cloud::stream::FileBlockReader reader(block_size);
+  common::ErrnoError err = reader.Open(path);
+  if (err) {
+    return 0;
+  }
+
+  *mapped = reader.IsMapped();
+  size_t total = 0;
+  while (true) {
+    GstBuffer* buffer = nullptr;
+    err = reader.ReadBlock(&buffer);
+    if (err || !buffer) {
+      break;
+    }
+    total += gst_buffer_get_size(buffer);
+    gst_buffer_unref(buffer);
+  }
+  return total;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  gst_init(&argc, &argv);
+  size_t file_size = 64 * 1024 * 1024;
+  if (argc > 1) {
+    file_size = std::stoul(argv[1]) * 1024 * 1024;
+  }
+
+  const std::string path = MakeTempFile(file_size);
+  if (path.empty()) {
+    std::cerr << "can't create temp file" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const double mbits = file_size * 8 / 1000000.0;
+
+  LegacyRead(path);  // warm page cache, both runs read from memory
+  uint64_t start = CpuTimeUsec();
+  const size_t legacy_total = LegacyRead(path);
+  const uint64_t legacy = CpuTimeUsec() - start;
+
+  bool mapped = false;
+  start = CpuTimeUsec();
+  const size_t block_total = BlockRead(path, DEFAULT_PLAYLIST_BLOCK_SIZE, &mapped);
+  const uint64_t block = CpuTimeUsec() - start;
+  unlink(path.c_str());
+
+  std::cout << "legacy: " << legacy / mbits << " cpu usec/Mbit (" << legacy_total << " bytes), block reader"
+            << (mapped ? " (mapped)" : " (pool)") << ": " << block / mbits << " cpu usec/Mbit (" << block_total
+            << " bytes)" << std::endl;
+  return EXIT_SUCCESS;
+}
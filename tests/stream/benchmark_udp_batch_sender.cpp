@@ -0,0 +1,115 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "stream/udp_batch_sender.h"
+
+namespace {
+
+typedef iptv_cloud::stream::UdpBatchSender UdpBatchSender;
+
+// bound loopback socket, port in *port
+int make_receiver(uint16_t* port) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (fd == -1 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+    return -1;
+  }
+
+  socklen_t len = sizeof(addr);
+  getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len);
+  *port = ntohs(addr.sin_port);
+  return fd;
+}
+
+std::vector<uint8_t> make_ts_packets(size_t count) {
+  std::vector<uint8_t> data(count * UdpBatchSender::ts_packet_size, 0xff);
+  for (size_t i = 0; i < count; ++i) {
+    data[i * UdpBatchSender::ts_packet_size] = 0x47;
+    data[i * UdpBatchSender::ts_packet_size + 1] = static_cast<uint8_t>(i);
+  }
+  return data;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t datagrams = 200000;
+  if (argc > 1) {
+    datagrams = std::stoul(argv[1]) / 1000 * 1000;
+  }
+
+  uint16_t port = 0;
+  int receiver = make_receiver(&port);
+  if (receiver == -1) {
+    std::cerr << "can't bind receiver" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<uint8_t> data = make_ts_packets(UdpBatchSender::ts_packets_per_datagram * 1000);
+
+  // what udpsink does, one syscall per datagram
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+    std::cerr << "can't connect sender" << std::endl;
+    close(receiver);
+    return EXIT_FAILURE;
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < datagrams; ++i) {
+    send(fd, &data[(i % 1000) * UdpBatchSender::datagram_size], UdpBatchSender::datagram_size, 0);
+  }
+  const auto single = std::chrono::steady_clock::now() - start;
+  close(fd);
+
+  UdpBatchSender sender;
+  sender.SetPacing(false);
+  common::ErrnoError err = sender.Open(common::net::HostAndPort("127.0.0.1", port));
+  if (err) {
+    std::cerr << "can't open batch sender: " << err->GetDescription() << std::endl;
+    close(receiver);
+    return EXIT_FAILURE;
+  }
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < datagrams / 1000; ++i) {
+    err = sender.Write(data.data(), data.size());
+  }
+  err = sender.Flush();
+  const auto batched = std::chrono::steady_clock::now() - start;
+
+  UdpBatchSender::Stats stats = sender.GetStats();
+  const auto single_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(single).count();
+  const auto batched_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(batched).count();
+  std::cout << datagrams << " datagrams, send: " << single_ns / datagrams << " ns/datagram, " << datagrams
+            << " syscalls, sendmmsg: " << batched_ns / datagrams << " ns/datagram, " << stats.bursts << " syscalls, "
+            << stats.send_errors << " errors" << std::endl;
+  close(receiver);
+  return EXIT_SUCCESS;
+}
@@ -33,6 +33,16 @@ class FakeObserver : public iptv_cloud::stream::IBaseStream::IStreamClient {
   MOCK_METHOD2(OnSyncMessageReceived, void(iptv_cloud::stream::IBaseStream*, GstMessage*));
   MOCK_METHOD2(OnASyncMessageReceived, void(iptv_cloud::stream::IBaseStream*, GstMessage*));
   void OnInputChanged(const iptv_cloud::InputUri& uri) override { UNUSED(uri); }
+  bool OnFindInputCaps(const iptv_cloud::InputUri& uri, iptv_cloud::stream::InputCaps* caps) override {
+    UNUSED(uri);
+    UNUSED(caps);
+    return false;
+  }
+  void OnInputCapsDetected(const iptv_cloud::InputUri& uri, const iptv_cloud::stream::InputCaps& caps) override {
+    UNUSED(uri);
+    UNUSED(caps);
+  }
+  void OnInputCapsMismatch(const iptv_cloud::InputUri& uri) override { UNUSED(uri); }
   GstPadProbeInfo* OnCheckReveivedOutputData(iptv_cloud::stream::IBaseStream* job,
                                              iptv_cloud::stream::Probe* probe,
                                              GstPadProbeInfo* info) override {
@@ -0,0 +1,147 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gst/gst.h>
+
+#include "stream/file_block_reader.h"
+
+namespace {
+
+std::string MakeTempFile(size_t size) {
+  char path[] = "/tmp/iptv_cloud_playlist_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd == -1) {
+    return std::string();
+  }
+
+  std::vector<char> chunk(1024 * 1024);
+  for (size_t i = 0; i < chunk.size(); ++i) {
+    chunk[i] = static_cast<char>(i * 7);
+  }
+  for (size_t written = 0; written < size; written += chunk.size()) {
+    if (write(fd, chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size())) {
+      close(fd);
+      unlink(path);
+      return std::string();
+    }
+  }
+  close(fd);
+  return path;
+}
+
+class FileBlockReaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override { gst_init(nullptr, nullptr); }
+
+  void TearDown() override {
+    if (!path_.empty()) {
+      unlink(path_.c_str());
+    }
+  }
+
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(FileBlockReaderTest, BlocksOutliveReader) {
+  path_ = MakeTempFile(1024 * 1024);
+  ASSERT_FALSE(path_.empty());
+
+  GstBuffer* first = nullptr;
+  {
+    iptv_cloud::stream::FileBlockReader reader(300 * 1024);
+    ASSERT_FALSE(reader.Open(path_));
+    ASSERT_TRUE(reader.IsMapped());
+    ASSERT_FALSE(reader.ReadBlock(&first));
+    ASSERT_TRUE(first);
+    ASSERT_EQ(gst_buffer_get_size(first), 300 * 1024);
+
+    GstBuffer* buffer = nullptr;
+    size_t total = gst_buffer_get_size(first);
+    while (!reader.ReadBlock(&buffer) && buffer) {
+      total += gst_buffer_get_size(buffer);
+      gst_buffer_unref(buffer);
+    }
+    ASSERT_EQ(total, 1024 * 1024);
+  }
+
+  GstMapInfo info;
+  ASSERT_TRUE(gst_buffer_map(first, &info, GST_MAP_READ));  // mapping still alive
+  ASSERT_EQ(info.data[7], static_cast<guint8>(7 * 7));
+  gst_buffer_unmap(first, &info);
+  gst_buffer_unref(first);
+}
+
+TEST_F(FileBlockReaderTest, PoolExhausted) {
+  const size_t block_size = 4096;
+  const size_t blocks = iptv_cloud::stream::FileBlockReader::read_ahead_blocks + 1;
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  std::vector<char> data(block_size * blocks);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i / block_size);
+  }
+  ASSERT_EQ(write(fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+  close(fds[1]);
+
+  iptv_cloud::stream::FileBlockReader reader(block_size);
+  ASSERT_FALSE(reader.Open("/proc/self/fd/" + std::to_string(fds[0])));  // not mappable, blocks from pool
+  close(fds[0]);
+  ASSERT_FALSE(reader.IsMapped());
+
+  std::vector<GstBuffer*> held;
+  for (size_t i = 0; i < iptv_cloud::stream::FileBlockReader::read_ahead_blocks; ++i) {
+    GstBuffer* buffer = nullptr;
+    ASSERT_FALSE(reader.ReadBlock(&buffer));
+    ASSERT_TRUE(buffer);
+    held.push_back(buffer);
+  }
+
+  // every pool buffer is downstream, reader waits until one of them is released
+  GstBuffer* last = nullptr;
+  std::atomic<bool> readed(false);
+  std::thread waiter([&reader, &last, &readed] { readed = !reader.ReadBlock(&last); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(readed);
+  gst_buffer_unref(held[0]);
+  waiter.join();
+  ASSERT_TRUE(readed);
+  ASSERT_TRUE(last);
+  ASSERT_EQ(gst_buffer_get_size(last), block_size);
+
+  GstMapInfo info;
+  ASSERT_TRUE(gst_buffer_map(last, &info, GST_MAP_READ));
+  ASSERT_EQ(info.data[0], static_cast<guint8>(blocks - 1));  // released buffer reused for next block
+  gst_buffer_unmap(last, &info);
+  gst_buffer_unref(last);
+
+  GstBuffer* eof = nullptr;
+  ASSERT_FALSE(reader.ReadBlock(&eof));
+  ASSERT_FALSE(eof);
+  for (size_t i = 1; i < held.size(); ++i) {
+    gst_buffer_unref(held[i]);
+  }
+}
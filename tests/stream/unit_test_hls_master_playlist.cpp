@@ -0,0 +1,101 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gst/gst.h>
+
+#include "stream/hls_master_playlist.h"
+
+namespace {
+
+GstPad* MakeActivePad(const char* name) {
+  GstPad* pad = gst_pad_new(name, GST_PAD_SRC);
+  gst_pad_set_active(pad, TRUE);
+  return pad;
+}
+
+// caps event goes through variant probe, pad has no peer
+void PushCaps(GstPad* pad, const char* caps_str) {
+  gst_pad_push_event(pad, gst_event_new_stream_start(GST_PAD_NAME(pad)));
+  GstCaps* caps = gst_caps_from_string(caps_str);
+  gst_pad_push_event(pad, gst_event_new_caps(caps));
+  gst_caps_unref(caps);
+}
+
+bool ReadFile(const std::string& path, std::string* content) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::stringstream ss;
+  ss << file.rdbuf();
+  *content = ss.str();
+  return true;
+}
+
+}  // namespace
+
+TEST(HlsMasterPlaylist, WriteContent) {
+  gst_init(nullptr, nullptr);
+  char dir[] = "/tmp/iptv_cloud_master_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir));
+  const std::string path = std::string(dir) + "/master.m3u8";
+
+  auto master = std::make_shared<iptv_cloud::stream::HlsMasterPlaylist>(
+      common::file_system::ascii_file_string_path(path), true);
+  ASSERT_EQ(master->AddVariant("720/playlist.m3u8", 2628000), 0);
+  ASSERT_EQ(master->AddVariant("360/playlist.m3u8", 928000), 1);
+
+  GstPad* pads[4] = {MakeActivePad("video_0"), MakeActivePad("audio_0"), MakeActivePad("video_1"),
+                     MakeActivePad("audio_1")};
+  master->LinkPad(0, iptv_cloud::stream::HlsMasterPlaylist::VIDEO_TRACK, pads[0]);
+  master->LinkPad(0, iptv_cloud::stream::HlsMasterPlaylist::AUDIO_TRACK, pads[1]);
+  master->LinkPad(1, iptv_cloud::stream::HlsMasterPlaylist::VIDEO_TRACK, pads[2]);
+  master->LinkPad(1, iptv_cloud::stream::HlsMasterPlaylist::AUDIO_TRACK, pads[3]);
+
+  PushCaps(pads[0], "video/x-h264, width=(int)1280, height=(int)720, profile=(string)main, level=(string)3.1");
+  PushCaps(pads[1], "audio/mpeg, mpegversion=(int)4");
+  PushCaps(pads[2], "video/x-h264, width=(int)640, height=(int)360, profile=(string)constrained-baseline, "
+                    "level=(string)3");
+  std::string content;
+  ASSERT_FALSE(ReadFile(path, &content));  // second variant has no audio caps yet
+
+  PushCaps(pads[3], "audio/x-ac3");  // codec tag unknown, CODECS omitted
+  ASSERT_TRUE(ReadFile(path, &content));
+  ASSERT_EQ(content,
+            "#EXTM3U\n"
+            "#EXT-X-VERSION:3\n"
+            "#EXT-X-INDEPENDENT-SEGMENTS\n"
+            "#EXT-X-STREAM-INF:BANDWIDTH=2628000,RESOLUTION=1280x720,CODECS=\"avc1.4D401F,mp4a.40.2\"\n"
+            "720/playlist.m3u8\n"
+            "#EXT-X-STREAM-INF:BANDWIDTH=928000,RESOLUTION=640x360\n"
+            "360/playlist.m3u8\n");
+
+  for (GstPad* pad : pads) {
+    gst_pad_set_active(pad, FALSE);
+    gst_object_unref(pad);
+  }
+  unlink(path.c_str());
+  rmdir(dir);
+}
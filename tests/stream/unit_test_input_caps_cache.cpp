@@ -0,0 +1,70 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <string>
+
+#include "stream/input_caps_cache.h"
+
+namespace {
+const char kCachePath[] = "/tmp/unit_test_input_caps_cache";
+const char kUrl[] = "http://localhost:8000/live/stream";
+}  // namespace
+
+TEST(InputCapsCache, PersistAcrossRestarts) {
+  unlink(kCachePath);
+  const iptv_cloud::stream::InputCaps caps("video/mpegts", "video/x-h264", "audio/mpeg");
+  {
+    iptv_cloud::stream::InputCapsCache cache(kCachePath);
+    ASSERT_FALSE(cache.Load());
+    ASSERT_EQ(cache.Size(), 0);
+    ASSERT_FALSE(cache.Insert(kUrl, caps));
+    ASSERT_FALSE(cache.Insert("udp://239.0.0.1:5000", iptv_cloud::stream::InputCaps("video/mpegts", "", "")));
+    ASSERT_TRUE(cache.Insert("rtmp://localhost/live", iptv_cloud::stream::InputCaps()));
+  }
+
+  iptv_cloud::stream::InputCapsCache cache(kCachePath);
+  ASSERT_FALSE(cache.Load());
+  ASSERT_EQ(cache.Size(), 2);
+  iptv_cloud::stream::InputCaps loaded;
+  ASSERT_TRUE(cache.Find(kUrl, &loaded));
+  ASSERT_EQ(loaded, caps);
+  ASSERT_TRUE(cache.Find("udp://239.0.0.1:5000", &loaded));
+  ASSERT_TRUE(loaded.video.empty());
+  ASSERT_TRUE(loaded.audio.empty());
+  ASSERT_FALSE(cache.Find("rtmp://localhost/live", &loaded));
+  unlink(kCachePath);
+}
+
+TEST(InputCapsCache, InvalidateOnMismatch) {
+  unlink(kCachePath);
+  iptv_cloud::stream::InputCapsCache cache(kCachePath);
+  ASSERT_FALSE(cache.Insert(kUrl, iptv_cloud::stream::InputCaps("video/mpegts", "video/x-h264", "")));
+  ASSERT_FALSE(cache.Insert(kUrl, iptv_cloud::stream::InputCaps("video/mpegts", "video/x-h265", "")));
+  iptv_cloud::stream::InputCaps loaded;
+  ASSERT_TRUE(cache.Find(kUrl, &loaded));
+  ASSERT_EQ(loaded.video, "video/x-h265");
+
+  ASSERT_FALSE(cache.Remove(kUrl));
+  ASSERT_FALSE(cache.Find(kUrl, &loaded));
+  ASSERT_FALSE(cache.Remove(kUrl));
+
+  iptv_cloud::stream::InputCapsCache reloaded(kCachePath);
+  ASSERT_FALSE(reloaded.Load());
+  ASSERT_EQ(reloaded.Size(), 0);
+  unlink(kCachePath);
+}
@@ -0,0 +1,40 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include "stream/key_unit_scheduler.h"
+
+namespace {
+const uint64_t kMs = 1000000;  // nsec
+}
+
+TEST(KeyUnitScheduler, AlignedToInterval) {
+  iptv_cloud::stream::KeyUnitScheduler scheduler(2000 * kMs);
+  ASSERT_FALSE(scheduler.Check(iptv_cloud::stream::KeyUnitScheduler::invalid_timestamp));
+
+  // 25 fps from 10s, keyframe forced every 50 frames
+  for (uint64_t i = 0; i < 250; ++i) {
+    const bool forced = scheduler.Check(10000 * kMs + i * 40 * kMs);
+    ASSERT_EQ(forced, i != 0 && i % 50 == 0) << i;
+  }
+  ASSERT_EQ(scheduler.GetCount(), 4u);
+
+  // discontinuity, schedule starts over from next frame
+  ASSERT_TRUE(scheduler.Check(100000 * kMs));
+  ASSERT_FALSE(scheduler.Check(100040 * kMs));
+  ASSERT_TRUE(scheduler.Check(102000 * kMs));
+  ASSERT_TRUE(scheduler.Check(500 * kMs));
+  ASSERT_EQ(scheduler.GetCount(), 7u);
+}
@@ -0,0 +1,56 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <gst/gst.h>
+
+#include "stream/elements/muxer/muxer.h"
+#include "stream/streams/builders/src_decodebin_stream_builder.h"
+
+namespace {
+iptv_cloud::stream::elements::SupportedElements MuxerOf(const char* url, bool udp_batch) {
+  return iptv_cloud::stream::elements::muxer::get_muxer_type(common::uri::Url(url).GetScheme(), udp_batch);
+}
+}  // namespace
+
+TEST(OutputGroups, SameContainerSharesMuxer) {
+  gst_init(nullptr, nullptr);
+  using iptv_cloud::stream::streams::builders::GroupOutput;
+  iptv_cloud::stream::elements::ElementTee first_rendition("tee_0");
+  iptv_cloud::stream::elements::ElementTee second_rendition("tee_1");
+
+  iptv_cloud::stream::streams::builders::output_groups_t groups;
+  // tcp and http are both mpegts
+  ASSERT_EQ(GroupOutput(MuxerOf("tcp://localhost:8000", false), &first_rendition, 0, &groups), 0);
+  ASSERT_EQ(GroupOutput(MuxerOf("http://localhost:8001/out.ts", false), &first_rendition, 1, &groups), 0);
+  // other containers get own muxers
+  ASSERT_EQ(GroupOutput(MuxerOf("rtmp://localhost/live/out", false), &first_rendition, 2, &groups), 2);
+  ASSERT_EQ(GroupOutput(MuxerOf("udp://239.0.0.1:5000", false), &first_rendition, 3, &groups), 3);
+  // batched udp is mpegts too
+  ASSERT_EQ(GroupOutput(MuxerOf("udp://239.0.0.1:5002", true), &first_rendition, 4, &groups), 0);
+  // same container of other rendition
+  ASSERT_EQ(GroupOutput(MuxerOf("tcp://localhost:8002", false), &second_rendition, 5, &groups), 5);
+  ASSERT_EQ(GroupOutput(MuxerOf("rtmp://localhost/live/out2", false), &first_rendition, 6, &groups), 2);
+
+  ASSERT_EQ(groups.size(), 4);
+  ASSERT_EQ(groups[0].muxer, iptv_cloud::stream::elements::ELEMENT_MPEGTS_MUX);
+  ASSERT_EQ(groups[0].outputs, std::vector<size_t>({0, 1, 4}));
+  ASSERT_EQ(groups[1].muxer, iptv_cloud::stream::elements::ELEMENT_FLV_MUX);
+  ASSERT_EQ(groups[1].outputs, std::vector<size_t>({2, 6}));
+  ASSERT_EQ(groups[2].muxer, iptv_cloud::stream::elements::ELEMENT_RTP_MUX);
+  ASSERT_EQ(groups[2].outputs, std::vector<size_t>({3}));
+  ASSERT_EQ(groups[3].video, &second_rendition);
+  ASSERT_EQ(groups[3].outputs, std::vector<size_t>({5}));
+}
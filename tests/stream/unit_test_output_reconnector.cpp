@@ -0,0 +1,129 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <gst/gst.h>
+
+#include "base/channel_stats.h"
+#include "stream/output_reconnector.h"
+
+namespace {
+const gint64 kMinBackoff = iptv_cloud::stream::OutputReconnector::min_backoff_msec * G_TIME_SPAN_MILLISECOND;
+const gint64 kMaxBackoff = iptv_cloud::stream::OutputReconnector::max_backoff_msec * G_TIME_SPAN_MILLISECOND;
+
+GstBuffer* MakeBuffer(bool keyframe) {
+  GstBuffer* buffer = gst_buffer_new_allocate(nullptr, 188, nullptr);
+  if (!keyframe) {
+    GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  }
+  return buffer;
+}
+}  // namespace
+
+TEST(ReconnectBackoff, Exponential) {
+  iptv_cloud::stream::ReconnectBackoff backoff(kMinBackoff, kMaxBackoff);
+  ASSERT_FALSE(backoff.IsOutage());
+
+  gint64 now = 100 * kMaxBackoff;
+  ASSERT_EQ(backoff.Failed(now), now + kMinBackoff);  // first outage
+  ASSERT_TRUE(backoff.IsOutage());
+  ASSERT_EQ(backoff.GetOutageStart(), now);
+
+  // server stays down, relinked sink fails again and again
+  ASSERT_EQ(backoff.Failed(now + kMinBackoff), now + kMinBackoff * 3);
+  ASSERT_EQ(backoff.GetBackoff(), kMinBackoff * 2);
+  for (size_t i = 0; i < 10; ++i) {
+    backoff.Failed(now);
+  }
+  ASSERT_EQ(backoff.GetBackoff(), kMaxBackoff);
+  ASSERT_EQ(backoff.GetOutageStart(), now);
+
+  // data passed sink, flapping server continues backoff
+  now += 10 * kMaxBackoff;
+  backoff.Connected(now);
+  ASSERT_FALSE(backoff.IsOutage());
+  ASSERT_EQ(backoff.Failed(now + kMinBackoff), now + kMinBackoff + kMaxBackoff);
+  backoff.Connected(now + kMaxBackoff);
+
+  // stable long enough, starts from min again
+  now += 3 * kMaxBackoff;
+  ASSERT_EQ(backoff.Failed(now), now + kMinBackoff);
+}
+
+TEST(OutputReconnector, StateMachine) {
+  gst_init(nullptr, nullptr);
+  GstElement* pipeline = gst_pipeline_new("pipeline");
+  GstElement* tee = gst_element_factory_make("tee", "tee_0");
+  GstElement* queue = gst_element_factory_make("queue", "output_queue_0");
+  GstElement* sink = gst_element_factory_make("fakesink", "sink_0");
+  g_object_set(sink, "async", FALSE, "sync", FALSE, nullptr);
+  gst_bin_add_many(GST_BIN(pipeline), tee, queue, sink, nullptr);
+  ASSERT_TRUE(gst_element_link_many(tee, queue, sink, nullptr));
+  ASSERT_NE(gst_element_set_state(pipeline, GST_STATE_PLAYING), GST_STATE_CHANGE_FAILURE);
+
+  iptv_cloud::ChannelStats stats(0);
+  iptv_cloud::stream::OutputReconnector* reconnector =
+      new iptv_cloud::stream::OutputReconnector(0, &stats, queue, sink);
+  ASSERT_EQ(reconnector->GetState(), iptv_cloud::stream::OutputReconnector::CONNECTED);
+  ASSERT_FALSE(reconnector->IsReconnecting());
+
+  GstPad* queue_pad = gst_element_get_static_pad(queue, "sink");
+  GstPad* tee_pad = gst_pad_get_peer(queue_pad);
+  gst_pad_push_event(tee_pad, gst_event_new_stream_start("output"));
+  GstCaps* caps = gst_caps_new_empty_simple("video/mpegts");
+  gst_pad_push_event(tee_pad, gst_event_new_caps(caps));
+  gst_caps_unref(caps);
+  GstSegment segment;
+  gst_segment_init(&segment, GST_FORMAT_TIME);
+  gst_pad_push_event(tee_pad, gst_event_new_segment(&segment));
+
+  // tee pad is idle, branch unlinked at once
+  reconnector->HandleError();
+  ASSERT_EQ(reconnector->GetState(), iptv_cloud::stream::OutputReconnector::DISCONNECTED);
+  ASSERT_FALSE(gst_pad_is_linked(queue_pad));
+  ASSERT_EQ(gst_pad_push(tee_pad, MakeBuffer(true)), GST_FLOW_OK);  // dropped by gate
+
+  const gint64 failed_at = g_get_monotonic_time();
+  reconnector->Check(failed_at);
+  ASSERT_EQ(reconnector->GetState(), iptv_cloud::stream::OutputReconnector::DISCONNECTED);
+  ASSERT_TRUE(reconnector->IsReconnecting());
+
+  // relinked, but reconnected only when data passed sink
+  reconnector->Check(failed_at + kMinBackoff);
+  ASSERT_EQ(reconnector->GetState(), iptv_cloud::stream::OutputReconnector::CONNECTED);
+  ASSERT_TRUE(gst_pad_is_linked(queue_pad));
+  ASSERT_TRUE(reconnector->IsReconnecting());
+  reconnector->Check(failed_at + kMinBackoff);
+  ASSERT_EQ(stats.GetReconnects(), 0);
+
+  ASSERT_EQ(gst_pad_push(tee_pad, MakeBuffer(false)), GST_FLOW_OK);  // waits for keyframe
+  for (size_t i = 0; i < iptv_cloud::stream::OutputReconnector::confirm_buffers; ++i) {
+    ASSERT_EQ(gst_pad_push(tee_pad, MakeBuffer(i == 0)), GST_FLOW_OK);
+  }
+  for (size_t i = 0; i < 500 && reconnector->IsReconnecting(); ++i) {  // queue thread pushes into sink
+    usleep(10000);
+    reconnector->Check(g_get_monotonic_time());
+  }
+  ASSERT_FALSE(reconnector->IsReconnecting());
+  ASSERT_EQ(stats.GetReconnects(), 1);
+
+  gst_object_unref(tee_pad);
+  gst_object_unref(queue_pad);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  delete reconnector;
+  gst_object_unref(pipeline);
+}
@@ -0,0 +1,182 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <gst/gst.h>
+
+#include "stream/elements/element.h"
+#include "stream/streams/relay/relay_stream.h"
+
+namespace {
+const char kCachePath[] = "/tmp/unit_test_relay_stream_caps_cache";
+const char kUrl[] = "http://localhost:8000/live/stream.ts";
+
+typedef iptv_cloud::stream::IBaseStream IBaseStream;
+typedef iptv_cloud::stream::InputCaps InputCaps;
+
+// caps cache of controller, written at once
+class CapsCacheClient : public IBaseStream::IStreamClient {
+ public:
+  CapsCacheClient() : cache(kCachePath), mismatches(0) {}
+
+  void OnStatusChanged(IBaseStream* stream, iptv_cloud::StreamStatus status) override {
+    UNUSED(stream);
+    UNUSED(status);
+  }
+  void OnPipelineEOS(IBaseStream* stream) override { UNUSED(stream); }
+  void OnTimeoutUpdated(IBaseStream* stream) override { UNUSED(stream); }
+  void OnProbeEvent(IBaseStream* stream, iptv_cloud::stream::Probe* probe, GstEvent* event) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    UNUSED(event);
+  }
+  void OnSyncMessageReceived(IBaseStream* stream, GstMessage* message) override {
+    UNUSED(stream);
+    UNUSED(message);
+  }
+  void OnASyncMessageReceived(IBaseStream* stream, GstMessage* message) override {
+    UNUSED(stream);
+    UNUSED(message);
+  }
+  GstPadProbeInfo* OnCheckReveivedOutputData(IBaseStream* stream,
+                                             iptv_cloud::stream::Probe* probe,
+                                             GstPadProbeInfo* info) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    return info;
+  }
+  GstPadProbeInfo* OnCheckReveivedData(IBaseStream* stream,
+                                       iptv_cloud::stream::Probe* probe,
+                                       GstPadProbeInfo* info) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    return info;
+  }
+  void OnInputChanged(const iptv_cloud::InputUri& uri) override { UNUSED(uri); }
+  bool OnFindInputCaps(const iptv_cloud::InputUri& uri, InputCaps* caps) override {
+    return cache.Find(uri.GetInput().GetUrl(), caps);
+  }
+  void OnInputCapsDetected(const iptv_cloud::InputUri& uri, const InputCaps& caps) override {
+    ASSERT_FALSE(cache.Insert(uri.GetInput().GetUrl(), caps));
+  }
+  void OnInputCapsMismatch(const iptv_cloud::InputUri& uri) override {
+    mismatches++;
+    ASSERT_FALSE(cache.Remove(uri.GetInput().GetUrl()));
+  }
+  void OnPipelineCreated(IBaseStream* stream) override { UNUSED(stream); }
+
+  iptv_cloud::stream::InputCapsCache cache;
+  size_t mismatches;
+};
+
+class CachedRelayStream : public iptv_cloud::stream::streams::RelayStream {
+ public:
+  CachedRelayStream(const iptv_cloud::stream::streams::RelayConfig* config,
+                    IStreamClient* client,
+                    iptv_cloud::StreamStruct* stats)
+      : RelayStream(config, client, stats) {}
+
+  using RelayStream::FindCachedDemuxer;
+  using RelayStream::HandleAsyncBusMessageReceived;
+  using RelayStream::OnDemuxerCreated;
+};
+
+void post_error(CachedRelayStream* stream, GstElement* src, GQuark domain, gint code) {
+  GError* err = g_error_new_literal(domain, code, "test error");
+  GstMessage* message = gst_message_new_error(GST_OBJECT(src), err, "test");
+  g_error_free(err);
+  stream->HandleAsyncBusMessageReceived(nullptr, message);
+  gst_message_unref(message);
+}
+}  // namespace
+
+TEST(RelayStream, CachedCapsInvalidatedByDemuxerOnly) {
+  gst_init(nullptr, nullptr);
+  iptv_cloud::stream::streams_init(0, nullptr);
+  unlink(kCachePath);
+
+  iptv_cloud::input_t input = {iptv_cloud::InputUri(0, common::uri::Url(kUrl))};
+  const iptv_cloud::stream::Config base(iptv_cloud::RELAY, 10, input, iptv_cloud::output_t());
+  iptv_cloud::stream::streams::RelayConfig config((iptv_cloud::stream::streams::AudioVideoConfig(base)));
+  config.SetFastPath(true);
+  iptv_cloud::StreamStruct stats(iptv_cloud::StreamInfo{"relay", iptv_cloud::RELAY, {0}, {}});
+
+  CapsCacheClient client;
+  ASSERT_FALSE(client.cache.Insert(kUrl, InputCaps("video/mpegts", "video/x-h264", "audio/mpeg")));
+  CachedRelayStream* stream = new CachedRelayStream(&config, &client, &stats);
+  iptv_cloud::stream::SupportedDemuxer demuxer_type;
+  ASSERT_TRUE(stream->FindCachedDemuxer(&demuxer_type));
+  ASSERT_EQ(demuxer_type, iptv_cloud::stream::VIDEO_MPEGTS_DEMUXER);
+
+  GstElement* src = gst_element_factory_make("fakesrc", "src_0");
+  gst_object_ref_sink(src);
+  iptv_cloud::stream::elements::ElementTsDemux* demuxer = new iptv_cloud::stream::elements::ElementTsDemux("demuxer_0");
+  gst_object_ref_sink(demuxer->GetGstElement());
+  stream->OnDemuxerCreated(demuxer, demuxer_type);
+
+  // source is down, 404 or timed out, input container is still the cached one
+  post_error(stream, src, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_NOT_FOUND);
+  post_error(stream, src, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_READ);
+  post_error(stream, src, GST_STREAM_ERROR, GST_STREAM_ERROR_FAILED);
+  post_error(stream, demuxer->GetGstElement(), GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_READ);
+  ASSERT_EQ(client.mismatches, 0);
+  InputCaps caps;
+  ASSERT_TRUE(client.cache.Find(kUrl, &caps));
+
+  // demuxer can't parse input or its pads aren't negotiated
+  post_error(stream, demuxer->GetGstElement(), GST_STREAM_ERROR, GST_STREAM_ERROR_DEMUX);
+  ASSERT_EQ(client.mismatches, 1);
+  ASSERT_FALSE(client.cache.Find(kUrl, &caps));
+  post_error(stream, demuxer->GetGstElement(), GST_STREAM_ERROR, GST_STREAM_ERROR_FAILED);
+  ASSERT_EQ(client.mismatches, 1);
+
+  delete stream;
+  GstElement* demuxer_element = demuxer->GetGstElement();
+  delete demuxer;  // disconnects pad-added callback
+  gst_object_unref(demuxer_element);
+  gst_object_unref(src);
+  unlink(kCachePath);
+}
+
+TEST(RelayStream, AutopluggedDemuxerErrorKeepsCache) {
+  gst_init(nullptr, nullptr);
+  iptv_cloud::stream::streams_init(0, nullptr);
+  unlink(kCachePath);
+
+  iptv_cloud::input_t input = {iptv_cloud::InputUri(0, common::uri::Url(kUrl))};
+  const iptv_cloud::stream::Config base(iptv_cloud::RELAY, 10, input, iptv_cloud::output_t());
+  iptv_cloud::stream::streams::RelayConfig config((iptv_cloud::stream::streams::AudioVideoConfig(base)));
+  config.SetFastPath(true);
+  iptv_cloud::StreamStruct stats(iptv_cloud::StreamInfo{"relay", iptv_cloud::RELAY, {0}, {}});
+
+  // nothing cached, demuxer is guessed from url
+  CapsCacheClient client;
+  CachedRelayStream* stream = new CachedRelayStream(&config, &client, &stats);
+  iptv_cloud::stream::SupportedDemuxer demuxer_type;
+  ASSERT_FALSE(stream->FindCachedDemuxer(&demuxer_type));
+
+  iptv_cloud::stream::elements::ElementTsDemux* demuxer = new iptv_cloud::stream::elements::ElementTsDemux("demuxer_0");
+  gst_object_ref_sink(demuxer->GetGstElement());
+  stream->OnDemuxerCreated(demuxer, iptv_cloud::stream::VIDEO_MPEGTS_DEMUXER);
+  post_error(stream, demuxer->GetGstElement(), GST_STREAM_ERROR, GST_STREAM_ERROR_DEMUX);
+  ASSERT_EQ(client.mismatches, 0);
+
+  delete stream;
+  GstElement* demuxer_element = demuxer->GetGstElement();
+  delete demuxer;  // disconnects pad-added callback
+  gst_object_unref(demuxer_element);
+}
@@ -0,0 +1,116 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <gst/gst.h>
+
+#include "stream/elements/element.h"
+#include "stream/elements/sink/shm.h"
+#include "stream/streams/builders/ingest_stream_builder.h"
+
+namespace {
+const guint kShmSize = 1024 * 1024;
+const gsize kBufferSize = 64 * 1024;
+const size_t kBuffers = 512;  // 32 MB, over shm area and ingest queue together
+
+GstPadProbeReturn count_buffers(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  UNUSED(info);
+  static_cast<std::atomic<size_t>*>(user_data)->fetch_add(1);
+  return GST_PAD_PROBE_OK;
+}
+
+// reader attached to control socket of shmsink, never acks buffers nor reads notifications
+int connect_reader(const std::string& path) {
+  for (int i = 0; i < 200; ++i) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0) {
+      return fd;
+    }
+    close(fd);
+    usleep(10000);
+  }
+  return -1;
+}
+}  // namespace
+
+TEST(SharedIngest, StalledReaderDoesntBlockSource) {
+  gst_init(nullptr, nullptr);
+  const std::string path = "/tmp/unit_test_shared_ingest_" + std::to_string(getpid());
+  GstElement* pipeline = gst_pipeline_new("ingest");
+  GstElement* src = gst_element_factory_make("appsrc", "src_0");
+  // blocks pushing thread as soon as its streaming thread can't push into ingest queue
+  g_object_set(src, "block", TRUE, "max-bytes", static_cast<guint64>(kBufferSize * 2), nullptr);
+  iptv_cloud::stream::elements::ElementQueue* queue = iptv_cloud::stream::streams::builders::make_ingest_queue();
+  iptv_cloud::stream::elements::sink::ElementShmSink* sink =
+      iptv_cloud::stream::elements::sink::make_shm_sink(path, kShmSize, 0);
+  gst_bin_add_many(GST_BIN(pipeline), src, queue->GetGstElement(), sink->GetGstElement(), nullptr);
+  ASSERT_TRUE(gst_element_link_many(src, queue->GetGstElement(), sink->GetGstElement(), nullptr));
+
+  std::atomic<size_t> rendered(0);
+  GstPad* sink_pad = gst_element_get_static_pad(sink->GetGstElement(), "sink");
+  gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_BUFFER, count_buffers, &rendered, nullptr);
+  gst_object_unref(sink_pad);
+  ASSERT_NE(gst_element_set_state(pipeline, GST_STATE_PLAYING), GST_STATE_CHANGE_FAILURE);
+
+  int reader = connect_reader(path);
+  ASSERT_NE(reader, -1);
+
+  std::atomic<size_t> pushed(0);
+  std::thread source([src, &pushed] {
+    for (size_t i = 0; i < kBuffers; ++i) {
+      GstBuffer* buffer = gst_buffer_new_allocate(nullptr, kBufferSize, nullptr);
+      gst_buffer_memset(buffer, 0, 0x47, kBufferSize);
+      GstFlowReturn ret;
+      g_signal_emit_by_name(src, "push-buffer", buffer, &ret);
+      gst_buffer_unref(buffer);
+      if (ret != GST_FLOW_OK) {
+        return;
+      }
+      pushed++;
+    }
+  });
+
+  for (int i = 0; i < 1000 && pushed != kBuffers; ++i) {
+    usleep(10000);
+  }
+  const size_t pushed_in_time = pushed;
+
+  // stopping pipeline unblocks source thread if ingest queue didn't leak
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  source.join();
+  close(reader);
+  gst_object_unref(pipeline);
+  delete queue;
+  delete sink;
+  unlink(path.c_str());
+
+  ASSERT_EQ(pushed_in_time, kBuffers);
+  // sink stalled on full shm area, queue dropped oldest buffers
+  ASSERT_GT(rendered, 0);
+  ASSERT_LT(rendered, kBuffers);
+}
@@ -0,0 +1,245 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stream/tcp_clients_server.h"
+
+namespace {
+
+typedef iptv_cloud::stream::TcpClientsServer TcpClientsServer;
+
+int connect_client(uint16_t port, int rcvbuf) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (rcvbuf) {
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  }
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+  return fd;
+}
+
+bool wait_clients(const TcpClientsServer& server, size_t clients) {
+  for (int i = 0; i < 200; ++i) {
+    if (server.GetStats().clients == clients) {
+      return true;
+    }
+    usleep(10000);
+  }
+  return false;
+}
+
+// sent bytes are committed after socket call, client can read them a bit earlier
+bool wait_sent(const TcpClientsServer& server, uint64_t bytes) {
+  for (int i = 0; i < 200; ++i) {
+    const std::vector<TcpClientsServer::ClientStats> clients = server.GetClientsStats();
+    if (clients.size() == 1 && clients[0].bytes_sent == bytes) {
+      return true;
+    }
+    usleep(10000);
+  }
+  return false;
+}
+
+std::string read_exactly(int fd, size_t size) {
+  std::string received;
+  char buff[4096];
+  while (received.size() < size) {
+    ssize_t res = read(fd, buff, std::min(sizeof(buff), size - received.size()));
+    if (res <= 0) {
+      break;
+    }
+    received.append(buff, res);
+  }
+  return received;
+}
+
+// ts packet with payload unit start, section follows zero pointer field
+std::string make_section_packet(uint16_t pid, const std::vector<uint8_t>& section) {
+  std::string packet(188, static_cast<char>(0xff));
+  packet[0] = 0x47;
+  packet[1] = static_cast<char>(0x40 | (pid >> 8));
+  packet[2] = static_cast<char>(pid & 0xff);
+  packet[3] = 0x10;
+  packet[4] = 0;
+  std::copy(section.begin(), section.end(), packet.begin() + 5);
+  return packet;
+}
+
+std::string make_payload_packet(uint16_t pid, char fill) {
+  std::string packet(188, fill);
+  packet[0] = 0x47;
+  packet[1] = static_cast<char>(pid >> 8);
+  packet[2] = static_cast<char>(pid & 0xff);
+  packet[3] = 0x10;
+  return packet;
+}
+
+}  // namespace
+
+TEST(TcpClientsServer, StartFromKeyframe) {
+  TcpClientsServer server(64 * 1024, 1000);
+  ASSERT_FALSE(server.Open(common::net::HostAndPort("127.0.0.1", 0)));
+  ASSERT_NE(server.GetPort(), 0);
+
+  int fd = connect_client(server.GetPort(), 0);
+  ASSERT_TRUE(wait_clients(server, 1));
+
+  const std::string delta = "delta";
+  const std::string key = "key";
+  server.Write(delta.data(), delta.size(), false);  // client joined in the middle of gop
+  server.Write(key.data(), key.size(), true);
+  server.Write(delta.data(), delta.size(), false);
+
+  const std::string expected = key + delta;
+  std::string received;
+  char buff[64];
+  while (received.size() < expected.size()) {
+    ssize_t res = read(fd, buff, sizeof(buff));
+    ASSERT_GT(res, 0);
+    received.append(buff, res);
+  }
+  ASSERT_EQ(received, expected);
+  ASSERT_TRUE(wait_sent(server, expected.size()));
+
+  const std::vector<TcpClientsServer::ClientStats> clients = server.GetClientsStats();
+  ASSERT_EQ(clients.size(), 1);
+  ASSERT_EQ(clients[0].bytes_sent, expected.size());
+  ASSERT_EQ(clients[0].bytes_dropped, 0);
+
+  close(fd);
+  ASSERT_TRUE(wait_clients(server, 0));
+  server.Close();
+}
+
+TEST(TcpClientsServer, SlowClientEvicted) {
+  TcpClientsServer server(1024 * 1024, 200);
+  ASSERT_FALSE(server.Open(common::net::HostAndPort("127.0.0.1", 0)));
+
+  int fast_fd = connect_client(server.GetPort(), 0);
+  int slow_fd = connect_client(server.GetPort(), 4096);  // never reads
+  ASSERT_TRUE(wait_clients(server, 2));
+
+  std::atomic<size_t> fast_received(0);
+  std::atomic<bool> stop(false);
+  std::thread reader([&] {
+    char buff[65536];
+    while (!stop) {
+      ssize_t res = recv(fast_fd, buff, sizeof(buff), MSG_DONTWAIT);
+      if (res > 0) {
+        fast_received += res;
+      } else {
+        usleep(100);
+      }
+    }
+  });
+
+  // 10 datagrams of 1316 bytes per chunk, keyframe every 25, about 50 mbit/s for 2 seconds,
+  // more than socket buffers of slow client can hide
+  std::vector<uint8_t> chunk(13160, 0x47);
+  size_t written = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    server.Write(chunk.data(), chunk.size(), i % 25 == 0);
+    written += chunk.size();
+    usleep(2000);
+  }
+
+  ASSERT_TRUE(wait_clients(server, 1));
+  for (int i = 0; i < 200 && fast_received != written; ++i) {
+    usleep(10000);
+  }
+  stop = true;
+  reader.join();
+
+  const TcpClientsServer::Stats stats = server.GetStats();
+  ASSERT_EQ(stats.accepted, 2);
+  ASSERT_EQ(stats.evicted, 1);
+  ASSERT_EQ(fast_received, written);  // stalled neighbour cost fast client nothing
+
+  close(fast_fd);
+  close(slow_fd);
+  server.Close();
+}
+
+TEST(TcpClientsServer, TablesBeforeFirstKeyframe) {
+  TcpClientsServer server(64 * 1024, 1000);
+  ASSERT_FALSE(server.Open(common::net::HostAndPort("127.0.0.1", 0)));
+
+  // program 1 in pmt pid 0x20, crc isn't checked
+  const std::string pat = make_section_packet(0, {0x00, 0xb0, 0x0d, 0x00, 0x01, 0xc1, 0x00, 0x00, 0x00, 0x01, 0xe0,
+                                                  0x20, 0x00, 0x00, 0x00, 0x00});
+  const std::string pmt = make_section_packet(0x20, {0x02, 0xb0, 0x12, 0x00, 0x01, 0xc1, 0x00, 0x00, 0xe1, 0x00,
+                                                     0xf0, 0x00, 0x1b, 0xe1, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00,
+                                                     0x00});
+  const std::string delta = make_payload_packet(0x100, 'd');
+  const std::string key = make_payload_packet(0x100, 'k');
+
+  // tables went out before client joined
+  const std::string head = pat + pmt + delta;
+  server.Write(head.data(), head.size(), false);
+
+  int fd = connect_client(server.GetPort(), 0);
+  ASSERT_TRUE(wait_clients(server, 1));
+  server.Write(delta.data(), delta.size(), false);
+  server.Write(key.data(), key.size(), true);
+  server.Write(delta.data(), delta.size(), false);
+
+  const std::string expected = pat + pmt + key + delta;
+  ASSERT_EQ(read_exactly(fd, expected.size()), expected);
+  ASSERT_TRUE(wait_sent(server, expected.size()));
+
+  // resumed client already has tables
+  server.Write(key.data(), key.size(), true);
+  ASSERT_EQ(read_exactly(fd, key.size()), key);
+
+  close(fd);
+  ASSERT_TRUE(wait_clients(server, 0));
+  server.Close();
+}
+
+TEST(TcpClientsServer, ChunkOverQueueLimit) {
+  TcpClientsServer server(64 * 1024, 0);
+  ASSERT_FALSE(server.Open(common::net::HostAndPort("127.0.0.1", 0)));
+
+  int fd = connect_client(server.GetPort(), 0);
+  ASSERT_TRUE(wait_clients(server, 1));
+
+  // keyframe bigger than whole queue
+  const std::string key(256 * 1024, 'k');
+  server.Write(key.data(), key.size(), true);
+  ASSERT_EQ(read_exactly(fd, key.size()), key);
+
+  const TcpClientsServer::Stats stats = server.GetStats();
+  ASSERT_EQ(stats.clients, 1);
+  ASSERT_EQ(stats.evicted, 0);
+  ASSERT_EQ(server.GetClientsStats()[0].bytes_dropped, 0);
+
+  close(fd);
+  ASSERT_TRUE(wait_clients(server, 0));
+  server.Close();
+}
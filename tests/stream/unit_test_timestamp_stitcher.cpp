@@ -0,0 +1,102 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include "stream/timestamp_stitcher.h"
+
+namespace {
+const uint64_t kMs = 1000000;  // nsec
+}
+
+TEST(TimestampStitcher, ContinuousAcrossFiles) {
+  iptv_cloud::stream::TimestampStitcher stitcher;
+  const uint64_t none = iptv_cloud::stream::TimestampStitcher::invalid_timestamp;
+  uint64_t jump = 0;
+
+  // first file 10s..10.2s, video 40ms frames, audio 20ms frames without dts
+  for (uint64_t i = 0; i < 5; ++i) {
+    uint64_t pts = 10000 * kMs + i * 40 * kMs;
+    uint64_t dts = pts;
+    ASSERT_FALSE(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump));
+    ASSERT_EQ(pts, 10000 * kMs + i * 40 * kMs);
+  }
+  for (uint64_t i = 0; i < 10; ++i) {
+    uint64_t pts = 10000 * kMs + i * 20 * kMs;
+    uint64_t dts = none;
+    ASSERT_FALSE(stitcher.Stitch(1, &pts, &dts, none, &jump));
+    ASSERT_EQ(dts, none);
+  }
+
+  stitcher.MarkTransition();
+  // demuxer still drains previous file, timestamps untouched
+  uint64_t pts = 10200 * kMs;
+  uint64_t dts = pts;
+  ASSERT_FALSE(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump));
+  ASSERT_EQ(dts, 10200 * kMs);
+
+  // second file starts from 1s, continues after end of video (10.24s)
+  pts = 1000 * kMs;
+  dts = 1000 * kMs;
+  ASSERT_TRUE(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump));
+  ASSERT_EQ(dts, 10240 * kMs);
+  ASSERT_EQ(jump, (10240 - 1000) * 1000);
+  pts = 1040 * kMs;
+  dts = 1040 * kMs;
+  ASSERT_FALSE(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump));
+  ASSERT_EQ(dts, 10280 * kMs);
+
+  // audio gets same offset, stays in sync with video
+  pts = 1000 * kMs;
+  dts = none;
+  ASSERT_TRUE(stitcher.Stitch(1, &pts, &dts, none, &jump));
+  ASSERT_EQ(pts, 10240 * kMs);
+
+  // jumps without transition are not stitched
+  pts = 50000 * kMs;
+  dts = pts;
+  ASSERT_FALSE(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump));
+  ASSERT_EQ(dts, 59240 * kMs);
+
+  stitcher.Reset();
+  pts = 1000 * kMs;
+  dts = pts;
+  ASSERT_FALSE(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump));
+  ASSERT_EQ(dts, 1000 * kMs);
+}
+
+TEST(TimestampStitcher, ShortFileRestart) {
+  iptv_cloud::stream::TimestampStitcher stitcher;
+  uint64_t jump = 0;
+
+  // first file is half second long, 0..0.48s
+  for (uint64_t i = 0; i < 13; ++i) {
+    uint64_t pts = i * 40 * kMs;
+    uint64_t dts = pts;
+    ASSERT_FALSE(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump));
+  }
+
+  // next file starts from 0 again, backward jump is smaller than max_jump
+  stitcher.MarkTransition();
+  uint64_t last_out = 480 * kMs;
+  for (uint64_t i = 0; i < 13; ++i) {
+    uint64_t pts = i * 40 * kMs;
+    uint64_t dts = pts;
+    ASSERT_EQ(stitcher.Stitch(0, &pts, &dts, 40 * kMs, &jump), i == 0);
+    ASSERT_GT(dts, last_out);
+    ASSERT_EQ(dts, 520 * kMs + i * 40 * kMs);
+    last_out = dts;
+  }
+  ASSERT_EQ(jump, 520 * 1000);
+}
@@ -0,0 +1,138 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "stream/rtp_jitter_buffer.h"
+#include "stream/udp_batch_receiver.h"
+
+namespace {
+
+typedef iptv_cloud::stream::RtpJitterBuffer RtpJitterBuffer;
+const uint64_t kMs = 1000000;  // nsec
+
+void push(RtpJitterBuffer* jitter, uint16_t seq, uint64_t arrival, std::vector<uint8_t>* out) {
+  const uint8_t payload = static_cast<uint8_t>(seq);
+  jitter->Push(seq, &payload, sizeof(payload), arrival, out);
+}
+
+uint16_t free_udp_port() {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+  socklen_t len = sizeof(addr);
+  getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len);
+  close(fd);
+  return ntohs(addr.sin_port);
+}
+
+}  // namespace
+
+TEST(RtpJitterBuffer, Reorder) {
+  RtpJitterBuffer jitter(50 * kMs);
+  std::vector<uint8_t> out;
+
+  // 3 and 4 swapped, 2 repeated, wrap of sequence numbers
+  const uint16_t seqs[] = {65534, 65535, 0, 1, 2, 4, 3, 2, 5};
+  for (uint16_t seq : seqs) {
+    push(&jitter, seq, 0, &out);
+    jitter.Pop(0, &out);
+  }
+  const std::vector<uint8_t> expected = {254, 255, 0, 1, 2, 3, 4, 5};
+  ASSERT_EQ(out, expected);
+  ASSERT_EQ(jitter.GetSize(), 0u);
+  ASSERT_EQ(jitter.GetLost(), 0u);
+  ASSERT_EQ(jitter.GetReordered(), 1u);
+  ASSERT_EQ(jitter.GetDuplicates(), 1u);
+}
+
+TEST(RtpJitterBuffer, LossAfterLatency) {
+  RtpJitterBuffer jitter(50 * kMs);
+  std::vector<uint8_t> out;
+
+  push(&jitter, 10, 0, &out);
+  push(&jitter, 13, 10 * kMs, &out);
+  push(&jitter, 14, 20 * kMs, &out);
+  jitter.Pop(20 * kMs, &out);
+  ASSERT_EQ(out, std::vector<uint8_t>({10}));
+  ASSERT_EQ(jitter.GetDeadline(), 60 * kMs);
+
+  // 11 came in time, 12 didn't
+  push(&jitter, 11, 30 * kMs, &out);
+  jitter.Pop(30 * kMs, &out);
+  ASSERT_EQ(out, std::vector<uint8_t>({10, 11}));
+  jitter.Pop(60 * kMs, &out);
+  ASSERT_EQ(out, std::vector<uint8_t>({10, 11, 13, 14}));
+  ASSERT_EQ(jitter.GetLost(), 1u);
+  ASSERT_EQ(jitter.GetDeadline(), RtpJitterBuffer::invalid_deadline);
+
+  // late one dropped, it is lost already
+  push(&jitter, 12, 70 * kMs, &out);
+  ASSERT_EQ(jitter.GetSize(), 0u);
+  ASSERT_EQ(jitter.GetReordered(), 2u);
+
+  // sender restart, new sequence without losses
+  push(&jitter, 40000, 80 * kMs, &out);
+  push(&jitter, 40001, 80 * kMs, &out);
+  jitter.Pop(80 * kMs, &out);
+  ASSERT_EQ(out, std::vector<uint8_t>({10, 11, 13, 14, 64, 65}));
+  ASSERT_EQ(jitter.GetLost(), 1u);
+}
+
+TEST(UdpBatchReceiver, RtpOverLoopback) {
+  const uint16_t port = free_udp_port();
+  iptv_cloud::stream::UdpBatchReceiver receiver(50 * kMs);
+  ASSERT_FALSE(receiver.Open(common::net::HostAndPort("127.0.0.1", port), 4 * 1024 * 1024));
+  ASSERT_GT(receiver.GetReceiveBufferSize(), 0);
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  ASSERT_EQ(connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+
+  // rtp (mp2t payload type 33) with one ts packet, numbered by sequence
+  const uint16_t seqs[] = {100, 102, 101, 102, 103};
+  for (uint16_t seq : seqs) {
+    uint8_t datagram[12 + 188] = {0x80, 33, static_cast<uint8_t>(seq >> 8), static_cast<uint8_t>(seq)};
+    datagram[12] = 0x47;
+    datagram[13] = static_cast<uint8_t>(seq);
+    ASSERT_EQ(send(fd, datagram, sizeof(datagram), 0), static_cast<ssize_t>(sizeof(datagram)));
+  }
+  close(fd);
+
+  std::vector<uint8_t> out;
+  for (int i = 0; i < 10 && out.size() < 4 * 188; ++i) {
+    ASSERT_FALSE(receiver.Read(100, &out));
+  }
+  ASSERT_EQ(out.size(), 4 * 188u);
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(out[i * 188], 0x47);
+    ASSERT_EQ(out[i * 188 + 1], 100 + i);
+  }
+  ASSERT_EQ(receiver.GetDatagrams(), 5u);
+  ASSERT_EQ(receiver.GetJitterBuffer()->GetReordered(), 1u);
+  ASSERT_EQ(receiver.GetJitterBuffer()->GetDuplicates(), 1u);
+  ASSERT_EQ(receiver.GetJitterBuffer()->GetLost(), 0u);
+}
@@ -0,0 +1,145 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "stream/udp_batch_sender.h"
+
+namespace {
+
+typedef iptv_cloud::stream::UdpBatchSender UdpBatchSender;
+
+// time passes only by sleeps of sender
+class FakeClock : public UdpBatchSender::Clock {
+ public:
+  FakeClock() : now(1000000000), slept(0) {}
+
+  uint64_t GetNsec() override { return now; }
+  void SleepNsec(uint64_t nsec) override {
+    now += nsec;
+    slept += nsec;
+  }
+
+  uint64_t now;
+  uint64_t slept;
+};
+
+// bound loopback socket, port in *port
+int make_receiver(uint16_t* port) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (fd == -1 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+    return -1;
+  }
+
+  socklen_t len = sizeof(addr);
+  getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len);
+  *port = ntohs(addr.sin_port);
+  struct timeval tv = {1, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  return fd;
+}
+
+std::vector<uint8_t> make_ts_packets(size_t count) {
+  std::vector<uint8_t> data(count * UdpBatchSender::ts_packet_size, 0xff);
+  for (size_t i = 0; i < count; ++i) {
+    data[i * UdpBatchSender::ts_packet_size] = 0x47;
+    data[i * UdpBatchSender::ts_packet_size + 1] = static_cast<uint8_t>(i);
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(UdpBatchSender, DatagramsOfSevenPackets) {
+  uint16_t port = 0;
+  int receiver = make_receiver(&port);
+  ASSERT_NE(receiver, -1);
+
+  FakeClock clock;
+  UdpBatchSender sender(&clock);
+  sender.SetPacing(false);
+  ASSERT_FALSE(sender.Open(common::net::HostAndPort("127.0.0.1", port)));
+
+  // muxer buffers aren't aligned to datagrams
+  const size_t packets = 100;
+  const std::vector<uint8_t> data = make_ts_packets(packets);
+  for (size_t offset = 0; offset < data.size(); offset += 1000) {
+    ASSERT_FALSE(sender.Write(&data[offset], std::min<size_t>(1000, data.size() - offset)));
+  }
+  ASSERT_FALSE(sender.Flush());
+
+  std::vector<uint8_t> received;
+  size_t datagrams = 0;
+  while (received.size() < data.size()) {
+    uint8_t buff[UdpBatchSender::datagram_size * 2];
+    ssize_t res = recv(receiver, buff, sizeof(buff), 0);
+    ASSERT_GT(res, 0);
+    const size_t expected = ++datagrams == packets / 7 + 1 ? (packets % 7) * UdpBatchSender::ts_packet_size
+                                                            : static_cast<size_t>(UdpBatchSender::datagram_size);
+    ASSERT_EQ(static_cast<size_t>(res), expected);
+    received.insert(received.end(), buff, buff + res);
+  }
+  ASSERT_EQ(received, data);
+
+  UdpBatchSender::Stats stats = sender.GetStats();
+  ASSERT_EQ(stats.datagrams, packets / 7 + 1);
+  ASSERT_EQ(stats.ts_packets, packets);
+  ASSERT_EQ(stats.bytes, data.size());
+  ASSERT_LT(stats.bursts, stats.datagrams);
+  ASSERT_EQ(stats.send_errors, 0u);
+  ASSERT_EQ(stats.paced_waits, 0u);
+  ASSERT_EQ(clock.slept, 0u);
+  close(receiver);
+}
+
+TEST(UdpBatchSender, PacedToBitrate) {
+  uint16_t port = 0;
+  int receiver = make_receiver(&port);
+  ASSERT_NE(receiver, -1);
+
+  FakeClock clock;
+  UdpBatchSender sender(&clock);
+  const uint64_t bitrate = 8000000;
+  sender.SetFixedBitrate(bitrate);
+  ASSERT_FALSE(sender.Open(common::net::HostAndPort("127.0.0.1", port)));
+
+  // half second of stream pushed at once as one big frame
+  const std::vector<uint8_t> data = make_ts_packets(bitrate / 8 / 2 / UdpBatchSender::ts_packet_size);
+  ASSERT_FALSE(sender.Write(data.data(), data.size()));
+  ASSERT_FALSE(sender.Flush());
+
+  UdpBatchSender::Stats stats = sender.GetStats();
+  ASSERT_EQ(stats.bytes, data.size());
+  // bursts of 4 datagrams (5 msec at 8.8 Mbit/s)
+  ASSERT_EQ(stats.bursts, (stats.datagrams + 3) / 4);
+
+  // each burst is followed by its time at 110% of bitrate, sender starts with one burst interval of credit,
+  // so two first bursts go at once and every next one waits for previous
+  const uint64_t pacing_bitrate = bitrate * UdpBatchSender::pacing_headroom_percent / 100;
+  const uint64_t burst_ns = 4 * UdpBatchSender::datagram_size * 8 * UINT64_C(1000000000) / pacing_bitrate;
+  const uint64_t credit_ns = UdpBatchSender::burst_interval_msec * UINT64_C(1000000);
+  ASSERT_EQ(stats.paced_waits, stats.bursts - 2);
+  ASSERT_EQ(clock.slept, (stats.bursts - 1) * burst_ns - credit_ns);
+  close(receiver);
+}
@@ -0,0 +1,75 @@
+/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+    This file is part of iptv_cloud.
+    iptv_cloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    iptv_cloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with iptv_cloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gtest/gtest.h"
+
+#include <json-c/json_object.h>
+
+#include "protocol/request_parser.h"
+
+TEST(Protocol, peek_header) {
+  iptv_cloud::protocol::MessageHeader header;
+  ASSERT_TRUE(iptv_cloud::protocol::PeekMessageHeader(
+      "{ \"jsonrpc\": \"2.0\", \"method\": \"statistic_stream\", \"params\": { \"id\": \"s\", \"input\": [ { \"id\": 0 "
+      "} ], \"method\": \"x}\" } }",
+      &header));
+  ASSERT_TRUE(header.IsNotification());
+  ASSERT_EQ(header.method, "statistic_stream");
+  ASSERT_EQ(header.params, "{ \"id\": \"s\", \"input\": [ { \"id\": 0 } ], \"method\": \"x}\" }");
+
+  ASSERT_TRUE(iptv_cloud::protocol::PeekMessageHeader(
+      "{\"params\":{\"config\":{}},\"id\":\"00000000000000a1\",\"jsonrpc\":\"2.0\",\"method\":\"start_stream\"}",
+      &header));
+  ASSERT_TRUE(header.IsRequest());
+  ASSERT_FALSE(header.IsNotification());
+  ASSERT_EQ(header.method, "start_stream");
+  ASSERT_EQ(header.params, "{\"config\":{}}");
+
+  ASSERT_TRUE(iptv_cloud::protocol::PeekMessageHeader("{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":\"OK\"}", &header));
+  ASSERT_FALSE(header.IsRequest());
+
+  ASSERT_TRUE(iptv_cloud::protocol::PeekMessageHeader("{\"method\":\"ping\",\"id\":null,\"params\":null}", &header));
+  ASSERT_TRUE(header.IsNotification());
+  ASSERT_TRUE(header.params.empty());
+
+  ASSERT_FALSE(iptv_cloud::protocol::PeekMessageHeader("", &header));
+  ASSERT_FALSE(iptv_cloud::protocol::PeekMessageHeader("[1, 2]", &header));
+  ASSERT_FALSE(iptv_cloud::protocol::PeekMessageHeader("{\"method\":\"ping\"", &header));
+  ASSERT_FALSE(iptv_cloud::protocol::PeekMessageHeader("{\"method\":\"ping\",\"params\":{\"a\":\"}", &header));
+  ASSERT_FALSE(iptv_cloud::protocol::PeekMessageHeader("{\"method\":1}", &header));
+}
+
+TEST(Protocol, parse_request) {
+  iptv_cloud::protocol::request_t req;
+  json_object* params = nullptr;
+  common::Error err = iptv_cloud::protocol::ParseRequest(
+      "{\"jsonrpc\":\"2.0\",\"method\":\"stop_stream\",\"id\":\"0a\",\"params\":{\"id\":\"stream\"}}", &req, &params);
+  ASSERT_FALSE(err);
+  ASSERT_EQ(req.method, "stop_stream");
+  ASSERT_TRUE(req.id);
+  ASSERT_EQ(*req.id, "0a");
+  ASSERT_TRUE(params);
+  json_object* jid = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(params, "id", &jid));
+  ASSERT_STREQ(json_object_get_string(jid), "stream");
+  json_object_put(params);
+
+  err = iptv_cloud::protocol::ParseRequest("{\"jsonrpc\":\"2.0\",\"method\":\"ping_service\"}", &req, &params);
+  ASSERT_FALSE(err);
+  ASSERT_FALSE(req.id);
+  ASSERT_FALSE(params);
+
+  err = iptv_cloud::protocol::ParseRequest("{\"jsonrpc\":\"2.0\",\"id\":\"0a\",\"result\":\"OK\"}", &req, &params);
+  ASSERT_TRUE(err);
+}
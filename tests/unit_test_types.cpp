@@ -14,6 +14,15 @@
 
 #include <gtest/gtest.h>
 
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/channel_stats.h"
+#include "base/histogram.h"
+
 #include "stream_commands_info/statistic_info.h"
 
 TEST(StreamStructInfo, SerializeDeSerialize) {
@@ -29,8 +38,9 @@ TEST(StreamStructInfo, SerializeDeSerialize) {
   iptv_cloud::StatisticInfo::cpu_load_t cpu_load = 0.33;
   iptv_cloud::StatisticInfo::rss_t rss = 12;
   time_t time = 10;
+  time_t first_output = 420;
 
-  iptv_cloud::StatisticInfo sinf(str, cpu_load, rss, time);
+  iptv_cloud::StatisticInfo sinf(str, cpu_load, rss, time, first_output);
   json_object* serialized = NULL;
   common::Error err = sinf.Serialize(&serialized);
   ASSERT_FALSE(err);
@@ -42,6 +52,254 @@ TEST(StreamStructInfo, SerializeDeSerialize) {
   ASSERT_EQ(sinf.GetCpuLoad(), sinf2.GetCpuLoad());
   ASSERT_EQ(sinf.GetRss(), sinf2.GetRss());
   ASSERT_EQ(sinf.GetTimestamp(), sinf2.GetTimestamp());
+  ASSERT_EQ(sinf.GetFirstOutput(), sinf2.GetFirstOutput());
 
   json_object_put(serialized);
 }
+
+TEST(StreamStatsBlock, PublishRead) {
+  iptv_cloud::StreamInfo sha;
+  sha.id = "test";
+  sha.input = {0, 1};
+  sha.output = {2};
+
+  iptv_cloud::StreamStruct str(sha, 15, 33, 1);
+  iptv_cloud::StreamStatsBlock block;
+  str.shared_stats = &block;
+  iptv_cloud::StreamStatsSnapshot snapshot;
+  ASSERT_TRUE(block.Read(&snapshot));
+  ASSERT_EQ(snapshot.input_count, 0);
+
+  str.status = iptv_cloud::PLAYING;
+  str.input[1]->SetTotalBytes(100);
+  str.input[1]->SetBps(10);
+  str.input[0]->RecordTransitionStall(3000);
+  str.output[0]->SetTotalBytes(200);
+  str.output[0]->RecordBuffer(1316, iptv_cloud::ChannelStats::invalid_timestamp);
+  str.output[0]->SetMaxGap(40000);
+  str.output[0]->RecordDrop(2632, 2);
+  str.output[0]->SetDegraded(true);
+  str.output[0]->RecordReconnect(1500);
+  str.input[0]->RecordRtpCounters(3, 2, 1);
+  str.output[0]->SetClients(12);
+  str.output[0]->SetEvictedClients(4);
+  str.PublishStats();
+  block.PublishProcessInfo(0.5, 1024);
+  block.PublishFirstOutput(250);
+
+  ASSERT_TRUE(block.Read(&snapshot));
+  ASSERT_EQ(snapshot.status, iptv_cloud::PLAYING);
+  ASSERT_EQ(snapshot.restarts, 1);
+  ASSERT_EQ(snapshot.start_time, 15);
+  ASSERT_EQ(snapshot.loop_start_time, 33);
+  ASSERT_EQ(snapshot.cpu_load, 0.5);
+  ASSERT_EQ(snapshot.rss, 1024);
+  ASSERT_EQ(snapshot.first_output, 250);
+  ASSERT_EQ(snapshot.input_count, 2);
+  ASSERT_EQ(snapshot.input[1].id, 1);
+  ASSERT_EQ(snapshot.input[1].total_bytes, 100);
+  ASSERT_EQ(snapshot.input[1].bps, 10);
+  ASSERT_EQ(snapshot.input[0].transition_stall.count, 1);
+  ASSERT_EQ(snapshot.input[0].transition_stall.sum, 3000);
+  ASSERT_EQ(snapshot.output_count, 1);
+  ASSERT_EQ(snapshot.output[0].id, 2);
+  ASSERT_EQ(snapshot.output[0].total_bytes, 200);
+  ASSERT_EQ(snapshot.output[0].buffer_size.count, 1);
+  ASSERT_EQ(snapshot.output[0].buffer_size.sum, 1316);
+  ASSERT_EQ(snapshot.output[0].max_gap, 40000);
+  ASSERT_EQ(snapshot.output[0].dropped_bytes, 2632);
+  ASSERT_EQ(snapshot.output[0].dropped_packets, 2);
+  ASSERT_TRUE(snapshot.output[0].degraded);
+  ASSERT_EQ(snapshot.output[0].reconnects, 1);
+  ASSERT_EQ(snapshot.output[0].downtime, 1500);
+  ASSERT_EQ(snapshot.input[0].lost_packets, 3);
+  ASSERT_EQ(snapshot.input[0].reordered_packets, 2);
+  ASSERT_EQ(snapshot.input[0].duplicate_packets, 1);
+  ASSERT_EQ(snapshot.output[0].clients, 12);
+  ASSERT_EQ(snapshot.output[0].evicted_clients, 4);
+}
+
+TEST(StreamStatsBlock, ConsistentSnapshot) {
+  iptv_cloud::StreamInfo sha;
+  sha.id = "test";
+  sha.input = {0, 1, 2, 3};
+  sha.output = {4, 5, 6, 7};
+
+  iptv_cloud::StreamStruct str(sha);
+  int fd = INVALID_DESCRIPTOR;
+  common::ErrnoError err = iptv_cloud::CreateSharedStatsBlock(&fd, &str.shared_stats);
+  ASSERT_FALSE(err);
+  iptv_cloud::StreamStatsBlock* attached = nullptr;
+  err = iptv_cloud::AttachSharedStatsBlock(fd, &attached);
+  ASSERT_FALSE(err);
+  close(fd);
+
+  std::thread writer([&str] {
+    for (size_t i = 1; i <= 100000; ++i) {
+      for (auto* stats : str.input) {
+        stats->SetTotalBytes(i);
+      }
+      for (auto* stats : str.output) {
+        stats->SetTotalBytes(i);
+      }
+      str.PublishStats();
+    }
+  });
+
+  size_t readed = 0;
+  for (size_t i = 0; i < 100000; ++i) {
+    iptv_cloud::StreamStatsSnapshot snapshot;
+    if (!attached->Read(&snapshot)) {  // other mapping of same memory
+      continue;
+    }
+
+    readed++;
+    for (size_t j = 0; j < snapshot.input_count; ++j) {
+      ASSERT_EQ(snapshot.input[j].total_bytes, snapshot.input[0].total_bytes);
+    }
+    for (size_t j = 0; j < snapshot.output_count; ++j) {
+      ASSERT_EQ(snapshot.output[j].total_bytes, snapshot.input[0].total_bytes);
+    }
+  }
+  writer.join();
+  ASSERT_NE(readed, 0);
+  iptv_cloud::DetachSharedStatsBlock(&attached);
+  iptv_cloud::DetachSharedStatsBlock(&str.shared_stats);
+}
+
+TEST(ChannelStats, UpdateData) {
+  iptv_cloud::ChannelStats stats(3);
+  stats.UpdateData(1316, 1);
+  stats.UpdateData(1316 * 7, 7);  // buffer list
+  ASSERT_EQ(stats.GetTotalBytes(), 1316 * 8);
+  ASSERT_EQ(stats.GetTotalPackets(), 8);
+  ASSERT_NE(stats.GetLastUpdateTime(), 0);
+
+  iptv_cloud::ChannelStats copy(stats);
+  ASSERT_EQ(copy.GetID(), 3);
+  ASSERT_EQ(copy.GetTotalBytes(), stats.GetTotalBytes());
+  ASSERT_EQ(copy.GetTotalPackets(), stats.GetTotalPackets());
+
+  iptv_cloud::StreamInfo sha;
+  sha.id = "test";
+  sha.output = {0};
+  iptv_cloud::StreamStruct str(sha);
+  std::thread writer([&str] {
+    for (size_t i = 0; i < 100000; ++i) {
+      str.output[0]->UpdateData(188, 1);
+    }
+  });
+  for (size_t i = 0; i < 100000; ++i) {
+    str.output[0]->UpdateData(188, 1);
+  }
+  writer.join();
+  ASSERT_EQ(str.output[0]->GetTotalBytes(), 188 * 200000);
+  ASSERT_EQ(str.output[0]->GetTotalPackets(), 200000);
+}
+
+TEST(ChannelStats, ProbeAccountingThreads) {
+  iptv_cloud::StreamInfo sha;
+  sha.id = "test";
+  sha.input = {0, 1};
+  sha.output = {2, 3};
+  iptv_cloud::StreamStruct str(sha);
+  const size_t buffers = 100000;
+
+  // probes of every pad write into slots bound at creation, two probes share last output
+  iptv_cloud::ChannelStats* slots[] = {str.input[0], str.input[1], str.output[0], str.output[1], str.output[1]};
+  std::vector<std::thread> probes;
+  for (size_t i = 0; i < sizeof(slots) / sizeof(slots[0]); ++i) {
+    iptv_cloud::ChannelStats* slot = slots[i];
+    probes.emplace_back([slot, i, buffers] {
+      for (size_t j = 0; j < buffers; ++j) {
+        if (j % 2) {
+          slot->UpdateData(1316 * (i + 1), i + 1);  // buffer list
+        } else {
+          slot->UpdateData(1316, 1);
+        }
+      }
+    });
+  }
+
+  // statistic timer reads while probes are running, counters never go back
+  size_t prev_bytes = 0;
+  size_t prev_packets = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    const size_t bytes = str.output[1]->GetTotalBytes();
+    const size_t packets = str.output[1]->GetTotalPackets();
+    ASSERT_GE(bytes, prev_bytes);
+    ASSERT_GE(packets, prev_packets);
+    prev_bytes = bytes;
+    prev_packets = packets;
+  }
+
+  for (auto& probe : probes) {
+    probe.join();
+  }
+
+  // each probe wrote half single buffers and half lists of (i + 1) buffers
+  const size_t half = buffers / 2;
+  ASSERT_EQ(str.input[0]->GetTotalPackets(), half * 2);
+  ASSERT_EQ(str.input[1]->GetTotalPackets(), half * 3);
+  ASSERT_EQ(str.output[0]->GetTotalPackets(), half * 4);
+  ASSERT_EQ(str.output[1]->GetTotalPackets(), half * 5 + half * 6);
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(slots[i]->GetTotalBytes(), slots[i]->GetTotalPackets() * 1316);
+  }
+}
+
+TEST(Histogram, Buckets) {
+  iptv_cloud::Histogram hist(100);
+  hist.Record(0);
+  hist.Record(100);
+  hist.Record(101);
+  hist.Record(200);
+  hist.Record(401);
+  hist.Record(UINT64_MAX / 2);
+
+  iptv_cloud::HistogramSnapshot snapshot = hist.GetSnapshot();
+  ASSERT_EQ(snapshot.first_bound, 100);
+  ASSERT_EQ(snapshot.buckets[0], 2);
+  ASSERT_EQ(snapshot.buckets[1], 2);
+  ASSERT_EQ(snapshot.buckets[2], 0);
+  ASSERT_EQ(snapshot.buckets[3], 1);
+  ASSERT_EQ(snapshot.buckets[iptv_cloud::HistogramSnapshot::buckets_count - 1], 1);
+  ASSERT_EQ(snapshot.count, 6);
+  ASSERT_EQ(snapshot.GetUpperBound(3), 800);
+  ASSERT_EQ(snapshot.GetUpperBound(iptv_cloud::HistogramSnapshot::buckets_count - 1), UINT64_MAX);
+
+  iptv_cloud::Histogram copy(hist);
+  ASSERT_EQ(copy.GetSnapshot().buckets[3], 1);
+  ASSERT_EQ(copy.GetSnapshot().sum, snapshot.sum);
+}
+
+TEST(ChannelStats, ArrivalHistograms) {
+  iptv_cloud::ChannelStats stats(0);
+  const uint64_t ms = 1000;
+  stats.RecordArrival(10 * ms);
+  stats.RecordBuffer(1316, 0);
+  stats.RecordArrival(11 * ms);
+  stats.RecordBuffer(1316, 40 * ms * 1000);
+  stats.RecordArrival(311 * ms);  // burst after 300 msec silence
+  stats.RecordBuffer(188 * 100, iptv_cloud::ChannelStats::invalid_timestamp);
+  stats.RecordArrival(312 * ms);
+  stats.RecordBuffer(1316, 80 * ms * 1000);
+
+  iptv_cloud::HistogramSnapshot sizes = stats.GetBufferSizeHistogram();
+  ASSERT_EQ(sizes.count, 4);
+  ASSERT_EQ(sizes.sum, 1316 * 3 + 188 * 100);
+  iptv_cloud::HistogramSnapshot arrival = stats.GetArrivalHistogram();
+  ASSERT_EQ(arrival.count, 3);
+  ASSERT_EQ(arrival.sum, 302 * ms);
+  iptv_cloud::HistogramSnapshot gaps = stats.GetTimestampGapHistogram();
+  ASSERT_EQ(gaps.count, 2);
+  ASSERT_EQ(gaps.sum, 80 * ms);
+
+  stats.UpdateGapWindow(400 * ms);  // silence since last buffer is longer than gap in window
+  ASSERT_EQ(stats.GetMaxGap(), 300 * ms);
+  stats.RecordArrival(1400 * ms);
+  stats.UpdateGapWindow(1400 * ms);
+  ASSERT_EQ(stats.GetMaxGap(), 1088 * ms);
+  stats.UpdateGapWindow(1401 * ms);
+  ASSERT_EQ(stats.GetMaxGap(), 1 * ms);
+}
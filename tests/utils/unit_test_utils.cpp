@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "utils/chunk_info.h"
+#include "utils/variant_info.h"
 
 #define TEST_PLAYLIST PROJECT_TEST_SOURCES_DIR "/playlist.m3u8"
 #define NEW_PLAYLIST PROJECT_TEST_SOURCES_DIR "/test_write.m3u8"
@@ -9,3 +10,12 @@ TEST(ChunkInfo, double) {
   iptv_cloud::utils::ChunkInfo ch("1497615343667_segment10012.ts", 11.43 * iptv_cloud::utils::ChunkInfo::SECOND, 10012);
   ASSERT_EQ(ch.GetDurationInSecconds(), 11.43);
 }
+
+TEST(VariantInfo, codec_tags) {
+  ASSERT_EQ(iptv_cloud::utils::MakeH264CodecTag("constrained-baseline", "3"), "avc1.42E01E");
+  ASSERT_EQ(iptv_cloud::utils::MakeH264CodecTag("main", "3.1"), "avc1.4D401F");
+  ASSERT_EQ(iptv_cloud::utils::MakeH264CodecTag("high", "4.1"), "avc1.640029");
+  ASSERT_EQ(iptv_cloud::utils::MakeH264CodecTag("unknown", "4.1"), "");
+  ASSERT_EQ(iptv_cloud::utils::MakeH265CodecTag("main", "4.1"), "hvc1.1.6.L123.B0");
+  ASSERT_EQ(iptv_cloud::utils::MakeMpegAudioCodecTag(4), "mp4a.40.2");
+}